@@ -0,0 +1,115 @@
+// Catalogo de mensagens comprimido em PROGMEM.
+//
+// Os textos fixos dos sketches sao escritos como MSG("texto"). O script
+// host/gerar_catalogo.py le o sketch e gera catalogo_<sketch>.h com
+// todas as mensagens, uma copia de cada, comprimidas:
+//
+//   - pares de caracteres frequentes viram um codigo de um byte
+//     (0x80-0xFF); um par pode conter outros pares, entao prefixos como
+//     "[INTERCEPTADO] " ou "=====" acabam num unico byte
+//   - uma mensagem que comeca com outra inteira guarda so uma
+//     referencia a ela (PREFIXO_MENSAGEM + id) e o resto; a outra e
+//     guardada sem referencia, entao a decodificacao desce um nivel so
+//   - uma mensagem que e o final de outra aponta para dentro dela
+//
+// MSG("texto") vira, na compilacao, o id da mensagem (hash do texto e
+// busca binaria numa tabela constexpr que nao vai para o binario). Se o
+// texto nao estiver no catalogo, a compilacao falha: rode
+// make -C host catalogo. Mensagem e Printable, entao funciona com
+// Serial, FilaSerial e TelaLcd, e o texto e decodificado da flash em
+// blocos pequenos direto para o destino, sem copia na RAM.
+//
+//   #include "catalogo_projeto_1-modificado.h"
+//   saida.println(MSG("Sistema online"));
+#ifndef CATALOGO_H
+#define CATALOGO_H
+
+#include <Arduino.h>
+
+// Codigos do texto comprimido; 0x03-0x7F sao o proprio caractere
+const uint8_t FIM_MENSAGEM = 0x00;
+const uint8_t PREFIXO_MENSAGEM = 0x01;   // + id: imprime essa mensagem antes
+const uint8_t BYTE_LITERAL = 0x02;       // + um byte >= 0x80 (UTF-8)
+const uint8_t PRIMEIRO_PAR = 0x80;       // 0x80-0xFF: par do dicionario
+
+// Aninhamento maximo dos pares (o gerador respeita)
+const uint8_t PROFUNDIDADE_PARES = 12;
+const uint8_t TAMANHO_BLOCO_MENSAGEM = 16;
+const uint16_t MENSAGEM_INEXISTENTE = 0xFFFF;
+
+// FNV-1a de 32 bits, igual ao do gerador
+constexpr uint32_t hashMensagem(const char *texto, uint32_t hash = 2166136261UL) {
+  return *texto ? hashMensagem(texto + 1, (uint32_t)((hash ^ (uint8_t)*texto) * 16777619UL)) : hash;
+}
+
+class Mensagem : public Printable {
+public:
+  explicit Mensagem(uint8_t id) : id(id) {}
+  size_t printTo(Print &p) const;   // definida no catalogo do sketch
+
+private:
+  uint8_t id;
+};
+
+template <uint16_t ID>
+struct IdMensagem {
+  static_assert(ID != MENSAGEM_INEXISTENTE, "mensagem fora do catalogo: rode make -C host catalogo");
+  static const uint8_t VALOR = ID;
+};
+
+// ID_MSG da o id como constante de um byte, para tabelas em PROGMEM
+// (ver cenario.h); o gerador tambem le as macros terminadas em _MSG
+#define ID_MSG(texto) IdMensagem<buscarMensagem(hashMensagem(texto))>::VALOR
+#define MSG(texto) Mensagem(ID_MSG(texto))
+
+// Decodifica a mensagem 'id' das tabelas do catalogo para 'p'
+inline size_t imprimirMensagem(Print &p, uint8_t id, const uint8_t *codigos,
+                               const uint16_t *inicios, const uint8_t *pares) {
+  char bloco[TAMANHO_BLOCO_MENSAGEM];
+  uint8_t usado = 0;
+  size_t total = 0;
+  uint8_t pilha[PROFUNDIDADE_PARES];
+  uint8_t topo = 0;
+  const uint8_t *proximo = codigos + pgm_read_word(&inicios[id]);
+
+  while (true) {
+    uint8_t codigo;
+    if (topo > 0) {
+      codigo = pilha[--topo];
+    } else {
+      codigo = pgm_read_byte(proximo++);
+      if (codigo == FIM_MENSAGEM) {
+        break;
+      }
+      if (codigo == PREFIXO_MENSAGEM) {
+        if (usado > 0) {
+          total += p.write((const uint8_t *)bloco, usado);
+          usado = 0;
+        }
+        total += imprimirMensagem(p, pgm_read_byte(proximo++), codigos, inicios, pares);
+        continue;
+      }
+    }
+    if (codigo == BYTE_LITERAL) {
+      codigo = pgm_read_byte(proximo++);
+    } else {
+      // Desce pelo primeiro elemento de cada par, guardando o segundo
+      while (codigo >= PRIMEIRO_PAR) {
+        const uint8_t *par = pares + 2 * (codigo - PRIMEIRO_PAR);
+        pilha[topo++] = pgm_read_byte(par + 1);
+        codigo = pgm_read_byte(par);
+      }
+    }
+    bloco[usado++] = (char)codigo;
+    if (usado == TAMANHO_BLOCO_MENSAGEM) {
+      total += p.write((const uint8_t *)bloco, usado);
+      usado = 0;
+    }
+  }
+  if (usado > 0) {
+    total += p.write((const uint8_t *)bloco, usado);
+  }
+  return total;
+}
+
+#endif
@@ -0,0 +1,190 @@
+// Gerado por host/gerar_catalogo.py a partir de projeto_1-modificado.cc.
+// Nao edite: rode make -C host catalogo
+//
+// 66 mensagens em 69 usos de MSG(): 1725 bytes de texto, 1632 sem as repetidas.
+// Catalogo: 824 bytes de codigos + 256 de pares + 132 de indice = 1212 bytes (70% do texto).
+// 128 pares no dicionario, 0 mensagens com prefixo de outra, 0 dentro de outra.
+#ifndef CATALOGO_PROJETO_1_MODIFICADO_H
+#define CATALOGO_PROJETO_1_MODIFICADO_H
+
+#include "catalogo.h"
+
+const uint8_t CODIGOS_MENSAGENS[] PROGMEM = {
+  0x20, 0x56, 0x55, 0x4C, 0x4E, 0x45, 0xB1, 0x56, 0x45, 0x4C, 0xA4, 0x53, 0xB8, 0x8E, 0xEA, 0x64,
+  0x8A, 0x89, 0x65, 0x78, 0xFA, 0x73, 0x85, 0x21, 0x00, 0xDA, 0xDB, 0x4D, 0x55, 0x4C, 0x41, 0xDC,
+  0x20, 0xB0, 0x53, 0xDD, 0x49, 0xB1, 0x86, 0x88, 0x54, 0x84, 0x43, 0x4B, 0xDA, 0xDA, 0x20, 0x00,
+  0x46, 0xF5, 0xF6, 0x32, 0x3A, 0xC4, 0xAF, 0x4E, 0x86, 0xFD, 0xD1, 0x84, 0x20, 0xB0, 0x53, 0xDD,
+  0x49, 0xB1, 0x86, 0x00, 0x41, 0xE6, 0xE9, 0x2D, 0x20, 0x8B, 0x76, 0x69, 0x87, 0x30, 0x20, 0xEA,
+  0x8A, 0xC2, 0x62, 0x6F, 0x72, 0x85, 0x72, 0x00, 0x42, 0x75, 0x93, 0x50, 0x69, 0x8A, 0x74, 0x87,
+  0x69, 0xA6, 0xD2, 0x63, 0x65, 0x70, 0x85, 0x6E, 0x81, 0x9C, 0x00, 0x41, 0x84, 0xC6, 0x88, 0x55,
+  0xC0, 0xCF, 0x54, 0x49, 0x43, 0x4F, 0xAC, 0x4D, 0x50, 0x4C, 0x45, 0xC0, 0x9C, 0x00, 0xF4, 0x52,
+  0x49, 0x43, 0x53, 0xC8, 0x44, 0x75, 0x8A, 0xEE, 0xA7, 0x6C, 0x6F, 0x6F, 0x70, 0x28, 0x29, 0x00,
+  0xA8, 0x56, 0xD2, 0x73, 0x61, 0x6F, 0xA4, 0x42, 0x45, 0x84, 0x2D, 0x8D, 0x53, 0xD1, 0x55, 0x52,
+  0x45, 0x00, 0x31, 0xC8, 0x52, 0x65, 0x97, 0x6E, 0x68, 0x65, 0xAA, 0xC3, 0xE9, 0xEA, 0x73, 0xEB,
+  0x76, 0x6F, 0x00, 0xDE, 0xC8, 0x55, 0xF2, 0x64, 0x8E, 0x66, 0x69, 0x6C, 0x8E, 0x64, 0x87, 0x73,
+  0x61, 0x69, 0xBB, 0x00, 0x4C, 0x6F, 0xBE, 0x6C, 0x69, 0x7A, 0xFE, 0x70, 0xB7, 0x6F, 0x93, 0xDE,
+  0x2F, 0x52, 0x58, 0x9C, 0x00, 0x52, 0xD1, 0xFF, 0x48, 0xD1, 0x49, 0x4D, 0x96, 0xC0, 0xDD, 0xF5,
+  0x53, 0x49, 0x56, 0x4F, 0x3A, 0x00, 0xA8, 0x80, 0x3D, 0x20, 0x8D, 0x46, 0x4F, 0xFD, 0x46, 0x49,
+  0x44, 0x96, 0xCE, 0x20, 0x80, 0x3D, 0x00, 0x90, 0x72, 0x65, 0x64, 0x8B, 0xAA, 0x61, 0x69, 0x93,
+  0xBE, 0x70, 0x74, 0x75, 0x8A, 0xBB, 0x73, 0x00, 0x20, 0x42, 0x75, 0x93, 0x50, 0x69, 0x8A, 0x74,
+  0x87, 0x97, 0x6E, 0x65, 0x63, 0x85, 0x81, 0x00, 0x3E, 0x3E, 0x3E, 0xC4, 0xC6, 0x88, 0x42, 0x4F,
+  0x52, 0x84, 0xE7, 0x3C, 0x3C, 0x3C, 0x00, 0x46, 0xF5, 0xF6, 0x31, 0xA4, 0x8D, 0x49, 0xCE, 0x49,
+  0x5A, 0x41, 0xDC, 0xDB, 0xF8, 0x00, 0xE8, 0x6F, 0x6E, 0x69, 0x95, 0x8A, 0x6E, 0xA7, 0xCC, 0x66,
+  0x65, 0x67, 0x6F, 0x9C, 0x00, 0x41, 0x63, 0xB2, 0xF2, 0x95, 0x85, 0x6C, 0x20, 0xFA, 0x73, 0xEB,
+  0x76, 0x65, 0x6C, 0x00, 0xA2, 0x8C, 0x88, 0x98, 0x53, 0x53, 0x4F, 0x5F, 0x4C, 0x49, 0x42, 0x45,
+  0xB1, 0x82, 0x00, 0x44, 0xB3, 0x93, 0xC9, 0x69, 0x91, 0x97, 0x93, 0x65, 0xED, 0x69, 0x81, 0x73,
+  0x21, 0x00, 0x20, 0x44, 0xB3, 0x93, 0xC9, 0x69, 0x91, 0x97, 0x93, 0x65, 0xED, 0x69, 0x81, 0x73,
+  0x00, 0xA8, 0x46, 0x69, 0x72, 0x6D, 0x77, 0x61, 0x72, 0x87, 0x76, 0x31, 0x2E, 0x30, 0x00, 0x43,
+  0x52, 0xAD, 0x96, 0xCE, 0x20, 0x45, 0x58, 0x50, 0x4F, 0x53, 0x84, 0x21, 0x00, 0x55, 0x73, 0xFE,
+  0x73, 0xB8, 0x8E, 0x64, 0xB2, 0x97, 0x62, 0xD2, 0x85, 0x9C, 0x00, 0x43, 0xFF, 0x54, 0x52, 0x4F,
+  0x4C, 0xF6, 0x52, 0x45, 0x4D, 0x4F, 0xC0, 0x3A, 0x00, 0x41, 0x67, 0x75, 0x61, 0x72, 0x64, 0x65,
+  0xA4, 0x73, 0xB6, 0xE0, 0xE1, 0x00, 0xC7, 0xE8, 0x96, 0x55, 0x20, 0x82, 0xC4, 0xAF, 0x4E, 0x86,
+  0x20, 0xC7, 0x00, 0x32, 0xEC, 0xBA, 0x64, 0x87, 0xC9, 0x65, 0x64, 0x8B, 0xAA, 0x61, 0x6C, 0x00,
+  0x20, 0x49, 0xA6, 0xD2, 0x63, 0x65, 0x70, 0x85, 0xEE, 0x61, 0xD0, 0x61, 0x00, 0x45, 0x78, 0x65,
+  0x63, 0x75, 0x85, 0x6E, 0xA7, 0xF1, 0xE1, 0x73, 0x9C, 0x00, 0x41, 0x84, 0xC6, 0x20, 0xBF, 0x90,
+  0x52, 0xAD, 0x96, 0xCE, 0x3A, 0x00, 0x53, 0x49, 0xF8, 0xAC, 0x4D, 0x50, 0x52, 0x4F, 0xF4, 0x49,
+  0x82, 0x00, 0x88, 0x63, 0xB2, 0xF2, 0x95, 0x85, 0x6C, 0x20, 0x6F, 0x62, 0xD6, 0x00, 0x46, 0x69,
+  0x6C, 0x8E, 0xDE, 0xA4, 0x70, 0x69, 0x63, 0x89, 0x00, 0x2F, 0x35, 0xC1, 0x20, 0x62, 0x79, 0x74,
+  0xB2, 0x2C, 0x20, 0x00, 0x41, 0x55, 0xC0, 0xEC, 0xBA, 0xF1, 0x70, 0x6C, 0x65, 0x95, 0x00, 0x30,
+  0xEC, 0x62, 0x6F, 0x72, 0x85, 0x72, 0xC2, 0xE6, 0x95, 0x00, 0x43, 0xCB, 0x66, 0xA5, 0x69, 0x63,
+  0x89, 0x6F, 0x62, 0xD6, 0x00, 0x45, 0x58, 0x54, 0xB1, 0xDC, 0xE8, 0x4F, 0xE7, 0xF0, 0x3A, 0x00,
+  0x43, 0x6F, 0x6D, 0xFE, 0x73, 0x65, 0xC9, 0x65, 0x95, 0x9C, 0x00, 0xC7, 0xC4, 0xC6, 0xFD, 0x43,
+  0x4C, 0x55, 0x49, 0xE7, 0xC7, 0x00, 0xDB, 0xF8, 0xAC, 0x4D, 0x50, 0x52, 0x4F, 0xF4, 0x49, 0x82,
+  0x00, 0x20, 0x6D, 0x93, 0x62, 0x6C, 0x6F, 0xA9, 0x65, 0xB3, 0x00, 0x34, 0xC8, 0x45, 0xED, 0xEE,
+  0x6D, 0x6F, 0xA7, 0xF0, 0x00, 0x43, 0xCB, 0x95, 0x85, 0x6C, 0x20, 0x6F, 0x62, 0xD6, 0x00, 0x44,
+  0xA5, 0xFA, 0xEB, 0xD0, 0x89, 0x97, 0xBD, 0xB3, 0x00, 0xA8, 0xD8, 0xBF, 0x53, 0x4C, 0x49, 0x47,
+  0x41, 0x82, 0x00, 0x90, 0xCB, 0x72, 0x8F, 0x6F, 0xE9, 0x61, 0xD0, 0x6F, 0x00, 0x20, 0xB2, 0x70,
+  0x65, 0x8A, 0x73, 0x2C, 0x20, 0x00, 0x33, 0x99, 0x90, 0xCB, 0x72, 0x8F, 0x6F, 0x95, 0x00, 0xF9,
+  0x49, 0x6F, 0x54, 0x20, 0xE0, 0xE1, 0x9C, 0x00, 0x20, 0x55, 0x41, 0x52, 0x54, 0xC2, 0xD0, 0x6F,
+  0x00, 0x3E, 0x3E, 0x3E, 0xAE, 0xB8, 0x61, 0xA4, 0xFC, 0x00, 0xD5, 0x8C, 0x88, 0x55, 0x54, 0x48,
+  0x3A, 0xFC, 0x00, 0xF9, 0xF1, 0x70, 0xAB, 0x6D, 0x65, 0xD6, 0x21, 0x00, 0x4E, 0xB8, 0x75, 0x6D,
+  0xC2, 0xE6, 0x95, 0x00, 0xAE, 0xB6, 0x6F, 0x6E, 0x6C, 0xB7, 0x65, 0x00, 0xA8, 0xD8, 0x4C, 0x49,
+  0x47, 0x41, 0x82, 0x00, 0xA8, 0x53, 0xB8, 0x61, 0xA4, 0xFC, 0x00, 0xD5, 0x92, 0xD8, 0x4F, 0x46,
+  0x46, 0x00, 0xA8, 0xF9, 0xE0, 0xB3, 0x00, 0xD5, 0x92, 0xD8, 0xFF, 0x00, 0xD9, 0xD9, 0x83, 0x00,
+  0xD9, 0xA3, 0x83, 0x00, 0xD5, 0x92, 0xF0, 0x00,
+};
+
+// Dois codigos por par, a partir de PRIMEIRO_PAR
+const uint8_t PARES_MENSAGENS[] PROGMEM = {
+  0x3D, 0x3D, 0x64, 0x6F, 0x44, 0x4F, 0x80, 0x80, 0x54, 0x41, 0x74, 0x61, 0x54, 0x45, 0x65, 0x20,
+  0x20, 0x41, 0x6F, 0x20, 0x72, 0x61, 0x65, 0x6E, 0x82, 0x5D, 0x49, 0x4E, 0x61, 0x20, 0x65, 0x6D,
+  0x20, 0x43, 0x74, 0x69, 0x8C, 0x20, 0x73, 0x20, 0x61, 0x6E, 0x74, 0x6F, 0x45, 0x4E, 0x63, 0x6F,
+  0x43, 0x45, 0x20, 0x2D, 0x49, 0x41, 0x2E, 0x2E, 0x9B, 0x2E, 0x5B, 0x8D, 0x9D, 0x86, 0x9E, 0x52,
+  0x9F, 0x98, 0xA0, 0x50, 0xA1, 0x84, 0x83, 0x83, 0x3A, 0x20, 0x69, 0x73, 0x6E, 0x74, 0x81, 0x20,
+  0xA2, 0x92, 0x71, 0x75, 0x63, 0x69, 0x72, 0x6F, 0x90, 0x4F, 0x45, 0x44, 0x20, 0x53, 0x43, 0x41,
+  0x42, 0x55, 0x52, 0x41, 0x65, 0x73, 0x61, 0x81, 0xA5, 0x74, 0xB4, 0x8F, 0xB5, 0x8E, 0x69, 0x6E,
+  0x8B, 0x68, 0x85, 0xA9, 0xB9, 0x87, 0x64, 0x61, 0xA6, 0xAB, 0xBC, 0x6C, 0x63, 0x61, 0x44, 0x45,
+  0x54, 0x4F, 0x31, 0x32, 0x20, 0x61, 0x6D, 0x8B, 0x88, 0x84, 0x51, 0x55, 0xC5, 0x45, 0x83, 0x3D,
+  0x99, 0x20, 0x63, 0x72, 0x6F, 0xBD, 0xCA, 0x87, 0x74, 0x8A, 0x43, 0x9A, 0xCD, 0x4C, 0x4D, 0x41,
+  0x91, 0x76, 0x45, 0x43, 0x65, 0x72, 0x5B, 0x96, 0xD3, 0x56, 0xD4, 0x9A, 0x91, 0x81, 0x4C, 0xAD,
+  0xD7, 0x5F, 0xA3, 0xA3, 0x20, 0x20, 0xAE, 0x49, 0xAF, 0x4F, 0x20, 0x50, 0x54, 0x58, 0xB7, 0x69,
+  0xDF, 0xAA, 0x94, 0x81, 0xBA, 0x8F, 0xE2, 0x20, 0xE3, 0x94, 0xE4, 0xBB, 0xE5, 0xC3, 0x82, 0x20,
+  0x20, 0x4D, 0x74, 0x89, 0x70, 0x61, 0x73, 0x69, 0x99, 0x88, 0x78, 0xCC, 0xBE, 0x89, 0xBF, 0xB0,
+  0xEF, 0x47, 0x97, 0x6D, 0x73, 0x89, 0x4D, 0x45, 0xF3, 0x54, 0x41, 0x53, 0x45, 0x20, 0x53, 0x86,
+  0xF7, 0xCF, 0x53, 0xB6, 0x70, 0x6F, 0xC1, 0x33, 0xFB, 0x34, 0xAC, 0x4E, 0x94, 0xA7, 0x4F, 0x4E,
+};
+
+const uint16_t INICIOS_MENSAGENS[] PROGMEM = {
+  812,   // 0: "===================================="
+  25,   // 1: "   SIMULACAO BUS PIRATE ATTACK     "
+  542,   // 2: "Fila TX: pico "
+  553,   // 3: "/512 bytes, "
+  701,   // 4: " esperas, "
+  641,   // 5: " ms bloqueado"
+  441,   // 6: "Aguarde: sistema iniciando"
+  764,   // 7: "Nenhum ataque em andamento"
+  280,   // 8: ">>> ATAQUE ABORTADO <<<"
+  454,   // 9: "===== MENU DO ATACANTE ====="
+  162,   // 10: "1 - Reconhecimento passivo"
+  467,   // 11: "2 - Ataque de credencial"
+  710,   // 12: "3 - Controle remoto"
+  651,   // 13: "4 - Extracao modo DEBUG"
+  564,   // 14: "AUTO - Ataque completo"
+  575,   // 15: "0 - Abortar ataque em andamento"
+  179,   // 16: "TX - Uso da fila de saida"
+  126,   // 17: "METRICS - Duracao do loop()"
+  816,   // 18: "============================"
+  295,   // 19: "FASE 1: INICIALIZACAO SISTEMA"
+  719,   // 20: "Sistema IoT iniciando..."
+  772,   // 21: " Sistema online"
+  728,   // 22: " UART ativo"
+  0,   // 23: " VULNERAVEL: Senha padrao exposta!"
+  737,   // 24: ">>> Senha: 1234"
+  48,   // 25: "FASE 2: ATACANTE CONECTA BUS PIRATE"
+  196,   // 26: "Localizando pinos TX/RX..."
+  264,   // 27: " Bus Pirate conectado"
+  480,   // 28: " Interceptacao ativa"
+  310,   // 29: " Monitorando trafego..."
+  213,   // 30: "RECONHECIMENTO PASSIVO:"
+  88,   // 31: "Bus Pirate interceptando..."
+  802,   // 32: "[INTERCEPTADO] Sistema iniciado"
+  385,   // 33: "[INTERCEPTADO] Firmware v1.0"
+  788,   // 34: "[INTERCEPTADO] Senha: 1234"
+  399,   // 35: "CREDENCIAL EXPOSTA!"
+  325,   // 36: "Acesso total possivel"
+  506,   // 37: "ATAQUE DE CREDENCIAL:"
+  413,   // 38: "Usando senha descoberta..."
+  746,   // 39: "[ENVIADO] AUTH:1234"
+  340,   // 40: "[INTERCEPTADO] ACESSO_LIBERADO"
+  755,   // 41: "Sistema comprometido!"
+  661,   // 42: "Controle total obtido"
+  427,   // 43: "CONTROLE REMOTO:"
+  493,   // 44: "Executando comandos..."
+  807,   // 45: "[ENVIADO] LED_ON"
+  780,   // 46: "[INTERCEPTADO] LED_LIGADO"
+  671,   // 47: "Dispositivo controlado"
+  795,   // 48: "[ENVIADO] LED_OFF"
+  681,   // 49: "[INTERCEPTADO] LED_DESLIGADO"
+  586,   // 50: "Controle fisico obtido"
+  597,   // 51: "EXTRACAO MODO DEBUG:"
+  608,   // 52: "Comando secreto..."
+  820,   // 53: "[ENVIADO] DEBUG"
+  230,   // 54: "[INTERCEPTADO] === INFO CONFIDENCIAL ==="
+  144,   // 55: "[INTERCEPTADO] Versao: BETA-INSECURE"
+  355,   // 56: "Dados criticos extraidos!"
+  518,   // 57: "SISTEMA COMPROMETIDO"
+  107,   // 58: "ATAQUE AUTOMATICO COMPLETO..."
+  619,   // 59: "===== ATAQUE CONCLUIDO ====="
+  247,   // 60: " Credenciais capturadas"
+  530,   // 61: " Acesso total obtido"
+  691,   // 62: " Controle remoto ativo"
+  370,   // 63: " Dados criticos extraidos"
+  630,   // 64: " SISTEMA COMPROMETIDO"
+  68,   // 65: "Ataque em andamento - envie 0 para abortar"
+};
+
+// Usadas so na compilacao, por MSG(): hash do texto -> id
+constexpr uint32_t HASHES_MENSAGENS[] = {
+  0x03F0CB5DUL, 0x06326BAAUL, 0x0AC397B8UL, 0x0FAA2D71UL, 0x10473D73UL, 0x127A7607UL,
+  0x13A8F9C8UL, 0x14200650UL, 0x1B7A93C3UL, 0x1BD296ECUL, 0x1D1A8C55UL, 0x1F55F801UL,
+  0x282FBE3BUL, 0x29AE9387UL, 0x36088306UL, 0x3D245492UL, 0x44559217UL, 0x44FB08B7UL,
+  0x46459509UL, 0x4799725AUL, 0x4970763EUL, 0x4AD18505UL, 0x56B92FD0UL, 0x61BD8CE3UL,
+  0x6466464DUL, 0x654254AAUL, 0x692FD009UL, 0x6CC37492UL, 0x7B74908BUL, 0x7C165F66UL,
+  0x7CDCBBD2UL, 0x7FFF9716UL, 0x8145591EUL, 0x8827329CUL, 0x882C45F0UL, 0x954AF327UL,
+  0x983B2C99UL, 0x9C846EBAUL, 0x9D62F484UL, 0xA035EC0FUL, 0xA0FD9A20UL, 0xA134BCB2UL,
+  0xA460DE61UL, 0xAC8568B5UL, 0xB0F41723UL, 0xB5F95D82UL, 0xB62DD765UL, 0xB8B942D5UL,
+  0xBA8788FAUL, 0xC690F225UL, 0xC7FEBEABUL, 0xCAA4F6EBUL, 0xCC30E271UL, 0xCFA78AD7UL,
+  0xD1C43DE3UL, 0xD7665000UL, 0xD88B0570UL, 0xD9739AF7UL, 0xD989DC5EUL, 0xE345A54AUL,
+  0xE3E1D416UL, 0xE9A4C99EUL, 0xEAB84B10UL, 0xF0882DEEUL, 0xFA9F76A4UL, 0xFEE5CB16UL,
+};
+constexpr uint8_t IDS_MENSAGENS[] = {
+  0x0C, 0x30, 0x29, 0x00, 0x14, 0x1E, 0x0B, 0x07, 0x2B, 0x26, 0x3A, 0x2C, 0x13, 0x40, 0x35, 0x3E,
+  0x10, 0x0D, 0x05, 0x01, 0x04, 0x21, 0x11, 0x32, 0x31, 0x37, 0x39, 0x33, 0x0E, 0x1C, 0x06, 0x17,
+  0x02, 0x16, 0x15, 0x25, 0x12, 0x1B, 0x1F, 0x1D, 0x41, 0x3B, 0x27, 0x19, 0x3C, 0x08, 0x34, 0x03,
+  0x38, 0x0F, 0x20, 0x0A, 0x3F, 0x2F, 0x1A, 0x23, 0x28, 0x2E, 0x24, 0x2A, 0x18, 0x09, 0x2D, 0x22,
+  0x36, 0x3D,
+};
+const uint16_t TOTAL_MENSAGENS = 66;
+
+constexpr uint16_t buscarMensagem(uint32_t hash, uint16_t inicio = 0, uint16_t fim = TOTAL_MENSAGENS) {
+  return inicio >= fim ? MENSAGEM_INEXISTENTE
+       : HASHES_MENSAGENS[(inicio + fim) / 2] == hash ? IDS_MENSAGENS[(inicio + fim) / 2]
+       : HASHES_MENSAGENS[(inicio + fim) / 2] < hash ? buscarMensagem(hash, (inicio + fim) / 2 + 1, fim)
+       : buscarMensagem(hash, inicio, (inicio + fim) / 2);
+}
+
+inline size_t Mensagem::printTo(Print &p) const {
+  return imprimirMensagem(p, id, CODIGOS_MENSAGENS, INICIOS_MENSAGENS, PARES_MENSAGENS);
+}
+
+#endif
@@ -0,0 +1,311 @@
+// Gerado por host/gerar_catalogo.py a partir de projeto_2-timing_attack-corrigido.cc.
+// Nao edite: rode make -C host catalogo
+//
+// 130 mensagens em 162 usos de MSG(): 3456 bytes de texto, 2873 sem as repetidas.
+// Catalogo: 1492 bytes de codigos + 256 de pares + 260 de indice = 2008 bytes (58% do texto).
+// 128 pares no dicionario, 3 mensagens com prefixo de outra, 8 dentro de outra.
+#ifndef CATALOGO_PROJETO_2_TIMING_ATTACK_CORRIGIDO_H
+#define CATALOGO_PROJETO_2_TIMING_ATTACK_CORRIGIDO_H
+
+#include "catalogo.h"
+
+const uint8_t CODIGOS_MENSAGENS[] PROGMEM = {
+  0x43, 0x6F, 0xAE, 0x6E, 0x64, 0x6F, 0x9D, 0x64, 0x83, 0x73, 0xF0, 0xA1, 0x82, 0x4D, 0x45, 0x54,
+  0x52, 0x49, 0x43, 0x53, 0x98, 0x4D, 0x45, 0x54, 0x52, 0x49, 0x43, 0x53, 0x3A, 0x5A, 0xB5, 0x52,
+  0x98, 0x50, 0xDC, 0x46, 0x49, 0x4C, 0x98, 0x50, 0xDC, 0x46, 0x49, 0x4C, 0x3A, 0x5A, 0xB5, 0x52,
+  0x00, 0x44, 0x65, 0x70, 0x6F, 0x94, 0x20, 0x8F, 0x90, 0xF8, 0xAA, 0xEC, 0x3E, 0x82, 0x55, 0x53,
+  0x55, 0x41, 0x52, 0x49, 0x4F, 0xF7, 0xAA, 0x70, 0x8C, 0x3E, 0x98, 0x52, 0x45, 0x91, 0x56, 0xDC,
+  0xF7, 0x98, 0x54, 0x92, 0x56, 0x41, 0x52, 0xF7, 0x2C, 0x00, 0xB3, 0x42, 0xB5, 0x52, 0xF7, 0x98,
+  0xB3, 0x9F, 0x41, 0x52, 0x98, 0xBA, 0x52, 0x47, 0x41, 0x98, 0x92, 0x9F, 0xE8, 0x3B, 0x20, 0x53,
+  0x41, 0x49, 0x52, 0x20, 0x89, 0x63, 0xB9, 0x83, 0x83, 0x73, 0x84, 0x73, 0x61, 0x6F, 0x00, 0x43,
+  0x87, 0x67, 0x83, 0x8F, 0xC0, 0xB4, 0x82, 0x3C, 0xDD, 0xAA, 0x70, 0x8C, 0xB6, 0x70, 0xAD, 0x20,
+  0x6C, 0x8C, 0x68, 0x61, 0x98, 0x46, 0x49, 0x4D, 0x20, 0x6E, 0x81, 0x66, 0x8C, 0xA1, 0x00, 0x8D,
+  0x41, 0x8B, 0xA3, 0x6E, 0x74, 0x88, 0x70, 0x6F, 0x8F, 0x64, 0x84, 0x96, 0x62, 0x72, 0x69, 0x72,
+  0x20, 0xBC, 0x83, 0x64, 0xCE, 0x81, 0x70, 0xAD, 0x20, 0x64, 0xCE, 0x6F, 0x00, 0x8D, 0x54, 0x69,
+  0xC1, 0x76, 0x87, 0x69, 0x83, 0x96, 0x6D, 0x20, 0x6E, 0x75, 0x6D, 0x8A, 0x81, 0x8F, 0x63, 0x87,
+  0x61, 0x63, 0x74, 0x8A, 0x84, 0x20, 0xFE, 0x74, 0xB4, 0x00, 0xAB, 0x8D, 0x41, 0x6C, 0x74, 0x8A,
+  0x6E, 0xE9, 0x6D, 0xC9, 0x28, 0x56, 0x75, 0x6C, 0x6E, 0x8A, 0x61, 0x76, 0xEA, 0x2F, 0x53, 0x65,
+  0x67, 0x75, 0x72, 0x6F, 0x29, 0x00, 0x53, 0xCB, 0x83, 0x70, 0x87, 0x83, 0x6E, 0x81, 0x70, 0x72,
+  0x69, 0x6D, 0x65, 0x69, 0x72, 0x81, 0xB9, 0x81, 0x8D, 0x93, 0xC1, 0x76, 0x87, 0x69, 0x61, 0x76,
+  0xEA, 0x00, 0x53, 0xCB, 0x83, 0x73, 0x9A, 0x70, 0x72, 0x88, 0x76, 0xF0, 0xFD, 0x63, 0x83, 0xFC,
+  0x64, 0x83, 0xBC, 0x83, 0x8D, 0x93, 0xC1, 0x96, 0x6E, 0x73, 0xB2, 0x74, 0x65, 0x00, 0xE2, 0x42,
+  0x4C, 0x4F, 0x51, 0x55, 0x45, 0x90, 0x86, 0x50, 0x4F, 0x52, 0x20, 0xFF, 0x55, 0x92, 0x4E, 0xBA,
+  0x21, 0x20, 0x45, 0x73, 0x70, 0x8A, 0x83, 0x8F, 0x00, 0x53, 0xCB, 0x83, 0x72, 0x84, 0x65, 0x8B,
+  0x95, 0x8D, 0x50, 0x72, 0xCC, 0x74, 0x81, 0x70, 0x87, 0x83, 0x6E, 0x6F, 0x76, 0x83, 0x61, 0x6E,
+  0xA1, 0x94, 0x65, 0x00, 0x53, 0x9A, 0x20, 0x74, 0xF6, 0xC2, 0x61, 0x67, 0xAD, 0x61, 0x82, 0x61,
+  0x67, 0x9C, 0x8F, 0x88, 0x64, 0xCE, 0x88, 0x8F, 0x6E, 0x6F, 0x76, 0x6F, 0x00, 0x49, 0x6E, 0xFB,
+  0x6D, 0x88, 0x81, 0xA9, 0x20, 0x95, 0xC0, 0x6F, 0x98, 0x65, 0x78, 0x2E, 0x82, 0x52, 0x45, 0x91,
+  0x56, 0xDC, 0x3A, 0x34, 0x32, 0x00, 0x43, 0x6F, 0xAE, 0x6E, 0x95, 0x8F, 0x8E, 0xA0, 0xA2, 0xCD,
+  0xA3, 0xA4, 0xAE, 0x6E, 0x8F, 0x61, 0x6E, 0xC3, 0x20, 0x90, 0xF8, 0xAA, 0xEC, 0x3E, 0x00, 0x54,
+  0x69, 0xC1, 0x73, 0x8A, 0x83, 0x65, 0x78, 0x69, 0x62, 0x69, 0x95, 0x6E, 0x81, 0x53, 0xF0, 0xA1,
+  0x20, 0x4D, 0xCC, 0x69, 0x74, 0xAD, 0x00, 0x8D, 0x43, 0x8E, 0x83, 0x74, 0xF6, 0x83, 0xAF, 0x76,
+  0xEA, 0x83, 0x8C, 0xFB, 0xAE, 0xEB, 0x8E, 0x69, 0x63, 0x69, 0xCC, 0xA1, 0x00, 0x45, 0x78, 0x65,
+  0x63, 0x75, 0xB2, 0x95, 0xC3, 0xC3, 0x20, 0x61, 0x75, 0xFC, 0xAE, 0x93, 0x96, 0x73, 0x2E, 0x2E,
+  0x2E, 0x00, 0x42, 0xCA, 0x41, 0xBB, 0x87, 0x2F, 0x44, 0x84, 0x61, 0xBB, 0xE9, 0x61, 0x6E, 0xA1,
+  0x94, 0x88, 0x8F, 0x93, 0xAC, 0x00, 0x0A, 0x85, 0x80, 0x20, 0x49, 0x4E, 0x46, 0x4F, 0x52, 0x4D,
+  0xC7, 0x4F, 0xC8, 0x20, 0x44, 0x86, 0xE2, 0x85, 0x80, 0x00, 0x2D, 0x2D, 0x8D, 0xF4, 0x20, 0x44,
+  0xAB, 0xEF, 0x42, 0x49, 0xB3, 0x44, 0x90, 0x45, 0x20, 0x2D, 0x2D, 0x2D, 0x00, 0x53, 0xCB, 0x83,
+  0x73, 0x65, 0x67, 0x75, 0x72, 0x81, 0x8D, 0x93, 0xC1, 0x96, 0x6E, 0x73, 0xB2, 0x74, 0x65, 0x00,
+  0x8D, 0x54, 0x9A, 0x70, 0x81, 0x6E, 0x61, 0x81, 0x76, 0x87, 0x69, 0x83, 0x96, 0x6D, 0x20, 0x89,
+  0xFA, 0xDB, 0x00, 0x44, 0xCA, 0x4D, 0xC9, 0x64, 0x9A, 0xCC, 0x73, 0x74, 0xCD, 0xEB, 0x61, 0x75,
+  0xFC, 0xAE, 0x93, 0xA3, 0x00, 0x20, 0x67, 0xCD, 0x76, 0x61, 0x96, 0x84, 0x98, 0xAF, 0x63, 0x75,
+  0x70, 0x8A, 0x8E, 0x81, 0x9A, 0x20, 0x00, 0x43, 0x87, 0x61, 0x63, 0x74, 0x8A, 0x84, 0x20, 0xFE,
+  0xFC, 0x9D, 0x84, 0x93, 0x6D, 0x8E, 0xB4, 0x82, 0x00, 0x43, 0xCA, 0x4D, 0xB4, 0xFA, 0xE9, 0x8C,
+  0xFB, 0xAE, 0x96, 0x84, 0x20, 0x95, 0x73, 0xCB, 0x61, 0x00, 0xBF, 0xC2, 0xB9, 0x8E, 0xC2, 0x64,
+  0x84, 0x8F, 0x83, 0x8C, 0x73, 0x8B, 0x6C, 0x61, 0xA3, 0xA4, 0x00, 0x8D, 0x52, 0x84, 0xA2, 0x89,
+  0x74, 0x88, 0x83, 0x93, 0xC1, 0x61, 0x74, 0x8B, 0x63, 0x6B, 0x73, 0x00, 0xE2, 0x9B, 0xC5, 0xE7,
+  0x8D, 0x99, 0xF8, 0x47, 0x20, 0x41, 0x54, 0x54, 0xC7, 0x4B, 0x53, 0x00, 0xEF, 0x42, 0x49, 0xB3,
+  0x44, 0x90, 0x45, 0xC5, 0x54, 0x45, 0x43, 0x54, 0x90, 0x41, 0x3A, 0x00, 0x0A, 0x80, 0x3D, 0xC5,
+  0xE7, 0x41, 0x55, 0x54, 0x4F, 0x4D, 0xA8, 0x43, 0xAB, 0x80, 0x3D, 0x00, 0x53, 0x84, 0x73, 0x61,
+  0x81, 0x8F, 0x8E, 0xA0, 0xA2, 0xCD, 0xEB, 0x61, 0x62, 0x8A, 0x8B, 0x00, 0x53, 0x84, 0x73, 0x61,
+  0x81, 0x8F, 0x8E, 0xA0, 0xA2, 0xCD, 0xEB, 0x89, 0x63, 0xB9, 0xDB, 0x00, 0x55, 0x73, 0xA4, 0x55,
+  0x53, 0x55, 0x41, 0x52, 0x49, 0x4F, 0xF7, 0xAA, 0x70, 0x8C, 0x3E, 0x00, 0x42, 0x6C, 0x6F, 0x71,
+  0x75, 0x65, 0x8E, 0x81, 0x70, 0xAD, 0x20, 0xAE, 0x94, 0x20, 0x00, 0x0A, 0x2D, 0x2D, 0x8D, 0xF4,
+  0xC5, 0x20, 0x99, 0xF8, 0x47, 0x20, 0x2D, 0x2D, 0x2D, 0x00, 0x8D, 0x4E, 0x97, 0x75, 0x6D, 0x83,
+  0x8C, 0xFB, 0xAE, 0xEB, 0x76, 0x61, 0x7A, 0xDB, 0x00, 0x80, 0x3D, 0xC5, 0xE7, 0x43, 0xF9, 0x43,
+  0x4C, 0x55, 0x49, 0x44, 0xAB, 0x80, 0x3D, 0x00, 0x52, 0x84, 0x70, 0xB4, 0x8B, 0x9D, 0x96, 0x6E,
+  0x66, 0x8A, 0xA9, 0x61, 0x73, 0x82, 0x00, 0x54, 0x61, 0x62, 0xEA, 0x83, 0x8F, 0xC0, 0x6F, 0x9D,
+  0x63, 0x68, 0x65, 0x69, 0x61, 0x00, 0x42, 0x6C, 0x6F, 0x71, 0x75, 0x65, 0x69, 0x81, 0x89, 0x63,
+  0xB9, 0x8E, 0x6F, 0x00, 0xBF, 0x61, 0x82, 0x28, 0x23, 0x20, 0x70, 0x2F, 0x20, 0x4F, 0x4B, 0x29,
+  0x00, 0x50, 0xAF, 0xFD, 0x78, 0x81, 0x64, 0x84, 0x96, 0x62, 0x8A, 0x74, 0xA4, 0x00, 0xED, 0xB9,
+  0xDB, 0x2E, 0x20, 0x54, 0xF6, 0xC2, 0x72, 0xDA, 0xC3, 0x82, 0x00, 0x2A, 0xCA, 0x52, 0x84, 0x65,
+  0x74, 0x20, 0x95, 0x73, 0xCB, 0x61, 0x00, 0x4D, 0xC9, 0x8F, 0x73, 0x65, 0x67, 0x75, 0xCD, 0x6E,
+  0xA3, 0x82, 0x00, 0x45, 0x45, 0x50, 0xE8, 0x4D, 0x82, 0xAF, 0x67, 0xA2, 0x72, 0x81, 0x00, 0x46,
+  0x69, 0x6C, 0x83, 0x54, 0x58, 0x82, 0x70, 0x69, 0x63, 0x81, 0x00, 0x20, 0x6D, 0x9D, 0x62, 0x6C,
+  0x6F, 0x71, 0x75, 0x65, 0x8E, 0x6F, 0x00, 0x56, 0xF0, 0xFD, 0xA3, 0x6E, 0x64, 0x6F, 0x2E, 0x2E,
+  0x2E, 0x20, 0x00, 0x01, 0x54, 0x21, 0x20, 0x54, 0xF6, 0xC2, 0x72, 0xDA, 0xC3, 0x82, 0x00, 0xB9,
+  0xA4, 0x8B, 0x62, 0xEA, 0x83, 0x63, 0x68, 0x65, 0x69, 0x61, 0x00, 0x98, 0x66, 0xA1, 0x68, 0xC2,
+  0x73, 0x9A, 0x20, 0xC0, 0xA4, 0x00, 0x54, 0x9A, 0x70, 0x81, 0x64, 0x65, 0xEE, 0x72, 0xA9, 0xA4,
+  0x00, 0xC7, 0xC8, 0x53, 0x86, 0x50, 0xDC, 0xC6, 0x99, 0x44, 0x4F, 0x00, 0xA5, 0x4D, 0x20, 0x54,
+  0x45, 0x4E, 0x54, 0xB1, 0x41, 0x53, 0x00, 0x54, 0xDA, 0x95, 0x6D, 0xC9, 0xEF, 0x56, 0x45, 0x4C,
+  0x3A, 0x00, 0x20, 0x6E, 0x61, 0x81, 0x63, 0xDB, 0x73, 0xFA, 0x8E, 0x6F, 0x00, 0x20, 0xC0, 0x6F,
+  0x9D, 0x63, 0x87, 0xAF, 0x67, 0x8E, 0xB4, 0x00, 0x23, 0xCA, 0x43, 0xCC, 0xFD, 0x72, 0x6D, 0xE9,
+  0xEC, 0x00, 0x41, 0x6E, 0xA1, 0x94, 0x88, 0x8F, 0x93, 0xAC, 0x82, 0x00, 0x2F, 0x32, 0x35, 0x36,
+  0x20, 0x62, 0x79, 0xC3, 0x98, 0x00, 0x55, 0xA7, 0xA4, 0x28, 0x23, 0x20, 0x4F, 0x4B, 0x29, 0x00,
+  0xC7, 0xC8, 0x53, 0x86, 0x4E, 0x45, 0x47, 0x90, 0x4F, 0x00, 0x54, 0xDA, 0x95, 0x6D, 0xC9, 0xFF,
+  0x55, 0xE8, 0x3A, 0x00, 0x30, 0x2D, 0x39, 0xCA, 0x44, 0xCE, 0xE9, 0xEC, 0x00, 0x54, 0x69, 0xC1,
+  0x6E, 0x81, 0x73, 0xF0, 0xA1, 0x00, 0x41, 0x67, 0x9C, 0x64, 0x65, 0x2E, 0x2E, 0x2E, 0x00, 0x43,
+  0xCC, 0x63, 0x6C, 0x75, 0xA9, 0x6F, 0x21, 0x00, 0x42, 0x9A, 0x2D, 0x76, 0x8C, 0x64, 0x6F, 0x21,
+  0x00, 0xE2, 0x42, 0x4C, 0x4F, 0x51, 0x55, 0x90, 0x4F, 0x00, 0x43, 0xF9, 0x54, 0xE8, 0x4C, 0xC8,
+  0x3A, 0x00, 0x4D, 0xC9, 0x61, 0x74, 0x75, 0xA1, 0x82, 0x00, 0xD5, 0xEF, 0x56, 0x45, 0x4C, 0x20,
+  0xD9, 0x00, 0x20, 0x84, 0x70, 0x8A, 0x61, 0x73, 0x98, 0x00, 0xB7, 0x9B, 0x4D, 0x86, 0x4F, 0x46,
+  0x46, 0x00, 0xED, 0x64, 0xBE, 0x8B, 0x64, 0x61, 0x82, 0x00, 0x20, 0x63, 0xDB, 0x73, 0xFA, 0x8E,
+  0x6F, 0x00, 0x44, 0xCE, 0x88, 0xC0, 0x6F, 0x3A, 0x00, 0xD5, 0xFF, 0x55, 0x52, 0x86, 0xD9, 0x00,
+  0xED, 0x61, 0x74, 0x75, 0xA1, 0x82, 0x00, 0xD5, 0x9B, 0xE7, 0x9B, 0x53, 0xD9, 0x00, 0xC4, 0xC4,
+  0xC4, 0xC4, 0x85, 0x00, 0x44, 0xCE, 0x88, 0xEC, 0x3A, 0x00, 0xD5, 0xF4, 0xC5, 0x53, 0xD9, 0x00,
+  0xB7, 0x9B, 0x4D, 0x86, 0xF9, 0x00, 0x54, 0x89, 0x74, 0x2E, 0x82, 0x00, 0x30, 0x30, 0x30, 0x30,
+  0x23, 0x00, 0x31, 0x30, 0x30, 0x30, 0x23, 0x00, 0x31, 0x32, 0x30, 0x30, 0x23, 0x00, 0x31, 0x32,
+  0x33, 0x30, 0x23, 0x00, 0x31, 0x32, 0x33, 0x34, 0x23, 0x00, 0x35, 0x35, 0x35, 0x35, 0x23, 0x00,
+  0x39, 0x39, 0x39, 0x39, 0x23, 0x00, 0xED, 0xFE, 0x8B, 0x82, 0x00, 0xEF, 0x56, 0x45, 0x4C, 0x00,
+  0xD5, 0xF4, 0x20, 0xD9, 0x00, 0x9B, 0x53, 0xB8, 0x41, 0x00, 0x55, 0xA7, 0xB4, 0x82, 0x00, 0xC4,
+  0xC4, 0x85, 0x3D, 0x00, 0xD5, 0x9B, 0xE7, 0xD9, 0x00, 0x4D, 0x6F, 0x64, 0xA4, 0x00, 0x41, 0x67,
+  0x9C, 0x8F, 0x00, 0x54, 0xDA, 0x64, 0xA4, 0x00, 0x20, 0xC0, 0xB4, 0x3A, 0x00, 0xFF, 0x55, 0xE8,
+  0x00, 0xB0, 0x4F, 0x82, 0x00, 0x20, 0x75, 0x73, 0x00, 0x01, 0x0A, 0x20, 0x00, 0x01, 0x51, 0x21,
+  0x00, 0x20, 0x2D, 0xB6, 0x00, 0x55, 0xA7, 0x81, 0x00, 0x82, 0x6F, 0x6B, 0x00, 0xF4, 0x82, 0x00,
+  0x20, 0x8F, 0x00, 0x20, 0x73, 0x00, 0x3A, 0x30, 0x00, 0xB9, 0xA4, 0x00, 0xE2, 0x00, 0xD1, 0x00,
+  0x2F, 0x00, 0x2A, 0x00,
+};
+
+// Dois codigos por par, a partir de PRIMEIRO_PAR
+const uint8_t PARES_MENSAGENS[] PROGMEM = {
+  0x3D, 0x3D, 0x6F, 0x20, 0x3A, 0x20, 0x61, 0x20, 0x65, 0x73, 0x80, 0x80, 0x4F, 0x20, 0x61, 0x72,
+  0x65, 0x20, 0x65, 0x6E, 0x65, 0x72, 0x74, 0x61, 0x69, 0x6E, 0x2D, 0x20, 0x61, 0x64, 0x64, 0x88,
+  0x41, 0x44, 0x4D, 0x4F, 0x52, 0x41, 0x74, 0x69, 0x69, 0x73, 0x64, 0x81, 0x63, 0x6F, 0x89, 0x68,
+  0x2C, 0x20, 0x54, 0x49, 0x65, 0x6D, 0x44, 0x45, 0x75, 0x87, 0x73, 0x20, 0x85, 0x85, 0x53, 0x54,
+  0x6D, 0x8C, 0x61, 0x6C, 0x94, 0x74, 0x63, 0x61, 0x6F, 0x82, 0x53, 0x45, 0x73, 0x9C, 0xA6, 0x69,
+  0x41, 0x99, 0x69, 0x64, 0x3A, 0x3C, 0x41, 0x20, 0xA0, 0x67, 0x6F, 0x72, 0x6D, 0x61, 0x72, 0x65,
+  0x91, 0x44, 0xA8, 0x56, 0x8B, 0x6E, 0x4C, 0x49, 0x6F, 0x73, 0x45, 0x92, 0x3E, 0x20, 0xB0, 0x86,
+  0xB1, 0x90, 0x8A, 0x72, 0x43, 0x41, 0x93, 0x76, 0x73, 0x97, 0x69, 0x67, 0xBD, 0x69, 0x53, 0x97,
+  0x75, 0xA7, 0xAC, 0x20, 0x61, 0x9D, 0x74, 0x84, 0x9E, 0x9E, 0x20, 0x9B, 0x4D, 0x49, 0x41, 0x43,
+  0x45, 0x53, 0x6F, 0x95, 0x20, 0x8D, 0xA2, 0x9A, 0x6F, 0x6E, 0x72, 0x61, 0xBE, 0x74, 0x56, 0x55,
+  0xCF, 0x4C, 0xD0, 0x4E, 0x0A, 0x3E, 0xD2, 0x3E, 0xD3, 0xB6, 0xD4, 0xB7, 0xB8, 0x86, 0xD6, 0x3C,
+  0xD7, 0x3C, 0xD8, 0x3C, 0x84, 0xB2, 0x8E, 0x61, 0x45, 0x52, 0xA9, 0x3E, 0x53, 0x49, 0xDE, 0x9F,
+  0xDF, 0x45, 0xE0, 0x4D, 0xE1, 0xAB, 0x91, 0x4E, 0xE3, 0x9F, 0xE4, 0x92, 0xE5, 0xBA, 0xE6, 0x86,
+  0x52, 0x4F, 0x87, 0x20, 0x65, 0x6C, 0xA3, 0x81, 0xBC, 0x61, 0xBF, 0x83, 0x96, 0x72, 0xD1, 0xB5,
+  0x8A, 0x69, 0x41, 0x4E, 0xF1, 0x41, 0xF2, 0xB3, 0xF3, 0xA5, 0x89, 0x8B, 0xF5, 0xBB, 0xAA, 0xDD,
+  0xC6, 0x4E, 0x4F, 0x4E, 0x74, 0x72, 0x66, 0xAD, 0x74, 0x6F, 0x66, 0x69, 0xEE, 0xAF, 0xA5, 0x47,
+};
+
+const uint16_t INICIOS_MENSAGENS[] PROGMEM = {
+  1310,   // 0: "===================================================================="
+  700,   // 1: "SISTEMA DE DEMONSTRACAO - TIMING ATTACKS"
+  1226,   // 2: "CONTROLES:"
+  218,   // 3: "A - Alternar modo (Vulneravel/Seguro)"
+  498,   // 4: "B - Ativar/Desativar analise de timing"
+  649,   // 5: "C - Mostrar informacoes do sistema"
+  595,   // 6: "D - Modo demonstracao automatica"
+  939,   // 7: "* - Reset do sistema"
+  1112,   // 8: "# - Confirmar senha"
+  1172,   // 9: "0-9 - Digitar senha"
+  1382,   // 10: "Senha correta: "
+  1234,   // 11: "Modo atual: "
+  1387,   // 12: "VULNERAVEL"
+  1437,   // 13: "SEGURO"
+  1484,   // 14: "SISTEMA "
+  1486,   // 15: "VULN"
+  1282,   // 16: "Digite usuario:"
+  1316,   // 17: "Digite senha:"
+  1441,   // 18: "MODO: "
+  1242,   // 19: "\n>>> MODO VULNERAVEL ATIVADO <<<"
+  246,   // 20: "Sistema para no primeiro erro - timing variavel"
+  1289,   // 21: "\n>>> MODO SEGURO ATIVADO <<<"
+  274,   // 22: "Sistema sempre verifica toda senha - timing constante"
+  1469,   // 23: "ANALISE: "
+  1332,   // 24: "ON"
+  1262,   // 25: "OFF"
+  1181,   // 26: "Timing no serial"
+  1392,   // 27: "\n>>> MODO ANALISE ATIVADO <<<"
+  431,   // 28: "Timing sera exibido no Serial Monitor"
+  1322,   // 29: "\n>>> MODO ANALISE DESATIVADO <<<"
+  518,   // 30: "\n====== INFORMACOES DO SISTEMA ======"
+  951,   // 31: "Modo de seguranca: "
+  1122,   // 32: "Analise de timing: "
+  1399,   // 33: "ATIVADA"
+  1397,   // 34: "DESATIVADA"
+  931,   // 35: "Tentativas restantes: "
+  666,   // 36: "Senhas erradas desde a instalacao: "
+  963,   // 37: "EEPROM: registro "
+  1472,   // 38: " de "
+  1140,   // 39: ", "
+  613,   // 40: " gravacoes, recuperado em "
+  1445,   // 41: " us"
+  1402,   // 42: "Usuarios: "
+  1488,   // 43: "/"
+  1035,   // 44: ", falhas sem usuario: "
+  796,   // 45: "Bloqueado por mais "
+  1475,   // 46: " s"
+  1296,   // 47: "Senha atual: "
+  975,   // 48: "Fila TX: pico "
+  1132,   // 49: "/256 bytes, "
+  1250,   // 50: " esperas, "
+  987,   // 51: " ms bloqueado"
+  1407,   // 52: "====================================="
+  1328,   // 53: "MODO DEMO ON"
+  1190,   // 54: "Aguarde..."
+  1412,   // 55: "\n>>> MODO DEMONSTRACAO ATIVADO <<<"
+  477,   // 56: "Executando testes automaticos..."
+  1258,   // 57: "MODO DEMO OFF"
+  1303,   // 58: "\n>>> MODO DEMONSTRACAO DESATIVADO <<<"
+  1142,   // 59: "Usuario: (# OK)"
+  900,   // 60: "Senha: (# p/ OK)"
+  1490,   // 61: "*"
+  811,   // 62: "\n--- ANALISE DE TIMING ---"
+  1417,   // 63: "Modo: "
+  1266,   // 64: "Senha digitada: "
+  1449,   // 65: "Senha correta:  "
+  999,   // 66: "Verificando... "
+  1199,   // 67: "Concluido!"
+  1046,   // 68: "Tempo decorrido: "
+  1446,   // 69: "us"
+  538,   // 70: "--- ANALISE DA VULNERABILIDADE ---"
+  631,   // 71: "Caracteres corretos estimados: "
+  913,   // 72: "Prefixo descoberto: "
+  716,   // 73: "VULNERABILIDADE DETECTADA:"
+  189,   // 74: "- Timing varia com numero de caracteres corretos"
+  159,   // 75: "- Atacante pode descobrir senha digito por digito"
+  455,   // 76: "- Cada tentativa revela informacao adicional"
+  557,   // 77: "Sistema seguro - timing constante"
+  576,   // 78: "- Tempo nao varia com entrada"
+  826,   // 79: "- Nenhuma informacao vazada"
+  683,   // 80: "- Resistente a timing attacks"
+  1057,   // 81: "ACESSO PERMITIDO"
+  1208,   // 82: "Bem-vindo!"
+  1453,   // 83: "ACESSO PERMITIDO!"
+  1152,   // 84: "ACESSO NEGADO"
+  1334,   // 85: "Tent.: "
+  1011,   // 86: "ACESSO NEGADO! Tentativas restantes: "
+  1068,   // 87: "SEM TENTATIVAS"
+  356,   // 88: "Sem tentativas agora: aguarde e digite de novo"
+  302,   // 89: "SISTEMA BLOQUEADO POR SEGURANCA! Espera de "
+  886,   // 90: "Bloqueio encerrado"
+  1217,   // 91: "SISTEMA BLOQUADO"
+  1422,   // 92: "Aguarde "
+  1478,   // 93: ":0"
+  730,   // 94: ":"
+  329,   // 95: "Sistema resetado - Pronto para nova analise"
+  1427,   // 96: "Testando: "
+  1457,   // 97: " -> "
+  732,   // 98: "\n=== DEMONSTRACAO AUTOMATICA ==="
+  1079,   // 99: "Testando modo VULNERAVEL:"
+  1340,   // 100: "0000#"
+  1346,   // 101: "1000#"
+  1352,   // 102: "1200#"
+  1358,   // 103: "1230#"
+  1364,   // 104: "1234#"
+  841,   // 105: "=== DEMONSTRACAO CONCLUIDA ==="
+  1162,   // 106: "Testando modo SEGURO:"
+  1370,   // 107: "5555#"
+  1376,   // 108: "9999#"
+  856,   // 109: "Respostas conferidas: "
+  748,   // 110: "Sessao de administracao aberta"
+  926,   // 111: "Senha errada. Tentativas restantes: "
+  764,   // 112: "Sessao de administracao encerrada"
+  780,   // 113: "Uso: USUARIO:<id>:<pin>"
+  1461,   // 114: "Usuario "
+  1274,   // 115: " cadastrado"
+  871,   // 116: "Tabela de usuarios cheia"
+  381,   // 117: "Informe o id do usuario, ex.: REMOVER:42"
+  1465,   // 118: ": ok"
+  1090,   // 119: " nao cadastrado"
+  1432,   // 120: " usuarios:"
+  127,   // 121: "Carga de usuarios: <id>:<pin> por linha, FIM no final"
+  1101,   // 122: " usuarios carregados"
+  1481,   // 123: "erro: "
+  1023,   // 124: "erro: tabela cheia"
+  1466,   // 125: "ok"
+  0,   // 126: "Comandos da serial: METRICS, METRICS:ZERAR, PERFIL, PERFIL:ZERAR"
+  49,   // 127: "Depois de ADMIN:<senha>: USUARIO:<id>:<pin>, REMOVER:<id>, TRAVAR:<id>,"
+  90,   // 128: "LIBERAR:<id>, LISTAR, CARGA, RASTRO; SAIR encerra a sessao"
+  406,   // 129: "Comando de administracao: mande antes ADMIN:<senha>"
+};
+
+// Usadas so na compilacao, por MSG(): hash do texto -> id
+constexpr uint32_t HASHES_MENSAGENS[] = {
+  0x0551070CUL, 0x0C89BCB6UL, 0x0E1E40C0UL, 0x0E7CBAABUL, 0x103CEE91UL, 0x10ED418DUL,
+  0x113AA074UL, 0x11D570E4UL, 0x148BC05AUL, 0x153D3824UL, 0x1615ED1DUL, 0x170A5F8FUL,
+  0x1767B89EUL, 0x17A2D235UL, 0x1ABEA6C9UL, 0x1C57AE68UL, 0x1D14CE39UL, 0x1D3F7BD9UL,
+  0x1DD293E1UL, 0x1E4CCE68UL, 0x22BE684EUL, 0x238708D9UL, 0x2619A722UL, 0x2A0C975EUL,
+  0x2A80D043UL, 0x2DB6B71EUL, 0x2DF193B0UL, 0x2E1505EAUL, 0x2F0C9F3DUL, 0x2F31869BUL,
+  0x2F50507AUL, 0x30868ACFUL, 0x31EF0D1AUL, 0x341C3401UL, 0x3BBDB597UL, 0x3DEBE6DEUL,
+  0x3E505CDBUL, 0x3F0CB86DUL, 0x42F2BE24UL, 0x44279302UL, 0x459AE14AUL, 0x46430FD9UL,
+  0x46459509UL, 0x4883BF63UL, 0x4970763EUL, 0x4B2D0F3AUL, 0x5037B7FFUL, 0x51DC3CBEUL,
+  0x51F4F224UL, 0x52366116UL, 0x564A04B6UL, 0x59A2991BUL, 0x59C2E37AUL, 0x5A90A56EUL,
+  0x5B631942UL, 0x5BF469A5UL, 0x5EC52FE4UL, 0x5FB9DA6EUL, 0x6056640FUL, 0x663437AFUL,
+  0x674B110DUL, 0x686A5D93UL, 0x691F9658UL, 0x69461022UL, 0x69E9827EUL, 0x6DD780C6UL,
+  0x7227F8D1UL, 0x74314A43UL, 0x74F93212UL, 0x7521BB71UL, 0x756C66C7UL, 0x782B2EE5UL,
+  0x78B4D9E4UL, 0x7E601D9AUL, 0x80E4B050UL, 0x8145591EUL, 0x8299E9D2UL, 0x82F77CA4UL,
+  0x89D000F1UL, 0x8AB93954UL, 0x8B7AA342UL, 0x8BB2F4E7UL, 0x908B1024UL, 0x92F6EE22UL,
+  0x9A7CF5C6UL, 0x9D37D86DUL, 0x9E063A67UL, 0x9E78C141UL, 0xA34662D1UL, 0xA83C5267UL,
+  0xA89E442CUL, 0xA9AE4314UL, 0xAB73AB19UL, 0xACD18972UL, 0xAECC24F7UL, 0xB52C8AF2UL,
+  0xB8C5EEB9UL, 0xB9DDEEAAUL, 0xBA235701UL, 0xC1B8F9D6UL, 0xC1E8586AUL, 0xC1EC8C08UL,
+  0xC3AC38E8UL, 0xC4CA1E12UL, 0xC5737AE5UL, 0xC757FADCUL, 0xC76B4341UL, 0xC972471CUL,
+  0xC9D386A4UL, 0xCA09DE7BUL, 0xCEBCBC08UL, 0xD3755EE8UL, 0xD4548ADFUL, 0xD76586B7UL,
+  0xDA182C59UL, 0xDBC9378FUL, 0xDBDE5F20UL, 0xDD94B1D5UL, 0xDF774EEBUL, 0xDFD804C2UL,
+  0xE2772E77UL, 0xE9CFD092UL, 0xE9D1CFCBUL, 0xEC49D742UL, 0xED6F3674UL, 0xF01317F3UL,
+  0xF4E54EA4UL, 0xF5891D7CUL, 0xF5B9E07BUL, 0xF9DD59F0UL,
+};
+constexpr uint8_t IDS_MENSAGENS[] = {
+  0x3A, 0x6B, 0x4F, 0x0B, 0x2F, 0x54, 0x7F, 0x1F, 0x03, 0x5C, 0x72, 0x57, 0x43, 0x79, 0x4A, 0x05,
+  0x09, 0x60, 0x75, 0x13, 0x12, 0x15, 0x1A, 0x2B, 0x20, 0x6C, 0x31, 0x19, 0x3D, 0x6F, 0x71, 0x1C,
+  0x25, 0x1D, 0x3C, 0x01, 0x66, 0x5E, 0x5F, 0x2D, 0x70, 0x45, 0x33, 0x49, 0x32, 0x46, 0x04, 0x2A,
+  0x26, 0x4B, 0x41, 0x7B, 0x68, 0x28, 0x64, 0x65, 0x2E, 0x3F, 0x59, 0x7D, 0x7A, 0x08, 0x51, 0x07,
+  0x39, 0x11, 0x00, 0x62, 0x0A, 0x2C, 0x44, 0x10, 0x02, 0x4D, 0x18, 0x30, 0x48, 0x17, 0x27, 0x5B,
+  0x7C, 0x0C, 0x78, 0x81, 0x5A, 0x3B, 0x5D, 0x21, 0x06, 0x6A, 0x37, 0x74, 0x3E, 0x56, 0x22, 0x38,
+  0x52, 0x14, 0x4C, 0x67, 0x0D, 0x7E, 0x63, 0x47, 0x42, 0x24, 0x77, 0x50, 0x35, 0x40, 0x61, 0x1E,
+  0x16, 0x29, 0x76, 0x73, 0x4E, 0x0E, 0x23, 0x36, 0x1B, 0x0F, 0x6D, 0x6E, 0x80, 0x69, 0x34, 0x58,
+  0x53, 0x55,
+};
+const uint16_t TOTAL_MENSAGENS = 130;
+
+constexpr uint16_t buscarMensagem(uint32_t hash, uint16_t inicio = 0, uint16_t fim = TOTAL_MENSAGENS) {
+  return inicio >= fim ? MENSAGEM_INEXISTENTE
+       : HASHES_MENSAGENS[(inicio + fim) / 2] == hash ? IDS_MENSAGENS[(inicio + fim) / 2]
+       : HASHES_MENSAGENS[(inicio + fim) / 2] < hash ? buscarMensagem(hash, (inicio + fim) / 2 + 1, fim)
+       : buscarMensagem(hash, inicio, (inicio + fim) / 2);
+}
+
+inline size_t Mensagem::printTo(Print &p) const {
+  return imprimirMensagem(p, id, CODIGOS_MENSAGENS, INICIOS_MENSAGENS, PARES_MENSAGENS);
+}
+
+#endif
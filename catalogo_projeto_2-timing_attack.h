@@ -0,0 +1,146 @@
+// Gerado por host/gerar_catalogo.py a partir de projeto_2-timing_attack.cc.
+// Nao edite: rode make -C host catalogo
+//
+// 46 mensagens em 48 usos de MSG(): 1128 bytes de texto, 1054 sem as repetidas.
+// Catalogo: 605 bytes de codigos + 170 de pares + 92 de indice = 867 bytes (77% do texto).
+// 85 pares no dicionario, 4 mensagens com prefixo de outra, 1 dentro de outra.
+#ifndef CATALOGO_PROJETO_2_TIMING_ATTACK_H
+#define CATALOGO_PROJETO_2_TIMING_ATTACK_H
+
+#include "catalogo.h"
+
+const uint8_t CODIGOS_MENSAGENS[] PROGMEM = {
+  0x43, 0x6F, 0x6D, 0xAC, 0x84, 0x73, 0x8E, 0x82, 0x73, 0xCB, 0x61, 0x6C, 0x87, 0x4D, 0x45, 0x54,
+  0x52, 0x49, 0x43, 0x53, 0x2C, 0x20, 0x4D, 0x45, 0x54, 0x52, 0x49, 0x43, 0x53, 0x3A, 0x5A, 0xCD,
+  0x52, 0x00, 0x8D, 0x54, 0xC1, 0xC2, 0x67, 0x20, 0x86, 0x76, 0x65, 0x6C, 0x82, 0x70, 0xB3, 0x67,
+  0x98, 0x73, 0xCC, 0x82, 0x76, 0xCB, 0x66, 0xCA, 0x61, 0x02, 0xC3, 0x02, 0xA7, 0x02, 0xC3, 0x02,
+  0xA3, 0x6F, 0x00, 0xA5, 0x42, 0x4C, 0x4F, 0x51, 0x55, 0x45, 0x41, 0x9A, 0x50, 0x4F, 0x52, 0x20,
+  0xA7, 0x47, 0x55, 0x52, 0x9B, 0x02, 0xC3, 0x02, 0x87, 0x41, 0x21, 0x20, 0x45, 0x73, 0x70, 0x90,
+  0x82, 0xA0, 0x00, 0xC6, 0x53, 0x97, 0x74, 0x9E, 0x82, 0x98, 0x65, 0x89, 0x84, 0x20, 0x8D, 0x50,
+  0xB3, 0x6E, 0xCF, 0x99, 0xBE, 0xD1, 0x76, 0x82, 0xAC, 0x02, 0xC3, 0x02, 0xA1, 0x6C, 0x97, 0x83,
+  0xC8, 0x00, 0x8D, 0x41, 0x89, 0xBF, 0x83, 0x70, 0x6F, 0xA0, 0x64, 0xB2, 0x95, 0x62, 0x72, 0x69,
+  0x72, 0x20, 0x73, 0x94, 0x82, 0x64, 0xB0, 0x99, 0x6F, 0x72, 0x8E, 0xB0, 0x00, 0x49, 0x6E, 0xCA,
+  0x69, 0xAC, 0x84, 0x20, 0x76, 0xCB, 0x66, 0xCA, 0x61, 0x02, 0xC3, 0x02, 0xA7, 0x02, 0xC3, 0x02,
+  0xA3, 0x6F, 0x2E, 0x2E, 0x2E, 0x20, 0x00, 0x53, 0x9E, 0x20, 0x74, 0x85, 0x89, 0xBC, 0xD0, 0x61,
+  0x67, 0x6F, 0x72, 0xC9, 0x61, 0xD4, 0xA0, 0x83, 0x64, 0xB0, 0x83, 0xA0, 0xD1, 0x76, 0x6F, 0x00,
+  0xB1, 0x8D, 0x9B, 0x02, 0xC3, 0x02, 0x81, 0xAF, 0x44, 0x92, 0x56, 0x55, 0x4C, 0x4E, 0xCD, 0x42,
+  0x49, 0x4C, 0x49, 0xCE, 0xA6, 0xB1, 0x2D, 0x00, 0xA5, 0xA6, 0xA7, 0x4E, 0x48, 0x92, 0x8D, 0x93,
+  0xA8, 0x4E, 0x47, 0x20, 0x41, 0x54, 0x54, 0x96, 0x4B, 0x20, 0x44, 0x45, 0xA9, 0x00, 0x50, 0x98,
+  0x73, 0x69, 0x6F, 0x6E, 0x83, 0x27, 0x44, 0x27, 0x99, 0xBE, 0x6D, 0x6F, 0x84, 0x8E, 0x83, 0x61,
+  0x89, 0xBF, 0x65, 0x00, 0x56, 0x55, 0x4C, 0x4E, 0xCD, 0x42, 0x49, 0x4C, 0x49, 0xCE, 0xA6, 0x44,
+  0x45, 0x91, 0x43, 0x54, 0x41, 0xCE, 0x3A, 0x00, 0x43, 0x8F, 0x61, 0x63, 0x74, 0x65, 0x98, 0x20,
+  0xBA, 0xCF, 0xD0, 0xB2, 0xAD, 0x6D, 0x61, 0x84, 0x73, 0x87, 0x00, 0x8D, 0x53, 0x97, 0x74, 0x9E,
+  0x82, 0x70, 0xBE, 0xD1, 0x99, 0x72, 0xC1, 0x65, 0x69, 0xB3, 0x20, 0x90, 0xB3, 0x00, 0x0A, 0xB1,
+  0x8D, 0x9B, 0x02, 0xC3, 0x02, 0x81, 0xAF, 0xA6, 0x93, 0xA8, 0x4E, 0x47, 0x20, 0xB1, 0x2D, 0x00,
+  0x4D, 0x6F, 0x84, 0x8E, 0x83, 0xAC, 0x02, 0xC3, 0x02, 0xA1, 0x6C, 0x97, 0x83, 0x61, 0xBC, 0xBD,
+  0x00, 0x01, 0x1F, 0x21, 0x20, 0x54, 0x85, 0x89, 0xBC, 0xD0, 0x98, 0x89, 0x6E, 0x74, 0xB2, 0x87,
+  0x00, 0xC6, 0xC0, 0x9B, 0x02, 0xC3, 0x02, 0x81, 0xAF, 0x41, 0x93, 0x56, 0x41, 0x9A, 0xC8, 0x00,
+  0x42, 0x6C, 0x6F, 0xBF, 0x65, 0x69, 0x6F, 0x20, 0x85, 0x63, 0x90, 0x72, 0x61, 0x84, 0x00, 0x50,
+  0x86, 0x66, 0x69, 0x78, 0xCC, 0xB2, 0x95, 0x62, 0x90, 0xCF, 0x87, 0x00, 0x54, 0xC1, 0xC2, 0x67,
+  0x20, 0x76, 0x97, 0x69, 0x76, 0x65, 0x6C, 0x00, 0x43, 0x6F, 0x6E, 0x63, 0x6C, 0x75, 0x02, 0xC3,
+  0x02, 0xAD, 0xBD, 0x00, 0xA7, 0x4D, 0x20, 0x91, 0x4E, 0x54, 0x41, 0x93, 0x56, 0x41, 0x53, 0x00,
+  0xC6, 0xC0, 0x4E, 0x4F, 0x52, 0x4D, 0x41, 0x4C, 0x20, 0xC8, 0x00, 0xAA, 0xC9, 0x28, 0x23, 0x99,
+  0x2F, 0x20, 0x4F, 0x4B, 0x29, 0x00, 0x54, 0x9E, 0x70, 0xCC, 0x65, 0xAB, 0x72, 0x69, 0x84, 0x87,
+  0x00, 0x44, 0xB0, 0x83, 0x73, 0x94, 0x61, 0x3A, 0x00, 0x41, 0xD4, 0x64, 0x65, 0x2E, 0x2E, 0x2E,
+  0x00, 0xA5, 0x42, 0x4C, 0x4F, 0x51, 0x55, 0xD2, 0x00, 0xC0, 0x9B, 0x41, 0xAF, 0x4F, 0x4E, 0x00,
+  0xA5, 0xA7, 0x47, 0x55, 0x52, 0x4F, 0x00, 0xB9, 0x64, 0x9D, 0x89, 0x64, 0xC9, 0x00, 0xB8, 0x50,
+  0x9F, 0xA8, 0x93, 0x88, 0x00, 0x42, 0x9E, 0x2D, 0x76, 0xC2, 0xBD, 0x00, 0xB8, 0x4E, 0x45, 0x47,
+  0xD2, 0x00, 0x54, 0x85, 0x74, 0x2E, 0x3A, 0x00, 0xB9, 0xBA, 0x89, 0x87, 0x00, 0x01, 0x00, 0x3D,
+  0x0A, 0x00, 0xA1, 0xA1, 0x81, 0x00, 0x01, 0x02, 0x20, 0x00, 0x01, 0x1C, 0x21, 0x00, 0x41, 0xD4,
+  0xA0, 0x00, 0x6D, 0x73, 0x00, 0x20, 0x73, 0x00, 0x3A, 0x30, 0x00, 0x2A, 0x00,
+};
+
+// Dois codigos por par, a partir de PRIMEIRO_PAR
+const uint8_t PARES_MENSAGENS[] PROGMEM = {
+  0x3D, 0x3D, 0x80, 0x80, 0x61, 0x20, 0x65, 0x20, 0x64, 0x6F, 0x65, 0x6E, 0x72, 0x65, 0x3A, 0x20,
+  0x44, 0x4F, 0x74, 0x61, 0x81, 0x81, 0x49, 0x53, 0x45, 0x20, 0x2D, 0x20, 0x20, 0x64, 0x61, 0x72,
+  0x65, 0x72, 0x54, 0x45, 0x41, 0x20, 0x54, 0x49, 0x85, 0x68, 0x63, 0x6F, 0x41, 0x43, 0x69, 0x73,
+  0x86, 0x73, 0x20, 0x70, 0x88, 0x20, 0x41, 0x4E, 0x69, 0x67, 0x9C, 0x69, 0x65, 0x6D, 0x45, 0x52,
+  0x64, 0x83, 0x8A, 0x8A, 0x53, 0x8B, 0xA2, 0x91, 0xA3, 0x4D, 0xA4, 0x92, 0x44, 0x8C, 0x53, 0x45,
+  0x4D, 0x49, 0x4D, 0x4F, 0x53, 0x94, 0x95, 0x72, 0x61, 0x6E, 0x74, 0x69, 0x4C, 0x8B, 0xAE, 0x8C,
+  0x9D, 0x74, 0x2D, 0x2D, 0x65, 0x73, 0x72, 0x6F, 0x96, 0x45, 0xB4, 0x53, 0xB5, 0x53, 0xB6, 0x4F,
+  0xB7, 0x20, 0xAA, 0x82, 0xAB, 0x86, 0xAD, 0x76, 0xBB, 0x61, 0x84, 0x21, 0x8F, 0x82, 0x71, 0x75,
+  0xA9, 0x9A, 0x69, 0x6D, 0x69, 0x6E, 0x0A, 0x3E, 0xC3, 0x3E, 0xC4, 0x3E, 0xC5, 0x20, 0x3C, 0x3C,
+  0xC7, 0x3C, 0x61, 0x87, 0x69, 0x63, 0x90, 0x69, 0x6F, 0x8E, 0x9F, 0x41, 0x44, 0x41, 0x74, 0x6F,
+  0x73, 0x20, 0x6E, 0x6F, 0x41, 0x88, 0x67, 0x75, 0xD3, 0x8F,
+};
+
+const uint16_t INICIOS_MENSAGENS[] PROGMEM = {
+  578,   // 0: "===================================="
+  232,   // 1: "SISTEMA DE SENHA - TIMING ATTACK DEMO"
+  568,   // 2: "Senha correta: "
+  352,   // 3: "Modo de an\xC3\xA1lise ativado!"
+  254,   // 4: "Pressione 'D' para modo de ataque"
+  521,   // 5: "MODO ANALISE ON"
+  428,   // 6: "Timing visivel"
+  385,   // 7: "\n>>> MODO AN\xC3\x81LISE ATIVADO <<<"
+  464,   // 8: "\n>>> MODO NORMAL <<<"
+  528,   // 9: "SISTEMA SEGURO"
+  497,   // 10: "Digite senha:"
+  475,   // 11: "Senha: (# p/ OK)"
+  603,   // 12: "*"
+  334,   // 13: "\n--- AN\xC3\x81LISE DE TIMING ---"
+  535,   // 14: "Senha digitada: "
+  582,   // 15: "Senha correta:  "
+  157,   // 16: "Iniciando verifica\xC3\xA7\xC3\xA3o... "
+  440,   // 17: "Conclu\xC3\xADdo!"
+  486,   // 18: "Tempo decorrido: "
+  594,   // 19: "ms"
+  208,   // 20: "--- AN\xC3\x81LISE DA VULNERABILIDADE ---"
+  296,   // 21: "Caracteres corretos estimados: "
+  415,   // 22: "Prefixo descoberto: "
+  276,   // 23: "VULNERABILIDADE DETECTADA:"
+  315,   // 24: "- Sistema para no primeiro erro"
+  34,   // 25: "- Timing revela progresso da verifica\xC3\xA7\xC3\xA3o"
+  130,   // 26: "- Ataque pode descobrir senha digit por digit"
+  573,   // 27: "=====================================\n"
+  542,   // 28: "ACESSO PERMITIDO"
+  549,   // 29: "Bem-vindo!"
+  586,   // 30: "ACESSO PERMITIDO!"
+  556,   // 31: "ACESSO NEGADO"
+  562,   // 32: "Tent.:"
+  369,   // 33: "ACESSO NEGADO! Tentativas restantes: "
+  452,   // 34: "SEM TENTATIVAS"
+  505,   // 35: "Aguarde..."
+  183,   // 36: "Sem tentativas agora: aguarde e digite de novo"
+  67,   // 37: "SISTEMA BLOQUEADO POR SEGURAN\xC3\x87A! Espera de "
+  597,   // 38: " s"
+  400,   // 39: "Bloqueio encerrado"
+  513,   // 40: "SISTEMA BLOQUADO"
+  590,   // 41: "Aguarde "
+  600,   // 42: ":0"
+  294,   // 43: ":"
+  99,   // 44: "\n>>> Sistema resetado - Pronto para nova an\xC3\xA1lise <<<"
+  0,   // 45: "Comandos da serial: METRICS, METRICS:ZERAR"
+};
+
+// Usadas so na compilacao, por MSG(): hash do texto -> id
+constexpr uint32_t HASHES_MENSAGENS[] = {
+  0x04A07400UL, 0x08ED8C81UL, 0x0D95FA0CUL, 0x0FAA2D71UL, 0x10ED418DUL, 0x153D3824UL,
+  0x170A5F8FUL, 0x2536216FUL, 0x2F0C9F3DUL, 0x32FADBEAUL, 0x38B048E8UL, 0x3BBDB597UL,
+  0x3F0CB86DUL, 0x4883BF63UL, 0x562E0E51UL, 0x564A04B6UL, 0x593B96E8UL, 0x5EC52FE4UL,
+  0x672BF961UL, 0x691F9658UL, 0x6A223986UL, 0x6DD780C6UL, 0x6F3123DAUL, 0x704E9422UL,
+  0x74F93212UL, 0x756C66C7UL, 0x821E7614UL, 0x8299E9D2UL, 0x8AB93954UL, 0x93293470UL,
+  0x9A7CF5C6UL, 0x9E063A67UL, 0xA093B1BDUL, 0xA474586EUL, 0xACD18972UL, 0xB222D955UL,
+  0xB8C5EEB9UL, 0xB991341EUL, 0xBBED277BUL, 0xC4CA1E12UL, 0xCA09DE7BUL, 0xDFD804C2UL,
+  0xE8249422UL, 0xF5597661UL, 0xF5891D7CUL, 0xF5B9E07BUL,
+};
+constexpr uint8_t IDS_MENSAGENS[] = {
+  0x03, 0x08, 0x0D, 0x00, 0x1F, 0x29, 0x22, 0x10, 0x0C, 0x1B, 0x25, 0x0B, 0x2B, 0x17, 0x13, 0x0F,
+  0x2D, 0x26, 0x11, 0x1C, 0x07, 0x0A, 0x09, 0x05, 0x02, 0x12, 0x1A, 0x16, 0x28, 0x20, 0x27, 0x2A,
+  0x01, 0x18, 0x21, 0x14, 0x1D, 0x04, 0x06, 0x15, 0x0E, 0x23, 0x19, 0x2C, 0x24, 0x1E,
+};
+const uint16_t TOTAL_MENSAGENS = 46;
+
+constexpr uint16_t buscarMensagem(uint32_t hash, uint16_t inicio = 0, uint16_t fim = TOTAL_MENSAGENS) {
+  return inicio >= fim ? MENSAGEM_INEXISTENTE
+       : HASHES_MENSAGENS[(inicio + fim) / 2] == hash ? IDS_MENSAGENS[(inicio + fim) / 2]
+       : HASHES_MENSAGENS[(inicio + fim) / 2] < hash ? buscarMensagem(hash, (inicio + fim) / 2 + 1, fim)
+       : buscarMensagem(hash, inicio, (inicio + fim) / 2);
+}
+
+inline size_t Mensagem::printTo(Print &p) const {
+  return imprimirMensagem(p, id, CODIGOS_MENSAGENS, INICIOS_MENSAGENS, PARES_MENSAGENS);
+}
+
+#endif
@@ -0,0 +1,343 @@
+// Roteiros de demonstracao e de ataque como bytecode em PROGMEM,
+// executados sem bloquear o loop().
+//
+// Um cenario e uma lista de operacoes de um byte, cada uma seguida dos
+// seus operandos, terminada por FIM_CENARIO. Os textos sao ids do
+// catalogo de mensagens (catalogo.h): as macros *_MSG("texto") entram no
+// catalogo como MSG() e ocupam um byte no cenario. Um roteiro novo custa
+// dois ou tres bytes de flash por passo, sem funcao nova.
+//
+//   LINHA_MSG("texto")           println() do texto na saida
+//   TEXTO_MSG("texto")           print(), sem fim de linha
+//   PULAR_LINHA                  println()
+//   ESPERAR_MS(ms)               espera sem bloquear (multiplo de 20 ms, ate 5,1 s)
+//   FIXAR_LEDS(mascara, acesos)  os LEDs da mascara ficam como em 'acesos'
+//   ACAO(n, argumento)           chama a funcao n da tabela do sketch
+//   ENVIAR_MSG("texto")          entrega o texto, caractere a caractere,
+//                                a entrada do sketch (teclas, comandos)
+//   CONFERIR_MSG("texto")        o texto tem que aparecer na saida antes
+//                                do proximo CONFERIR_MSG ou do fim
+//   REPETIR(n) ... FIM_REPETIR   repete o trecho n vezes (1 a 255)
+//   CHAMAR(n)                    executa o cenario n da tabela e volta
+//
+// executar(), a cada loop(), roda as operacoes ate a proxima espera e
+// volta. Para CONFERIR_MSG, o sketch liga a saida ao cenario com
+// FilaSerial::espelhar(&cenario); so os primeiros TAMANHO_CONFERENCIA
+// caracteres do texto sao conferidos.
+//
+//   const uint8_t DEMO[] PROGMEM = {
+//     CONFERIR_MSG("ACESSO NEGADO"), ENVIAR_MSG("0000#"), ESPERAR_MS(2000),
+//     FIM_CENARIO
+//   };
+//   Cenario cenario(saida, &RECURSOS);
+//   cenario.iniciar(DEMO);
+//   if (cenario.executar()) ...      // no loop(); true quando termina
+#ifndef CENARIO_H
+#define CENARIO_H
+
+#include <Arduino.h>
+#include "catalogo.h"
+
+const uint8_t OP_CENARIO_FIM = 0x00;
+const uint8_t OP_CENARIO_LINHA = 0x01;         // + id da mensagem
+const uint8_t OP_CENARIO_TEXTO = 0x02;         // + id da mensagem
+const uint8_t OP_CENARIO_PULAR_LINHA = 0x03;
+const uint8_t OP_CENARIO_ESPERAR = 0x04;       // + unidades de MS_POR_UNIDADE_CENARIO
+const uint8_t OP_CENARIO_LEDS = 0x05;          // + mascara + acesos
+const uint8_t OP_CENARIO_ACAO = 0x06;          // + numero + argumento
+const uint8_t OP_CENARIO_ENVIAR = 0x07;        // + id da mensagem
+const uint8_t OP_CENARIO_CONFERIR = 0x08;      // + id da mensagem
+const uint8_t OP_CENARIO_REPETIR = 0x09;       // + vezes
+const uint8_t OP_CENARIO_FIM_REPETIR = 0x0A;
+const uint8_t OP_CENARIO_CHAMAR = 0x0B;        // + numero do cenario
+
+const uint8_t MS_POR_UNIDADE_CENARIO = 20;
+const uint8_t PROFUNDIDADE_CENARIO = 4;    // CHAMAR e REPETIR aninhados
+const uint8_t TAMANHO_CONFERENCIA = 24;
+const unsigned long SEM_PASSO = 0xFFFFFFFFUL;
+
+template <unsigned long MS>
+struct UnidadesEspera {
+  static_assert(MS % MS_POR_UNIDADE_CENARIO == 0 && MS / MS_POR_UNIDADE_CENARIO <= 0xFF,
+                "ESPERAR_MS: multiplo de 20 ms, ate 5100 ms");
+  static const uint8_t VALOR = MS / MS_POR_UNIDADE_CENARIO;
+};
+
+// O contador do REPETIR e de um byte: 0 daria 256 voltas
+template <unsigned VEZES>
+struct VezesRepetir {
+  static_assert(VEZES >= 1 && VEZES <= 0xFF, "REPETIR: de 1 a 255 vezes");
+  static const uint8_t VALOR = VEZES;
+};
+
+#define LINHA_MSG(texto) OP_CENARIO_LINHA, ID_MSG(texto)
+#define TEXTO_MSG(texto) OP_CENARIO_TEXTO, ID_MSG(texto)
+#define PULAR_LINHA OP_CENARIO_PULAR_LINHA
+#define ESPERAR_MS(ms) OP_CENARIO_ESPERAR, UnidadesEspera<(ms)>::VALOR
+#define FIXAR_LEDS(mascara, acesos) OP_CENARIO_LEDS, (mascara), (acesos)
+#define ACAO(numero, argumento) OP_CENARIO_ACAO, (numero), (argumento)
+#define ENVIAR_MSG(texto) OP_CENARIO_ENVIAR, ID_MSG(texto)
+#define CONFERIR_MSG(texto) OP_CENARIO_CONFERIR, ID_MSG(texto)
+#define REPETIR(vezes) OP_CENARIO_REPETIR, VezesRepetir<(vezes)>::VALOR
+#define FIM_REPETIR OP_CENARIO_FIM_REPETIR
+#define CHAMAR(numero) OP_CENARIO_CHAMAR, (numero)
+#define FIM_CENARIO OP_CENARIO_FIM
+
+typedef void (*AcaoCenario)(uint8_t argumento);
+typedef void (*EntradaCenario)(char c);
+typedef void (*LedsCenario)(uint8_t mascara, uint8_t acesos);
+
+// O que os cenarios de um sketch podem usar, em PROGMEM; o que o sketch
+// nao usa fica NULL
+struct RecursosCenario {
+  const uint8_t *const *cenarios;   // CHAMAR(n)
+  const AcaoCenario *acoes;         // ACAO(n, argumento)
+  EntradaCenario entrada;           // ENVIAR_MSG
+  LedsCenario leds;                 // FIXAR_LEDS
+};
+
+// E um Print para receber a copia da saida do sketch (CONFERIR_MSG)
+class Cenario : public Print {
+public:
+  Cenario(Print &saida, const RecursosCenario *recursos)
+    : saida(saida), recursos(recursos), ponteiro(NULL), profundidade(0), inicioEspera(0),
+      duracaoEspera(0), tamanhoEsperado(0), casados(0), conferencias(0), faltas(0) {}
+
+  void iniciar(const uint8_t *cenario) {
+    ponteiro = cenario;
+    profundidade = 0;
+    duracaoEspera = 0;
+    tamanhoEsperado = 0;
+    conferencias = 0;
+    faltas = 0;
+  }
+
+  void parar() {
+    ponteiro = NULL;
+    tamanhoEsperado = 0;
+  }
+
+  bool ativo() const { return ponteiro != NULL; }
+
+  // Roda ate a proxima espera; true na chamada em que o cenario termina
+  bool executar() {
+    if (ponteiro == NULL || millis() - inicioEspera < duracaoEspera) {
+      return false;
+    }
+    duracaoEspera = 0;
+    while (ponteiro != NULL) {
+      if (!passo()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Quanto falta para o proximo passo (0 = no proximo executar(),
+  // SEM_PASSO = parado). No host, o emulador avanca o relogio direto ate
+  // la em vez de girar o loop() (host/bench_cenario.cc)
+  unsigned long msAteProximoPasso() const {
+    if (ponteiro == NULL) {
+      return SEM_PASSO;
+    }
+    unsigned long passou = millis() - inicioEspera;
+    return passou >= duracaoEspera ? 0 : duracaoEspera - passou;
+  }
+
+  // CONFERIR_MSG desde iniciar(), e quantos textos nao apareceram
+  uint8_t totalConferencias() const { return conferencias; }
+  uint8_t conferenciasFalhas() const { return faltas; }
+
+  // Copia da saida: procura o texto esperado
+  size_t write(uint8_t c) {
+    if (tamanhoEsperado == 0) {
+      return 1;
+    }
+    // KMP: no erro, volta ao maior prefixo do texto que ainda casa
+    while (casados > 0 && c != (uint8_t)esperado[casados]) {
+      casados = falha[casados - 1];
+    }
+    if (c == (uint8_t)esperado[casados]) {
+      casados++;
+    }
+    if (casados == tamanhoEsperado) {
+      tamanhoEsperado = 0;
+    }
+    return 1;
+  }
+  using Print::write;
+
+private:
+  // Recebe o texto decodificado de uma mensagem: guarda na RAM ou
+  // entrega a entrada do sketch
+  class DestinoTexto : public Print {
+  public:
+    DestinoTexto(char *texto, uint8_t tamanho, EntradaCenario entrada)
+      : texto(texto), tamanho(tamanho), usado(0), entrada(entrada) {}
+    size_t write(uint8_t c) {
+      if (entrada != NULL) {
+        entrada((char)c);
+      } else if (usado < tamanho) {
+        texto[usado++] = (char)c;
+      }
+      return 1;
+    }
+    using Print::write;
+    uint8_t guardados() const { return usado; }
+
+  private:
+    char *texto;
+    uint8_t tamanho;
+    uint8_t usado;
+    EntradaCenario entrada;
+  };
+
+  struct Retorno {
+    const uint8_t *ponteiro;   // depois do CHAMAR, ou o inicio do trecho repetido
+    uint8_t vezes;             // 0 = CHAMAR
+  };
+
+  uint8_t lerByte() {
+    return pgm_read_byte(ponteiro++);
+  }
+
+  // Uma operacao; false quando comecou uma espera
+  bool passo() {
+    uint8_t op = lerByte();
+    switch (op) {
+      case OP_CENARIO_LINHA:
+        saida.println(Mensagem(lerByte()));
+        break;
+      case OP_CENARIO_TEXTO:
+        saida.print(Mensagem(lerByte()));
+        break;
+      case OP_CENARIO_PULAR_LINHA:
+        saida.println();
+        break;
+      case OP_CENARIO_ESPERAR:
+        inicioEspera = millis();
+        duracaoEspera = (unsigned long)lerByte() * MS_POR_UNIDADE_CENARIO;
+        return duracaoEspera == 0;
+      case OP_CENARIO_LEDS: {
+        uint8_t mascara = lerByte();
+        uint8_t acesos = lerByte();
+        ((LedsCenario)pgm_read_ptr(&recursos->leds))(mascara, acesos);
+        break;
+      }
+      case OP_CENARIO_ACAO: {
+        const AcaoCenario *acoes = (const AcaoCenario *)pgm_read_ptr(&recursos->acoes);
+        uint8_t numero = lerByte();
+        uint8_t argumento = lerByte();
+        ((AcaoCenario)pgm_read_ptr(&acoes[numero]))(argumento);
+        break;
+      }
+      case OP_CENARIO_ENVIAR: {
+        DestinoTexto destino(NULL, 0, (EntradaCenario)pgm_read_ptr(&recursos->entrada));
+        Mensagem(lerByte()).printTo(destino);
+        break;
+      }
+      case OP_CENARIO_CONFERIR:
+        encerrarConferencia();
+        conferir(lerByte());
+        break;
+      case OP_CENARIO_REPETIR: {
+        uint8_t vezes = lerByte();
+        if (vezes == 0) {   // so em bytecode estragado (ver VezesRepetir)
+          encerrarConferencia();
+          parar();
+        } else {
+          empilhar(vezes);
+        }
+        break;
+      }
+      case OP_CENARIO_FIM_REPETIR:
+        if (profundidade == 0) {
+          parar();
+        } else if (--pilha[profundidade - 1].vezes > 0) {
+          ponteiro = pilha[profundidade - 1].ponteiro;
+        } else {
+          profundidade--;
+        }
+        break;
+      case OP_CENARIO_CHAMAR: {
+        const uint8_t *const *cenarios = (const uint8_t *const *)pgm_read_ptr(&recursos->cenarios);
+        uint8_t numero = lerByte();
+        if (empilhar(0)) {
+          ponteiro = (const uint8_t *)pgm_read_ptr(&cenarios[numero]);
+        }
+        break;
+      }
+      case OP_CENARIO_FIM:
+        if (profundidade > 0) {
+          ponteiro = pilha[--profundidade].ponteiro;
+          break;
+        }
+        encerrarConferencia();
+        ponteiro = NULL;
+        break;
+      default:   // bytecode estragado: para
+        encerrarConferencia();
+        parar();
+        break;
+    }
+    return true;
+  }
+
+  // Aninhamento alem de PROFUNDIDADE_CENARIO para o cenario
+  bool empilhar(uint8_t vezes) {
+    if (profundidade == PROFUNDIDADE_CENARIO) {
+      parar();
+      return false;
+    }
+    pilha[profundidade].ponteiro = ponteiro;
+    pilha[profundidade].vezes = vezes;
+    profundidade++;
+    return true;
+  }
+
+  void conferir(uint8_t id) {
+    DestinoTexto destino(esperado, TAMANHO_CONFERENCIA, NULL);
+    Mensagem(id).printTo(destino);
+    tamanhoEsperado = destino.guardados();
+    casados = 0;
+    conferencias++;
+
+    // falha[i]: tamanho do maior prefixo proprio de esperado[0..i] que
+    // tambem e sufixo ("===x" depois de "====" continua com 3 casados)
+    uint8_t k = 0;
+    falha[0] = 0;
+    for (uint8_t i = 1; i < tamanhoEsperado; i++) {
+      while (k > 0 && esperado[i] != esperado[k]) {
+        k = falha[k - 1];
+      }
+      if (esperado[i] == esperado[k]) {
+        k++;
+      }
+      falha[i] = k;
+    }
+  }
+
+  // O texto esperado que ainda nao apareceu conta como falha
+  void encerrarConferencia() {
+    if (tamanhoEsperado > 0) {
+      faltas++;
+      tamanhoEsperado = 0;
+    }
+  }
+
+  Print &saida;
+  const RecursosCenario *recursos;
+  const uint8_t *ponteiro;   // proxima operacao; NULL = parado
+  Retorno pilha[PROFUNDIDADE_CENARIO];
+  uint8_t profundidade;
+  unsigned long inicioEspera;
+  unsigned long duracaoEspera;
+  char esperado[TAMANHO_CONFERENCIA];
+  uint8_t tamanhoEsperado;   // 0 = nada a conferir
+  uint8_t falha[TAMANHO_CONFERENCIA];   // para onde 'casados' volta num erro
+  uint8_t casados;           // caracteres de 'esperado' ja vistos em sequencia
+  uint8_t conferencias;
+  uint8_t faltas;
+};
+
+#endif
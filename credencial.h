@@ -0,0 +1,50 @@
+// Senha guardada como resumo com sal: HMAC-SHA256(sal, senha) (ver
+// sha256.h). O sketch nao precisa da senha em texto para conferir.
+//
+// verificarCredencial() hasheia a tentativa e compara os 32 bytes sem
+// sair no primeiro byte diferente; o tempo so depende do tamanho da
+// tentativa (uma compressao a mais a cada 64 bytes), nunca de quantos
+// digitos estao certos. O sal, diferente em cada credencial, impede que
+// uma tabela pronta de resumos sirva para varios aparelhos. Com 4
+// digitos ainda sao so 10000 senhas: quem copiar a flash testa todas, e
+// contra isso so vale limitar tentativas (limite_tentativas.h).
+//
+// host/gerar_credencial.py gera o inicializador para uma senha nova:
+//
+//   Credencial credencial = { { 0x3f, ... }, { 0x9a, ... } };   // sal, resumo
+//   if (verificarCredencial(credencial, digitada, strlen(digitada))) ...
+#ifndef CREDENCIAL_H
+#define CREDENCIAL_H
+
+#include <Arduino.h>
+#include "sha256.h"
+
+const uint8_t TAMANHO_SAL = 16;
+
+struct Credencial {
+  uint8_t sal[TAMANHO_SAL];
+  uint8_t resumo[TAMANHO_RESUMO_SHA256];
+};
+
+// Compara tudo, sem desvio que dependa dos dados
+inline bool iguaisTempoConstante(const uint8_t *a, const uint8_t *b, uint8_t tamanho) {
+  uint8_t diferenca = 0;
+  for (uint8_t i = 0; i < tamanho; i++) {
+    diferenca |= a[i] ^ b[i];
+  }
+  return diferenca == 0;
+}
+
+inline void criarCredencial(Credencial &credencial, const uint8_t *sal,
+                            const char *senha, uint8_t tamanho) {
+  memcpy(credencial.sal, sal, TAMANHO_SAL);
+  hmacSha256(sal, TAMANHO_SAL, (const uint8_t *)senha, tamanho, credencial.resumo);
+}
+
+inline bool verificarCredencial(const Credencial &credencial, const char *senha, uint8_t tamanho) {
+  uint8_t resumo[TAMANHO_RESUMO_SHA256];
+  hmacSha256(credencial.sal, TAMANHO_SAL, (const uint8_t *)senha, tamanho, resumo);
+  return iguaisTempoConstante(resumo, credencial.resumo, TAMANHO_RESUMO_SHA256);
+}
+
+#endif
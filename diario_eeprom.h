@@ -0,0 +1,176 @@
+// Estado pequeno que sobrevive ao reset, gravado na EEPROM como um
+// diario: um anel de registros, e cada gravacao vai para o registro
+// seguinte em vez de reescrever o mesmo lugar.
+//
+//   registro = sequencia(1) estado(sizeof(Estado)) crc8(1)
+//
+// Desgaste: com N registros no anel, cada celula recebe 1/N das
+// gravacoes (a EEPROM do AVR aguenta ~100 mil escritas por celula). E
+// update() so grava os bytes que mudaram.
+//
+// Sem espera: agendar() so copia o estado para a RAM. bombear(), no
+// loop() e no yield(), grava no maximo um byte por chamada, e so com a
+// EEPROM livre (eeprom_is_ready()); os ~3,4 ms de cada byte correm em
+// paralelo com o sketch. Mudancas seguidas dentro de 'atrasoMs' viram um
+// registro so, e um estado igual ao ultimo gravado nao grava nada.
+// gravarAgora() e para o que nao pode se perder num corte de energia:
+// comeca o registro na hora, e concluir() espera o que faltar.
+//
+// O byte de sequencia e gravado por ultimo: ate ele chegar, o registro
+// ainda tem a sequencia antiga e nao conta. Um corte de energia no meio
+// deixa valendo o registro anterior (o CRC-8 sozinho deixaria passar
+// parte desses cortes). Na volta, recuperar() le so a sequencia de cada
+// registro: o mais novo e o fim da primeira corrida s, s+1, s+2... A
+// partir dele o CRC e conferido de tras para frente, o que pula um
+// registro com bits estragados.
+//
+//   DiarioEeprom<Estado, 768, 256> diario(3000);
+//   if (diario.recuperar(estado)) ...           // no setup()
+//   diario.agendar(estado);                     // quando o estado muda
+//   diario.bombear(millis());                   // no loop() e no yield()
+#ifndef DIARIO_EEPROM_H
+#define DIARIO_EEPROM_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+
+// CRC-8 (polinomio 0x07), bit a bit: poucos bytes por registro nao pagam
+// uma tabela de 256 bytes
+inline uint8_t crc8Diario(const uint8_t *dados, uint8_t tamanho) {
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < tamanho; i++) {
+    crc ^= dados[i];
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+template <typename Estado, uint16_t INICIO, uint16_t TAMANHO>
+class DiarioEeprom {
+public:
+  static const uint8_t TAMANHO_REGISTRO = sizeof(Estado) + 2;
+  static const uint8_t REGISTROS = TAMANHO / TAMANHO_REGISTRO;
+  static_assert(REGISTROS >= 2 && REGISTROS <= 128, "a sequencia de 8 bits precisa de 2 a 128 registros");
+
+  explicit DiarioEeprom(unsigned long atrasoMs)
+    : atrasoMs(atrasoMs), atual(REGISTROS - 1), sequencia(0xFF), temGravado(false), pendente(false),
+      escritos(TAMANHO_REGISTRO), ultimaMudanca(0), gravacoes(0), coalescidas(0) {}
+
+  // No setup(): o estado do registro valido mais novo; false se nao
+  // houver nenhum (EEPROM apagada), e 'estado' fica como estava
+  bool recuperar(Estado &estado) {
+    uint8_t fim = REGISTROS - 1;
+    uint8_t anterior = EEPROM.read(endereco(0));
+    for (uint8_t i = 1; i < REGISTROS; i++) {
+      uint8_t s = EEPROM.read(endereco(i));
+      if (s != (uint8_t)(anterior + 1)) {
+        fim = i - 1;
+        break;
+      }
+      anterior = s;
+    }
+    for (uint8_t n = 0; n < REGISTROS; n++) {
+      uint8_t i = (fim + REGISTROS - n) % REGISTROS;
+      for (uint8_t j = 0; j < TAMANHO_REGISTRO; j++) {
+        registro[j] = EEPROM.read(endereco(i) + j);
+      }
+      if (crc8Diario(registro, TAMANHO_REGISTRO - 1) == registro[TAMANHO_REGISTRO - 1]) {
+        atual = i;
+        sequencia = registro[0];
+        temGravado = true;
+        memcpy(&gravado, registro + 1, sizeof(Estado));
+        memcpy(&estado, &gravado, sizeof(Estado));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Guarda para gravar depois de 'atrasoMs' sem outra mudanca
+  void agendar(const Estado &estado, unsigned long agora) {
+    if (pendente) {
+      coalescidas++;
+    }
+    memcpy(&proximo, &estado, sizeof(Estado));
+    pendente = true;
+    ultimaMudanca = agora;
+  }
+
+  // Comeca ja (sem o atraso); o registro anterior, se estiver no meio,
+  // termina antes
+  void gravarAgora(const Estado &estado) {
+    concluir();
+    memcpy(&proximo, &estado, sizeof(Estado));
+    iniciarRegistro();
+  }
+
+  // Espera o registro em andamento chegar inteiro a EEPROM
+  void concluir() {
+    while (gravando()) {
+      gravarByte();
+    }
+  }
+
+  // Grava no maximo um byte, sem esperar pela EEPROM
+  void bombear(unsigned long agora) {
+    if (!gravando() && pendente && agora - ultimaMudanca >= atrasoMs) {
+      iniciarRegistro();
+    }
+    if (gravando() && eeprom_is_ready()) {
+      gravarByte();
+    }
+  }
+
+  bool gravando() const { return escritos < TAMANHO_REGISTRO; }
+  bool ocioso() const { return !gravando() && !pendente; }
+
+  // Para o relatorio de desgaste
+  uint8_t registros() const { return REGISTROS; }
+  uint8_t registroAtual() const { return atual; }
+  unsigned long totalGravacoes() const { return gravacoes; }
+  unsigned long totalCoalescidas() const { return coalescidas; }
+
+private:
+  static uint16_t endereco(uint8_t i) {
+    return INICIO + (uint16_t)i * TAMANHO_REGISTRO;
+  }
+
+  // Estado e CRC primeiro, sequencia no fim
+  void gravarByte() {
+    uint8_t i = escritos + 1 < TAMANHO_REGISTRO ? escritos + 1 : 0;
+    EEPROM.update(endereco(atual) + i, registro[i]);
+    escritos++;
+  }
+
+  void iniciarRegistro() {
+    pendente = false;
+    if (temGravado && memcmp(&proximo, &gravado, sizeof(Estado)) == 0) {
+      return;
+    }
+    memcpy(&gravado, &proximo, sizeof(Estado));
+    temGravado = true;
+    atual = (atual + 1) % REGISTROS;
+    registro[0] = ++sequencia;
+    memcpy(registro + 1, &gravado, sizeof(Estado));
+    registro[TAMANHO_REGISTRO - 1] = crc8Diario(registro, TAMANHO_REGISTRO - 1);
+    escritos = 0;
+    gravacoes++;
+  }
+
+  unsigned long atrasoMs;
+  uint8_t atual;          // registro mais novo (ou sendo gravado)
+  uint8_t sequencia;
+  bool temGravado;        // 'gravado' tem o conteudo do registro atual
+  bool pendente;
+  uint8_t escritos;       // bytes do registro ja gravados
+  unsigned long ultimaMudanca;
+  Estado proximo;
+  Estado gravado;
+  uint8_t registro[TAMANHO_REGISTRO];
+  unsigned long gravacoes;
+  unsigned long coalescidas;
+};
+
+#endif
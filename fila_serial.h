@@ -0,0 +1,133 @@
+// Fila de saida da serial maior que o buffer de 64 bytes do core.
+//
+// Serial.print() bloqueia assim que os 64 bytes de TX enchem: a 9600
+// baud, uma tela de ajuda de ~900 bytes para o loop() por quase um
+// segundo, e a RX transborda nesse meio tempo. FilaSerial guarda a saida
+// num buffer circular em RAM e so entrega a UART o que cabe sem esperar.
+//
+// print()/println() de texto chegam como um bloco (write com tamanho) e
+// sao copiados de uma vez, emendados no que ja estava na fila. bombear()
+// passa para a UART tantos bytes quantos ela aceitar naquele momento;
+// chame a cada loop() e em yield(), que o delay() do core chama
+// enquanto espera. Assim a fila esvazia em segundo plano.
+//
+// Se a fila encher, o byte mais antigo vai direto para Serial.write(),
+// que espera a UART como antes. O tempo perdido assim e o pico de
+// ocupacao ficam registrados para dimensionar TAMANHO pelos dados.
+//
+// espelhar() manda uma copia de tudo o que entra na fila para outro
+// Print, como o Cenario (cenario.h) que confere as respostas do sketch.
+//
+//   FilaSerial<256> saida(Serial);
+//   saida.println(F("texto"));
+//   void yield() { saida.bombear(); }
+#ifndef FILA_SERIAL_H
+#define FILA_SERIAL_H
+
+#include <Arduino.h>
+
+template <uint16_t TAMANHO>
+class FilaSerial : public Print {
+public:
+  explicit FilaSerial(HardwareSerial &serial)
+    : serial(serial), copia(NULL), inicio(0), ocupados(0), maiorOcupacao(0), microsEsperando(0), esperas(0) {}
+
+  size_t write(uint8_t byte) {
+    return write(&byte, 1);
+  }
+
+  size_t write(const uint8_t *buffer, size_t tamanho) {
+    if (copia != NULL) {
+      copia->write(buffer, tamanho);
+    }
+    bombear();
+    size_t restante = tamanho;
+    bool esperou = false;
+    unsigned long inicioEspera = 0;
+    while (restante > 0) {
+      if (ocupados == TAMANHO) {
+        if (!esperou) {
+          esperou = true;
+          inicioEspera = micros();
+        }
+        enviarMaisAntigo();
+      }
+      // Copia ate o fim do espaco livre contiguo do buffer circular
+      uint16_t fim = (inicio + ocupados) % TAMANHO;
+      size_t trecho = TAMANHO - ocupados;
+      if (trecho > (size_t)(TAMANHO - fim)) {
+        trecho = TAMANHO - fim;
+      }
+      if (trecho > restante) {
+        trecho = restante;
+      }
+      memcpy(dados + fim, buffer, trecho);
+      ocupados += trecho;
+      buffer += trecho;
+      restante -= trecho;
+    }
+    if (ocupados > maiorOcupacao) {
+      maiorOcupacao = ocupados;
+    }
+    if (esperou) {
+      microsEsperando += micros() - inicioEspera;
+      esperas++;
+    }
+    return tamanho;
+  }
+  using Print::write;
+
+  // NULL desliga a copia
+  void espelhar(Print *destino) {
+    copia = destino;
+  }
+
+  // Entrega a UART o que ela aceitar sem bloquear
+  void bombear() {
+    int espaco = serial.availableForWrite();
+    while (espaco-- > 0 && ocupados > 0) {
+      serial.write(dados[inicio]);
+      inicio = (inicio + 1) % TAMANHO;
+      ocupados--;
+    }
+  }
+
+  // Espera a fila inteira sair (antes de uma pausa longa, por exemplo)
+  void esvaziar() {
+    while (ocupados > 0) {
+      enviarMaisAntigo();
+    }
+    serial.flush();
+  }
+
+  uint16_t pendentes() const { return ocupados; }
+  uint16_t pico() const { return maiorOcupacao; }
+  // Tempo que print() ficou parado com a fila cheia, e quantas vezes
+  unsigned long microsBloqueado() const { return microsEsperando; }
+  unsigned long vezesBloqueado() const { return esperas; }
+
+  void zerarContadores() {
+    maiorOcupacao = ocupados;
+    microsEsperando = 0;
+    esperas = 0;
+  }
+
+private:
+  // Serial.write() espera a UART se os 64 bytes dela estiverem cheios
+  void enviarMaisAntigo() {
+    serial.write(dados[inicio]);
+    inicio = (inicio + 1) % TAMANHO;
+    ocupados--;
+  }
+
+  HardwareSerial &serial;
+  Print *copia;
+  uint8_t dados[TAMANHO];
+  uint16_t inicio;
+  uint16_t ocupados;
+  uint16_t maiorOcupacao;
+  unsigned long microsEsperando;
+  unsigned long esperas;
+};
+
+#endif
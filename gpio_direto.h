@@ -0,0 +1,104 @@
+// Acesso direto as portas do ATmega328P, com o pino resolvido em tempo
+// de compilacao.
+//
+// digitalWrite() procura porta e mascara em tabelas na flash, desliga o
+// PWM do pino e protege a escrita com cli/sei: ~50 ciclos por chamada.
+// Aqui o numero do pino e parametro de template, entao porta e mascara
+// viram constantes e cada operacao e uma instrucao (sbi/cbi, 2 ciclos).
+//
+// GrupoPinos junta pinos de uma mesma porta (verificado na compilacao)
+// e escreve todos com um unico 'out' em PINx: escrever 1 em PINx inverte
+// o bit, entao PINx = (PORTx ^ valor) & mascara muda so os pinos do
+// grupo, sem cli/sei e sem risco de desfazer o que uma ISR escreveu nos
+// outros pinos da porta entre a leitura e a escrita. Uma ISR nao deve
+// mexer nos pinos do proprio grupo.
+//
+//   typedef PinoDireto<13> LedVermelho;
+//   LedVermelho::comoSaida();
+//   LedVermelho::ligar();
+//
+//   typedef GrupoPinos<13, 12, 11> Leds;   // bit 0 = pino 13, ...
+//   Leds::comoSaida();
+//   Leds::escrever(0x07);                  // os tres acesos
+//
+// Pinos do Uno: 0-7 em PORTD, 8-13 em PORTB, A0-A5 (14-19) em PORTC.
+#ifndef GPIO_DIRETO_H
+#define GPIO_DIRETO_H
+
+#include <Arduino.h>
+
+enum { PORTA_B, PORTA_C, PORTA_D };
+
+constexpr uint8_t portaDoPino(uint8_t pino) {
+  return pino < 8 ? PORTA_D : pino < 14 ? PORTA_B : PORTA_C;
+}
+
+constexpr uint8_t mascaraDoPino(uint8_t pino) {
+  return 1 << (pino < 8 ? pino : pino < 14 ? pino - 8 : pino - 14);
+}
+
+template <uint8_t PORTA> struct Porta;
+
+#define DEFINIR_PORTA(id, registradorPin, registradorDdr, registradorPort)   \
+  template <> struct Porta<id> {                                             \
+    static void saida(uint8_t mascara) { registradorDdr |= mascara; }        \
+    static void ligar(uint8_t mascara) { registradorPort |= mascara; }       \
+    static void desligar(uint8_t mascara) { registradorPort &= (uint8_t)~mascara; } \
+    static void alternar(uint8_t mascara) { registradorPin = mascara; }      \
+    static void escrever(uint8_t mascara, uint8_t valor) {                   \
+      registradorPin = (uint8_t)((registradorPort ^ valor) & mascara);       \
+    }                                                                        \
+    static uint8_t ler() { return registradorPin; }                          \
+  };
+
+DEFINIR_PORTA(PORTA_B, PINB, DDRB, PORTB)
+DEFINIR_PORTA(PORTA_C, PINC, DDRC, PORTC)
+DEFINIR_PORTA(PORTA_D, PIND, DDRD, PORTD)
+
+#undef DEFINIR_PORTA
+
+template <uint8_t PINO>
+struct PinoDireto {
+  static_assert(PINO < 20, "o Uno tem pinos digitais de 0 a 19");
+  typedef Porta<portaDoPino(PINO)> P;
+  static const uint8_t PORTA = portaDoPino(PINO);
+  static const uint8_t MASCARA = mascaraDoPino(PINO);
+
+  static void comoSaida() { P::saida(MASCARA); }
+  static void ligar() { P::ligar(MASCARA); }
+  static void desligar() { P::desligar(MASCARA); }
+  static void alternar() { P::alternar(MASCARA); }
+  static void escrever(bool nivel) { nivel ? ligar() : desligar(); }
+  static bool ler() { return P::ler() & MASCARA; }
+};
+
+// O bit i de 'valor' vai para o i-esimo pino da lista
+template <uint8_t... PINOS> struct GrupoPinos;
+
+template <uint8_t PINO>
+struct GrupoPinos<PINO> {
+  static const uint8_t PORTA = portaDoPino(PINO);
+  static const uint8_t MASCARA = mascaraDoPino(PINO);
+  static const uint8_t QUANTIDADE = 1;
+
+  static uint8_t paraPorta(uint8_t valor) { return (valor & 1) ? MASCARA : 0; }
+  static void comoSaida() { Porta<PORTA>::saida(MASCARA); }
+  static void escrever(uint8_t valor) { Porta<PORTA>::escrever(MASCARA, paraPorta(valor)); }
+};
+
+template <uint8_t PINO, uint8_t... RESTO>
+struct GrupoPinos<PINO, RESTO...> {
+  typedef GrupoPinos<RESTO...> Resto;
+  static_assert(portaDoPino(PINO) == Resto::PORTA, "todos os pinos do grupo precisam estar na mesma porta");
+  static const uint8_t PORTA = Resto::PORTA;
+  static const uint8_t MASCARA = mascaraDoPino(PINO) | Resto::MASCARA;
+  static const uint8_t QUANTIDADE = 1 + Resto::QUANTIDADE;
+
+  static uint8_t paraPorta(uint8_t valor) {
+    return ((valor & 1) ? mascaraDoPino(PINO) : 0) | Resto::paraPorta(valor >> 1);
+  }
+  static void comoSaida() { Porta<PORTA>::saida(MASCARA); }
+  static void escrever(uint8_t valor) { Porta<PORTA>::escrever(MASCARA, paraPorta(valor)); }
+};
+
+#endif
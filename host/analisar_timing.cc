@@ -0,0 +1,210 @@
+// Detector de vazamento por tempo no estilo do dudect para as duas
+// verificacoes de senha do projeto_2-timing_attack-corrigido.
+//
+// Cada verificacao roda milhoes de vezes com duas classes de entrada
+// intercaladas ao acaso: a senha correta (fixa) e senhas aleatorias do
+// mesmo tamanho. Cada chamada e medida em dois relogios:
+//
+//   virtual  ciclos do emulador, isto e, o custo da API do Arduino
+//            (delay(), millis()...) que o atacante veria no AVR
+//   host     contador de ciclos da CPU do host rodando o codigo
+//            compilado, que pega desvios e lacos dependentes da entrada
+//
+// Para cada relogio e mantido um teste t de Welch sobre todas as medidas
+// e outros sobre as medidas abaixo de percentis fixados no aquecimento
+// (corta as caudas causadas por interrupcoes do sistema). Vale o maior
+// |t|: acima de 10 ha vazamento, abaixo de 4,5 nao ha evidencia.
+//
+// Sai com 1 se a verificacao segura vazar ou se a vulneravel passar,
+// para servir de teste de regressao a cada mudanca nas verificacoes.
+//
+//   build/analisar_timing [--medidas N] [--semente S]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "Arduino.h"
+#include "emulador.h"
+#include "estatistica.h"
+
+bool verificarSenhaVulneravel(String senha);
+bool verificarSenhaSegura(const String &senha);
+bool sistemaOcioso();
+
+namespace {
+
+const double LIMITE_VAZAMENTO = 10;
+const double LIMITE_SUSPEITA = 4.5;
+
+const int AQUECIMENTO = 10000;   // medidas usadas so para fixar os cortes
+const int LOTE = 10000;
+const int CORTES = 8;
+
+const char SENHA_FIXA[] = "1234";
+
+inline uint64_t ticksHost() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void descartar(uint8_t, uint64_t) {
+}
+
+// Um relogio: histogramas por classe e os testes t com e sem corte
+struct Analise {
+  const char *nome;
+  Histograma histograma[2];
+  Histograma aquecimento;
+  uint64_t corte[CORTES];
+  TesteWelch teste[1 + CORTES];
+  bool aquecido;
+
+  explicit Analise(const char *nome) : nome(nome), aquecido(false) {}
+
+  void adicionar(int classe, uint64_t medida) {
+    if (!aquecido) {
+      aquecimento.adicionar(medida);
+      if (aquecimento.amostras() == AQUECIMENTO) {
+        // Percentis 1 - 0,5^(10 (k+1) / CORTES), como no dudect
+        for (int k = 0; k < CORTES; k++) {
+          corte[k] = aquecimento.percentil(1 - pow(0.5, 10.0 * (k + 1) / CORTES));
+        }
+        aquecido = true;
+      }
+      return;
+    }
+    histograma[classe].adicionar(medida);
+    teste[0].adicionar(classe, (double)medida);
+    for (int k = 0; k < CORTES; k++) {
+      if (medida <= corte[k]) {
+        teste[1 + k].adicionar(classe, (double)medida);
+      }
+    }
+  }
+
+  // Teste com o maior |t| entre os que ja tem amostras suficientes
+  int piorTeste() const {
+    int pior = 0;
+    for (int k = 1; k <= CORTES; k++) {
+      if (teste[k].n() > 1000 && fabs(teste[k].t()) > fabs(teste[pior].t())) {
+        pior = k;
+      }
+    }
+    return pior;
+  }
+
+  bool vazou() const {
+    return fabs(teste[piorTeste()].t()) > LIMITE_VAZAMENTO;
+  }
+
+  void relatar() const {
+    int k = piorTeste();
+    double t = teste[k].t();
+    const char *veredito = fabs(t) > LIMITE_VAZAMENTO ? "VAZAMENTO"
+                         : fabs(t) > LIMITE_SUSPEITA ? "suspeito"
+                         : "sem vazamento";
+    printf("  %-8s fixa p50 %8llu p99 %8llu | aleatoria p50 %8llu p99 %8llu\n", nome,
+           (unsigned long long)histograma[0].percentil(0.5),
+           (unsigned long long)histograma[0].percentil(0.99),
+           (unsigned long long)histograma[1].percentil(0.5),
+           (unsigned long long)histograma[1].percentil(0.99));
+    if (k == 0) {
+      printf("           |t| = %.2f sem corte", fabs(t));
+    } else {
+      printf("           |t| = %.2f com corte em %llu", fabs(t), (unsigned long long)corte[k - 1]);
+    }
+    printf(" (%.0f medidas, p = %.2g) -> %s\n", teste[k].n(), valorP(t), veredito);
+  }
+};
+
+template <typename Verificar>
+void analisar(const char *nome, Verificar verificar, long medidas, std::mt19937_64 &gerador,
+              Analise &virtual_, Analise &host) {
+  std::vector<String> entradas(LOTE);
+  std::vector<int> classes(LOTE);
+  std::uniform_int_distribution<int> digito('0', '9');
+  volatile bool resultado = false;
+
+  std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+  for (long feitas = 0; feitas < medidas + AQUECIMENTO; feitas += LOTE) {
+    // Entradas preparadas antes para nao entrar na medida
+    for (int i = 0; i < LOTE; i++) {
+      classes[i] = (int)(gerador() & 1);
+      if (classes[i] == 0) {
+        entradas[i] = SENHA_FIXA;
+      } else {
+        char aleatoria[sizeof(SENHA_FIXA)] = { 0 };
+        for (size_t j = 0; j + 1 < sizeof(SENHA_FIXA); j++) {
+          aleatoria[j] = (char)digito(gerador);
+        }
+        entradas[i] = aleatoria;
+      }
+    }
+    for (int i = 0; i < LOTE; i++) {
+      uint64_t cicloInicial = emu::ciclos();
+      uint64_t tickInicial = ticksHost();
+      resultado = verificar(entradas[i]);
+      uint64_t tickFinal = ticksHost();
+      virtual_.adicionar(classes[i], emu::ciclos() - cicloInicial);
+      host.adicionar(classes[i], tickFinal - tickInicial);
+    }
+  }
+  (void)resultado;
+  double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+  printf("%s (%ld medidas em %.2f s)\n", nome, medidas, segundos);
+  virtual_.relatar();
+  host.relatar();
+}
+
+}
+
+int main(int argc, char **argv) {
+  long medidas = 1000000;
+  unsigned long semente = 1;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--medidas")) {
+      medidas = strtol(argv[i + 1], NULL, 10);
+    } else if (!strcmp(argv[i], "--semente")) {
+      semente = strtoul(argv[i + 1], NULL, 10);
+    } else {
+      fprintf(stderr, "uso: %s [--medidas N] [--semente S]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  emu::reiniciar();
+  emu::observarSerial(descartar);
+  emu::definirTimer2Ocioso(emu::varreduraTecladoOciosa);   // teclado_timer.h
+  emu::definirYieldOcioso(sistemaOcioso);
+  setup();
+
+  std::mt19937_64 gerador(semente);
+  printf("classes: \"%s\" (fixa) x aleatoria de %zu digitos, limite |t| > %.0f\n\n",
+         SENHA_FIXA, sizeof(SENHA_FIXA) - 1, LIMITE_VAZAMENTO);
+
+  Analise vulneravelVirtual("virtual"), vulneravelHost("host");
+  analisar("verificarSenhaVulneravel", verificarSenhaVulneravel, medidas, gerador,
+           vulneravelVirtual, vulneravelHost);
+  Analise seguraVirtual("virtual"), seguraHost("host");
+  analisar("verificarSenhaSegura", verificarSenhaSegura, medidas, gerador,
+           seguraVirtual, seguraHost);
+
+  bool vulneravelDetectada = vulneravelVirtual.vazou() && vulneravelHost.vazou();
+  bool seguraVaza = seguraVirtual.vazou() || seguraHost.vazou();
+  printf("\nResultado: vulneravel %s, segura %s\n",
+         vulneravelDetectada ? "vaza (esperado)" : "NAO DETECTADA",
+         seguraVaza ? "VAZA" : "constante");
+  return vulneravelDetectada && !seguraVaza ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+// Ataque de timing automatico contra as verificacoes de senha do
+// projeto_2-timing_attack-corrigido. O atacante so ve o tempo de
+// resposta de cada tentativa (relogio do emulador mais ruido gaussiano
+// de medida) e se o acesso foi liberado.
+//
+// Primeiro descobre o tamanho da senha, depois um digito por vez. Em
+// cada etapa os candidatos sao amostrados em rodadas e eliminados assim
+// que o intervalo de confianca da media fica abaixo do melhor (eliminacao
+// sucessiva, um teste sequencial): candidatos muito piores saem logo e
+// so os parecidos continuam gastando tentativas. Se o orcamento da
+// etapa acabar sem um vencedor, o ataque desiste.
+//
+//   build/atacar_timing [--ruido MS] [--semente S] [--orcamento N]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <string>
+
+#include "Arduino.h"
+#include "emulador.h"
+#include "estatistica.h"
+
+bool verificarSenhaVulneravel(String senha);
+bool verificarSenhaSegura(const String &senha);
+bool sistemaOcioso();
+
+namespace {
+
+const int TAMANHO_MAXIMO = 8;
+const int MAX_CANDIDATOS = 10;
+const char DIGITOS[] = "0123456789";
+const double ERRO_POR_ETAPA = 0.001;
+
+void descartar(uint8_t, uint64_t) {
+}
+
+// Tentativa de senha vista de fora: tempo medido em ms e resultado
+class Oraculo {
+public:
+  Oraculo(bool (*verificar)(const String &), double ruidoMs, unsigned long semente)
+    : tentativas(0), msVirtuais(0), verificar(verificar),
+      ruido(0, ruidoMs > 0 ? ruidoMs : 1e-9), gerador(semente) {}
+
+  double medir(const std::string &senha, bool &liberado) {
+    uint64_t inicio = emu::ciclos();
+    liberado = verificar(String(senha.c_str()));
+    double ms = (emu::ciclos() - inicio) / (emu::CICLOS_POR_US * 1000.0);
+    tentativas++;
+    msVirtuais += ms;
+    return ms + ruido(gerador);
+  }
+
+  long tentativas;
+  double msVirtuais;
+
+private:
+  bool (*verificar)(const String &);
+  std::normal_distribution<double> ruido;
+  std::mt19937_64 gerador;
+};
+
+// Quantil da normal para o erro total da etapa dividido entre os
+// candidatos (Bonferroni). Aproximacao de Abramowitz-Stegun 26.2.23.
+double quantilNormal(double caudaSuperior) {
+  double t = sqrt(-2 * log(caudaSuperior));
+  return t - (2.515517 + 0.802853 * t + 0.010328 * t * t) /
+             (1 + 1.432788 * t + 0.189269 * t * t + 0.001308 * t * t * t);
+}
+
+// Eliminacao sucessiva entre 'total' candidatos; retorna o indice do
+// mais lento ou -1 se o orcamento acabar. 'liberada' recebe o indice de
+// uma tentativa que abriu o sistema, se houver.
+template <typename Montar>
+int escolherMaisLento(Oraculo &oraculo, int total, Montar montar, long orcamento, int &liberada) {
+  Acumulador medidas[MAX_CANDIDATOS];
+  bool ativo[MAX_CANDIDATOS];
+  int ativos = total;
+  for (int i = 0; i < total; i++) {
+    ativo[i] = true;
+  }
+  double z = quantilNormal(ERRO_POR_ETAPA / total);
+  long gastas = 0;
+  liberada = -1;
+
+  while (gastas < orcamento) {
+    for (int i = 0; i < total; i++) {
+      if (!ativo[i]) {
+        continue;
+      }
+      bool liberado;
+      medidas[i].adicionar(oraculo.medir(montar(i), liberado));
+      gastas++;
+      if (liberado) {
+        liberada = i;
+        return i;
+      }
+    }
+    if (medidas[0].n < 3) {
+      continue;
+    }
+
+    int melhor = -1;
+    for (int i = 0; i < total; i++) {
+      if (ativo[i] && (melhor < 0 || medidas[i].media > medidas[melhor].media)) {
+        melhor = i;
+      }
+    }
+    double piso = medidas[melhor].media - z * sqrt(medidas[melhor].variancia() / medidas[melhor].n);
+    for (int i = 0; i < total; i++) {
+      double teto = medidas[i].media + z * sqrt(medidas[i].variancia() / medidas[i].n);
+      if (ativo[i] && i != melhor && teto < piso) {
+        ativo[i] = false;
+        ativos--;
+      }
+    }
+    if (ativos == 1) {
+      return melhor;
+    }
+  }
+  return -1;
+}
+
+struct Resultado {
+  bool sucesso;
+  std::string senha;
+  long tentativas;
+  double msVirtuais;
+  double segundosHost;
+};
+
+Resultado atacar(const char *nome, bool (*verificar)(const String &), double ruidoMs,
+                 unsigned long semente, long orcamento) {
+  Oraculo oraculo(verificar, ruidoMs, semente);
+  Resultado r;
+  r.sucesso = false;
+  std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+
+  printf("%s\n", nome);
+  int liberada;
+  int tamanho = 1 + escolherMaisLento(oraculo, TAMANHO_MAXIMO,
+                                      [](int i) { return std::string(i + 1, '0'); },
+                                      orcamento, liberada);
+  if (tamanho == 0) {
+    printf("  tamanho: sem diferenca apos %ld tentativas, desistindo\n", oraculo.tentativas);
+  } else {
+    printf("  tamanho: %d (%ld tentativas)\n", tamanho, oraculo.tentativas);
+    std::string prefixo;
+    while ((int)prefixo.size() < tamanho) {
+      long antes = oraculo.tentativas;
+      std::string base = prefixo;
+      int resto = tamanho - (int)prefixo.size() - 1;
+      int d = escolherMaisLento(oraculo, 10,
+                                [&](int i) { return base + DIGITOS[i] + std::string(resto, '0'); },
+                                orcamento, liberada);
+      if (d < 0) {
+        printf("  digito %zu: sem diferenca apos %ld tentativas, desistindo\n",
+               prefixo.size() + 1, oraculo.tentativas - antes);
+        break;
+      }
+      prefixo += DIGITOS[d];
+      printf("  digito %zu: %c (%ld tentativas)%s\n", prefixo.size(), DIGITOS[d],
+             oraculo.tentativas - antes, liberada >= 0 ? " -> acesso liberado" : "");
+      if (liberada >= 0) {
+        r.sucesso = true;
+        break;
+      }
+    }
+    r.senha = prefixo;
+  }
+
+  r.tentativas = oraculo.tentativas;
+  r.msVirtuais = oraculo.msVirtuais;
+  r.segundosHost = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+  return r;
+}
+
+bool verificarVulneravel(const String &senha) {
+  return verificarSenhaVulneravel(senha);
+}
+
+}
+
+int main(int argc, char **argv) {
+  double ruidoMs = 50;
+  unsigned long semente = 1;
+  long orcamento = 5000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--ruido")) {
+      ruidoMs = strtod(argv[i + 1], NULL);
+    } else if (!strcmp(argv[i], "--semente")) {
+      semente = strtoul(argv[i + 1], NULL, 10);
+    } else if (!strcmp(argv[i], "--orcamento")) {
+      orcamento = strtol(argv[i + 1], NULL, 10);
+    } else {
+      fprintf(stderr, "uso: %s [--ruido MS] [--semente S] [--orcamento N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  emu::reiniciar();
+  emu::observarSerial(descartar);
+  emu::definirTimer2Ocioso(emu::varreduraTecladoOciosa);   // teclado_timer.h
+  emu::definirYieldOcioso(sistemaOcioso);
+  setup();
+
+  printf("ruido de medida: %.0f ms (desvio padrao), orcamento de %ld tentativas por etapa\n\n",
+         ruidoMs, orcamento);
+  Resultado vulneravel = atacar("verificarSenhaVulneravel", verificarVulneravel, ruidoMs, semente, orcamento);
+  Resultado segura = atacar("verificarSenhaSegura", verificarSenhaSegura, ruidoMs, semente, orcamento);
+
+  printf("\n%-12s | %-9s | %10s | %14s | %9s\n", "verificacao", "senha", "tentativas",
+         "verificando", "host");
+  printf("-------------+-----------+------------+----------------+----------\n");
+  const Resultado *rs[] = { &vulneravel, &segura };
+  const char *nomes[] = { "vulneravel", "segura" };
+  for (int i = 0; i < 2; i++) {
+    printf("%-12s | %-9s | %10ld | %12.1f s | %6.3f s\n", nomes[i],
+           rs[i]->sucesso ? rs[i]->senha.c_str() : "-", rs[i]->tentativas,
+           rs[i]->msVirtuais / 1000, rs[i]->segundosHost);
+  }
+  return vulneravel.sucesso && !segura.sucesso ? 0 : 1;
+}
@@ -0,0 +1,267 @@
+// Cenarios em bytecode (cenario.h) no projeto_1-modificado.
+//
+// 1. Interpretador: um cenario de teste com REPETIR aninhado, CHAMAR,
+//    ENVIAR_MSG e CONFERIR_MSG (um texto que aparece e um que nao), e o
+//    custo de executar() no loop() enquanto o cenario espera. Depois, um
+//    CONFERIR_MSG de texto que se sobrepoe a si mesmo ("=====" antes de
+//    "===== ATAQUE"), que uma busca sem voltar ao prefixo perderia, e um
+//    REPETIR com 0 vezes, que para o cenario.
+// 2. Os ataques do sketch (comandos 1 a 4 e AUTO) rodados duas vezes: com
+//    o loop() girando como no aparelho e com o relogio avancado direto
+//    ate o proximo passo do cenario (msAteProximoPasso()) ou ate a UART
+//    ter espaco. A saida serial e os LEDs no fim tem que ser iguais.
+//
+// Sai com 1 se o interpretador errar ou se as duas execucoes divergirem.
+#include <stdio.h>
+#include <chrono>
+#include <string>
+
+#include "Arduino.h"
+#include "emulador.h"
+#include "fila_serial.h"
+#include "cenario.h"
+#include "catalogo_projeto_1-modificado.h"
+
+// Do sketch
+extern Cenario cenario;
+extern FilaSerial<512> saida;
+
+namespace {
+
+const uint32_t US_POR_BYTE_SERIAL = 1042;   // 10 bits a 9600 baud
+const int CAPACIDADE_TX = 63;               // serialLivreParaEscrita() vazia
+
+std::string recebido;
+
+void guardar(uint8_t byte, uint64_t) {
+  recebido += (char)byte;
+}
+
+// ===== 1. Interpretador =====
+
+// Guarda a saida e manda a copia ao cenario, como FilaSerial::espelhar()
+class Texto : public Print {
+public:
+  size_t write(uint8_t c) {
+    conteudo += (char)c;
+    if (copia != NULL) {
+      copia->write(c);
+    }
+    return 1;
+  }
+  using Print::write;
+  std::string conteudo;
+  Print *copia;
+};
+
+Texto saidaTeste;
+std::string entradaTeste;
+unsigned acoesTeste = 0;
+
+void contar(uint8_t argumento) {
+  acoesTeste += argumento;
+}
+
+// Ecoa na saida, como um sketch respondendo ao que recebeu
+void receber(char c) {
+  entradaTeste += c;
+  saidaTeste.write((uint8_t)c);
+}
+
+void ledsTeste(uint8_t, uint8_t) {
+}
+
+const uint8_t SUB_TESTE[] PROGMEM = {
+  LINHA_MSG("CREDENCIAL EXPOSTA!"),
+  FIM_CENARIO
+};
+
+const uint8_t *const CENARIOS_TESTE[] PROGMEM = { SUB_TESTE };
+const AcaoCenario ACOES_TESTE[] PROGMEM = { contar };
+const RecursosCenario RECURSOS_TESTE PROGMEM = { CENARIOS_TESTE, ACOES_TESTE, receber, ledsTeste };
+
+const uint8_t CENARIO_TESTE[] PROGMEM = {
+  REPETIR(3),
+    REPETIR(2),
+      ACAO(0, 1),
+    FIM_REPETIR,
+    ESPERAR_MS(100),
+  FIM_REPETIR,
+  CHAMAR(0),
+  CONFERIR_MSG("[ENVIADO] DEBUG"),
+  ENVIAR_MSG("[ENVIADO] DEBUG"),
+  CONFERIR_MSG("SISTEMA COMPROMETIDO"),   // nunca aparece
+  ESPERAR_MS(5000),
+  FIM_CENARIO
+};
+
+bool interpretador() {
+  Cenario teste(saidaTeste, &RECURSOS_TESTE);
+  saidaTeste.conteudo.clear();
+  saidaTeste.copia = &teste;
+  teste.iniciar(CENARIO_TESTE);
+  unsigned long inicio = millis();
+  uint64_t maiorEspera = 0;
+  unsigned chamadas = 0;
+  bool terminou = false;
+  while (!terminou && millis() - inicio < 60000) {
+    uint64_t antes = emu::ciclos();
+    bool esperando = teste.msAteProximoPasso() > 0;
+    terminou = teste.executar();
+    uint64_t c = emu::ciclos() - antes;
+    if (esperando && c > maiorEspera) {
+      maiorEspera = c;
+    }
+    chamadas++;
+    emu::avancarMicros(100);
+  }
+  saidaTeste.copia = NULL;
+  unsigned long duracao = millis() - inicio;
+
+  bool ok = terminou && acoesTeste == 6 && duracao >= 5300 && duracao < 5310 &&
+            entradaTeste == "[ENVIADO] DEBUG" &&
+            saidaTeste.conteudo == "CREDENCIAL EXPOSTA!\r\n[ENVIADO] DEBUG" &&
+            teste.totalConferencias() == 2 && teste.conferenciasFalhas() == 1;
+  printf("Interpretador (REPETIR aninhado, CHAMAR, ENVIAR, CONFERIR):\n");
+  printf("  acoes %u de 6, %lu ms de espera (5300), entrada \"%s\"\n", acoesTeste, duracao,
+         entradaTeste.c_str());
+  printf("  conferencias %u, falhas %u (2 e 1)  %s\n", teste.totalConferencias(), teste.conferenciasFalhas(),
+         ok ? "ok" : "ERRADO");
+  printf("  executar() esperando: ate %llu ciclos por loop() (%u chamadas)\n",
+         (unsigned long long)maiorEspera, chamadas);
+  return ok;
+}
+
+// 33 '=' e so entao " ATAQUE": no sexto '=' o texto continua casado
+// em "=====", e nao so em "="
+const uint8_t CENARIO_SOBREPOSTO[] PROGMEM = {
+  CONFERIR_MSG("===== ATAQUE CONCLUIDO ====="),
+  ENVIAR_MSG("============================"),
+  ENVIAR_MSG("===== ATAQUE CONCLUIDO ====="),
+  FIM_CENARIO
+};
+
+bool conferenciaSobreposta() {
+  Cenario teste(saidaTeste, &RECURSOS_TESTE);
+  saidaTeste.conteudo.clear();
+  saidaTeste.copia = &teste;
+  teste.iniciar(CENARIO_SOBREPOSTO);
+  bool terminou = teste.executar();
+  saidaTeste.copia = NULL;
+
+  bool ok = terminou && teste.totalConferencias() == 1 && teste.conferenciasFalhas() == 0;
+  printf("  CONFERIR com sobreposicao: conferencias %u, falhas %u (1 e 0)  %s\n",
+         teste.totalConferencias(), teste.conferenciasFalhas(), ok ? "ok" : "ERRADO");
+  return ok;
+}
+
+// REPETIR(0) nao compila; em bytecode montado a mao, para o cenario
+// em vez de dar 256 voltas
+const uint8_t CENARIO_REPETIR_ZERO[] PROGMEM = {
+  OP_CENARIO_REPETIR, 0,
+    ACAO(0, 1),
+  FIM_REPETIR,
+  FIM_CENARIO
+};
+
+bool repetirZero() {
+  Cenario teste(saidaTeste, &RECURSOS_TESTE);
+  unsigned antes = acoesTeste;
+  teste.iniciar(CENARIO_REPETIR_ZERO);
+  bool terminou = teste.executar();
+  bool ok = terminou && acoesTeste == antes;
+  printf("  REPETIR com 0 vezes: %u acoes (0)  %s\n", acoesTeste - antes, ok ? "ok" : "ERRADO");
+  return ok;
+}
+
+// ===== 2. Ataques do sketch =====
+
+struct Execucao {
+  std::string saida;
+  uint8_t leds;
+  unsigned long msVirtuais;
+  uint64_t iteracoes;
+  double msHost;
+};
+
+// Vitima e alerta; o do Bus Pirate ainda pisca depois do ataque
+uint8_t lerLeds() {
+  return emu::lerPino(13) | emu::lerPino(11) << 1;
+}
+
+// Manda o comando e roda ate o cenario acabar e a serial esvaziar
+Execucao executar(const char *comando, bool rapido) {
+  Execucao e;
+  recebido.clear();
+  emu::agendarSerial(emu::micros(), std::string(comando) + "\n");
+  unsigned long inicio = millis();
+  std::chrono::steady_clock::time_point relogio = std::chrono::steady_clock::now();
+  e.iteracoes = 0;
+  bool comecou = false;
+  while (true) {
+    loop();
+    emu::avancarCiclos(emu::CUSTO_LOOP);
+    e.iteracoes++;
+    comecou |= cenario.ativo();
+    int naUart = CAPACIDADE_TX - emu::serialLivreParaEscrita();
+    if (comecou && !cenario.ativo() && saida.pendentes() == 0 && naUart == 0) {
+      break;
+    }
+    if (!rapido || emu::serialAgendadaPendente()) {
+      continue;
+    }
+    // Ate o proximo passo; com bytes na fila, so ate a UART os aceitar
+    uint64_t us = cenario.msAteProximoPasso() == SEM_PASSO ? UINT64_MAX
+                                                           : cenario.msAteProximoPasso() * 1000ULL;
+    if (saida.pendentes() > 0 || cenario.msAteProximoPasso() == SEM_PASSO) {
+      uint64_t uart = (uint64_t)naUart * US_POR_BYTE_SERIAL;
+      us = uart < us ? uart : us;
+    }
+    if (us > 0) {
+      emu::avancarMicros(us);
+    }
+  }
+  e.msHost = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - relogio).count();
+  e.msVirtuais = millis() - inicio;
+  e.saida = recebido;
+  e.leds = lerLeds();
+  return e;
+}
+
+bool ataques() {
+  printf("\nAtaques do projeto_1-modificado (normal x relogio avancado):\n");
+  printf("  %-7s | %8s | %10s %9s | %10s %9s | %s\n", "comando", "virtual", "iteracoes", "host", "iteracoes",
+         "host", "saida e LEDs");
+  const char *comandos[] = { "1", "2", "3", "4", "AUTO" };
+  bool ok = true;
+  for (size_t i = 0; i < sizeof(comandos) / sizeof(comandos[0]); i++) {
+    Execucao normal = executar(comandos[i], false);
+    Execucao rapida = executar(comandos[i], true);
+    bool iguais = normal.saida == rapida.saida && normal.leds == rapida.leds && !normal.saida.empty();
+    ok &= iguais;
+    printf("  %-7s | %6.1f s | %10llu %6.1f ms | %10llu %6.2f ms | %s (%u bytes)\n", comandos[i],
+           normal.msVirtuais / 1000.0, (unsigned long long)normal.iteracoes, normal.msHost,
+           (unsigned long long)rapida.iteracoes, rapida.msHost, iguais ? "iguais" : "DIFERENTES",
+           (unsigned)normal.saida.size());
+  }
+  return ok;
+}
+
+}
+
+int main() {
+  emu::reiniciar();
+  emu::observarSerial(guardar);
+  bool ok = interpretador();
+  ok &= conferenciaSobreposta();
+  ok &= repetirZero();
+
+  // O roteiro de inicio (Bus Pirate conectado) antes dos comandos
+  setup();
+  while (cenario.ativo() || saida.pendentes() > 0) {
+    loop();
+    emu::avancarCiclos(emu::CUSTO_LOOP);
+  }
+  ok &= ataques();
+  return ok ? 0 : 1;
+}
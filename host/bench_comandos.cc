@@ -0,0 +1,140 @@
+// Compara o tratamento de comandos do projeto_1 com buffers fixos contra
+// a versao anterior baseada em String (reproduzida aqui como referencia).
+// Mede o heap que a String usaria no AVR e o tempo por comando no host.
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "Arduino.h"
+#include "emulador.h"
+
+// Funcoes do sketch projeto_1.cc
+void processarComando(char *comando);
+
+namespace {
+
+// ===== Versao de referencia com String (projeto_1.cc original) =====
+String senhaReferencia = "1234";
+bool autenticadoReferencia = false;
+const int LED_REFERENCIA = 13;
+
+void processarComandoString(String comando) {
+  comando.trim();
+
+  Serial.println("CMD_LOG: " + comando);
+
+  if (comando.startsWith("AUTH:")) {
+    String senhaDigitada = comando.substring(5);
+    if (senhaDigitada == senhaReferencia) {
+      autenticadoReferencia = true;
+      Serial.println("ACESSO_LIBERADO");
+    } else {
+      Serial.println("ACESSO_NEGADO - Tentativa: " + senhaDigitada);
+    }
+    return;
+  }
+
+  if (autenticadoReferencia) {
+    if (comando == "LED_ON") {
+      digitalWrite(LED_REFERENCIA, HIGH);
+      Serial.println("LED_LIGADO");
+    }
+    else if (comando == "LED_OFF") {
+      digitalWrite(LED_REFERENCIA, LOW);
+      Serial.println("LED_DESLIGADO");
+    }
+    else if (comando == "STATUS") {
+      Serial.println("Sistema: ATIVO");
+      Serial.println("LED: " + String(digitalRead(LED_REFERENCIA) ? "ON" : "OFF"));
+      Serial.println("Tempo ligado: " + String(millis()) + "ms");
+    }
+    else if (comando == "DEBUG") {
+      Serial.println("=== INFORMAÇÕES CONFIDENCIAIS ===");
+      Serial.println("Senha do sistema: " + senhaReferencia);
+      Serial.println("Memória livre: 1024 bytes");
+      Serial.println("Versão: 1.0-BETA-INSECURE");
+    }
+  } else {
+    Serial.println("ERRO: Você precisa se autenticar primeiro");
+  }
+}
+
+void descartar(uint8_t, uint64_t) {
+}
+
+struct Medida {
+  uint64_t alocacoes;
+  int64_t picoHeap;
+  double nsPorComando;
+};
+
+const char *const COMANDOS[] = {
+  "AUTH:0000", "AUTH:1234", "LED_ON", "LED_OFF", "STATUS", "DEBUG",
+};
+const int TOTAL_COMANDOS = sizeof(COMANDOS) / sizeof(COMANDOS[0]);
+const int REPETICOES = 200000;
+
+template <class Funcao>
+Medida medir(const char *comando, Funcao executar) {
+  Medida m;
+
+  // Uma execucao isolada para o heap: alocacoes e pico acima do uso base
+  emu::zerarPicoHeap();
+  int64_t base = emu::estatisticas().bytesHeap;
+  uint64_t alocacoes = emu::estatisticas().alocacoesHeap;
+  executar(comando);
+  m.alocacoes = emu::estatisticas().alocacoesHeap - alocacoes;
+  m.picoHeap = emu::estatisticas().picoHeap - base;
+
+  std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+  for (int i = 0; i < REPETICOES; i++) {
+    executar(comando);
+  }
+  std::chrono::duration<double, std::nano> decorrido = std::chrono::steady_clock::now() - inicio;
+  m.nsPorComando = decorrido.count() / REPETICOES;
+  return m;
+}
+
+void executarString(const char *comando) {
+  processarComandoString(String(comando));
+}
+
+void executarBuffer(const char *comando) {
+  char buffer[32];
+  strncpy(buffer, comando, sizeof(buffer) - 1);
+  buffer[sizeof(buffer) - 1] = '\0';
+  processarComando(buffer);
+}
+
+}
+
+int main() {
+  emu::reiniciar();
+  emu::observarSerial(descartar);
+  // Sem espera da UART: so o custo de montar as respostas importa aqui
+  emu::configurarSerial(100000000UL);
+
+  printf("%-10s | %22s | %22s | %17s\n", "comando", "alocacoes (String/buf)",
+         "pico heap B (String/buf)", "ns host (String/buf)");
+  printf("-----------+------------------------+------------------------+------------------\n");
+
+  uint64_t totalAlocacoes[2] = { 0, 0 };
+  int64_t maiorPico[2] = { 0, 0 };
+  for (int i = 0; i < TOTAL_COMANDOS; i++) {
+    Medida s = medir(COMANDOS[i], executarString);
+    Medida b = medir(COMANDOS[i], executarBuffer);
+    printf("%-10s | %10llu / %-9llu | %10lld / %-9lld | %7.1f / %-7.1f\n", COMANDOS[i],
+           (unsigned long long)s.alocacoes, (unsigned long long)b.alocacoes,
+           (long long)s.picoHeap, (long long)b.picoHeap, s.nsPorComando, b.nsPorComando);
+    totalAlocacoes[0] += s.alocacoes;
+    totalAlocacoes[1] += b.alocacoes;
+    maiorPico[0] = max(maiorPico[0], s.picoHeap);
+    maiorPico[1] = max(maiorPico[1], b.picoHeap);
+  }
+
+  printf("\nTotal: %llu alocacoes com String, %llu com buffers fixos\n",
+         (unsigned long long)totalAlocacoes[0], (unsigned long long)totalAlocacoes[1]);
+  printf("Pico de heap por comando: %lld bytes com String, %lld com buffers fixos\n",
+         (long long)maiorPico[0], (long long)maiorPico[1]);
+  return 0;
+}
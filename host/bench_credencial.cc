@@ -0,0 +1,222 @@
+// Custo da verificacao por resumo com sal (credencial.h, sha256.h) no
+// projeto_2-timing_attack-corrigido.
+//
+// Primeiro confere o SHA-256 e o HMAC com os vetores de teste da FIPS
+// 180-4 e da RFC 4231 (sai com 1 se algum falhar). Depois mede o tempo no
+// host e estima os ciclos no ATmega328P.
+//
+// O emulador nao conta as instrucoes do AVR, entao a estimativa sai de
+// um modelo: quantas operacoes de 32 bits a compressao faz (contadas no
+// codigo de sha256.h) vezes o custo de cada uma no AVR, onde uma palavra
+// ocupa 4 registradores e as instrucoes de 8 bits custam 1 ciclo (lpm 3,
+// ld/st 2). O estado, os temporarios e o ponteiro nao cabem juntos nos
+// 32 registradores; o modelo conta 4 palavras lidas da pilha e 2 gravadas
+// por rodada. O resultado e comparado com o orcamento do loop() do
+// sketch (ORCAMENTO_LOOP_US, 10 ms): a verificacao roda dentro de uma
+// iteracao.
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "Arduino.h"
+#include "emulador.h"
+#include "sha256.h"
+#include "credencial.h"
+
+bool verificarSenhaSegura(const String &senha);
+
+namespace {
+
+const double ORCAMENTO_MS = 10.0;   // ORCAMENTO_LOOP_US do sketch
+
+// ===== Vetores de teste =====
+
+bool conferir(const char *nome, const uint8_t *resumo, const char *esperadoHex) {
+  char hex[2 * TAMANHO_RESUMO_SHA256 + 1];
+  for (int i = 0; i < TAMANHO_RESUMO_SHA256; i++) {
+    snprintf(hex + 2 * i, 3, "%02x", resumo[i]);
+  }
+  bool ok = strcmp(hex, esperadoHex) == 0;
+  printf("  %-34s %s\n", nome, ok ? "ok" : "FALHOU");
+  if (!ok) {
+    printf("    esperado %s\n    obtido   %s\n", esperadoHex, hex);
+  }
+  return ok;
+}
+
+bool conferirSha(const char *nome, const char *texto, size_t repeticoes, const char *esperado) {
+  Sha256 sha;
+  for (size_t i = 0; i < repeticoes; i++) {
+    sha.adicionar((const uint8_t *)texto, strlen(texto));
+  }
+  uint8_t resumo[TAMANHO_RESUMO_SHA256];
+  sha.finalizar(resumo);
+  return conferir(nome, resumo, esperado);
+}
+
+bool conferirHmac(const char *nome, uint8_t byteChave, size_t tamanhoChave, const char *mensagem,
+                  const char *esperado) {
+  uint8_t chave[131];
+  memset(chave, byteChave, tamanhoChave);
+  uint8_t resumo[TAMANHO_RESUMO_SHA256];
+  hmacSha256(chave, tamanhoChave, (const uint8_t *)mensagem, strlen(mensagem), resumo);
+  return conferir(nome, resumo, esperado);
+}
+
+bool vetoresDeTeste() {
+  printf("Vetores de teste:\n");
+  bool ok = true;
+  ok &= conferirSha("SHA-256 \"\"", "", 1,
+                    "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  ok &= conferirSha("SHA-256 \"abc\"", "abc", 1,
+                    "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  ok &= conferirSha("SHA-256 2 blocos", "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+                    "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+  ok &= conferirSha("SHA-256 1000000 x \"a\"", "a", 1000000,
+                    "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+  ok &= conferirHmac("HMAC RFC 4231 caso 1", 0x0b, 20, "Hi There",
+                     "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+  ok &= conferirHmac("HMAC RFC 4231 caso 6 (chave longa)", 0xaa, 131,
+                     "Test Using Larger Than Block-Size Key - Hash Key First",
+                     "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+  return ok;
+}
+
+// ===== Modelo de ciclos no AVR =====
+
+const int LOGICA = 4;        // and/or/eor nos 4 bytes
+const int SOMA = 4;          // add + 3 adc
+const int COPIA = 2;         // 2 movw
+const int DESLOCA_BIT = 4;   // lsr + 3 ror
+const int ROTACAO_BIT = 6;   // bst, lsr, 3 ror, bld
+const int LE_FLASH = 12;     // 4 lpm Z+
+const int LE_RAM = 8;        // 4 ld/ldd
+const int ESCREVE_RAM = 8;   // 4 st/std
+
+// Bytes inteiros sao renomeados (uma copia); os bits que sobram giram
+// para o lado mais curto
+int rotacao(int n) {
+  int bits = n % 8;
+  return COPIA + ROTACAO_BIT * (bits <= 4 ? bits : 8 - bits);
+}
+
+int deslocamento(int n) {
+  return COPIA + DESLOCA_BIT * (n % 8);
+}
+
+struct Parte {
+  const char *nome;
+  int ciclos;
+  int vezes;
+};
+
+void modeloAvr(double *ciclosBloco) {
+  int sigma1 = rotacao(6) + rotacao(11) + rotacao(25) + 2 * LOGICA;
+  int escolha = COPIA + 3 * LOGICA;
+  int sigma0 = rotacao(2) + rotacao(13) + rotacao(22) + 2 * LOGICA;
+  int maioria = COPIA + 4 * LOGICA;
+  // t1 = h + S1 + Ch + kw, kw = K + W, d += t1, h = t1 + S0 + Maj
+  int somasRodada = 7 * SOMA;
+  int acessosRodada = LE_FLASH + LE_RAM + 4 * LE_RAM + 2 * ESCREVE_RAM;
+  int rodada = sigma1 + escolha + sigma0 + maioria + somasRodada + acessosRodada;
+
+  int expansao = rotacao(7) + rotacao(18) + deslocamento(3) + 2 * LOGICA +
+                 rotacao(17) + rotacao(19) + deslocamento(10) + 2 * LOGICA +
+                 3 * SOMA + 4 * LE_RAM + ESCREVE_RAM;
+
+  Parte partes[] = {
+    { "rodada (S0, S1, Ch, Maj, 7 somas)", rodada, 64 },
+    { "expansao de W (s0, s1, 3 somas)", expansao, 48 },
+    { "carga do bloco (big-endian)", 4 * 2 + ESCREVE_RAM, 16 },
+    { "estado: carga e soma final", LE_RAM + SOMA + ESCREVE_RAM, 8 },
+  };
+  printf("\nModelo da compressao no AVR (ciclos):\n");
+  printf("  %-36s %8s %6s %8s\n", "parte", "por vez", "vezes", "total");
+  double total = 0;
+  for (size_t i = 0; i < sizeof(partes) / sizeof(partes[0]); i++) {
+    int t = partes[i].ciclos * partes[i].vezes;
+    total += t;
+    printf("  %-36s %8d %6d %8d\n", partes[i].nome, partes[i].ciclos, partes[i].vezes, t);
+  }
+  printf("  %-36s %8s %6s %8.0f\n", "por bloco", "", "", total);
+  *ciclosBloco = total;
+}
+
+// Blocos comprimidos por um HMAC com chave de ate 64 bytes
+int blocosHmac(int tamanhoMensagem) {
+  int interno = (TAMANHO_BLOCO_SHA256 + tamanhoMensagem + 9 + 63) / 64;
+  int externo = (TAMANHO_BLOCO_SHA256 + TAMANHO_RESUMO_SHA256 + 9 + 63) / 64;
+  return interno + externo;
+}
+
+// ===== Tempo no host =====
+
+template <typename F>
+double nsPorChamada(F f, int chamadas) {
+  double melhor = 1e30;
+  for (int lote = 0; lote < 20; lote++) {
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < chamadas; i++) {
+      f();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - inicio).count();
+    if (ns / chamadas < melhor) {
+      melhor = ns / chamadas;
+    }
+  }
+  return melhor;
+}
+
+void descartar(uint8_t, uint64_t) {
+}
+
+}
+
+int main() {
+  if (!vetoresDeTeste()) {
+    return 1;
+  }
+
+  emu::reiniciar();
+  emu::observarSerial(descartar);
+  setup();
+
+  double ciclosBloco;
+  modeloAvr(&ciclosBloco);
+
+  uint8_t bloco[TAMANHO_BLOCO_SHA256] = { 0 };
+  volatile uint8_t afundar = 0;
+  double nsBloco = nsPorChamada([&]() {
+    Sha256 sha;
+    sha.adicionar(bloco, 55);   // 55 bytes + enchimento = 1 compressao
+    uint8_t resumo[TAMANHO_RESUMO_SHA256];
+    sha.finalizar(resumo);
+    afundar ^= resumo[0];
+  }, 20000);
+
+  printf("\nVerificacao (HMAC-SHA256 com sal de %d bytes + comparacao de %d bytes):\n",
+         TAMANHO_SAL, TAMANHO_RESUMO_SHA256);
+  printf("  %-10s | %6s | %12s | %9s | %10s | %s\n", "senha", "blocos", "AVR (ciclos)", "AVR (ms)",
+         "host (ns)", "orcamento");
+  printf("  -----------+--------+--------------+-----------+------------+----------\n");
+  const char *entradas[] = { "0000", "1230", "1234", "12345678" };
+  bool cabe = true;
+  for (size_t i = 0; i < sizeof(entradas) / sizeof(entradas[0]); i++) {
+    String senha = entradas[i];
+    int blocos = blocosHmac(senha.length());
+    // Alem das compressoes: a copia byte a byte em adicionar() e o XOR
+    // da chave (~10 ciclos por byte) e a comparacao final
+    double ciclos = blocos * ciclosBloco + 10.0 * (blocos * TAMANHO_BLOCO_SHA256 + 2 * TAMANHO_BLOCO_SHA256) +
+                    TAMANHO_RESUMO_SHA256 * 6;
+    double ms = ciclos / (emu::FREQUENCIA_CPU / 1000.0);
+    double ns = nsPorChamada([&]() { afundar ^= verificarSenhaSegura(senha); }, 20000);
+    cabe = cabe && ms < ORCAMENTO_MS;
+    printf("  %-10s | %6d | %12.0f | %9.2f | %10.1f | %s\n", entradas[i], blocos, ciclos, ms, ns,
+           ms < ORCAMENTO_MS ? "cabe" : "PASSA");
+  }
+  printf("\nHost: %.1f ns por compressao. AVR (modelo): %.0f ciclos por bloco, %.0f ciclos/byte\n",
+         nsBloco, ciclosBloco, ciclosBloco / TAMANHO_BLOCO_SHA256);
+  printf("Orcamento do loop(): %.0f ms -> %s\n", ORCAMENTO_MS,
+         cabe ? "a verificacao cabe numa iteracao" : "a verificacao passa do orcamento");
+  return 0;
+}
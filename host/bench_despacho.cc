@@ -0,0 +1,154 @@
+// Compara a busca na tabela de comandos com hash perfeito
+// (tabela_comandos.h) contra a cadeia de if/else com comparacao de texto
+// que os sketches usavam, com 5 e com 16 comandos.
+//
+// Alem do tempo no host, conta os bytes lidos da entrada e dos nomes:
+// no AVR o custo das duas buscas e proporcional a esse numero.
+//
+// Antes, confere as opcoes de argumento: "AUTH" sem senha e "LED_ON:x"
+// nao sao comandos, como na cadeia de if/else. Sai com 1 se errar.
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "Arduino.h"
+#include "tabela_comandos.h"
+
+namespace {
+
+void nada(const char *) {
+}
+
+constexpr Comando COMANDOS_5[] PROGMEM = {
+  { "AUTH", nada, 0 }, { "LED_ON", nada, 0 }, { "LED_OFF", nada, 0 },
+  { "STATUS", nada, 0 }, { "DEBUG", nada, 0 },
+};
+constexpr IndiceComandos INDICE_5 PROGMEM = GERAR_INDICE_COMANDOS(COMANDOS_5);
+
+constexpr Comando COMANDOS_16[] PROGMEM = {
+  { "AUTH", nada, 0 }, { "LED_ON", nada, 0 }, { "LED_OFF", nada, 0 },
+  { "STATUS", nada, 0 }, { "DEBUG", nada, 0 }, { "RESET", nada, 0 },
+  { "MODO", nada, 0 }, { "VERSAO", nada, 0 }, { "LOGOUT", nada, 0 },
+  { "PISCAR", nada, 0 }, { "TEMPO", nada, 0 }, { "SENHA", nada, 0 },
+  { "BLOQ", nada, 0 }, { "AJUDA", nada, 0 }, { "METRICS", nada, 0 },
+  { "ECO", nada, 0 },
+};
+constexpr IndiceComandos INDICE_16 PROGMEM = GERAR_INDICE_COMANDOS(COMANDOS_16);
+
+unsigned long bytesLidos = 0;
+
+// strcmp que conta quantos bytes examinou
+int compararContando(const char *a, const char *b) {
+  while (true) {
+    bytesLidos++;
+    if (*a != *b || !*a) {
+      return (unsigned char)*a - (unsigned char)*b;
+    }
+    a++;
+    b++;
+  }
+}
+
+// Equivalente a "if (cmd == A) ... else if (cmd == B) ..." com o nome
+// ja separado do argumento
+template <size_t N>
+int buscarEmCadeia(const Comando (&tabela)[N], const char *nome) {
+  for (size_t i = 0; i < N; i++) {
+    if (compararContando(nome, tabela[i].nome) == 0) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+template <size_t N>
+int buscarComHash(const Comando (&tabela)[N], const IndiceComandos &indice, char *linha) {
+  char *argumento;
+  const Comando *c = buscarComando(tabela, indice, linha, &argumento);
+  // Uma passada no nome para o hash e outra no strcmp_P de confirmacao
+  bytesLidos += 2 * (argumento - linha) + 1;
+  return c ? (int)(c - tabela) : -1;
+}
+
+// Como a tabela do projeto_1
+constexpr Comando COMANDOS_ARGUMENTO[] PROGMEM = {
+  { "AUTH", nada, COMANDO_EXIGE_ARGUMENTO }, { "LED_ON", nada, COMANDO_SEM_ARGUMENTO },
+  { "METRICS", nada, 0 },
+};
+constexpr IndiceComandos INDICE_ARGUMENTO PROGMEM = GERAR_INDICE_COMANDOS(COMANDOS_ARGUMENTO);
+
+bool conferirArgumentos() {
+  struct Caso {
+    const char *linha;
+    int esperado;   // posicao na tabela, -1 = nenhum comando
+  };
+  const Caso casos[] = {
+    { "AUTH:1234", 0 }, { "AUTH", -1 }, { "AUTH:", -1 },
+    { "LED_ON", 1 }, { "LED_ON:x", -1 }, { "LED_ON:", -1 },
+    { "METRICS", 2 }, { "METRICS:ZERAR", 2 },
+  };
+  bool ok = true;
+  printf("argumentos:");
+  for (size_t i = 0; i < sizeof(casos) / sizeof(casos[0]); i++) {
+    char linha[16];
+    strcpy(linha, casos[i].linha);
+    int achado = buscarComHash(COMANDOS_ARGUMENTO, INDICE_ARGUMENTO, linha);
+    if (achado != casos[i].esperado) {
+      printf(" \"%s\" -> %d (esperado %d)", casos[i].linha, achado, casos[i].esperado);
+      ok = false;
+    }
+  }
+  printf(" %s\n\n", ok ? "ok" : "ERRADO");
+  return ok;
+}
+
+const int REPETICOES = 1000000;
+
+template <size_t N>
+void comparar(const char *titulo, const Comando (&tabela)[N], const IndiceComandos &indice) {
+  // Todos os comandos da tabela e um desconhecido
+  const char *entradas[N + 1];
+  for (size_t i = 0; i < N; i++) {
+    entradas[i] = tabela[i].nome;
+  }
+  entradas[N] = "FOO";
+
+  double ns[2];
+  unsigned long bytes[2];
+  for (int modo = 0; modo < 2; modo++) {
+    volatile int soma = 0;
+    char linha[TAMANHO_NOME_COMANDO + 1];
+
+    bytesLidos = 0;
+    for (size_t e = 0; e <= N; e++) {
+      strcpy(linha, entradas[e]);
+      soma += modo == 0 ? buscarEmCadeia(tabela, linha) : buscarComHash(tabela, indice, linha);
+    }
+    bytes[modo] = bytesLidos;
+
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    for (int r = 0; r < REPETICOES; r++) {
+      size_t e = r % (N + 1);
+      strcpy(linha, entradas[e]);
+      soma += modo == 0 ? buscarEmCadeia(tabela, linha) : buscarComHash(tabela, indice, linha);
+    }
+    std::chrono::duration<double, std::nano> d = std::chrono::steady_clock::now() - inicio;
+    ns[modo] = d.count() / REPETICOES;
+  }
+
+  printf("%-12s | %8.1f / %-8.1f | %10.1f / %-10.1f\n", titulo, ns[0], ns[1],
+         (double)bytes[0] / (N + 1), (double)bytes[1] / (N + 1));
+}
+
+}
+
+int main() {
+  printf("multiplicadores: %u (5 comandos), %u (16 comandos)\n\n",
+         pgm_read_word(&INDICE_5.multiplicador), pgm_read_word(&INDICE_16.multiplicador));
+  bool ok = conferirArgumentos();
+  printf("%-12s | %19s | %23s\n", "tabela", "ns host (if/hash)", "bytes lidos (if/hash)");
+  printf("-------------+---------------------+------------------------\n");
+  comparar("5 comandos", COMANDOS_5, INDICE_5);
+  comparar("16 comandos", COMANDOS_16, INDICE_16);
+  return ok ? 0 : 1;
+}
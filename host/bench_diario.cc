@@ -0,0 +1,253 @@
+// Diario de estado na EEPROM (diario_eeprom.h) com o formato dos sketches
+// do projeto_2: registros de 8 bytes num anel de 256 bytes.
+//
+// 1. Recuperacao no boot: com a EEPROM apagada, com poucos registros e
+//    com o anel ja dando voltas, quanto tempo recuperar() leva e se acha
+//    o mais novo. Depois corta a energia no meio de um registro (para de
+//    gravar depois de k bytes) em varios pontos do anel: a volta tem que
+//    dar o registro anterior ou o novo inteiro, nunca outra coisa.
+// 2. Caminho da tecla: o custo de agendar() (so RAM, que o emulador nao
+//    cobra) e de cada bombear(), que nao pode esperar pela EEPROM, e o da
+//    gravacao imediata do '#'.
+// 3. Desgaste num dia carregado, comparado a gravar o estado sempre no
+//    mesmo endereco (EEPROM.put): escritas por celula por dia e anos ate
+//    as 100 mil escritas que a EEPROM do AVR garante.
+//
+// Sai com 1 se alguma recuperacao der errado ou se bombear() esperar.
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "emulador.h"
+#include "diario_eeprom.h"
+
+namespace {
+
+struct EstadoSalvo {   // o mesmo dos sketches
+  uint16_t segundosBloqueio;
+  uint8_t fichas;
+  uint8_t nivel;
+  uint8_t modos;
+  uint8_t falhas;
+};
+
+const uint16_t INICIO_DIARIO = 768;
+const uint16_t TAMANHO_DIARIO = 256;
+const uint16_t ENDERECO_FIXO = 0;           // para a comparacao
+const unsigned long ATRASO_MS = 3000;
+const double ENDURANCE = 100000;
+typedef DiarioEeprom<EstadoSalvo, INICIO_DIARIO, TAMANHO_DIARIO> Diario;
+
+EstadoSalvo estadoNumero(unsigned n) {
+  EstadoSalvo e;
+  e.segundosBloqueio = (uint16_t)(n * 7);
+  e.fichas = n % 4;
+  e.nivel = n % 5;
+  e.modos = n % 3;
+  e.falhas = (uint8_t)n;
+  return e;
+}
+
+bool iguais(const EstadoSalvo &a, const EstadoSalvo &b) {
+  return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+// Grava os estados 1..n em sequencia, cada um inteiro
+void gravar(Diario &diario, unsigned de, unsigned ate) {
+  for (unsigned n = de; n <= ate; n++) {
+    diario.gravarAgora(estadoNumero(n));
+    diario.concluir();
+  }
+}
+
+// Um boot: objeto novo, como depois de um reset
+bool recuperar(EstadoSalvo &estado, double &us) {
+  Diario diario(ATRASO_MS);
+  emu::avancarMicros(emu::US_ESCRITA_EEPROM);
+  uint64_t inicio = emu::ciclos();
+  bool ok = diario.recuperar(estado);
+  us = (emu::ciclos() - inicio) / (double)emu::CICLOS_POR_US;
+  return ok;
+}
+
+bool recuperacao() {
+  printf("Recuperacao no boot (%u registros de %u bytes):\n", Diario::REGISTROS, Diario::TAMANHO_REGISTRO);
+  printf("  %-28s | %9s | %s\n", "EEPROM", "tempo", "resultado");
+  bool ok = true;
+  emu::apagarEeprom();
+  EstadoSalvo estado;
+  double us;
+  bool achou = recuperar(estado, us);
+  printf("  %-28s | %6.0f us | %s\n", "apagada", us, achou ? "ERRADO" : "nada (ok)");
+  ok &= !achou;
+
+  const unsigned totais[] = { 1, 5, 31, 32, 33, 100, 1000 };
+  unsigned gravados = 0;
+  Diario diario(ATRASO_MS);
+  double pior = 0;
+  for (size_t i = 0; i < sizeof(totais) / sizeof(totais[0]); i++) {
+    gravar(diario, gravados + 1, totais[i]);
+    gravados = totais[i];
+    achou = recuperar(estado, us);
+    bool certo = achou && iguais(estado, estadoNumero(gravados));
+    char rotulo[40];
+    snprintf(rotulo, sizeof(rotulo), "%u gravacoes", gravados);
+    printf("  %-28s | %6.0f us | %s\n", rotulo, us, certo ? "o mais novo (ok)" : "ERRADO");
+    ok &= certo;
+    if (us > pior) {
+      pior = us;
+    }
+  }
+
+  // Corte de energia depois de k bytes do registro seguinte
+  unsigned cortes = 0, errados = 0;
+  for (unsigned volta = 0; volta < Diario::REGISTROS + 3; volta++) {
+    for (uint8_t k = 0; k <= Diario::TAMANHO_REGISTRO; k++) {
+      Diario atual(ATRASO_MS);
+      EstadoSalvo anterior;
+      atual.recuperar(anterior);
+      EstadoSalvo novo = estadoNumero(++gravados);
+      atual.agendar(novo, 0);
+      for (uint8_t escritos = 0; escritos < k && !atual.ocioso(); escritos++) {
+        emu::avancarMicros(emu::US_ESCRITA_EEPROM);
+        atual.bombear(ATRASO_MS);
+      }
+      bool certo = recuperar(estado, us) && (iguais(estado, novo) || iguais(estado, anterior));
+      cortes++;
+      errados += !certo;
+      if (us > pior) {
+        pior = us;
+      }
+      // Termina o registro para a proxima rodada partir dele
+      Diario seguinte(ATRASO_MS);
+      seguinte.recuperar(estado);
+      seguinte.gravarAgora(novo);
+      seguinte.concluir();
+    }
+  }
+  printf("  %-28s | %6.0f us | %u cortes, %s\n", "corte no meio do registro", pior, cortes,
+         errados ? "ERRADO" : "sempre o anterior ou o novo (ok)");
+  ok &= errados == 0;
+  printf("  Pior tempo de recuperacao com registros: %.0f us\n", pior);
+  return ok;
+}
+
+bool caminhoDaTecla() {
+  emu::apagarEeprom();
+  Diario diario(ATRASO_MS);
+  emu::avancarMicros(emu::US_ESCRITA_EEPROM);
+  uint64_t espera = emu::estatisticas().ciclosEsperaEeprom;
+
+  uint64_t inicio = emu::ciclos();
+  diario.agendar(estadoNumero(1), 0);
+  uint64_t ciclosAgendar = emu::ciclos() - inicio;
+
+  // Um loop() a cada 1 ms ate o registro terminar
+  uint64_t maiorBombear = 0;
+  unsigned long ms = 0;
+  unsigned chamadas = 0;
+  while (!diario.ocioso()) {
+    emu::avancarMicros(1000);
+    ms++;
+    inicio = emu::ciclos();
+    diario.bombear(ms);
+    uint64_t c = emu::ciclos() - inicio;
+    if (c > maiorBombear) {
+      maiorBombear = c;
+    }
+    chamadas++;
+  }
+  bool semEspera = emu::estatisticas().ciclosEsperaEeprom == espera;
+
+  emu::avancarMicros(emu::US_ESCRITA_EEPROM);
+  inicio = emu::ciclos();
+  diario.gravarAgora(estadoNumero(2));
+  diario.concluir();
+  double msImediato = (emu::ciclos() - inicio) / (emu::CICLOS_POR_US * 1000.0);
+
+  printf("\nCaminho da tecla:\n");
+  printf("  agendar()                    %6llu ciclos\n", (unsigned long long)ciclosAgendar);
+  printf("  bombear() (pior de %4u)      %6llu ciclos, %s\n", chamadas, (unsigned long long)maiorBombear,
+         semEspera ? "sem esperar a EEPROM" : "ESPEROU A EEPROM");
+  printf("  gravarAgora() + concluir()   %6.1f ms (o '#', antes da resposta)\n", msImediato);
+  return semEspera;
+}
+
+// Um dia carregado: 200 senhas (1 em 4 certa), 30 trocas de modo em
+// rajadas de 3 e 10 bloqueios que terminam
+void desgaste() {
+  emu::apagarEeprom();
+  Diario diario(ATRASO_MS);
+  EstadoSalvo estado = estadoNumero(0);
+  unsigned long agora = 0;
+  unsigned salvamentos = 0;
+
+  auto esperar = [&](unsigned long ms) {
+    for (unsigned long fim = agora + ms; agora < fim; agora += 10) {
+      emu::avancarMicros(10000);
+      diario.bombear(agora);
+    }
+  };
+  auto fixo = [&]() {
+    EEPROM.put(ENDERECO_FIXO, estado);
+    salvamentos++;
+  };
+
+  for (int i = 0; i < 200; i++) {
+    estado.fichas = (estado.fichas + 2) % 4;
+    estado.falhas++;
+    diario.gravarAgora(estado);
+    diario.concluir();
+    fixo();
+    if (i % 4 == 0) {
+      estado.fichas = 3;
+      estado.falhas--;
+      diario.agendar(estado, agora);
+      fixo();
+    }
+    if (i % 20 == 0) {
+      estado.segundosBloqueio = 0;
+      estado.nivel++;
+      diario.agendar(estado, agora);
+      fixo();
+    }
+    esperar(5000);
+  }
+  for (int i = 0; i < 30; i++) {
+    estado.modos ^= 1 << (i % 2);
+    diario.agendar(estado, agora);
+    fixo();
+    esperar(i % 3 == 2 ? 5000 : 500);
+  }
+  esperar(ATRASO_MS + 100);
+
+  uint32_t piorDiario = 0, piorFixo = 0;
+  for (uint16_t i = 0; i < TAMANHO_DIARIO; i++) {
+    uint32_t e = emu::escritasNaCelulaEeprom(INICIO_DIARIO + i);
+    if (e > piorDiario) {
+      piorDiario = e;
+    }
+  }
+  for (uint16_t i = 0; i < sizeof(EstadoSalvo); i++) {
+    uint32_t e = emu::escritasNaCelulaEeprom(ENDERECO_FIXO + i);
+    if (e > piorFixo) {
+      piorFixo = e;
+    }
+  }
+  printf("\nDesgaste num dia carregado (%u mudancas de estado):\n", salvamentos);
+  printf("  %-26s | %10s | %16s | %s\n", "", "registros", "escritas/celula", "vida (100 mil)");
+  printf("  %-26s | %10s | %16u | %8.1f anos\n", "endereco fixo (put)", "-", (unsigned)piorFixo,
+         ENDURANCE / piorFixo / 365);
+  printf("  %-26s | %10lu | %16u | %8.1f anos\n", "diario (32 registros)", diario.totalGravacoes(),
+         (unsigned)piorDiario, ENDURANCE / piorDiario / 365);
+  printf("  %lu mudancas juntadas antes de gravar\n", diario.totalCoalescidas());
+}
+
+}
+
+int main() {
+  emu::reiniciar();
+  bool ok = recuperacao();
+  ok &= caminhoDaTecla();
+  desgaste();
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// Compara digitalWrite() com o acesso direto as portas (gpio_direto.h)
+// em ciclos do relogio virtual: acender e apagar os tres LEDs do
+// projeto_1-modificado (pinos 13, 12 e 11, todos na PORTB), ligar um
+// pino so e inverter um pino.
+//
+// O emulador cobra o custo das instrucoes de I/O (out, sbi/cbi) e o das
+// funcoes do core; a aritmetica de mascaras em volta nao e cobrada, mas
+// com pinos constantes o compilador do AVR a resolve na compilacao.
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "emulador.h"
+#include "gpio_direto.h"
+
+namespace {
+
+typedef GrupoPinos<13, 12, 11> Leds;
+typedef PinoDireto<13> LedVitima;
+
+const int REPETICOES = 1000;
+
+template <class Operacao>
+double medir(Operacao operacao) {
+  uint64_t inicio = emu::ciclos();
+  for (int i = 0; i < REPETICOES; i++) {
+    operacao(i);
+  }
+  return (double)(emu::ciclos() - inicio) / REPETICOES;
+}
+
+void tresLedsDigitalWrite(int i) {
+  uint8_t nivel = i & 1 ? LOW : HIGH;
+  digitalWrite(13, nivel);
+  digitalWrite(12, nivel);
+  digitalWrite(11, nivel);
+}
+
+void tresLedsPinoAPino(int i) {
+  if (i & 1) {
+    PinoDireto<13>::desligar();
+    PinoDireto<12>::desligar();
+    PinoDireto<11>::desligar();
+  } else {
+    PinoDireto<13>::ligar();
+    PinoDireto<12>::ligar();
+    PinoDireto<11>::ligar();
+  }
+}
+
+void tresLedsGrupo(int i) {
+  Leds::escrever(i & 1 ? 0 : 0x07);
+}
+
+void umPinoDigitalWrite(int i) {
+  digitalWrite(13, i & 1 ? LOW : HIGH);
+}
+
+void umPinoDireto(int i) {
+  LedVitima::escrever(!(i & 1));
+}
+
+void inverterDigitalWrite(int) {
+  digitalWrite(13, !digitalRead(13));
+}
+
+void inverterDireto(int) {
+  LedVitima::alternar();
+}
+
+void linha(const char *operacao, double antes, double depois) {
+  printf("%-24s | %12.1f | %12.1f | %6.1fx\n", operacao, antes, depois, antes / depois);
+}
+
+}
+
+int main() {
+  emu::reiniciar();
+  pinMode(13, OUTPUT);
+  pinMode(12, OUTPUT);
+  pinMode(11, OUTPUT);
+  pinMode(8, OUTPUT);
+
+  printf("%-24s | %12s | %12s | %s\n", "operacao", "digitalWrite", "direto", "ganho");
+  printf("-------------------------+--------------+--------------+--------\n");
+  linha("3 LEDs (pino a pino)", medir(tresLedsDigitalWrite), medir(tresLedsPinoAPino));
+  linha("3 LEDs (grupo, 1 out)", medir(tresLedsDigitalWrite), medir(tresLedsGrupo));
+  linha("1 pino", medir(umPinoDigitalWrite), medir(umPinoDireto));
+  linha("inverter 1 pino", medir(inverterDigitalWrite), medir(inverterDireto));
+
+  // A escrita do grupo nao pode mexer nos outros pinos da PORTB
+  digitalWrite(8, HIGH);
+  Leds::escrever(0x05);
+  bool certo = digitalRead(13) && !digitalRead(12) && digitalRead(11) && digitalRead(8);
+  Leds::escrever(0);
+  certo = certo && !digitalRead(13) && !digitalRead(11) && digitalRead(8);
+  printf("\nGrupo preserva os outros pinos da porta: %s\n", certo ? "sim" : "NAO");
+  return certo ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+// Mede a vazao de comandos do projeto_1 quando o cliente espera cada
+// resposta antes de mandar o proximo comando e quando manda um lote
+// separado por ';' numa transmissao so. O tempo de ida e volta do
+// conversor USB-serial (latency timer do FTDI, 16 ms por padrao) e
+// somado a cada espera do cliente.
+#include <stdio.h>
+#include <string>
+
+#include "Arduino.h"
+#include "emulador.h"
+#include "fila_serial.h"
+
+// Do sketch
+extern FilaSerial<256> saida;
+
+namespace {
+
+const uint64_t LATENCIA_USB_US = 16000;
+
+std::string recebido;
+
+void capturar(uint8_t byte, uint64_t) {
+  recebido += (char)byte;
+}
+
+void executarAteOcioso() {
+  do {
+    loop();
+    emu::avancarCiclos(emu::CUSTO_LOOP);
+  } while (emu::serialAgendadaPendente() || saida.pendentes() > 0 ||
+           emu::serialLivreParaEscrita() < emu::TAMANHO_BUFFER_TX - 1);
+}
+
+// Envia 'pedido', espera a resposta inteira e paga a latencia do
+// conversor nos dois sentidos
+void transacao(const std::string &pedido) {
+  emu::avancarMicros(LATENCIA_USB_US);
+  emu::agendarSerial(emu::micros(), pedido);
+  executarAteOcioso();
+  emu::avancarMicros(LATENCIA_USB_US);
+}
+
+// Confere que as respostas vieram numeradas de 'primeiro' ate 'ultimo'
+bool numeracaoCompleta(unsigned primeiro, unsigned ultimo) {
+  for (unsigned n = primeiro; n <= ultimo; n++) {
+    std::string marca = "#" + std::to_string(n) + " CMD_LOG";
+    if (recebido.find(marca) == std::string::npos) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+int main() {
+  const char *comandos[] = { "LED_ON", "LED_OFF", "LED_ON", "STATUS", "LED_OFF" };
+  const int TOTAL = sizeof(comandos) / sizeof(comandos[0]);
+  const int RODADAS = 20;
+
+  emu::reiniciar();
+  emu::observarSerial(capturar);
+  setup();
+  executarAteOcioso();
+  transacao("AUTH:1234\n");
+  unsigned sequencia = 1;
+
+  // Um comando por transacao
+  recebido.clear();
+  uint64_t inicio = emu::ciclos();
+  for (int r = 0; r < RODADAS; r++) {
+    for (int i = 0; i < TOTAL; i++) {
+      transacao(std::string(comandos[i]) + "\n");
+    }
+  }
+  double msUmPorVez = (emu::ciclos() - inicio) / (emu::CICLOS_POR_US * 1000.0);
+  bool okUmPorVez = numeracaoCompleta(sequencia + 1, sequencia + RODADAS * TOTAL);
+  sequencia += RODADAS * TOTAL;
+
+  // Os mesmos comandos, um lote por transacao
+  std::string lote;
+  for (int i = 0; i < TOTAL; i++) {
+    lote += comandos[i];
+    lote += i + 1 < TOTAL ? ';' : '\n';
+  }
+  recebido.clear();
+  uint64_t perdidosAntes = emu::estatisticas().bytesRxPerdidos;
+  inicio = emu::ciclos();
+  for (int r = 0; r < RODADAS; r++) {
+    transacao(lote);
+  }
+  double msLote = (emu::ciclos() - inicio) / (emu::CICLOS_POR_US * 1000.0);
+  bool okLote = numeracaoCompleta(sequencia + 1, sequencia + RODADAS * TOTAL);
+  uint64_t perdidos = emu::estatisticas().bytesRxPerdidos - perdidosAntes;
+
+  int n = RODADAS * TOTAL;
+  printf("%d comandos, latencia USB de %llu ms por sentido\n", n,
+         (unsigned long long)(LATENCIA_USB_US / 1000));
+  printf("lote: \"%.*s\" (%zu bytes)\n\n", (int)lote.size() - 1, lote.c_str(), lote.size());
+  printf("%-12s | %9s | %10s | %s\n", "modo", "tempo", "comandos/s", "respostas numeradas");
+  printf("-------------+-----------+------------+--------------------\n");
+  printf("%-12s | %6.0f ms | %10.1f | %s\n", "um por vez", msUmPorVez, n * 1000.0 / msUmPorVez,
+         okUmPorVez ? "ok" : "FALTANDO");
+  printf("%-12s | %6.0f ms | %10.1f | %s\n", "em lote", msLote, n * 1000.0 / msLote,
+         okLote ? "ok" : "FALTANDO");
+  printf("\nGanho: %.1fx, %llu bytes perdidos na RX\n", msUmPorVez / msLote,
+         (unsigned long long)perdidos);
+  return okUmPorVez && okLote && perdidos == 0 ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+// Mede bytes e tempo por transacao do projeto_1 no modo texto e no modo
+// binario (protocolo_binario.h), rodando o sketch no emulador a 9600 baud.
+// As respostas binarias sao decodificadas aqui com o mesmo codigo do
+// firmware, como faria um cliente no PC.
+#include <stdio.h>
+#include <string>
+
+#include "Arduino.h"
+#include "emulador.h"
+#include "fila_serial.h"
+#include "protocolo_binario.h"
+
+// Do sketch
+extern FilaSerial<256> saida;
+
+namespace {
+
+std::string recebido;
+
+void capturar(uint8_t byte, uint64_t) {
+  recebido += (char)byte;
+}
+
+// Roda loop() ate a entrada ser consumida e o ultimo byte da resposta
+// sair da fila do sketch e pelo fio
+void executarAteOcioso() {
+  do {
+    loop();
+    emu::avancarCiclos(emu::CUSTO_LOOP);
+  } while (emu::serialAgendadaPendente() || saida.pendentes() > 0 ||
+           emu::serialLivreParaEscrita() < emu::TAMANHO_BUFFER_TX - 1);
+}
+
+struct Transacao {
+  size_t bytesEnviados;
+  size_t bytesRecebidos;
+  double ms;
+};
+
+Transacao executar(const std::string &pedido) {
+  recebido.clear();
+  uint64_t inicio = emu::ciclos();
+  emu::agendarSerial(emu::micros(), pedido);
+  executarAteOcioso();
+
+  Transacao t;
+  t.bytesEnviados = pedido.size();
+  t.bytesRecebidos = recebido.size();
+  t.ms = (emu::ciclos() - inicio) / (emu::CICLOS_POR_US * 1000.0);
+  return t;
+}
+
+std::string quadro(uint8_t opcode, const char *dados = "") {
+  uint8_t pacote[TAMANHO_MAX_PACOTE + 2] = { opcode };
+  uint8_t tamanho = 1;
+  while (*dados) {
+    pacote[tamanho++] = (uint8_t)*dados++;
+  }
+  uint8_t codificado[TAMANHO_MAX_QUADRO];
+  uint8_t n = montarQuadro(pacote, tamanho, codificado);
+  return std::string((const char *)codificado, n) + '\0';
+}
+
+// Decodifica a resposta binaria para mostrar que o cliente entende
+std::string descreverResposta(const std::string &bruto) {
+  uint8_t buf[64];
+  size_t n = bruto.size() - 1;   // sem o delimitador
+  if (n > sizeof(buf)) {
+    return "quadro grande demais";
+  }
+  memcpy(buf, bruto.data(), n);
+  uint8_t tamanho = abrirQuadro(buf, (uint8_t)n);
+  if (tamanho == 0) {
+    return "CRC invalido";
+  }
+  char texto[64];
+  if (buf[0] == (OP_STATUS | OP_RESPOSTA) && tamanho == 7) {
+    unsigned long uptime = buf[3] | (buf[4] << 8) | ((unsigned long)buf[5] << 16) | ((unsigned long)buf[6] << 24);
+    snprintf(texto, sizeof(texto), "led=%u auth=%u uptime=%lums", buf[1], buf[2], uptime);
+  } else if (tamanho >= 2) {
+    snprintf(texto, sizeof(texto), "op=0x%02X valor=%u", buf[0], buf[1]);
+  } else {
+    snprintf(texto, sizeof(texto), "op=0x%02X", buf[0]);
+  }
+  return texto;
+}
+
+}
+
+int main() {
+  emu::reiniciar();
+  emu::observarSerial(capturar);
+  setup();
+  executarAteOcioso();
+
+  const char *nomes[] = { "AUTH", "LED_ON", "LED_OFF", "STATUS" };
+  const std::string texto[] = { "AUTH:1234\n", "LED_ON\n", "LED_OFF\n", "STATUS\n" };
+  const std::string binario[] = {
+    quadro(OP_AUTH, "1234"), quadro(OP_LED_ON), quadro(OP_LED_OFF), quadro(OP_STATUS),
+  };
+
+  Transacao t[2][4];
+  std::string respostas[4];
+  for (int i = 0; i < 4; i++) {
+    t[0][i] = executar(texto[i]);
+  }
+  executar("BIN\n");
+  for (int i = 0; i < 4; i++) {
+    t[1][i] = executar(binario[i]);
+    respostas[i] = descreverResposta(recebido);
+  }
+
+  printf("%-8s | %-17s | %-17s | %7s | %s\n", "comando", "bytes texto", "bytes binario",
+         "reducao", "resposta binaria");
+  printf("---------+-------------------+-------------------+---------+----------------\n");
+  size_t total[2] = { 0, 0 };
+  double ms[2] = { 0, 0 };
+  for (int i = 0; i < 4; i++) {
+    size_t bt = t[0][i].bytesEnviados + t[0][i].bytesRecebidos;
+    size_t bb = t[1][i].bytesEnviados + t[1][i].bytesRecebidos;
+    printf("%-8s | %3zu (%5.1f ms)    | %3zu (%5.1f ms)    | %6.1fx | %s\n", nomes[i],
+           bt, t[0][i].ms, bb, t[1][i].ms, (double)bt / bb, respostas[i].c_str());
+    total[0] += bt;
+    total[1] += bb;
+    ms[0] += t[0][i].ms;
+    ms[1] += t[1][i].ms;
+  }
+  printf("\nTotal: %zu bytes / %.1f ms no modo texto, %zu bytes / %.1f ms no binario (%.1fx)\n",
+         total[0], ms[0], total[1], ms[1], (double)total[0] / total[1]);
+  return 0;
+}
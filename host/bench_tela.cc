@@ -0,0 +1,56 @@
+// Mede o tempo de barramento do LCD por tecla no
+// projeto_2-timing_attack: cada digito digitado, o '#' que mostra
+// ACESSO NEGADO e volta para a tela inicial, e o '*' de reset.
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "emulador.h"
+
+namespace {
+
+void descartar(uint8_t, uint64_t) {
+}
+
+struct Medida {
+  uint64_t micros;
+  uint64_t bytes;
+  uint64_t clears;
+};
+
+// Pressiona a tecla e roda loop() ate o sketch terminar de reagir
+Medida pressionar(char tecla, unsigned long msDepois) {
+  const emu::Estatisticas &e = emu::estatisticas();
+  Medida antes = { e.microsLcd, e.bytesLcd, e.clearsLcd };
+  emu::agendarTecla(emu::micros(), tecla, 100);
+  uint64_t fim = emu::millis() + msDepois;
+  while (emu::millis() < fim) {
+    loop();
+    emu::avancarCiclos(emu::CUSTO_LOOP);
+  }
+  Medida m = { e.microsLcd - antes.micros, e.bytesLcd - antes.bytes, e.clearsLcd - antes.clears };
+  return m;
+}
+
+}
+
+int main() {
+  emu::reiniciar();
+  emu::observarSerial(descartar);
+  setup();
+
+  const char teclas[] = "1239#*";
+  const unsigned long espera[] = { 300, 300, 300, 300, 3000, 300 };
+  printf("%-6s | %10s | %6s | %6s | %s\n", "tecla", "LCD (us)", "bytes", "clears", "tela depois");
+  printf("-------+------------+--------+--------+------------------------------------\n");
+  uint64_t somaDigitos = 0;
+  for (int i = 0; teclas[i]; i++) {
+    Medida m = pressionar(teclas[i], espera[i]);
+    if (teclas[i] >= '0' && teclas[i] <= '9') {
+      somaDigitos += m.micros;
+    }
+    printf("%-6c | %10llu | %6llu | %6llu | %s\n", teclas[i], (unsigned long long)m.micros,
+           (unsigned long long)m.bytes, (unsigned long long)m.clears, emu::lcdConteudo().c_str());
+  }
+  printf("\nMedia por digito: %.0f us de barramento\n", somaDigitos / 4.0);
+  return 0;
+}
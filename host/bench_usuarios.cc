@@ -0,0 +1,175 @@
+// Tabela de usuarios na EEPROM (tabela_usuarios.h) com a configuracao do
+// projeto_2-timing_attack-corrigido: 768 bytes, 57 usuarios.
+//
+// Confere primeiro que a verificacao nao vaza pelo tempo: com a tabela
+// em varios niveis de ocupacao, mede leituras, escritas e ciclos virtuais
+// de uma verificacao com o usuario certo, com o PIN errado e com ids que
+// nao existem (antes do primeiro, depois do ultimo e entre dois). Tudo
+// tem que dar igual (sai com 1 se nao der). Antes de cada medida a
+// escrita anterior termina, para nao cobrar a espera de uma na outra.
+//
+// O emulador so cobra os acessos a EEPROM; o HMAC por cima (4 blocos,
+// ~5.8 ms no AVR) e o de bench_credencial, o mesmo para todo id.
+//
+// Depois compara a carga em lote (CARGA ... FIM) com cadastrar um por um.
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "emulador.h"
+#include "tabela_usuarios.h"
+
+namespace {
+
+typedef TabelaUsuarios<0, 768> Tabela;
+Tabela tabela;
+
+// Ids espalhados de 0 a 9999, sem repetir; o PIN e derivado do id
+uint16_t idDoUsuario(uint8_t i) {
+  return 37 + (uint16_t)i * 173;
+}
+
+void pinDoUsuario(uint16_t id, char *pin) {
+  snprintf(pin, 5, "%04u", (unsigned)((id * 7 + 1234) % 10000));
+}
+
+void carregar(uint8_t n) {
+  tabela.iniciarCarga();
+  char pin[5];
+  // Em ordem embaralhada, para concluirCarga() ordenar de verdade
+  for (uint8_t i = 0; i < n; i++) {
+    uint8_t j = (uint8_t)((i * 23) % n);
+    pinDoUsuario(idDoUsuario(j), pin);
+    tabela.acrescentar(idDoUsuario(j), pin, 4);
+  }
+  tabela.concluirCarga();
+}
+
+struct Medida {
+  uint64_t leituras;
+  uint64_t escritas;
+  uint64_t ciclos;
+  bool aceito;
+};
+
+Medida medir(uint16_t id, const char *pin) {
+  emu::avancarMicros(emu::US_ESCRITA_EEPROM);
+  emu::Estatisticas antes = emu::estatisticas();
+  uint64_t inicio = emu::ciclos();
+  Medida m;
+  m.aceito = tabela.verificar(id, pin, 4);
+  m.ciclos = emu::ciclos() - inicio;
+  m.leituras = emu::estatisticas().leiturasEeprom - antes.leiturasEeprom;
+  m.escritas = emu::estatisticas().escritasEeprom - antes.escritasEeprom;
+  return m;
+}
+
+struct Referencia {
+  bool definida;
+  Medida medida;
+};
+
+bool conferir(uint8_t n, const char *caso, uint16_t id, const char *pin, bool esperado, Referencia &ref) {
+  Medida m = medir(id, pin);
+  if (!ref.definida) {
+    ref.definida = true;
+    ref.medida = m;
+  }
+  bool plano = m.leituras == ref.medida.leituras && m.escritas == ref.medida.escritas &&
+               m.ciclos == ref.medida.ciclos;
+  bool certo = m.aceito == esperado;
+  printf("%8u | %-22s | %5u | %8llu | %8llu | %7llu | %s\n", n, caso, id, (unsigned long long)m.leituras,
+         (unsigned long long)m.escritas, (unsigned long long)m.ciclos,
+         !certo ? "RESULTADO ERRADO" : plano ? (m.aceito ? "aceito" : "recusado") : "TEMPO DIFERENTE");
+  return plano && certo;
+}
+
+bool verificacoes() {
+  printf("%8s | %-22s | %5s | %8s | %8s | %7s | %s\n", "usuarios", "caso", "id", "leituras", "escritas",
+         "ciclos", "");
+  printf("---------+------------------------+-------+----------+----------+---------+---------\n");
+  Referencia ref = { false, Medida() };
+  bool ok = true;
+  const uint8_t niveis[] = { 1, 8, 29, Tabela::CAPACIDADE };
+  for (size_t k = 0; k < sizeof(niveis) / sizeof(niveis[0]); k++) {
+    uint8_t n = niveis[k];
+    carregar(n);
+    uint16_t primeiro = idDoUsuario(0), ultimo = idDoUsuario(n - 1);
+    char pin[5];
+    pinDoUsuario(primeiro, pin);
+    ok &= conferir(n, "primeiro, PIN certo", primeiro, pin, true, ref);
+    ok &= conferir(n, "primeiro, PIN errado", primeiro, "0000", false, ref);
+    pinDoUsuario(ultimo, pin);
+    ok &= conferir(n, "ultimo, PIN certo", ultimo, pin, true, ref);
+    ok &= conferir(n, "sem usuario: antes", 0, pin, false, ref);
+    ok &= conferir(n, "sem usuario: depois", 9999, pin, false, ref);
+    ok &= conferir(n, "sem usuario: entre", primeiro + 1, pin, false, ref);
+  }
+  return ok;
+}
+
+// Travar, esgotar as tentativas e liberar
+bool bloqueios() {
+  carregar(8);
+  uint16_t id = idDoUsuario(3);
+  char pin[5];
+  pinDoUsuario(id, pin);
+  bool ok = true;
+  tabela.travar(id, true);
+  ok &= !tabela.verificar(id, pin, 4);
+  tabela.travar(id, false);
+  ok &= tabela.verificar(id, pin, 4);
+  for (uint8_t i = 0; i < MAX_TENTATIVAS_USUARIO; i++) {
+    tabela.verificar(id, "0000", 4);
+  }
+  ok &= !tabela.verificar(id, pin, 4);
+  tabela.travar(id, false);
+  ok &= tabela.verificar(id, pin, 4);
+  // Remover tira do indice; cadastrar de novo reaproveita o registro
+  ok &= tabela.remover(id) && !tabela.verificar(id, pin, 4) && tabela.total() == 7;
+  ok &= tabela.definir(id, pin, 4) && tabela.verificar(id, pin, 4) && tabela.total() == 8;
+  printf("\nTravar, %u erros seguidos, liberar, remover: %s\n", MAX_TENTATIVAS_USUARIO, ok ? "ok" : "FALHOU");
+  return ok;
+}
+
+void cadastro() {
+  emu::avancarMicros(emu::US_ESCRITA_EEPROM);
+  uint64_t inicio = emu::micros();
+  uint64_t escritas = emu::estatisticas().escritasEeprom;
+  carregar(Tabela::CAPACIDADE);
+  emu::avancarMicros(emu::US_ESCRITA_EEPROM);
+  double msLote = (emu::micros() - inicio) / 1000.0;
+  uint64_t escritasLote = emu::estatisticas().escritasEeprom - escritas;
+
+  // Um por um, do maior id para o menor: cada insercao desloca o indice
+  tabela.iniciarCarga();
+  tabela.concluirCarga();
+  emu::avancarMicros(emu::US_ESCRITA_EEPROM);
+  inicio = emu::micros();
+  escritas = emu::estatisticas().escritasEeprom;
+  char pin[5];
+  for (int i = Tabela::CAPACIDADE - 1; i >= 0; i--) {
+    pinDoUsuario(idDoUsuario(i), pin);
+    tabela.definir(idDoUsuario(i), pin, 4);
+  }
+  emu::avancarMicros(emu::US_ESCRITA_EEPROM);
+  double msUm = (emu::micros() - inicio) / 1000.0;
+  uint64_t escritasUm = emu::estatisticas().escritasEeprom - escritas;
+
+  printf("\nCadastro de %u usuarios (escrita de %.1f ms por byte):\n", Tabela::CAPACIDADE,
+         emu::US_ESCRITA_EEPROM / 1000.0);
+  printf("  %-26s %8llu escritas %9.0f ms\n", "carga em lote", (unsigned long long)escritasLote, msLote);
+  printf("  %-26s %8llu escritas %9.0f ms\n", "um por um (pior ordem)", (unsigned long long)escritasUm, msUm);
+}
+
+}
+
+int main() {
+  emu::reiniciar();
+  emu::apagarEeprom();
+  tabela.iniciar();
+  bool ok = verificacoes();
+  ok &= bloqueios();
+  cadastro();
+  printf("\nVerificacao: %s\n", ok ? "mesmo custo para todo id e ocupacao" : "FALHOU");
+  return ok ? 0 : 1;
+}
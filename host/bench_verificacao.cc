@@ -0,0 +1,76 @@
+// Compara o tempo das duas verificacoes de senha do
+// projeto_2-timing_attack-corrigido para entradas com 0 a 4 digitos
+// certos e com tamanho errado.
+//
+// O relogio virtual mostra o custo no Arduino das chamadas da API
+// (delay() domina a versao vulneravel). O emulador nao conta as
+// instrucoes do AVR, entao a constancia da versao segura e conferida
+// pelo tempo no host: a media de cada entrada, em lotes, fica com o
+// menor lote para descartar interrupcoes do sistema.
+#include <stdio.h>
+#include <chrono>
+
+#include "Arduino.h"
+#include "emulador.h"
+
+bool verificarSenhaVulneravel(String senha);
+bool verificarSenhaSegura(const String &senha);
+
+namespace {
+
+const int LOTES = 200;
+const int CHAMADAS_POR_LOTE = 2000;
+
+void descartar(uint8_t, uint64_t) {
+}
+
+template <typename Verificar>
+double microsVirtuais(Verificar verificar, const String &senha) {
+  uint64_t inicio = emu::ciclos();
+  verificar(senha);
+  return (emu::ciclos() - inicio) / (double)emu::CICLOS_POR_US;
+}
+
+double nsNoHost(const String &senha) {
+  double melhor = 1e30;
+  volatile bool resultado = false;
+  for (int l = 0; l < LOTES; l++) {
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < CHAMADAS_POR_LOTE; i++) {
+      resultado = verificarSenhaSegura(senha);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - inicio).count();
+    if (ns / CHAMADAS_POR_LOTE < melhor) {
+      melhor = ns / CHAMADAS_POR_LOTE;
+    }
+  }
+  (void)resultado;
+  return melhor;
+}
+
+}
+
+int main() {
+  emu::reiniciar();
+  emu::observarSerial(descartar);
+  setup();
+
+  const char *entradas[] = { "0000", "1000", "1200", "1230", "1234", "12", "12345678" };
+  const int TOTAL = sizeof(entradas) / sizeof(entradas[0]);
+
+  printf("%-10s | %14s | %14s | %14s\n", "entrada", "vulneravel", "segura", "segura no host");
+  printf("-----------+----------------+----------------+---------------\n");
+  double minimo = 1e30, maximo = 0;
+  for (int i = 0; i < TOTAL; i++) {
+    String senha = entradas[i];
+    double vulneravel = microsVirtuais(verificarSenhaVulneravel, senha);
+    double segura = microsVirtuais(verificarSenhaSegura, senha);
+    double host = nsNoHost(senha);
+    minimo = host < minimo ? host : minimo;
+    maximo = host > maximo ? host : maximo;
+    printf("%-10s | %11.0f us | %11.0f us | %11.1f ns\n", entradas[i], vulneravel, segura, host);
+  }
+  printf("\nVariacao da versao segura entre entradas no host: %.1f ns (%.1f%%)\n",
+         maximo - minimo, 100.0 * (maximo - minimo) / minimo);
+  return 0;
+}
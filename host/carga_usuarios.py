@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""Carrega a tabela de usuarios do projeto_2-timing_attack-corrigido (ver
+tabela_usuarios.h) de um arquivo com uma linha "id:pin" por usuario
+(linhas vazias e comecadas por '#' sao ignoradas).
+
+uso: carga_usuarios.py ARQUIVO --porta DISPOSITIVO [--admin SENHA]
+     carga_usuarios.py ARQUIVO --emulador INICIO_MS --admin SENHA
+
+  --porta     manda ADMIN, CARGA, as linhas, FIM e SAIR pela serial
+              (pyserial), sempre esperando a resposta de cada linha antes
+              da proxima; sem --admin, pergunta a senha mestra
+  --emulador  escreve os --serial para o emulador, espacados pelo tempo
+              de gravar um registro:
+                build/projeto_2-timing_attack-corrigido --eeprom e.bin \\
+                  $(python3 carga_usuarios.py usuarios.txt --emulador 500 --admin 1234)
+"""
+import getpass
+import sys
+
+INTERVALO_MS = 60       # um registro: ate 12 escritas de 3.4 ms
+TAMANHO_MAX_USUARIO = 4
+TAMANHO_MAX_SENHA = 8
+
+
+def ler_usuarios(arquivo):
+    usuarios = []
+    with open(arquivo) as f:
+        for numero, linha in enumerate(f, 1):
+            linha = linha.strip()
+            if not linha or linha.startswith('#'):
+                continue
+            id_, _, pin = linha.partition(':')
+            if not (id_.isdigit() and len(id_) <= TAMANHO_MAX_USUARIO and
+                    pin.isdigit() and len(pin) <= TAMANHO_MAX_SENHA):
+                sys.exit('%s:%d: esperado id:pin (id ate %d digitos, pin ate %d): %s' %
+                         (arquivo, numero, TAMANHO_MAX_USUARIO, TAMANHO_MAX_SENHA, linha))
+            usuarios.append('%d:%s' % (int(id_), pin))
+    return usuarios
+
+
+def pela_serial(usuarios, dispositivo, senha):
+    import serial
+    porta = serial.Serial(dispositivo, 9600, timeout=5)
+
+    def mandar(linha):
+        porta.write((linha + '\n').encode('ascii'))
+        resposta = porta.readline().decode('ascii', 'replace').strip()
+        if not resposta:
+            sys.exit('sem resposta para %s' % linha)
+        return resposta
+
+    resposta = mandar('ADMIN:' + senha)
+    if 'aberta' not in resposta:
+        sys.exit('ADMIN recusado: %s' % resposta)
+    mandar('CARGA')
+    for linha in usuarios:
+        resposta = mandar(linha)
+        if resposta != 'ok':
+            print('%s -> %s' % (linha, resposta), file=sys.stderr)
+    print(mandar('FIM'))
+    mandar('SAIR')
+
+
+def para_o_emulador(usuarios, inicio, senha):
+    linhas = ['ADMIN:' + senha, 'CARGA'] + usuarios + ['FIM', 'SAIR']
+    for i, linha in enumerate(linhas):
+        print('--serial %d:%s\\n' % (inicio + i * INTERVALO_MS, linha))
+
+
+def main():
+    args = sys.argv[1:]
+    senha = None
+    if len(args) == 5 and args[3] == '--admin':
+        senha = args[4]
+        args = args[:3]
+    if len(args) != 3 or args[1] not in ('--porta', '--emulador'):
+        sys.exit(__doc__)
+    usuarios = ler_usuarios(args[0])
+    if args[1] == '--porta':
+        if senha is None:
+            senha = getpass.getpass('Senha mestra: ')
+        pela_serial(usuarios, args[2], senha)
+    else:
+        if senha is None:
+            sys.exit(__doc__)
+        para_o_emulador(usuarios, int(args[2]), senha)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,96 @@
+#include "Arduino.h"
+#include "emulador.h"
+
+void pinMode(uint8_t pino, uint8_t modo) {
+  emu::definirModoPino(pino, modo);
+}
+
+void digitalWrite(uint8_t pino, uint8_t nivel) {
+  emu::escreverPino(pino, nivel);
+}
+
+int digitalRead(uint8_t pino) {
+  return emu::lerPino(pino);
+}
+
+unsigned long millis() {
+  emu::avancarCiclos(emu::CUSTO_MILLIS);
+  return (unsigned long)emu::millis();
+}
+
+unsigned long micros() {
+  emu::avancarCiclos(emu::CUSTO_MILLIS);
+  return (unsigned long)emu::micros();
+}
+
+// Como no core do AVR, o sketch pode definir yield() para trabalhar
+// enquanto delay() espera
+__attribute__((weak)) void yield() {
+}
+
+// Como no AVR, o prazo conta da entrada e o tempo do yield() entra nele:
+// o trabalho feito na espera nao a alonga. La yield() roda sem parar;
+// aqui, uma vez por ms, e com o sketch ocioso (emu::definirYieldOcioso())
+// o resto da espera passa de uma vez
+void delay(unsigned long ms) {
+  // Telas mostradas antes de um delay() tambem aparecem no registro do LCD
+  emu::lcdAlterado();
+  uint64_t fim = emu::micros() + (uint64_t)ms * 1000;
+  for (uint64_t agora = emu::micros(); agora < fim; agora = emu::micros()) {
+    if (emu::yieldOcioso()) {
+      emu::avancarMicros(fim - agora);
+      return;
+    }
+    yield();
+    agora = emu::micros();
+    if (agora < fim) {
+      emu::avancarMicros(fim - agora < 1000 ? fim - agora : 1000);
+    }
+  }
+}
+
+void delayMicroseconds(unsigned int us) {
+  emu::avancarMicros(us);
+}
+
+// Mesmo gerador do avr-libc (Park-Miller), para sequencias reproduziveis
+static unsigned long sementeAleatoria = 1;
+
+static long proximoAleatorio() {
+  long hi = sementeAleatoria / 127773L;
+  long lo = sementeAleatoria % 127773L;
+  long x = 16807L * lo - 2836L * hi;
+  if (x < 0) {
+    x += 0x7fffffffL;
+  }
+  sementeAleatoria = x;
+  return x;
+}
+
+long random(long maximo) {
+  if (maximo == 0) {
+    return 0;
+  }
+  return proximoAleatorio() % maximo;
+}
+
+long random(long minimo, long maximo) {
+  if (minimo >= maximo) {
+    return minimo;
+  }
+  return random(maximo - minimo) + minimo;
+}
+
+void randomSeed(unsigned long semente) {
+  if (semente != 0) {
+    sementeAleatoria = semente;
+  }
+}
+
+void noInterrupts() {
+  emu::habilitarInterrupcoes(false);
+}
+
+void interrupts() {
+  emu::habilitarInterrupcoes(true);
+}
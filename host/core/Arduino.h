@@ -0,0 +1,74 @@
+// Substituto do Arduino.h para compilar os sketches no host. Implementa
+// so a parte da API que os sketches usam, sobre o emulador (emulador.h).
+//
+// Diferenca importante: no host int tem 32 bits e long 64 bits; no AVR
+// sao 16 e 32. Codigo que depende de estouro desses tipos pode divergir.
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <type_traits>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define LED_BUILTIN 13
+
+// Pinos analogicos do Uno usados como digitais
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef unsigned int word;
+
+// No Arduino min/max sao macros; templates evitam conflito com a STL
+template <class A, class B>
+inline typename std::common_type<A, B>::type min(A a, B b) { return a < b ? a : b; }
+template <class A, class B>
+inline typename std::common_type<A, B>::type max(A a, B b) { return a > b ? a : b; }
+
+#define constrain(x, baixo, alto) ((x) < (baixo) ? (baixo) : ((x) > (alto) ? (alto) : (x)))
+
+#define bitRead(valor, bit) (((valor) >> (bit)) & 0x01)
+#define bitSet(valor, bit) ((valor) |= (1UL << (bit)))
+#define bitClear(valor, bit) ((valor) &= ~(1UL << (bit)))
+#define bitWrite(valor, bit, b) ((b) ? bitSet(valor, bit) : bitClear(valor, bit))
+
+void pinMode(uint8_t pino, uint8_t modo);
+void digitalWrite(uint8_t pino, uint8_t nivel);
+int digitalRead(uint8_t pino);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield(void);
+void delayMicroseconds(unsigned int us);
+
+long random(long maximo);
+long random(long minimo, long maximo);
+void randomSeed(unsigned long semente);
+
+void setup();
+void loop();
+
+#include "WString.h"
+#include "HardwareSerial.h"
+
+#endif
@@ -0,0 +1,16 @@
+#include "EEPROM.h"
+#include "emulador.h"
+
+EEPROMClass EEPROM;
+
+uint8_t EEPROMClass::read(int endereco) {
+  return emu::lerEeprom(endereco);
+}
+
+void EEPROMClass::write(int endereco, uint8_t valor) {
+  emu::escreverEeprom(endereco, valor);
+}
+
+bool eeprom_is_ready() {
+  return emu::eepromPronta();
+}
@@ -0,0 +1,43 @@
+// Substituto da biblioteca EEPROM: cada byte vai para a EEPROM do
+// emulador, com o tempo de leitura e de escrita do AVR
+#ifndef EEPROM_H
+#define EEPROM_H
+
+#include "Arduino.h"
+#include "avr/eeprom.h"
+
+class EEPROMClass {
+public:
+  uint8_t read(int endereco);
+  void write(int endereco, uint8_t valor);
+  // Escreve so se o valor mudou (poupa tempo e desgaste)
+  void update(int endereco, uint8_t valor) {
+    if (read(endereco) != valor) {
+      write(endereco, valor);
+    }
+  }
+
+  template <typename T>
+  T &get(int endereco, T &valor) {
+    uint8_t *p = (uint8_t *)&valor;
+    for (size_t i = 0; i < sizeof(T); i++) {
+      p[i] = read(endereco + i);
+    }
+    return valor;
+  }
+
+  template <typename T>
+  const T &put(int endereco, const T &valor) {
+    const uint8_t *p = (const uint8_t *)&valor;
+    for (size_t i = 0; i < sizeof(T); i++) {
+      update(endereco + i, p[i]);
+    }
+    return valor;
+  }
+
+  uint16_t length() { return E2END + 1; }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,33 @@
+#include "Arduino.h"
+#include "emulador.h"
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long baud) {
+  emu::configurarSerial(baud);
+}
+
+int HardwareSerial::available() {
+  return emu::serialDisponivel();
+}
+
+int HardwareSerial::peek() {
+  return emu::serialEspiar();
+}
+
+int HardwareSerial::read() {
+  return emu::serialLer();
+}
+
+int HardwareSerial::availableForWrite() {
+  return emu::serialLivreParaEscrita();
+}
+
+void HardwareSerial::flush() {
+  emu::serialEsvaziar();
+}
+
+size_t HardwareSerial::write(uint8_t byte) {
+  emu::serialEscrever(byte);
+  return 1;
+}
@@ -0,0 +1,24 @@
+// Substituto do HardwareSerial: RX e TX passam pelo emulador, que
+// respeita o tempo de cada byte no baud rate configurado
+#ifndef HARDWARESERIAL_H
+#define HARDWARESERIAL_H
+
+#include "Print.h"
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud);
+  void end() {}
+  int available();
+  int peek();
+  int read();
+  int availableForWrite();
+  void flush();
+  size_t write(uint8_t byte);
+  using Print::write;
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
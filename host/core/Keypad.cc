@@ -0,0 +1,42 @@
+#include "Keypad.h"
+#include "emulador.h"
+
+Keypad::Keypad(char *mapa, byte *pinosLinha, byte *pinosColuna, byte linhas, byte colunas)
+  : mapa(mapa), pinosLinha(pinosLinha), pinosColuna(pinosColuna),
+    linhas(linhas), colunas(colunas), debounce(10), ultimaVarredura(0),
+    teclaAnterior(NO_KEY) {
+  emu::registrarTeclado(mapa, pinosLinha, pinosColuna, linhas, colunas);
+}
+
+// Mesma varredura da biblioteca: uma coluna por vez em LOW e leitura das
+// linhas com pull-up. Retorna a primeira tecla pressionada.
+char Keypad::varrer() {
+  char tecla = NO_KEY;
+  for (byte l = 0; l < linhas; l++) {
+    pinMode(pinosLinha[l], INPUT_PULLUP);
+  }
+  for (byte c = 0; c < colunas; c++) {
+    pinMode(pinosColuna[c], OUTPUT);
+    digitalWrite(pinosColuna[c], LOW);
+    for (byte l = 0; l < linhas; l++) {
+      if (!digitalRead(pinosLinha[l]) && tecla == NO_KEY) {
+        tecla = mapa[l * colunas + c];
+      }
+    }
+    digitalWrite(pinosColuna[c], HIGH);
+    pinMode(pinosColuna[c], INPUT);
+  }
+  return tecla;
+}
+
+char Keypad::getKey() {
+  if (millis() - ultimaVarredura < debounce) {
+    return NO_KEY;
+  }
+  ultimaVarredura = millis();
+
+  char tecla = varrer();
+  char nova = (tecla != NO_KEY && tecla != teclaAnterior) ? tecla : NO_KEY;
+  teclaAnterior = tecla;
+  return nova;
+}
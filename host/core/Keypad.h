@@ -0,0 +1,33 @@
+// Substituto da biblioteca Keypad: varre a matriz pelos pinos do
+// emulador (coluna em LOW, linhas com pull-up), com debounce de 10 ms
+#ifndef KEYPAD_H
+#define KEYPAD_H
+
+#include "Arduino.h"
+
+#define makeKeymap(x) ((char *)x)
+#define NO_KEY '\0'
+
+typedef char KeypadEvent;
+
+class Keypad {
+public:
+  Keypad(char *mapa, byte *pinosLinha, byte *pinosColuna, byte linhas, byte colunas);
+
+  char getKey();
+  void setDebounceTime(unsigned int ms) { debounce = ms < 1 ? 1 : ms; }
+
+private:
+  char varrer();
+
+  char *mapa;
+  byte *pinosLinha;
+  byte *pinosColuna;
+  byte linhas;
+  byte colunas;
+  unsigned int debounce;
+  unsigned long ultimaVarredura;
+  char teclaAnterior;
+};
+
+#endif
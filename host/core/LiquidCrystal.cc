@@ -0,0 +1,40 @@
+#include "LiquidCrystal.h"
+#include "emulador.h"
+
+LiquidCrystal::LiquidCrystal(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t) {
+}
+
+void LiquidCrystal::begin(uint8_t colunas, uint8_t linhas) {
+  emu::configurarLcd(colunas, linhas);
+}
+
+void LiquidCrystal::clear() {
+  emu::lcdLimpar();
+}
+
+void LiquidCrystal::home() {
+  emu::lcdPosicionar(0, 0);
+  emu::avancarMicros(emu::LCD_US_CLEAR - emu::LCD_US_POR_BYTE);
+}
+
+void LiquidCrystal::setCursor(uint8_t coluna, uint8_t linha) {
+  emu::lcdPosicionar(coluna, linha);
+}
+
+void LiquidCrystal::display() { emu::lcdComando(); }
+void LiquidCrystal::noDisplay() { emu::lcdComando(); }
+void LiquidCrystal::cursor() { emu::lcdComando(); }
+void LiquidCrystal::noCursor() { emu::lcdComando(); }
+void LiquidCrystal::blink() { emu::lcdComando(); }
+void LiquidCrystal::noBlink() { emu::lcdComando(); }
+
+void LiquidCrystal::createChar(uint8_t, uint8_t[]) {
+  for (int i = 0; i < 9; i++) {
+    emu::lcdComando();
+  }
+}
+
+size_t LiquidCrystal::write(uint8_t caractere) {
+  emu::lcdEscrever(caractere);
+  return 1;
+}
@@ -0,0 +1,29 @@
+// Substituto da biblioteca LiquidCrystal: guarda o conteudo da tela no
+// emulador e cobra o tempo de barramento do HD44780 em modo 4 bits
+#ifndef LIQUIDCRYSTAL_H
+#define LIQUIDCRYSTAL_H
+
+#include "Arduino.h"
+#include "Print.h"
+
+class LiquidCrystal : public Print {
+public:
+  LiquidCrystal(uint8_t rs, uint8_t enable,
+                uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7);
+
+  void begin(uint8_t colunas, uint8_t linhas);
+  void clear();
+  void home();
+  void setCursor(uint8_t coluna, uint8_t linha);
+  void display();
+  void noDisplay();
+  void cursor();
+  void noCursor();
+  void blink();
+  void noBlink();
+  void createChar(uint8_t posicao, uint8_t mapa[]);
+  size_t write(uint8_t caractere);
+  using Print::write;
+};
+
+#endif
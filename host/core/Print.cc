@@ -0,0 +1,103 @@
+#include "Arduino.h"
+#include "Print.h"
+
+#include <stdio.h>
+
+size_t Print::write(const uint8_t *buffer, size_t tamanho) {
+  size_t n = 0;
+  while (tamanho--) {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+size_t Print::write(const char *s) {
+  return s ? write((const uint8_t *)s, strlen(s)) : 0;
+}
+
+size_t Print::imprimirNumero(unsigned long valor, uint8_t base) {
+  char buf[8 * sizeof(long) + 1];
+  char *p = &buf[sizeof(buf) - 1];
+  *p = '\0';
+  if (base < 2) {
+    base = 10;
+  }
+  do {
+    char digito = (char)(valor % base);
+    *--p = digito < 10 ? digito + '0' : digito + 'A' - 10;
+    valor /= base;
+  } while (valor);
+  return write(p);
+}
+
+size_t Print::print(const __FlashStringHelper *s) {
+  return write(reinterpret_cast<const char *>(s));
+}
+
+size_t Print::print(const String &s) {
+  return write((const uint8_t *)s.c_str(), s.length());
+}
+
+size_t Print::print(const char *s) {
+  return write(s);
+}
+
+size_t Print::print(char c) {
+  return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char valor, int base) {
+  return print((unsigned long)valor, base);
+}
+
+size_t Print::print(int valor, int base) {
+  return print((long)valor, base);
+}
+
+size_t Print::print(unsigned int valor, int base) {
+  return print((unsigned long)valor, base);
+}
+
+size_t Print::print(long valor, int base) {
+  if (base == 0) {
+    return write((uint8_t)valor);
+  }
+  if (base == 10 && valor < 0) {
+    size_t n = print('-');
+    return n + imprimirNumero((unsigned long)-valor, 10);
+  }
+  return imprimirNumero((unsigned long)valor, (uint8_t)base);
+}
+
+size_t Print::print(unsigned long valor, int base) {
+  if (base == 0) {
+    return write((uint8_t)valor);
+  }
+  return imprimirNumero(valor, (uint8_t)base);
+}
+
+size_t Print::print(double valor, int casas) {
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.*f", casas, valor);
+  return write(buf);
+}
+
+size_t Print::print(const Printable &objeto) {
+  return objeto.printTo(*this);
+}
+
+size_t Print::println() {
+  return write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper *s) { size_t n = print(s); return n + println(); }
+size_t Print::println(const String &s) { size_t n = print(s); return n + println(); }
+size_t Print::println(const char *s) { size_t n = print(s); return n + println(); }
+size_t Print::println(char c) { size_t n = print(c); return n + println(); }
+size_t Print::println(unsigned char valor, int base) { size_t n = print(valor, base); return n + println(); }
+size_t Print::println(int valor, int base) { size_t n = print(valor, base); return n + println(); }
+size_t Print::println(unsigned int valor, int base) { size_t n = print(valor, base); return n + println(); }
+size_t Print::println(long valor, int base) { size_t n = print(valor, base); return n + println(); }
+size_t Print::println(unsigned long valor, int base) { size_t n = print(valor, base); return n + println(); }
+size_t Print::println(double valor, int casas) { size_t n = print(valor, casas); return n + println(); }
+size_t Print::println(const Printable &objeto) { size_t n = print(objeto); return n + println(); }
@@ -0,0 +1,54 @@
+// Substituto da classe Print do Arduino: formata numeros e textos e
+// entrega byte a byte para write() da classe derivada
+#ifndef PRINT_H
+#define PRINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Printable.h"
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print {
+public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t byte) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t tamanho);
+  size_t write(const char *s);
+
+  size_t print(const __FlashStringHelper *s);
+  size_t print(const String &s);
+  size_t print(const char *s);
+  size_t print(char c);
+  size_t print(unsigned char valor, int base = DEC);
+  size_t print(int valor, int base = DEC);
+  size_t print(unsigned int valor, int base = DEC);
+  size_t print(long valor, int base = DEC);
+  size_t print(unsigned long valor, int base = DEC);
+  size_t print(double valor, int casas = 2);
+  size_t print(const Printable &objeto);
+
+  size_t println(const __FlashStringHelper *s);
+  size_t println(const String &s);
+  size_t println(const char *s);
+  size_t println(char c);
+  size_t println(unsigned char valor, int base = DEC);
+  size_t println(int valor, int base = DEC);
+  size_t println(unsigned int valor, int base = DEC);
+  size_t println(long valor, int base = DEC);
+  size_t println(unsigned long valor, int base = DEC);
+  size_t println(double valor, int casas = 2);
+  size_t println(const Printable &objeto);
+  size_t println();
+
+private:
+  size_t imprimirNumero(unsigned long valor, uint8_t base);
+};
+
+#endif
@@ -0,0 +1,16 @@
+// Substituto do Printable do Arduino: objetos que sabem se imprimir em
+// qualquer Print (Serial, LCD) com print(objeto)
+#ifndef PRINTABLE_H
+#define PRINTABLE_H
+
+#include <stddef.h>
+
+class Print;
+
+class Printable {
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print &p) const = 0;
+};
+
+#endif
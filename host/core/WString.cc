@@ -0,0 +1,296 @@
+#include "Arduino.h"
+#include "emulador.h"
+
+#include <ctype.h>
+#include <stdio.h>
+
+static std::string paraTexto(unsigned long valor, unsigned char base) {
+  if (base < 2) {
+    base = 10;
+  }
+  char buf[8 * sizeof(long) + 1];
+  char *p = &buf[sizeof(buf) - 1];
+  *p = '\0';
+  do {
+    unsigned long digito = valor % base;
+    *--p = (char)(digito < 10 ? '0' + digito : 'A' + digito - 10);
+    valor /= base;
+  } while (valor);
+  return p;
+}
+
+static std::string paraTextoComSinal(long valor, unsigned char base) {
+  if (valor < 0 && base == 10) {
+    return "-" + paraTexto((unsigned long)-valor, base);
+  }
+  return paraTexto((unsigned long)valor, base);
+}
+
+String::String(const char *s)
+  : texto(s ? s : ""), nulo(0), temBloco(false), capacidade(0) {
+  modelarReserva(length());
+}
+
+String::String(const String &s)
+  : texto(s.texto), nulo(0), temBloco(false), capacidade(0) {
+  modelarReserva(length());
+}
+
+String::String(const __FlashStringHelper *s)
+  : texto(s ? reinterpret_cast<const char *>(s) : ""), nulo(0), temBloco(false), capacidade(0) {
+  modelarReserva(length());
+}
+
+String::String(char c)
+  : texto(1, c), nulo(0), temBloco(false), capacidade(0) {
+  modelarReserva(length());
+}
+
+String::String(unsigned char valor, unsigned char base)
+  : texto(paraTexto(valor, base)), nulo(0), temBloco(false), capacidade(0) {
+  modelarReserva(length());
+}
+
+String::String(int valor, unsigned char base)
+  : texto(paraTextoComSinal(valor, base)), nulo(0), temBloco(false), capacidade(0) {
+  modelarReserva(length());
+}
+
+String::String(unsigned int valor, unsigned char base)
+  : texto(paraTexto(valor, base)), nulo(0), temBloco(false), capacidade(0) {
+  modelarReserva(length());
+}
+
+String::String(long valor, unsigned char base)
+  : texto(paraTextoComSinal(valor, base)), nulo(0), temBloco(false), capacidade(0) {
+  modelarReserva(length());
+}
+
+String::String(unsigned long valor, unsigned char base)
+  : texto(paraTexto(valor, base)), nulo(0), temBloco(false), capacidade(0) {
+  modelarReserva(length());
+}
+
+String::String(float valor, unsigned char casas)
+  : nulo(0), temBloco(false), capacidade(0) {
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.*f", casas, (double)valor);
+  texto = buf;
+  modelarReserva(length());
+}
+
+String::String(double valor, unsigned char casas)
+  : nulo(0), temBloco(false), capacidade(0) {
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.*f", casas, valor);
+  texto = buf;
+  modelarReserva(length());
+}
+
+String::~String() {
+  if (temBloco) {
+    emu::registrarHeap(-(int64_t)(capacidade + 3), false);
+  }
+}
+
+// Mesmo criterio do WString.cpp: so realoca quando o texto nao cabe
+void String::modelarReserva(unsigned int tamanho) {
+  if (temBloco && capacidade >= tamanho) {
+    return;
+  }
+  int64_t anterior = temBloco ? capacidade + 3 : 0;
+  emu::registrarHeap((int64_t)tamanho + 3 - anterior, true);
+  temBloco = true;
+  capacidade = tamanho;
+}
+
+String &String::operator=(const String &s) {
+  modelarReserva(s.length());
+  texto = s.texto;
+  return *this;
+}
+
+String &String::operator=(const char *s) {
+  texto = s ? s : "";
+  modelarReserva(length());
+  return *this;
+}
+
+bool String::reserve(unsigned int tamanho) {
+  modelarReserva(tamanho);
+  texto.reserve(tamanho);
+  return true;
+}
+
+bool String::concat(const String &s) {
+  modelarReserva(length() + s.length());
+  texto += s.texto;
+  return true;
+}
+
+bool String::concat(const char *s) {
+  if (!s) {
+    return false;
+  }
+  modelarReserva(length() + (unsigned int)strlen(s));
+  texto += s;
+  return true;
+}
+
+bool String::concat(char c) {
+  modelarReserva(length() + 1);
+  texto += c;
+  return true;
+}
+
+bool String::equalsIgnoreCase(const String &s) const {
+  if (texto.size() != s.texto.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < texto.size(); i++) {
+    if (tolower((unsigned char)texto[i]) != tolower((unsigned char)s.texto[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool String::startsWith(const String &prefixo) const {
+  return texto.compare(0, prefixo.texto.size(), prefixo.texto) == 0;
+}
+
+bool String::endsWith(const String &sufixo) const {
+  return texto.size() >= sufixo.texto.size() &&
+         texto.compare(texto.size() - sufixo.texto.size(), sufixo.texto.size(), sufixo.texto) == 0;
+}
+
+void String::setCharAt(unsigned int i, char c) {
+  if (i < texto.size()) {
+    texto[i] = c;
+  }
+}
+
+char String::operator[](unsigned int i) const {
+  return i < texto.size() ? texto[i] : 0;
+}
+
+char &String::operator[](unsigned int i) {
+  if (i < texto.size()) {
+    return texto[i];
+  }
+  nulo = 0;
+  return nulo;
+}
+
+void String::getBytes(unsigned char *buf, unsigned int tamanho, unsigned int inicio) const {
+  if (!tamanho || !buf) {
+    return;
+  }
+  if (inicio >= texto.size()) {
+    buf[0] = 0;
+    return;
+  }
+  unsigned int n = (unsigned int)texto.size() - inicio;
+  if (n > tamanho - 1) {
+    n = tamanho - 1;
+  }
+  memcpy(buf, texto.data() + inicio, n);
+  buf[n] = 0;
+}
+
+void String::toCharArray(char *buf, unsigned int tamanho, unsigned int inicio) const {
+  getBytes((unsigned char *)buf, tamanho, inicio);
+}
+
+int String::indexOf(char c, unsigned int inicio) const {
+  size_t pos = texto.find(c, inicio);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String &s, unsigned int inicio) const {
+  size_t pos = texto.find(s.texto, inicio);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const {
+  size_t pos = texto.rfind(c);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int inicio) const {
+  return substring(inicio, length());
+}
+
+String String::substring(unsigned int inicio, unsigned int fim) const {
+  if (inicio > fim) {
+    unsigned int t = inicio;
+    inicio = fim;
+    fim = t;
+  }
+  if (inicio >= texto.size()) {
+    return String();
+  }
+  if (fim > texto.size()) {
+    fim = (unsigned int)texto.size();
+  }
+  return String(texto.substr(inicio, fim - inicio).c_str());
+}
+
+void String::replace(const String &de, const String &para) {
+  if (de.texto.empty()) {
+    return;
+  }
+  size_t pos = 0;
+  while ((pos = texto.find(de.texto, pos)) != std::string::npos) {
+    texto.replace(pos, de.texto.size(), para.texto);
+    pos += para.texto.size();
+  }
+}
+
+void String::remove(unsigned int indice, unsigned int quantidade) {
+  if (indice < texto.size()) {
+    texto.erase(indice, quantidade);
+  }
+}
+
+void String::toLowerCase() {
+  for (size_t i = 0; i < texto.size(); i++) {
+    texto[i] = (char)tolower((unsigned char)texto[i]);
+  }
+}
+
+void String::toUpperCase() {
+  for (size_t i = 0; i < texto.size(); i++) {
+    texto[i] = (char)toupper((unsigned char)texto[i]);
+  }
+}
+
+void String::trim() {
+  size_t inicio = 0;
+  while (inicio < texto.size() && isspace((unsigned char)texto[inicio])) {
+    inicio++;
+  }
+  size_t fim = texto.size();
+  while (fim > inicio && isspace((unsigned char)texto[fim - 1])) {
+    fim--;
+  }
+  texto = texto.substr(inicio, fim - inicio);
+}
+
+long String::toInt() const {
+  return atol(texto.c_str());
+}
+
+float String::toFloat() const {
+  return (float)atof(texto.c_str());
+}
+
+String operator+(const String &a, const String &b) { String r(a); r.concat(b); return r; }
+String operator+(const String &a, const char *b) { String r(a); r.concat(b); return r; }
+String operator+(const char *a, const String &b) { String r(a); r.concat(b); return r; }
+String operator+(const String &a, char b) { String r(a); r.concat(b); return r; }
+String operator+(const String &a, int b) { return a + String(b); }
+String operator+(const String &a, unsigned int b) { return a + String(b); }
+String operator+(const String &a, long b) { return a + String(b); }
+String operator+(const String &a, unsigned long b) { return a + String(b); }
+String operator+(const String &a, double b) { return a + String(b); }
@@ -0,0 +1,96 @@
+// Substituto da classe String do Arduino sobre std::string
+#ifndef WSTRING_H
+#define WSTRING_H
+
+#include <string>
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(PSTR(s)))
+
+class String {
+public:
+  String(const char *s = "");
+  String(const String &s);
+  String(const __FlashStringHelper *s);
+  explicit String(char c);
+  explicit String(unsigned char valor, unsigned char base = 10);
+  explicit String(int valor, unsigned char base = 10);
+  explicit String(unsigned int valor, unsigned char base = 10);
+  explicit String(long valor, unsigned char base = 10);
+  explicit String(unsigned long valor, unsigned char base = 10);
+  explicit String(float valor, unsigned char casas = 2);
+  explicit String(double valor, unsigned char casas = 2);
+  ~String();
+
+  String &operator=(const String &s);
+  String &operator=(const char *s);
+
+  unsigned int length() const { return (unsigned int)texto.size(); }
+  const char *c_str() const { return texto.c_str(); }
+  bool reserve(unsigned int tamanho);
+
+  bool concat(const String &s);
+  bool concat(const char *s);
+  bool concat(char c);
+  String &operator+=(const String &s) { concat(s); return *this; }
+  String &operator+=(const char *s) { concat(s); return *this; }
+  String &operator+=(char c) { concat(c); return *this; }
+  String &operator+=(int valor) { concat(String(valor)); return *this; }
+  String &operator+=(unsigned long valor) { concat(String(valor)); return *this; }
+
+  bool equals(const String &s) const { return texto == s.texto; }
+  bool equals(const char *s) const { return texto == (s ? s : ""); }
+  bool equalsIgnoreCase(const String &s) const;
+  bool operator==(const String &s) const { return equals(s); }
+  bool operator==(const char *s) const { return equals(s); }
+  bool operator!=(const String &s) const { return !equals(s); }
+  bool operator!=(const char *s) const { return !equals(s); }
+  bool operator<(const String &s) const { return texto < s.texto; }
+  int compareTo(const String &s) const { return texto.compare(s.texto); }
+  bool startsWith(const String &prefixo) const;
+  bool endsWith(const String &sufixo) const;
+
+  char charAt(unsigned int i) const { return (*this)[i]; }
+  void setCharAt(unsigned int i, char c);
+  char operator[](unsigned int i) const;
+  char &operator[](unsigned int i);
+  void getBytes(unsigned char *buf, unsigned int tamanho, unsigned int inicio = 0) const;
+  void toCharArray(char *buf, unsigned int tamanho, unsigned int inicio = 0) const;
+
+  int indexOf(char c, unsigned int inicio = 0) const;
+  int indexOf(const String &s, unsigned int inicio = 0) const;
+  int lastIndexOf(char c) const;
+  String substring(unsigned int inicio) const;
+  String substring(unsigned int inicio, unsigned int fim) const;
+
+  void replace(const String &de, const String &para);
+  void remove(unsigned int indice, unsigned int quantidade = (unsigned int)-1);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long toInt() const;
+  float toFloat() const;
+
+private:
+  void modelarReserva(unsigned int tamanho);
+
+  std::string texto;
+  char nulo;    // destino de operator[] fora do intervalo, como no Arduino
+
+  // Bloco que a String do Arduino teria no heap do AVR (ver emulador.h)
+  bool temBloco;
+  unsigned int capacidade;
+};
+
+String operator+(const String &a, const String &b);
+String operator+(const String &a, const char *b);
+String operator+(const char *a, const String &b);
+String operator+(const String &a, char b);
+String operator+(const String &a, int b);
+String operator+(const String &a, unsigned int b);
+String operator+(const String &a, long b);
+String operator+(const String &a, unsigned long b);
+String operator+(const String &a, double b);
+
+#endif
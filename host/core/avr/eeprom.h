@@ -0,0 +1,8 @@
+// Substituto de <avr/eeprom.h> para o host: so o teste de EEPE, para
+// quem grava um byte por vez sem esperar a escrita anterior
+#ifndef AVR_EEPROM_H
+#define AVR_EEPROM_H
+
+bool eeprom_is_ready();
+
+#endif
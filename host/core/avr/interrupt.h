@@ -0,0 +1,15 @@
+// Substituto de <avr/interrupt.h> para o host. A rotina de interrupcao
+// vira uma funcao C comum, que o emulador chama entre as instrucoes do
+// sketch quando o timer dispara e as interrupcoes estao habilitadas.
+#ifndef AVR_INTERRUPT_H
+#define AVR_INTERRUPT_H
+
+#define ISR(vetor) extern "C" void vetor(void)
+
+void noInterrupts();
+void interrupts();
+
+#define cli() noInterrupts()
+#define sei() interrupts()
+
+#endif
@@ -0,0 +1,91 @@
+// Substituto de <avr/io.h> para o host: so os registradores que os
+// sketches usam. Os do Timer2 sao lidos pelo emulador, que chama
+// ISR(TIMER2_COMPA_vect) no periodo configurado (ver emulador.cc). O
+// Timer1 so existe no modo normal (contagem livre ate 0xFFFF), com
+// ISR(TIMER1_OVF_vect) a cada volta; TCNT1 sai do relogio virtual.
+//
+// Os de porta (PINx, DDRx, PORTx) sao objetos que repassam cada acesso
+// aos pinos emulados, cobrando o custo das instrucoes do AVR: in/out
+// 1 ciclo, sbi/cbi (|= ou &= de um bit so) 2 ciclos.
+#ifndef AVR_IO_H
+#define AVR_IO_H
+
+#include <stdint.h>
+
+#define _BV(bit) (1 << (bit))
+
+extern volatile uint8_t TCCR2A;
+extern volatile uint8_t TCCR2B;
+extern volatile uint8_t TCNT2;
+extern volatile uint8_t OCR2A;
+extern volatile uint8_t TIMSK2;
+
+// TCCR2A
+#define WGM20 0
+#define WGM21 1
+// TCCR2B
+#define CS20 0
+#define CS21 1
+#define CS22 2
+// TIMSK2
+#define TOIE2 0
+#define OCIE2A 1
+
+extern volatile uint8_t TCCR1A;
+extern volatile uint8_t TCCR1B;
+extern volatile uint8_t TIMSK1;
+
+// TCCR1B
+#define CS10 0
+#define CS11 1
+#define CS12 2
+// TIMSK1
+#define TOIE1 0
+// TIFR1
+#define TOV1 0
+
+// Implementadas em emulador.cc
+uint8_t lerRegistradorIo(uint8_t endereco);
+void escreverRegistradorIo(uint8_t endereco, uint8_t valor);
+// registrador = (registrador & e) | ou
+void modificarRegistradorIo(uint8_t endereco, uint8_t e, uint8_t ou);
+
+class RegistradorIo {
+public:
+  explicit RegistradorIo(uint8_t endereco) : endereco(endereco) {}
+  operator uint8_t() const { return lerRegistradorIo(endereco); }
+  void operator=(uint8_t valor) const { escreverRegistradorIo(endereco, valor); }
+  void operator|=(uint8_t bits) const { modificarRegistradorIo(endereco, 0xFF, bits); }
+  void operator&=(uint8_t bits) const { modificarRegistradorIo(endereco, bits, 0); }
+
+private:
+  uint8_t endereco;
+};
+
+uint16_t lerContadorTimer1();
+void escreverContadorTimer1(uint16_t valor);
+
+// TCNT1: 16 bits, lido e escrito de uma vez (o AVR usa o registrador
+// TEMP para isso), dois ciclos
+class RegistradorContador1 {
+public:
+  operator uint16_t() const { return lerContadorTimer1(); }
+  void operator=(uint16_t valor) const { escreverContadorTimer1(valor); }
+};
+
+// Enderecos de I/O do ATmega328P
+#define PINB  RegistradorIo(0x03)
+#define DDRB  RegistradorIo(0x04)
+#define PORTB RegistradorIo(0x05)
+#define PINC  RegistradorIo(0x06)
+#define DDRC  RegistradorIo(0x07)
+#define PORTC RegistradorIo(0x08)
+#define PIND  RegistradorIo(0x09)
+#define DDRD  RegistradorIo(0x0A)
+#define PORTD RegistradorIo(0x0B)
+#define TIFR1 RegistradorIo(0x16)   // escrever 1 em TOV1 limpa a flag
+#define TCNT1 RegistradorContador1()
+
+#define E2END 0x3FF   // ultimo endereco da EEPROM (1 KB)
+
+#endif
@@ -0,0 +1,24 @@
+// Substituto de <avr/pgmspace.h> para o host: no PC nao existe espaco de
+// programa separado, entao PROGMEM e as leituras pgm_read_* acessam RAM.
+#ifndef PGMSPACE_H
+#define PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+
+#define pgm_read_byte(p)  (*(const uint8_t *)(p))
+#define pgm_read_word(p)  (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define pgm_read_ptr(p)   (*(void * const *)(p))
+
+#define strcmp_P(a, b)     strcmp((a), (b))
+#define strncmp_P(a, b, n) strncmp((a), (b), (n))
+#define strcpy_P(a, b)     strcpy((a), (b))
+#define strlen_P(s)        strlen(s)
+#define memcpy_P(d, s, n)  memcpy((d), (s), (n))
+
+#endif
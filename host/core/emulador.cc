@@ -0,0 +1,853 @@
+#include "emulador.h"
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+
+// Registradores do Timer2 (avr/io.h)
+volatile uint8_t TCCR2A;
+volatile uint8_t TCCR2B;
+volatile uint8_t TCNT2;
+volatile uint8_t OCR2A;
+volatile uint8_t TIMSK2;
+
+// Registradores do Timer1 guardados como estao; TCNT1 e TIFR1 sao
+// calculados a partir do relogio
+volatile uint8_t TCCR1A;
+volatile uint8_t TCCR1B;
+volatile uint8_t TIMSK1;
+
+// Definidas pelo sketch com ISR(...), se ele usar o timer
+extern "C" void TIMER2_COMPA_vect(void) __attribute__((weak));
+extern "C" void TIMER1_OVF_vect(void) __attribute__((weak));
+
+const uint8_t ENDERECO_TIFR1 = 0x16;
+
+namespace emu {
+
+namespace {
+
+struct Pino {
+  uint8_t modo;
+  uint8_t nivel;
+};
+
+struct ByteAgendado {
+  uint64_t chegada;   // ciclo em que o byte termina de chegar
+  uint8_t valor;
+};
+
+struct TeclaAgendada {
+  uint64_t inicio;
+  uint64_t fim;
+  uint8_t pinoLinha;
+  uint8_t pinoColuna;
+  bool vista;
+};
+
+// Valores de pinMode() iguais aos do Arduino.h
+const uint8_t MODO_INPUT = 0;
+const uint8_t MODO_OUTPUT = 1;
+const uint8_t MODO_INPUT_PULLUP = 2;
+
+uint64_t relogio = 0;
+SketchOcioso sketchOcioso = NULL;   // da ferramenta; sobrevive a reiniciar()
+
+Pino pinos[NUM_PINOS];
+bool mostrarPinos = false;
+
+uint64_t ciclosPorByte = FREQUENCIA_CPU * 10 / 9600;
+std::deque<ByteAgendado> rxAgendados;
+uint64_t ultimaChegadaRx = 0;
+std::deque<uint8_t> rxBuffer;
+uint64_t fimTx = 0;   // ciclo em que o ultimo byte da TX termina de sair
+
+void imprimirByte(uint8_t byte, uint64_t) {
+  fputc(byte, stdout);
+}
+ObservadorSerial observadorSerial = imprimirByte;
+
+struct Teclado {
+  bool registrado;
+  char mapa[16 * 16];
+  uint8_t pinosLinha[16];
+  uint8_t pinosColuna[16];
+  uint8_t linhas;
+  uint8_t colunas;
+};
+Teclado teclado;
+std::vector<TeclaAgendada> teclas;
+size_t primeiraTeclaAtiva = 0;
+size_t primeiraTeclaRecente = 0;   // primeira que nao ficou para tras de vez
+
+struct Lcd {
+  uint8_t colunas;
+  uint8_t linhas;
+  uint8_t coluna;
+  uint8_t linha;
+  char celulas[4][40];
+  bool alterado;
+};
+Lcd lcd;
+bool mostrarLcd = false;
+
+uint8_t eeprom[TAMANHO_EEPROM];
+uint32_t desgasteEeprom[TAMANHO_EEPROM];
+uint64_t fimEscritaEeprom = 0;   // ciclo em que a ultima escrita termina
+
+Estatisticas stats;
+
+bool interrupcoesAtivas = true;
+bool emInterrupcao = false;
+uint64_t periodoTimer2 = 0;      // periodo em uso (0 = desligado)
+uint64_t proximoTimer2 = 0;
+Timer2Ocioso timer2Ocioso = NULL;  // da ferramenta; sobrevive a reiniciar()
+uint64_t fimUltimoLoop = 0;      // para o maior intervalo entre loop()
+
+// Timer1: a contagem e (relogio - inicioTimer1) / prescaler enquanto o
+// prescaler nao muda; parado, fica em contagemParada
+uint16_t prescalerTimer1 = 0;
+uint64_t inicioTimer1 = 0;
+uint16_t contagemParada = 0;
+uint64_t proximoEstouro = 0;     // flag TOV1 ligada se ja passou
+const uint16_t PRESCALERS_TIMER1[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };   // 6 e 7: pino T1
+
+// Periodo configurado no Timer2, ou 0 se a interrupcao de comparacao
+// nao estiver ligada
+uint64_t lerPeriodoTimer2() {
+  static const uint16_t PRESCALERS[8] = { 0, 1, 8, 32, 64, 128, 256, 1024 };
+  uint16_t prescaler = PRESCALERS[TCCR2B & 0x07];
+  if (!TIMER2_COMPA_vect || !(TIMSK2 & _BV(OCIE2A)) || !(TCCR2A & _BV(WGM21)) || !prescaler) {
+    return 0;
+  }
+  return (uint64_t)prescaler * (OCR2A + 1);
+}
+
+uint16_t contagemTimer1() {
+  if (!prescalerTimer1) {
+    return contagemParada;
+  }
+  return (uint16_t)((relogio - inicioTimer1) / prescalerTimer1);
+}
+
+// Recomeca a contagem em 'contagem' com o prescaler de agora
+void reiniciarTimer1(uint16_t contagem) {
+  prescalerTimer1 = PRESCALERS_TIMER1[TCCR1B & 0x07];
+  contagemParada = contagem;
+  inicioTimer1 = relogio - (uint64_t)contagem * prescalerTimer1;
+  proximoEstouro = relogio + (uint64_t)(0x10000 - contagem) * prescalerTimer1;
+}
+
+// Acompanha mudancas do prescaler feitas pelo sketch em TCCR1B
+void sincronizarTimer1() {
+  if (PRESCALERS_TIMER1[TCCR1B & 0x07] != prescalerTimer1) {
+    reiniciarTimer1(contagemTimer1());
+  }
+}
+
+bool estouroTimer1Pendente() {
+  return prescalerTimer1 && proximoEstouro <= relogio;
+}
+
+// Limpa a flag: o proximo estouro e o primeiro depois de agora (com a
+// flag ligada por varias voltas, o AVR guarda uma so)
+void atenderEstouroTimer1() {
+  uint64_t volta = (uint64_t)0x10000 * prescalerTimer1;
+  while (proximoEstouro <= relogio) {
+    proximoEstouro += volta;
+  }
+}
+
+// Avanca o relogio ate 'alvo', executando as interrupcoes do Timer2 que
+// vencerem no caminho. Se 'estender', o tempo gasto nas ISRs empurra o
+// alvo (a CPU estava ocupada com elas).
+//
+// Numa espera, se a ferramenta registrou um timer2Ocioso e ele diz que a
+// ISR nao faria nada ate o alvo, as comparacoes sao puladas de uma vez,
+// na mesma fase: uma ISR assim nao muda o fim da espera, so o custo no
+// host.
+void avancarAte(uint64_t alvo, bool estender) {
+  while (!emInterrupcao && interrupcoesAtivas) {
+    uint64_t periodo = lerPeriodoTimer2();
+    if (periodo != periodoTimer2) {
+      periodoTimer2 = periodo;
+      proximoTimer2 = relogio + periodo;
+    }
+    sincronizarTimer1();
+    bool timer1 = TIMER1_OVF_vect && (TIMSK1 & _BV(TOIE1)) && prescalerTimer1;
+    bool vence2 = periodo && proximoTimer2 <= alvo;
+    bool vence1 = timer1 && proximoEstouro <= alvo;
+    if (vence2 && !estender && timer2Ocioso && timer2Ocioso(alvo)) {
+      uint64_t puladas = (alvo - proximoTimer2) / periodo + 1;
+      proximoTimer2 += puladas * periodo;
+      stats.interrupcoesPuladas += puladas;
+      vence2 = false;
+    }
+    if (!vence1 && !vence2) {
+      break;
+    }
+
+    void (*vetor)(void);
+    if (vence2 && (!vence1 || proximoTimer2 <= proximoEstouro)) {
+      // Com as interrupcoes desligadas por muito tempo o AVR guarda so uma
+      if (proximoTimer2 + periodo <= relogio) {
+        proximoTimer2 = relogio - (relogio - proximoTimer2) % periodo;
+      }
+      if (proximoTimer2 > relogio) {
+        relogio = proximoTimer2;
+      }
+      proximoTimer2 += periodo;
+      vetor = TIMER2_COMPA_vect;
+    } else {
+      if (proximoEstouro > relogio) {
+        relogio = proximoEstouro;
+      }
+      atenderEstouroTimer1();
+      vetor = TIMER1_OVF_vect;
+    }
+
+    uint64_t inicio = relogio;
+    emInterrupcao = true;
+    relogio += CUSTO_INTERRUPCAO;
+    vetor();
+    emInterrupcao = false;
+    stats.interrupcoes++;
+    stats.ciclosInterrupcao += relogio - inicio;
+    if (estender) {
+      alvo += relogio - inicio;
+    }
+  }
+  if (alvo > relogio) {
+    relogio = alvo;
+  }
+}
+
+// Move para o buffer RX os bytes que ja chegaram ate agora
+void sincronizarRx() {
+  while (!rxAgendados.empty() && rxAgendados.front().chegada <= relogio) {
+    if (rxBuffer.size() < TAMANHO_BUFFER_RX - 1) {
+      rxBuffer.push_back(rxAgendados.front().valor);
+      stats.bytesRecebidos++;
+    } else {
+      stats.bytesRxPerdidos++;
+    }
+    rxAgendados.pop_front();
+  }
+}
+
+// Bytes na TX que ainda nao terminaram de sair pelo fio
+uint64_t ocupacaoTx() {
+  if (fimTx <= relogio) {
+    return 0;
+  }
+  return (fimTx - relogio + ciclosPorByte - 1) / ciclosPorByte;
+}
+
+bool teclaPressionada(const TeclaAgendada &t) {
+  return t.inicio <= relogio && relogio < t.fim;
+}
+
+}
+
+uint64_t ciclos() {
+  return relogio;
+}
+
+uint64_t micros() {
+  return relogio / CICLOS_POR_US;
+}
+
+uint64_t millis() {
+  return relogio / (CICLOS_POR_US * 1000);
+}
+
+void avancarCiclos(uint64_t n) {
+  avancarAte(relogio + n, true);
+}
+
+void avancarMicros(uint64_t us) {
+  avancarAte(relogio + us * CICLOS_POR_US, false);
+}
+
+void definirYieldOcioso(SketchOcioso ocioso) {
+  sketchOcioso = ocioso;
+}
+
+bool yieldOcioso() {
+  return sketchOcioso && sketchOcioso();
+}
+
+void habilitarInterrupcoes(bool ativas) {
+  interrupcoesAtivas = ativas;
+}
+
+void definirTimer2Ocioso(Timer2Ocioso ocioso) {
+  timer2Ocioso = ocioso;
+}
+
+void reiniciar() {
+  relogio = 0;
+  interrupcoesAtivas = true;
+  emInterrupcao = false;
+  periodoTimer2 = 0;
+  proximoTimer2 = 0;
+  fimUltimoLoop = 0;
+  TCCR2A = TCCR2B = TCNT2 = OCR2A = TIMSK2 = 0;
+  TCCR1A = TCCR1B = TIMSK1 = 0;
+  prescalerTimer1 = 0;
+  inicioTimer1 = 0;
+  contagemParada = 0;
+  proximoEstouro = 0;
+  memset(pinos, 0, sizeof(pinos));
+  rxAgendados.clear();
+  rxBuffer.clear();
+  ultimaChegadaRx = 0;
+  fimTx = 0;
+  teclado.registrado = false;
+  teclas.clear();
+  primeiraTeclaAtiva = 0;
+  primeiraTeclaRecente = 0;
+  memset(&lcd, 0, sizeof(lcd));
+  fimEscritaEeprom = 0;
+  // Strings globais do sketch continuam vivas no heap
+  int64_t heap = stats.bytesHeap;
+  memset(&stats, 0, sizeof(stats));
+  stats.bytesHeap = heap;
+  stats.picoHeap = heap;
+}
+
+// ===== Pinos =====
+
+void definirModoPino(uint8_t pino, uint8_t modo) {
+  avancarCiclos(CUSTO_PIN_MODE);
+  if (pino < NUM_PINOS) {
+    pinos[pino].modo = modo;
+  }
+}
+
+namespace {
+
+void mudarNivel(uint8_t pino, uint8_t nivel) {
+  if (mostrarPinos && pinos[pino].modo == MODO_OUTPUT && pinos[pino].nivel != nivel) {
+    fflush(stdout);
+    printf("[PINO %u = %s @ %llu ms]\n", pino, nivel ? "HIGH" : "LOW",
+           (unsigned long long)millis());
+  }
+  pinos[pino].nivel = nivel;
+}
+
+// Nivel visto no pino, sem cobrar ciclos
+uint8_t nivelLido(uint8_t pino) {
+  if (pinos[pino].modo != MODO_INPUT_PULLUP) {
+    return pinos[pino].nivel;
+  }
+
+  // Tecla pressionada liga linha e coluna: se o outro lado estiver
+  // sendo puxado para LOW, o pull-up deste pino perde
+  while (primeiraTeclaAtiva < teclas.size() && teclas[primeiraTeclaAtiva].fim <= relogio) {
+    primeiraTeclaAtiva++;
+  }
+  for (size_t i = primeiraTeclaAtiva; i < teclas.size() && teclas[i].inicio <= relogio; i++) {
+    TeclaAgendada &t = teclas[i];
+    if (!teclaPressionada(t)) {
+      continue;
+    }
+    uint8_t outro;
+    if (t.pinoLinha == pino) {
+      outro = t.pinoColuna;
+    } else if (t.pinoColuna == pino) {
+      outro = t.pinoLinha;
+    } else {
+      continue;
+    }
+    if (pinos[outro].modo == MODO_OUTPUT && pinos[outro].nivel == 0) {
+      t.vista = true;
+      return 0;
+    }
+  }
+  return 1;
+}
+
+}
+
+void escreverPino(uint8_t pino, uint8_t nivel) {
+  avancarCiclos(CUSTO_DIGITAL_WRITE);
+  if (pino >= NUM_PINOS) {
+    return;
+  }
+  stats.escritasPinos++;
+  mudarNivel(pino, nivel ? 1 : 0);
+}
+
+int lerPino(uint8_t pino) {
+  avancarCiclos(CUSTO_DIGITAL_READ);
+  if (pino >= NUM_PINOS) {
+    return 0;
+  }
+  return nivelLido(pino);
+}
+
+// ===== Portas =====
+
+namespace {
+
+// No Uno: PORTD = pinos 0-7, PORTB = 8-13, PORTC = A0-A5 (14-19). Cada
+// porta tem PINx, DDRx e PORTx em enderecos de I/O seguidos.
+struct Porta {
+  uint8_t enderecoPin;
+  uint8_t primeiroPino;
+  uint8_t quantidade;
+};
+const Porta PORTAS[] = { { 0x03, 8, 6 }, { 0x06, 14, 6 }, { 0x09, 0, 8 } };
+
+enum { REGISTRADOR_PIN, REGISTRADOR_DDR, REGISTRADOR_PORT };
+
+const Porta *acharPorta(uint8_t endereco, uint8_t *registrador) {
+  for (size_t i = 0; i < sizeof(PORTAS) / sizeof(PORTAS[0]); i++) {
+    if (endereco >= PORTAS[i].enderecoPin && endereco < PORTAS[i].enderecoPin + 3) {
+      *registrador = endereco - PORTAS[i].enderecoPin;
+      return &PORTAS[i];
+    }
+  }
+  return NULL;
+}
+
+uint8_t lerPorta(const Porta &porta, uint8_t registrador) {
+  uint8_t valor = 0;
+  for (uint8_t b = 0; b < porta.quantidade; b++) {
+    const Pino &p = pinos[porta.primeiroPino + b];
+    uint8_t bit;
+    if (registrador == REGISTRADOR_PIN) {
+      bit = nivelLido(porta.primeiroPino + b);
+    } else if (registrador == REGISTRADOR_DDR) {
+      bit = p.modo == MODO_OUTPUT;
+    } else {
+      // Em entrada, o bit de PORTx liga o pull-up
+      bit = p.modo == MODO_OUTPUT ? p.nivel : p.modo == MODO_INPUT_PULLUP;
+    }
+    valor |= bit << b;
+  }
+  return valor;
+}
+
+void escreverPorta(const Porta &porta, uint8_t registrador, uint8_t valor) {
+  if (registrador == REGISTRADOR_PIN) {
+    // Escrever 1 em PINx inverte o bit de PORTx
+    valor ^= lerPorta(porta, REGISTRADOR_PORT);
+    registrador = REGISTRADOR_PORT;
+  }
+  uint8_t port = lerPorta(porta, REGISTRADOR_PORT);
+  stats.escritasPinos++;
+  for (uint8_t b = 0; b < porta.quantidade; b++) {
+    uint8_t pino = porta.primeiroPino + b;
+    uint8_t bit = (valor >> b) & 1;
+    if (registrador == REGISTRADOR_DDR) {
+      pinos[pino].modo = bit ? MODO_OUTPUT : ((port >> b) & 1) ? MODO_INPUT_PULLUP : MODO_INPUT;
+    } else if (pinos[pino].modo == MODO_OUTPUT) {
+      mudarNivel(pino, bit);
+    } else {
+      pinos[pino].modo = bit ? MODO_INPUT_PULLUP : MODO_INPUT;
+    }
+  }
+}
+
+}
+
+}
+
+uint8_t lerRegistradorIo(uint8_t endereco) {
+  emu::avancarCiclos(emu::CUSTO_IO);
+  if (endereco == ENDERECO_TIFR1) {
+    emu::sincronizarTimer1();
+    return emu::estouroTimer1Pendente() ? _BV(TOV1) : 0;
+  }
+  uint8_t registrador;
+  const emu::Porta *porta = emu::acharPorta(endereco, &registrador);
+  return porta ? emu::lerPorta(*porta, registrador) : 0;
+}
+
+void escreverRegistradorIo(uint8_t endereco, uint8_t valor) {
+  emu::avancarCiclos(emu::CUSTO_IO);
+  if (endereco == ENDERECO_TIFR1) {
+    emu::sincronizarTimer1();
+    if ((valor & _BV(TOV1)) && emu::estouroTimer1Pendente()) {
+      emu::atenderEstouroTimer1();
+    }
+    return;
+  }
+  uint8_t registrador;
+  const emu::Porta *porta = emu::acharPorta(endereco, &registrador);
+  if (porta) {
+    emu::escreverPorta(*porta, registrador, valor);
+  }
+}
+
+void modificarRegistradorIo(uint8_t endereco, uint8_t e, uint8_t ou) {
+  // Um bit so vira sbi/cbi (2 ciclos, atomico); mais bits, in/op/out
+  uint8_t afetados = (uint8_t)~e | ou;
+  bool umBit = afetados != 0 && (afetados & (afetados - 1)) == 0;
+  emu::avancarCiclos(umBit ? emu::CUSTO_SBI : 3 * emu::CUSTO_IO);
+  uint8_t registrador;
+  const emu::Porta *porta = emu::acharPorta(endereco, &registrador);
+  if (porta) {
+    // sbi em PINx inverte so o bit indicado
+    uint8_t atual = registrador == emu::REGISTRADOR_PIN ? 0 : emu::lerPorta(*porta, registrador);
+    emu::escreverPorta(*porta, registrador, (atual & e) | ou);
+  }
+}
+
+uint16_t lerContadorTimer1() {
+  emu::avancarCiclos(2 * emu::CUSTO_IO);
+  emu::sincronizarTimer1();
+  return emu::contagemTimer1();
+}
+
+void escreverContadorTimer1(uint16_t valor) {
+  emu::avancarCiclos(2 * emu::CUSTO_IO);
+  emu::reiniciarTimer1(valor);
+}
+
+namespace emu {
+
+void registrarPinos(bool ativo) {
+  mostrarPinos = ativo;
+}
+
+// ===== Serial =====
+
+void configurarSerial(unsigned long baud) {
+  ciclosPorByte = (uint64_t)FREQUENCIA_CPU * 10 / baud;
+}
+
+void agendarSerial(uint64_t us, const std::string &bytes) {
+  uint64_t chegada = us * CICLOS_POR_US;
+  if (chegada < ultimaChegadaRx) {
+    chegada = ultimaChegadaRx;
+  }
+  for (size_t i = 0; i < bytes.size(); i++) {
+    chegada += ciclosPorByte;
+    ByteAgendado b = { chegada, (uint8_t)bytes[i] };
+    rxAgendados.push_back(b);
+  }
+  ultimaChegadaRx = chegada;
+}
+
+void receberSerial(const std::string &bytes) {
+  sincronizarRx();
+  for (size_t i = 0; i < bytes.size(); i++) {
+    if (rxBuffer.size() < TAMANHO_BUFFER_RX - 1) {
+      rxBuffer.push_back((uint8_t)bytes[i]);
+      stats.bytesRecebidos++;
+    } else {
+      stats.bytesRxPerdidos++;
+    }
+  }
+}
+
+int serialDisponivel() {
+  avancarCiclos(CUSTO_SERIAL_AVAILABLE);
+  sincronizarRx();
+  return (int)rxBuffer.size();
+}
+
+int serialLer() {
+  avancarCiclos(CUSTO_SERIAL_READ);
+  sincronizarRx();
+  if (rxBuffer.empty()) {
+    return -1;
+  }
+  uint8_t b = rxBuffer.front();
+  rxBuffer.pop_front();
+  return b;
+}
+
+int serialEspiar() {
+  sincronizarRx();
+  return rxBuffer.empty() ? -1 : rxBuffer.front();
+}
+
+void serialEscrever(uint8_t byte) {
+  avancarCiclos(CUSTO_SERIAL_WRITE);
+
+  // Buffer TX cheio: o HardwareSerial fica esperando a UART liberar espaco
+  if (ocupacaoTx() >= TAMANHO_BUFFER_TX) {
+    uint64_t liberado = fimTx - (TAMANHO_BUFFER_TX - 1) * ciclosPorByte;
+    stats.ciclosTxBloqueado += liberado - relogio;
+    avancarAte(liberado, false);
+  }
+
+  fimTx = (fimTx > relogio ? fimTx : relogio) + ciclosPorByte;
+  stats.bytesEnviados++;
+  observadorSerial(byte, relogio);
+}
+
+int serialLivreParaEscrita() {
+  return (int)(TAMANHO_BUFFER_TX - 1 - ocupacaoTx());
+}
+
+void serialEsvaziar() {
+  if (fimTx > relogio) {
+    avancarAte(fimTx, false);
+  }
+}
+
+bool serialAgendadaPendente() {
+  return !rxAgendados.empty() || !rxBuffer.empty();
+}
+
+void observarSerial(ObservadorSerial observador) {
+  observadorSerial = observador ? observador : imprimirByte;
+}
+
+// ===== Teclado =====
+
+void registrarTeclado(const char *mapa, const uint8_t *pinosLinha,
+                      const uint8_t *pinosColuna, uint8_t linhas, uint8_t colunas) {
+  teclado.registrado = true;
+  teclado.linhas = linhas;
+  teclado.colunas = colunas;
+  memcpy(teclado.mapa, mapa, linhas * colunas);
+  memcpy(teclado.pinosLinha, pinosLinha, linhas);
+  memcpy(teclado.pinosColuna, pinosColuna, colunas);
+}
+
+void agendarTecla(uint64_t us, char tecla, uint32_t duracaoMs) {
+  for (uint8_t l = 0; l < teclado.linhas; l++) {
+    for (uint8_t c = 0; c < teclado.colunas; c++) {
+      if (teclado.mapa[l * teclado.colunas + c] == tecla) {
+        TeclaAgendada t;
+        t.inicio = us * CICLOS_POR_US;
+        t.fim = t.inicio + (uint64_t)duracaoMs * 1000 * CICLOS_POR_US;
+        t.pinoLinha = teclado.pinosLinha[l];
+        t.pinoColuna = teclado.pinosColuna[c];
+        t.vista = false;
+
+        // Mantem a lista ordenada pelo inicio
+        std::vector<TeclaAgendada>::iterator pos = teclas.end();
+        while (pos != teclas.begin() && (pos - 1)->inicio > t.inicio) {
+          --pos;
+        }
+        if ((size_t)(pos - teclas.begin()) < primeiraTeclaRecente) {
+          primeiraTeclaRecente = pos - teclas.begin();
+        }
+        teclas.insert(pos, t);
+        stats.teclasAgendadas++;
+        return;
+      }
+    }
+  }
+  fprintf(stderr, "emulador: tecla '%c' nao existe no teclado\n", tecla);
+}
+
+bool teclaAgendadaPendente() {
+  return !teclas.empty() && teclas.back().fim > relogio;
+}
+
+bool tecladoParado(uint64_t ate, uint64_t margem) {
+  while (primeiraTeclaRecente < teclas.size() && teclas[primeiraTeclaRecente].fim + margem <= relogio) {
+    primeiraTeclaRecente++;
+  }
+  return primeiraTeclaRecente == teclas.size() || teclas[primeiraTeclaRecente].inicio > ate + margem;
+}
+
+namespace {
+
+// Folga em volta de cada tecla em que a varredura tem que rodar: o
+// debounce de 10 ms pode pular uma comparacao e a soltura so vale depois
+// de uma varredura que a veja
+const uint64_t MARGEM_VARREDURA = 4;
+
+}
+
+bool varreduraTecladoOciosa(uint64_t ate) {
+  return tecladoParado(ate, MARGEM_VARREDURA * periodoTimer2);
+}
+
+// ===== LCD =====
+
+void configurarLcd(uint8_t colunas, uint8_t linhas) {
+  lcd.colunas = colunas > 40 ? 40 : colunas;
+  lcd.linhas = linhas > 4 ? 4 : linhas;
+  memset(lcd.celulas, ' ', sizeof(lcd.celulas));
+  lcd.coluna = 0;
+  lcd.linha = 0;
+  lcd.alterado = true;
+}
+
+void lcdLimpar() {
+  avancarMicros(LCD_US_CLEAR);
+  stats.clearsLcd++;
+  stats.microsLcd += LCD_US_CLEAR;
+  memset(lcd.celulas, ' ', sizeof(lcd.celulas));
+  lcd.coluna = 0;
+  lcd.linha = 0;
+  lcd.alterado = true;
+}
+
+void lcdPosicionar(uint8_t coluna, uint8_t linha) {
+  lcdComando();
+  lcd.coluna = coluna;
+  lcd.linha = linha < lcd.linhas ? linha : lcd.linhas - 1;
+}
+
+void lcdEscrever(uint8_t caractere) {
+  avancarMicros(LCD_US_POR_BYTE);
+  stats.bytesLcd++;
+  stats.microsLcd += LCD_US_POR_BYTE;
+  // O HD44780 tem 40 posicoes por linha; o que passa da coluna 16 some
+  if (lcd.coluna < 40) {
+    if (lcd.celulas[lcd.linha][lcd.coluna] != (char)caractere) {
+      lcd.celulas[lcd.linha][lcd.coluna] = (char)caractere;
+      lcd.alterado = true;
+    }
+    lcd.coluna++;
+  }
+}
+
+void lcdComando() {
+  avancarMicros(LCD_US_POR_BYTE);
+  stats.bytesLcd++;
+  stats.microsLcd += LCD_US_POR_BYTE;
+}
+
+std::string lcdConteudo() {
+  std::string s = "|";
+  for (uint8_t l = 0; l < lcd.linhas; l++) {
+    s.append(lcd.celulas[l], lcd.colunas);
+    s += "|";
+  }
+  return s;
+}
+
+bool lcdAlterado() {
+  bool alterado = lcd.alterado;
+  lcd.alterado = false;
+  if (alterado && mostrarLcd) {
+    fflush(stdout);
+    printf("[LCD %s @ %llu ms]\n", lcdConteudo().c_str(), (unsigned long long)millis());
+  }
+  return alterado;
+}
+
+void registrarLcd(bool ativo) {
+  mostrarLcd = ativo;
+}
+
+// ===== EEPROM =====
+
+namespace {
+
+struct EepromApagada {
+  EepromApagada() { apagarEeprom(); }
+} eepromApagada;
+
+// Enquanto a escrita anterior nao termina as interrupcoes seguem
+void esperarEeprom() {
+  if (fimEscritaEeprom > relogio) {
+    stats.ciclosEsperaEeprom += fimEscritaEeprom - relogio;
+    avancarAte(fimEscritaEeprom, false);
+  }
+}
+
+}
+
+uint8_t lerEeprom(uint16_t endereco) {
+  esperarEeprom();
+  avancarCiclos(CUSTO_EEPROM_LEITURA);
+  stats.leiturasEeprom++;
+  return eeprom[endereco % TAMANHO_EEPROM];
+}
+
+void escreverEeprom(uint16_t endereco, uint8_t valor) {
+  esperarEeprom();
+  avancarCiclos(CUSTO_EEPROM_ESCRITA);
+  stats.escritasEeprom++;
+  eeprom[endereco % TAMANHO_EEPROM] = valor;
+  desgasteEeprom[endereco % TAMANHO_EEPROM]++;
+  fimEscritaEeprom = relogio + (uint64_t)US_ESCRITA_EEPROM * CICLOS_POR_US;
+}
+
+void apagarEeprom() {
+  memset(eeprom, 0xFF, sizeof(eeprom));
+  memset(desgasteEeprom, 0, sizeof(desgasteEeprom));
+}
+
+bool eepromPronta() {
+  avancarCiclos(1);
+  return fimEscritaEeprom <= relogio;
+}
+
+uint32_t escritasNaCelulaEeprom(uint16_t endereco) {
+  return desgasteEeprom[endereco % TAMANHO_EEPROM];
+}
+
+uint16_t celulaMaisGastaEeprom() {
+  uint16_t maior = 0;
+  for (uint16_t i = 1; i < TAMANHO_EEPROM; i++) {
+    if (desgasteEeprom[i] > desgasteEeprom[maior]) {
+      maior = i;
+    }
+  }
+  return maior;
+}
+
+bool carregarEeprom(const char *arquivo) {
+  FILE *f = fopen(arquivo, "rb");
+  if (!f) {
+    return false;
+  }
+  apagarEeprom();
+  size_t lidos = fread(eeprom, 1, sizeof(eeprom), f);
+  fclose(f);
+  return lidos > 0;
+}
+
+bool salvarEeprom(const char *arquivo) {
+  FILE *f = fopen(arquivo, "wb");
+  if (!f) {
+    return false;
+  }
+  bool ok = fwrite(eeprom, 1, sizeof(eeprom), f) == sizeof(eeprom);
+  return fclose(f) == 0 && ok;
+}
+
+// ===== Estatisticas =====
+
+void registrarHeap(int64_t delta, bool alocacao) {
+  if (alocacao) {
+    stats.alocacoesHeap++;
+  }
+  stats.bytesHeap += delta;
+  if (stats.bytesHeap > stats.picoHeap) {
+    stats.picoHeap = stats.bytesHeap;
+  }
+}
+
+void zerarPicoHeap() {
+  stats.picoHeap = stats.bytesHeap;
+}
+
+const Estatisticas &estatisticas() {
+  return stats;
+}
+
+void contarIteracaoLoop() {
+  stats.iteracoesLoop++;
+  if (relogio - fimUltimoLoop > stats.maiorIntervaloLoop) {
+    stats.maiorIntervaloLoop = relogio - fimUltimoLoop;
+  }
+  fimUltimoLoop = relogio;
+}
+
+void finalizarEstatisticas() {
+  stats.teclasPerdidas = 0;
+  for (size_t i = 0; i < teclas.size(); i++) {
+    if (!teclas[i].vista && teclas[i].fim <= relogio) {
+      stats.teclasPerdidas++;
+    }
+  }
+}
+
+}
@@ -0,0 +1,184 @@
+// Emulador do nucleo Arduino para o host (Linux)
+//
+// Mantem um relogio virtual em ciclos de um ATmega328P a 16 MHz. delay()
+// apenas avanca esse relogio, entao um cenario de minutos roda em
+// microssegundos. As chamadas da API Arduino cobram um custo aproximado
+// em ciclos, e a serial e o LCD seguem o tempo do hardware real
+// (9600 baud = ~1 ms por byte, clear() do HD44780 = ~2 ms).
+#ifndef EMULADOR_H
+#define EMULADOR_H
+
+#include <stdint.h>
+#include <string>
+
+namespace emu {
+
+const uint32_t FREQUENCIA_CPU = 16000000UL;
+const uint32_t CICLOS_POR_US = FREQUENCIA_CPU / 1000000UL;
+
+// Custos aproximados (em ciclos) das funcoes do core no AVR
+const uint32_t CUSTO_DIGITAL_WRITE = 56;
+const uint32_t CUSTO_DIGITAL_READ = 52;
+const uint32_t CUSTO_PIN_MODE = 60;
+const uint32_t CUSTO_MILLIS = 20;
+const uint32_t CUSTO_SERIAL_AVAILABLE = 20;
+const uint32_t CUSTO_SERIAL_READ = 30;
+const uint32_t CUSTO_SERIAL_WRITE = 40;
+const uint32_t CUSTO_LOOP = 40;      // chamada de loop() pelo main() do core
+const uint32_t CUSTO_INTERRUPCAO = 50; // entrada e saida de uma ISR (registradores)
+const uint32_t CUSTO_IO = 1;         // in/out num registrador de porta
+const uint32_t CUSTO_SBI = 2;        // sbi/cbi: liga ou desliga um bit
+
+// Tempos do LCD HD44780 em modo 4 bits (biblioteca LiquidCrystal)
+const uint32_t LCD_US_POR_BYTE = 230;
+const uint32_t LCD_US_CLEAR = 2000 + LCD_US_POR_BYTE;
+
+const uint8_t TAMANHO_BUFFER_RX = 64;
+const uint8_t TAMANHO_BUFFER_TX = 64;
+
+const uint8_t NUM_PINOS = 20;
+
+// ===== Relogio virtual =====
+uint64_t ciclos();
+uint64_t micros();
+uint64_t millis();
+// Trabalho da CPU: interrupcoes que caem no meio atrasam o fim
+void avancarCiclos(uint64_t n);
+// Espera por tempo (delay, barramentos): interrupcoes nao atrasam
+void avancarMicros(uint64_t us);
+// delay() chama yield() a cada ms ate o prazo (o core do AVR chama sem
+// parar). Uma ferramenta que sabe quando o yield() do sketch nao tem o
+// que fazer registra um predicado, e delay() passa o resto da espera de
+// uma vez. NULL (o padrao) chama sempre. Vale ate ser trocado, tambem
+// depois de reiniciar()
+typedef bool (*SketchOcioso)();
+void definirYieldOcioso(SketchOcioso ocioso);
+bool yieldOcioso();
+
+// Volta todo o estado do emulador ao instante zero
+void reiniciar();
+
+// ===== Interrupcoes =====
+// noInterrupts()/interrupts(). Com o Timer2 em modo CTC e OCIE2A ligado,
+// ISR(TIMER2_COMPA_vect) roda a cada prescaler * (OCR2A + 1) ciclos;
+// com TOIE1 ligado, ISR(TIMER1_OVF_vect) a cada prescaler * 65536.
+void habilitarInterrupcoes(bool ativas);
+// O emulador nao sabe o que a ISR do Timer2 faz, entao roda todas as
+// comparacoes. Uma ferramenta que sabe pode registrar um predicado: true
+// se a ISR nao faria nada ate o ciclo 'ate', e nas esperas (delay,
+// barramentos) as comparacoes ate la sao puladas. NULL (o padrao) roda
+// todas. Vale ate ser trocado, tambem depois de reiniciar()
+typedef bool (*Timer2Ocioso)(uint64_t ate);
+void definirTimer2Ocioso(Timer2Ocioso ocioso);
+
+// ===== Pinos =====
+void definirModoPino(uint8_t pino, uint8_t modo);
+void escreverPino(uint8_t pino, uint8_t nivel);
+int lerPino(uint8_t pino);
+void registrarPinos(bool ativo);   // mostra cada mudanca de LED na saida
+// Os registradores PINx/DDRx/PORTx de avr/io.h chegam aos mesmos pinos
+// por lerRegistradorIo()/escreverRegistradorIo(), declaradas la
+
+// ===== Serial =====
+void configurarSerial(unsigned long baud);
+// Agenda bytes para chegarem na RX a partir do instante 'us', um byte
+// a cada tempo de caractere (como um terminal digitando rapido)
+void agendarSerial(uint64_t us, const std::string &bytes);
+// Poe os bytes direto no buffer RX, como se ja tivessem chegado: para
+// reproduzir um rastro gravado na leitura (ver rastro.h)
+void receberSerial(const std::string &bytes);
+int serialDisponivel();
+int serialLer();
+int serialEspiar();
+void serialEscrever(uint8_t byte);
+int serialLivreParaEscrita();
+void serialEsvaziar();
+bool serialAgendadaPendente();
+
+// Recebe cada byte enviado pela TX (padrao: imprime em stdout)
+typedef void (*ObservadorSerial)(uint8_t byte, uint64_t ciclo);
+void observarSerial(ObservadorSerial observador);
+
+// ===== Teclado matricial =====
+void registrarTeclado(const char *mapa, const uint8_t *pinosLinha,
+                      const uint8_t *pinosColuna, uint8_t linhas, uint8_t colunas);
+// Mantem a tecla pressionada de 'us' ate 'us + duracaoMs'
+void agendarTecla(uint64_t us, char tecla, uint32_t duracaoMs = 100);
+bool teclaAgendadaPendente();
+// Nenhuma tecla agendada pressionada de 'margem' ciclos antes de agora
+// ate 'margem' depois do ciclo 'ate'
+bool tecladoParado(uint64_t ate, uint64_t margem);
+// Predicado para definirTimer2Ocioso() quando a ISR do Timer2 so varre o
+// teclado (teclado_timer.h): ocioso sem tecla a menos de 4 periodos,
+// folga para o debounce de 10 ms e para a varredura que ve a soltura
+bool varreduraTecladoOciosa(uint64_t ate);
+
+// ===== LCD =====
+void configurarLcd(uint8_t colunas, uint8_t linhas);
+void lcdLimpar();
+void lcdPosicionar(uint8_t coluna, uint8_t linha);
+void lcdEscrever(uint8_t caractere);
+void lcdComando();
+std::string lcdConteudo();          // "|linha 0|linha 1|"
+bool lcdAlterado();                 // alterado desde a ultima consulta
+void registrarLcd(bool ativo);      // mostra o LCD na saida a cada mudanca
+
+// ===== EEPROM =====
+// 1 KB do ATmega328P. Comeca apagada (0xFF) e sobrevive a reiniciar(),
+// como num reset. A escrita de um byte leva ~3,4 ms, mas a CPU so espera
+// por ela no proximo acesso a EEPROM (eeprom_write_byte aguarda EEPE
+// antes de comecar), como no AVR.
+const uint16_t TAMANHO_EEPROM = 1024;
+const uint32_t CUSTO_EEPROM_LEITURA = 12;   // espera EEPE, sbi EERE e a CPU parada 4 ciclos
+const uint32_t CUSTO_EEPROM_ESCRITA = 14;   // carrega EEAR/EEDR, EEMPE, EEPE
+const uint32_t US_ESCRITA_EEPROM = 3400;
+uint8_t lerEeprom(uint16_t endereco);
+void escreverEeprom(uint16_t endereco, uint8_t valor);
+void apagarEeprom();
+// EEPE limpo: a escrita anterior terminou (eeprom_is_ready(), 1 ciclo)
+bool eepromPronta();
+// Desgaste: escritas que cada celula ja recebeu. Como o conteudo, sobrevive
+// a reiniciar(); apagarEeprom() zera tambem a contagem
+uint32_t escritasNaCelulaEeprom(uint16_t endereco);
+uint16_t celulaMaisGastaEeprom();
+// Imagem binaria de ate TAMANHO_EEPROM bytes; false se nao abriu
+bool carregarEeprom(const char *arquivo);
+bool salvarEeprom(const char *arquivo);
+
+// ===== Estatisticas =====
+struct Estatisticas {
+  uint64_t iteracoesLoop;
+  uint64_t maiorIntervaloLoop;    // ciclos entre duas iteracoes (loop() mais lento)
+  uint64_t bytesRecebidos;
+  uint64_t bytesRxPerdidos;       // buffer RX cheio
+  uint64_t bytesEnviados;
+  uint64_t ciclosTxBloqueado;     // tempo parado esperando espaco na TX
+  uint64_t escritasPinos;
+  uint64_t bytesLcd;
+  uint64_t clearsLcd;
+  uint64_t microsLcd;             // tempo total no barramento do LCD
+  uint64_t teclasAgendadas;
+  uint64_t teclasPerdidas;        // soltas sem nenhuma varredura ve-las
+  uint64_t interrupcoes;
+  uint64_t ciclosInterrupcao;     // tempo gasto dentro das ISRs
+  uint64_t interrupcoesPuladas;   // varreduras do teclado puladas numa espera sem tecla
+  uint64_t leiturasEeprom;
+  uint64_t escritasEeprom;
+  uint64_t ciclosEsperaEeprom;    // parado esperando a escrita anterior
+  uint64_t alocacoesHeap;         // malloc/realloc feitos pela classe String
+  int64_t bytesHeap;              // heap ocupado agora (modelo do AVR)
+  int64_t picoHeap;
+};
+
+// Modelo do heap do AVR: a String do Arduino guarda o texto num bloco
+// de malloc (tamanho + 1, mais 2 bytes de cabecalho do avr-libc)
+void registrarHeap(int64_t delta, bool alocacao);
+void zerarPicoHeap();
+
+const Estatisticas &estatisticas();
+void contarIteracaoLoop();
+void finalizarEstatisticas();       // contabiliza teclas nunca vistas
+
+}
+
+#endif
@@ -0,0 +1,14 @@
+// Substituto de <util/crc16.h> do avr-libc, com as mesmas formulas
+#ifndef UTIL_CRC16_H
+#define UTIL_CRC16_H
+
+#include <stdint.h>
+
+// CRC-CCITT refletido (polinomio 0x8408), como no avr-libc
+static inline uint16_t _crc_ccitt_update(uint16_t crc, uint8_t dado) {
+  dado ^= (uint8_t)(crc & 0xFF);
+  dado ^= (uint8_t)(dado << 4);
+  return (uint16_t)((((uint16_t)dado << 8) | (crc >> 8)) ^ (uint8_t)(dado >> 4) ^ ((uint16_t)dado << 3));
+}
+
+#endif
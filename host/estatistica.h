@@ -0,0 +1,119 @@
+// Estatistica incremental para as ferramentas de timing do host: media
+// e variancia de Welford, teste t de Welch entre duas classes e um
+// histograma logaritmico que guarda milhoes de medidas em memoria fixa.
+#ifndef ESTATISTICA_H
+#define ESTATISTICA_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+// Media e variancia atualizadas a cada amostra (Welford)
+struct Acumulador {
+  double n;
+  double media;
+  double m2;
+
+  Acumulador() : n(0), media(0), m2(0) {}
+
+  void adicionar(double x) {
+    n++;
+    double delta = x - media;
+    media += delta / n;
+    m2 += delta * (x - media);
+  }
+
+  double variancia() const {
+    return n > 1 ? m2 / (n - 1) : 0;
+  }
+};
+
+// Teste t de Welch entre a classe 0 e a classe 1
+struct TesteWelch {
+  Acumulador classe[2];
+
+  void adicionar(int c, double x) {
+    classe[c].adicionar(x);
+  }
+
+  double n() const {
+    return classe[0].n + classe[1].n;
+  }
+
+  double t() const {
+    const Acumulador &a = classe[0], &b = classe[1];
+    if (a.n < 2 || b.n < 2) {
+      return 0;
+    }
+    double diferenca = a.media - b.media;
+    double erro = sqrt(a.variancia() / a.n + b.variancia() / b.n);
+    if (erro == 0) {
+      // Medidas constantes: so ha vazamento se as medias diferem
+      return diferenca == 0 ? 0 : INFINITY;
+    }
+    return diferenca / erro;
+  }
+};
+
+// Probabilidade bilateral de |t| tao grande sem vazamento. Com milhares
+// de amostras a distribuicao t ja e praticamente a normal.
+inline double valorP(double t) {
+  return erfc(fabs(t) / sqrt(2.0));
+}
+
+// Histograma com 8 faixas por potencia de 2 (erro relativo < 12,5%)
+class Histograma {
+public:
+  static const int SUBFAIXAS = 8;
+  static const int FAIXAS = 16 + (64 - 4) * SUBFAIXAS;
+
+  Histograma() : total(0) {
+    memset(contagem, 0, sizeof(contagem));
+  }
+
+  void adicionar(uint64_t x) {
+    contagem[faixa(x)]++;
+    total++;
+  }
+
+  uint64_t amostras() const {
+    return total;
+  }
+
+  // Limite inferior da faixa que contem o percentil p (0..1)
+  uint64_t percentil(double p) const {
+    uint64_t alvo = (uint64_t)(p * total);
+    uint64_t acumulado = 0;
+    for (int i = 0; i < FAIXAS; i++) {
+      acumulado += contagem[i];
+      if (acumulado > alvo) {
+        return inicioFaixa(i);
+      }
+    }
+    return total ? inicioFaixa(FAIXAS - 1) : 0;
+  }
+
+private:
+  uint64_t contagem[FAIXAS];
+  uint64_t total;
+
+  static int faixa(uint64_t x) {
+    if (x < 16) {
+      return (int)x;
+    }
+    int expoente = 63 - __builtin_clzll(x);
+    int sub = (int)(x >> (expoente - 3)) & (SUBFAIXAS - 1);
+    return 16 + (expoente - 4) * SUBFAIXAS + sub;
+  }
+
+  static uint64_t inicioFaixa(int i) {
+    if (i < 16) {
+      return (uint64_t)i;
+    }
+    int expoente = (i - 16) / SUBFAIXAS + 4;
+    uint64_t sub = (uint64_t)((i - 16) % SUBFAIXAS);
+    return (SUBFAIXAS + sub) << (expoente - 3);
+  }
+};
+
+#endif
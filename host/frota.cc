@@ -0,0 +1,451 @@
+// Simulador de frota: centenas de instancias emuladas do mesmo sketch,
+// cada uma com o seu relogio virtual e o seu segredo, executadas por um
+// pool de threads com roubo de trabalho. Mede a vazao agregada e como
+// ela escala com o numero de threads.
+//
+// Cada instancia e uma copia propria da biblioteca
+// build/instancias/instancia_<sketch>.so (ver instancia_frota.cc), carregada
+// com dlopen; por isso as globais do sketch e do emulador nao sao
+// compartilhadas. Uma instancia so roda em uma thread por vez: a tarefa
+// de uma instancia executa um bloco de trabalho e volta para a fila da
+// thread que a executou. Threads sem trabalho roubam do inicio da fila
+// de outra thread.
+//
+// Cargas:
+//   verificacao  tentativas aleatorias contra a senha de cada instancia
+//   ataque       ataque de timing digito a digito contra cada instancia
+//   comandos     lotes de comandos pela serial do projeto_1
+//
+//   build/frota --carga ataque --instancias 256 --threads 1,2,4,8
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const uint32_t CICLOS_POR_MS = 16000;
+const int DIGITOS_SENHA = 4;
+const int AMOSTRAS_POR_DIGITO = 4;
+const double RUIDO_MS = 30;           // ruido de medida do atacante
+const int VERIFICACOES_POR_BLOCO = 100;
+const char LOTE_COMANDOS[] = "LED_ON;STATUS;LED_OFF\n";
+const int COMANDOS_POR_LOTE = 3;
+
+enum Carga { VERIFICACAO, ATAQUE, COMANDOS };
+
+struct Biblioteca {
+  void *handle;
+  void (*iniciar)(unsigned long);
+  uint64_t (*ciclos)();
+  bool (*definirSenha)(const char *);
+  int (*verificar)(const char *, bool, uint64_t *);
+  void (*enviarSerial)(const char *);
+  void (*executarAteOcioso)();
+};
+
+struct Instancia {
+  Biblioteca lib;
+  std::mt19937_64 gerador;
+  char senha[DIGITOS_SENHA + 1];
+  int restantes;                      // blocos de trabalho que faltam
+  // Estado do ataque
+  char palpite[DIGITOS_SENHA + 1];
+  int posicao;
+  bool descoberta;
+  uint64_t operacoes;
+};
+
+// ===== Carregamento das instancias =====
+
+bool copiarArquivo(const char *origem, const char *destino) {
+  FILE *in = fopen(origem, "rb");
+  if (!in) {
+    return false;
+  }
+  FILE *out = fopen(destino, "wb");
+  if (!out) {
+    fclose(in);
+    return false;
+  }
+  char buf[1 << 16];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+    fwrite(buf, 1, n, out);
+  }
+  fclose(in);
+  return fclose(out) == 0;
+}
+
+template <typename F>
+bool resolver(void *handle, const char *nome, F &destino) {
+  destino = (F)dlsym(handle, nome);
+  return destino != NULL;
+}
+
+// O dlopen reaproveita um arquivo ja carregado, entao cada instancia
+// carrega uma copia com outro nome. A copia e apagada logo depois; o
+// mapeamento continua valido.
+bool carregar(const std::string &caminho, const std::string &diretorio, int indice, Biblioteca &lib) {
+  std::string copia = diretorio + "/instancia" + std::to_string(indice) + ".so";
+  if (!copiarArquivo(caminho.c_str(), copia.c_str())) {
+    fprintf(stderr, "frota: nao foi possivel copiar %s\n", caminho.c_str());
+    return false;
+  }
+  lib.handle = dlopen(copia.c_str(), RTLD_NOW | RTLD_LOCAL);
+  unlink(copia.c_str());
+  if (!lib.handle) {
+    fprintf(stderr, "frota: %s\n", dlerror());
+    return false;
+  }
+  return resolver(lib.handle, "frota_iniciar", lib.iniciar) &&
+         resolver(lib.handle, "frota_ciclos", lib.ciclos) &&
+         resolver(lib.handle, "frota_definir_senha", lib.definirSenha) &&
+         resolver(lib.handle, "frota_verificar", lib.verificar) &&
+         resolver(lib.handle, "frota_enviar_serial", lib.enviarSerial) &&
+         resolver(lib.handle, "frota_executar_ate_ocioso", lib.executarAteOcioso);
+}
+
+bool carregarTodas(const std::string &caminho, std::vector<Instancia> &instancias) {
+  char diretorio[] = "/tmp/frota-XXXXXX";
+  if (!mkdtemp(diretorio)) {
+    perror("frota: mkdtemp");
+    return false;
+  }
+  bool ok = true;
+  for (size_t i = 0; i < instancias.size() && ok; i++) {
+    ok = carregar(caminho, diretorio, (int)i, instancias[i].lib);
+  }
+  rmdir(diretorio);
+  return ok;
+}
+
+void descarregarTodas(std::vector<Instancia> &instancias) {
+  for (size_t i = 0; i < instancias.size(); i++) {
+    dlclose(instancias[i].lib.handle);
+    instancias[i].lib.handle = NULL;
+  }
+}
+
+// ===== Cargas =====
+
+struct Opcoes {
+  Carga carga;
+  bool segura;
+  int blocos;
+};
+
+void preparar(Instancia &inst, int indice, unsigned long semente, const Opcoes &op) {
+  inst.gerador.seed(semente * 1000003UL + indice);
+  inst.lib.iniciar((unsigned long)inst.gerador());
+  for (int i = 0; i < DIGITOS_SENHA; i++) {
+    inst.senha[i] = (char)('0' + inst.gerador() % 10);
+  }
+  inst.senha[DIGITOS_SENHA] = '\0';
+  inst.lib.definirSenha(inst.senha);
+  memset(inst.palpite, '0', DIGITOS_SENHA);
+  inst.palpite[DIGITOS_SENHA] = '\0';
+  inst.posicao = 0;
+  inst.descoberta = false;
+  inst.operacoes = 0;
+  inst.restantes = op.carga == ATAQUE ? DIGITOS_SENHA : op.blocos;
+  if (op.carga == COMANDOS) {
+    inst.lib.enviarSerial("AUTH:1234\n");
+    inst.lib.executarAteOcioso();
+  }
+}
+
+// Ataque de um digito: mede cada candidato algumas vezes (tempo virtual
+// mais ruido) e fica com o mais lento. No ultimo digito o acesso
+// liberado ja confirma o palpite.
+void atacarDigito(Instancia &inst, bool segura) {
+  std::normal_distribution<double> ruido(0, RUIDO_MS);
+  double melhorTempo = -1;
+  char melhor = '0';
+  for (char d = '0'; d <= '9'; d++) {
+    inst.palpite[inst.posicao] = d;
+    double soma = 0;
+    for (int a = 0; a < AMOSTRAS_POR_DIGITO; a++) {
+      uint64_t ciclos;
+      int liberado = inst.lib.verificar(inst.palpite, segura, &ciclos);
+      inst.operacoes++;
+      if (liberado == 1) {
+        inst.descoberta = true;
+        return;
+      }
+      soma += (double)ciclos / CICLOS_POR_MS + ruido(inst.gerador);
+    }
+    if (soma > melhorTempo) {
+      melhorTempo = soma;
+      melhor = d;
+    }
+  }
+  inst.palpite[inst.posicao++] = melhor;
+}
+
+// Executa um bloco; retorna false quando a instancia terminou
+bool executarBloco(Instancia &inst, const Opcoes &op) {
+  if (op.carga == VERIFICACAO) {
+    char tentativa[DIGITOS_SENHA + 1] = { 0 };
+    for (int i = 0; i < VERIFICACOES_POR_BLOCO; i++) {
+      for (int j = 0; j < DIGITOS_SENHA; j++) {
+        tentativa[j] = (char)('0' + inst.gerador() % 10);
+      }
+      uint64_t ciclos;
+      inst.lib.verificar(tentativa, op.segura, &ciclos);
+      inst.operacoes++;
+    }
+  } else if (op.carga == ATAQUE) {
+    atacarDigito(inst, op.segura);
+    if (inst.descoberta) {
+      return false;
+    }
+  } else {
+    inst.lib.enviarSerial(LOTE_COMANDOS);
+    inst.lib.executarAteOcioso();
+    inst.operacoes += COMANDOS_POR_LOTE;
+  }
+  return --inst.restantes > 0;
+}
+
+// ===== Pool com roubo de trabalho =====
+
+class FilaTarefas {
+public:
+  void empilhar(int tarefa) {
+    std::lock_guard<std::mutex> trava(mutex);
+    tarefas.push_back(tarefa);
+  }
+
+  // A dona pega do fim (a tarefa mais recente, ainda quente no cache)
+  bool desempilhar(int &tarefa) {
+    std::lock_guard<std::mutex> trava(mutex);
+    if (tarefas.empty()) {
+      return false;
+    }
+    tarefa = tarefas.back();
+    tarefas.pop_back();
+    return true;
+  }
+
+  // Quem rouba pega do inicio
+  bool roubar(int &tarefa) {
+    std::lock_guard<std::mutex> trava(mutex);
+    if (tarefas.empty()) {
+      return false;
+    }
+    tarefa = tarefas.front();
+    tarefas.pop_front();
+    return true;
+  }
+
+private:
+  std::mutex mutex;
+  std::deque<int> tarefas;
+};
+
+struct Rodada {
+  double segundos;
+  uint64_t operacoes;
+  uint64_t ciclosVirtuais;
+  uint64_t roubos;
+  int descobertas;
+};
+
+Rodada executar(std::vector<Instancia> &instancias, int threads, unsigned long semente,
+                const Opcoes &op) {
+  for (size_t i = 0; i < instancias.size(); i++) {
+    preparar(instancias[i], (int)i, semente, op);
+  }
+  // Se as copias compartilhassem globais, so o ultimo segredo valeria
+  for (size_t i = 0; op.carga != COMANDOS && i < instancias.size(); i++) {
+    uint64_t ciclos;
+    if (instancias[i].lib.verificar(instancias[i].senha, true, &ciclos) != 1) {
+      fprintf(stderr, "frota: instancia %zu nao reconhece a propria senha\n", i);
+      exit(1);
+    }
+  }
+  std::vector<uint64_t> ciclosIniciais(instancias.size());
+  for (size_t i = 0; i < instancias.size(); i++) {
+    ciclosIniciais[i] = instancias[i].lib.ciclos();
+  }
+
+  std::vector<FilaTarefas> filas(threads);
+  for (size_t i = 0; i < instancias.size(); i++) {
+    filas[i % threads].empilhar((int)i);
+  }
+  std::atomic<int> ativas((int)instancias.size());
+  std::atomic<uint64_t> roubos(0);
+
+  std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; t++) {
+    pool.push_back(std::thread([&, t]() {
+      std::mt19937 vitimas(t);
+      int tarefa;
+      while (ativas.load() > 0) {
+        bool achou = filas[t].desempilhar(tarefa);
+        for (int tentativa = 0; !achou && tentativa < threads - 1; tentativa++) {
+          int v = (int)(vitimas() % threads);
+          if (v != t && filas[v].roubar(tarefa)) {
+            achou = true;
+            roubos++;
+          }
+        }
+        if (!achou) {
+          std::this_thread::yield();
+          continue;
+        }
+        if (executarBloco(instancias[tarefa], op)) {
+          filas[t].empilhar(tarefa);
+        } else {
+          ativas--;
+        }
+      }
+    }));
+  }
+  for (size_t t = 0; t < pool.size(); t++) {
+    pool[t].join();
+  }
+
+  Rodada r;
+  r.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+  r.operacoes = 0;
+  r.ciclosVirtuais = 0;
+  r.descobertas = 0;
+  for (size_t i = 0; i < instancias.size(); i++) {
+    Instancia &inst = instancias[i];
+    r.operacoes += inst.operacoes;
+    r.ciclosVirtuais += inst.lib.ciclos() - ciclosIniciais[i];
+    if (op.carga == ATAQUE && (inst.descoberta || strcmp(inst.palpite, inst.senha) == 0)) {
+      r.descobertas++;
+    }
+  }
+  r.roubos = roubos.load();
+  return r;
+}
+
+std::vector<int> lerThreads(const char *lista) {
+  std::vector<int> r;
+  for (const char *p = lista; *p;) {
+    char *fim;
+    long n = strtol(p, &fim, 10);
+    if (fim == p || n < 1) {
+      return std::vector<int>();
+    }
+    r.push_back((int)n);
+    p = *fim == ',' ? fim + 1 : fim;
+  }
+  return r;
+}
+
+void uso(const char *programa) {
+  fprintf(stderr,
+          "uso: %s [opcoes]\n"
+          "  --carga verificacao|ataque|comandos  (padrao verificacao)\n"
+          "  --segura               usa verificarSenhaSegura\n"
+          "  --instancias N         instancias emuladas (padrao 256)\n"
+          "  --threads 1,2,4        numeros de threads a medir (padrao: potencias de 2\n"
+          "                         ate o numero de nucleos)\n"
+          "  --blocos N             blocos de trabalho por instancia (padrao 20)\n"
+          "  --semente S\n",
+          programa);
+}
+
+}
+
+int main(int argc, char **argv) {
+  Opcoes op;
+  op.carga = VERIFICACAO;
+  op.segura = false;
+  op.blocos = 20;
+  int total = 256;
+  unsigned long semente = 1;
+  std::vector<int> threads;
+
+  for (int i = 1; i < argc; i++) {
+    const char *valor = i + 1 < argc ? argv[i + 1] : NULL;
+    if (!strcmp(argv[i], "--segura")) {
+      op.segura = true;
+    } else if (!valor) {
+      uso(argv[0]);
+      return 2;
+    } else if (!strcmp(argv[i], "--carga")) {
+      op.carga = !strcmp(valor, "ataque") ? ATAQUE : !strcmp(valor, "comandos") ? COMANDOS : VERIFICACAO;
+      i++;
+    } else if (!strcmp(argv[i], "--instancias")) {
+      total = atoi(valor);
+      i++;
+    } else if (!strcmp(argv[i], "--threads")) {
+      threads = lerThreads(valor);
+      i++;
+    } else if (!strcmp(argv[i], "--blocos")) {
+      op.blocos = atoi(valor);
+      i++;
+    } else if (!strcmp(argv[i], "--semente")) {
+      semente = strtoul(valor, NULL, 10);
+      i++;
+    } else {
+      uso(argv[0]);
+      return 2;
+    }
+  }
+  if (threads.empty()) {
+    int nucleos = (int)std::thread::hardware_concurrency();
+    for (int n = 1; n < nucleos; n *= 2) {
+      threads.push_back(n);
+    }
+    threads.push_back(nucleos > 0 ? nucleos : 1);
+  }
+  if (total < 1 || op.blocos < 1) {
+    uso(argv[0]);
+    return 2;
+  }
+
+  // A biblioteca fica ao lado do executavel
+  std::string base = argv[0];
+  base = base.substr(0, base.find_last_of('/') + 1);
+  std::string caminho = base + (op.carga == COMANDOS ? "instancias/instancia_projeto_1.so"
+                                                     : "instancias/instancia_projeto_2-timing_attack-corrigido.so");
+  std::vector<Instancia> instancias(total);
+  const char *nomesCarga[] = { "verificacao", "ataque", "comandos" };
+  const char *unidade = op.carga == COMANDOS ? "comandos/s" : "verificacoes/s";
+  printf("carga %s%s, %d instancias de %s, %u nucleos\n\n",
+         nomesCarga[op.carga], op.carga != COMANDOS ? (op.segura ? " (segura)" : " (vulneravel)") : "",
+         total, caminho.c_str(), std::thread::hardware_concurrency());
+  printf("%7s | %9s | %12s | %14s | %10s | %7s | %8s%s\n", "threads", "tempo", "operacoes",
+         unidade, "s virtuais", "ganho", "roubos", op.carga == ATAQUE ? " | senhas" : "");
+  printf("--------+-----------+--------------+----------------+------------+---------+---------%s\n",
+         op.carga == ATAQUE ? "+--------" : "");
+
+  double vazaoInicial = 0;   // o ganho e relativo a primeira rodada
+  for (size_t k = 0; k < threads.size(); k++) {
+    // Instancias novas a cada rodada: setup() nao zera as globais do sketch
+    if (!carregarTodas(caminho, instancias)) {
+      return 1;
+    }
+    Rodada r = executar(instancias, threads[k], semente, op);
+    descarregarTodas(instancias);
+    double vazao = r.operacoes / r.segundos;
+    if (k == 0) {
+      vazaoInicial = vazao;
+    }
+    printf("%7d | %7.3f s | %12llu | %14.0f | %10.1f | %6.2fx | %8llu", threads[k], r.segundos,
+           (unsigned long long)r.operacoes, vazao, r.ciclosVirtuais / (CICLOS_POR_MS * 1000.0),
+           vazao / vazaoInicial, (unsigned long long)r.roubos);
+    if (op.carga == ATAQUE) {
+      printf(" | %3d/%d", r.descobertas, total);
+    }
+    printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,332 @@
+#!/usr/bin/env python3
+"""Gera o catalogo de mensagens comprimido de um sketch (ver catalogo.h).
+
+Le os textos de MSG("...") do sketch, junta os repetidos, comprime com
+pares de bytes (cada par vira um codigo de 0x80 a 0xFF, e um par pode
+conter outros pares), troca o comeco de uma mensagem por uma referencia
+quando ele e outra mensagem inteira e faz mensagens que sao o final de
+outra apontarem para dentro dela.
+
+O arquivo so e reescrito se o conteudo mudar.
+
+uso: gerar_catalogo.py sketch.cc catalogo.h [--resumo]
+"""
+import os
+import re
+import sys
+
+FIM_MENSAGEM = 0x00
+PREFIXO_MENSAGEM = 0x01
+BYTE_LITERAL = 0x02
+PRIMEIRO_PAR = 0x80
+MAX_PARES = 0x100 - PRIMEIRO_PAR
+PROFUNDIDADE_PARES = 12   # igual a catalogo.h
+
+# MSG("...") e as macros terminadas em _MSG (ID_MSG, LINHA_MSG de cenario.h...)
+MSG = re.compile(r'\b(?:\w+_)?MSG\("((?:[^"\\\n]|\\.)*)"\)')
+ESCAPES = {'n': 0x0A, 'r': 0x0D, 't': 0x09, '\\': 0x5C, '"': 0x22, "'": 0x27, '0': 0x00}
+
+
+def desescapar(texto):
+    """Bytes que o compilador gera para o literal (fonte em UTF-8)."""
+    bruto = texto.encode('utf-8')
+    saida = bytearray()
+    i = 0
+    while i < len(bruto):
+        c = bruto[i]
+        if c != 0x5C:
+            saida.append(c)
+            i += 1
+            continue
+        e = chr(bruto[i + 1])
+        if e == 'x':
+            m = re.match(rb'[0-9A-Fa-f]+', bruto[i + 2:])
+            saida.append(int(m.group(0), 16) & 0xFF)
+            i += 2 + len(m.group(0))
+        else:
+            saida.append(ESCAPES[e])
+            i += 2
+    return bytes(saida)
+
+
+def hash_mensagem(texto):
+    h = 2166136261
+    for c in texto:
+        h = ((h ^ c) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def simbolos(texto):
+    """Texto -> lista de simbolos; bytes >= 0x80 ficam como ('lit', b)."""
+    return [c if 0x03 <= c < 0x80 else ('lit', c) for c in texto]
+
+
+def comprimir(mensagens):
+    """Pares de bytes gulosos. Retorna (pares, sequencias)."""
+    seqs = [simbolos(m) for m in mensagens]
+    pares = []
+    profundidade = {}
+
+    def prof(s):
+        return profundidade.get(s, 0) if isinstance(s, int) else 0
+
+    while len(pares) < MAX_PARES:
+        contagem = {}
+        for seq in seqs:
+            i = 0
+            while i < len(seq) - 1:
+                a, b = seq[i], seq[i + 1]
+                if isinstance(a, int) and isinstance(b, int) and \
+                        max(prof(a), prof(b)) + 1 <= PROFUNDIDADE_PARES:
+                    contagem[(a, b)] = contagem.get((a, b), 0) + 1
+                    # "aaa" conta uma vez so
+                    if i + 2 < len(seq) and seq[i + 2] == b and a == b:
+                        i += 1
+                i += 1
+        if not contagem:
+            break
+        melhor = max(contagem, key=lambda par: (contagem[par], -len(pares)))
+        # Cada troca economiza um byte; o par custa dois no dicionario
+        if contagem[melhor] < 3:
+            break
+        codigo = PRIMEIRO_PAR + len(pares)
+        pares.append(melhor)
+        profundidade[codigo] = max(prof(melhor[0]), prof(melhor[1])) + 1
+        for n, seq in enumerate(seqs):
+            nova = []
+            i = 0
+            while i < len(seq):
+                if i < len(seq) - 1 and (seq[i], seq[i + 1]) == melhor:
+                    nova.append(codigo)
+                    i += 2
+                else:
+                    nova.append(seq[i])
+                    i += 1
+            seqs[n] = nova
+    return pares, seqs
+
+
+def codificar(seq):
+    saida = []
+    for s in seq:
+        if isinstance(s, tuple):
+            saida += [BYTE_LITERAL, s[1]]
+        else:
+            saida.append(s)
+    return saida
+
+
+def montar(mensagens):
+    pares, seqs = comprimir(mensagens)
+    codigos = [codificar(s) for s in seqs]
+
+    # Prefixo: a mensagem comeca com outra inteira (so compensa se a
+    # outra ocupar mais que os 2 bytes da referencia). A outra tem que
+    # estar guardada inteira, sem prefixo proprio: o decodificador desce
+    # um nivel so. As mais curtas decidem primeiro, entao quando uma
+    # longa procura a sua, as candidatas ja estao resolvidas
+    finais = list(codigos)
+    prefixos = 0
+    for i in sorted(range(len(codigos)), key=lambda i: len(codigos[i])):
+        c = codigos[i]
+        melhor = None
+        for j, outro in enumerate(codigos):
+            if j == i or j > 0xFF or len(outro) <= 2 or len(outro) >= len(c):
+                continue
+            if finais[j][0] == PREFIXO_MENSAGEM:
+                continue
+            if c[:len(outro)] == outro and (melhor is None or len(outro) > len(codigos[melhor])):
+                melhor = j
+        if melhor is not None:
+            finais[i] = [PREFIXO_MENSAGEM, melhor] + c[len(codigos[melhor]):]
+            prefixos += 1
+
+    # Sufixo: a mensagem e o final de outra ja guardada. As mais longas
+    # entram primeiro para as curtas poderem apontar para elas
+    fluxo = []
+    inicios = [0] * len(finais)
+    ordem = sorted(range(len(finais)), key=lambda i: -len(finais[i]))
+    guardadas = []
+    sufixos = 0
+    for i in ordem:
+        alvo = finais[i] + [FIM_MENSAGEM]
+        achou = None
+        for inicio, tamanho in guardadas:
+            trecho = fluxo[inicio:inicio + tamanho]
+            if len(trecho) >= len(alvo) and trecho[len(trecho) - len(alvo):] == alvo:
+                # Nao pode cair no meio de um codigo de dois bytes
+                pos = inicio + len(trecho) - len(alvo)
+                if valido_em(fluxo, inicio, pos):
+                    achou = pos
+                    break
+        if achou is not None:
+            inicios[i] = achou
+            sufixos += 1
+        else:
+            inicios[i] = len(fluxo)
+            guardadas.append((len(fluxo), len(alvo)))
+            fluxo += alvo
+    return pares, fluxo, inicios, prefixos, sufixos
+
+
+def valido_em(fluxo, inicio, pos):
+    """pos e o comeco de um codigo se lido a partir de inicio."""
+    i = inicio
+    while i < pos:
+        i += 2 if fluxo[i] in (PREFIXO_MENSAGEM, BYTE_LITERAL) else 1
+    return i == pos
+
+
+def decodificar(pares, fluxo, inicios, id_):
+    saida = bytearray()
+    i = inicios[id_]
+    while fluxo[i] != FIM_MENSAGEM:
+        c = fluxo[i]
+        if c == PREFIXO_MENSAGEM:
+            saida += decodificar(pares, fluxo, inicios, fluxo[i + 1])
+            i += 2
+            continue
+        if c == BYTE_LITERAL:
+            saida.append(fluxo[i + 1])
+            i += 2
+            continue
+        pilha = [c]
+        while pilha:
+            s = pilha.pop()
+            if s >= PRIMEIRO_PAR:
+                a, b = pares[s - PRIMEIRO_PAR]
+                pilha += [b, a]
+            else:
+                saida.append(s)
+        i += 1
+    return bytes(saida)
+
+
+def literal_c(texto):
+    saida = ''
+    for c in texto:
+        if c == 0x22 or c == 0x5C:
+            saida += '\\' + chr(c)
+        elif 0x20 <= c < 0x7F:
+            saida += chr(c)
+        elif c == 0x0A:
+            saida += '\\n'
+        else:
+            saida += '\\x%02X' % c
+    return saida
+
+
+def tabela_bytes(valores, indentacao='  ', por_linha=16):
+    linhas = []
+    for i in range(0, len(valores), por_linha):
+        linhas.append(indentacao + ', '.join('0x%02X' % v for v in valores[i:i + por_linha]) + ',')
+    return '\n'.join(linhas)
+
+
+def main():
+    args = [a for a in sys.argv[1:] if not a.startswith('--')]
+    resumo = '--resumo' in sys.argv
+    origem, destino = args
+    with open(origem, encoding='utf-8') as f:
+        fonte = f.read()
+
+    usos = [desescapar(m.group(1)) for m in MSG.finditer(fonte)]
+    mensagens = []
+    for u in usos:
+        if u not in mensagens:
+            mensagens.append(u)
+    if len(mensagens) > 0xFF:
+        sys.exit('%s: mais de 255 mensagens' % origem)
+
+    hashes = {}
+    for id_, m in enumerate(mensagens):
+        h = hash_mensagem(m)
+        if h in hashes:
+            sys.exit('%s: hash repetido para "%s" e "%s"' % (origem, literal_c(m), literal_c(mensagens[hashes[h]])))
+        hashes[h] = id_
+
+    pares, fluxo, inicios, prefixos, sufixos = montar(mensagens)
+    for id_, m in enumerate(mensagens):
+        assert decodificar(pares, fluxo, inicios, id_) == m, m
+
+    texto_usos = sum(len(u) + 1 for u in usos)
+    texto_unico = sum(len(m) + 1 for m in mensagens)
+    catalogo = len(fluxo) + 2 * len(pares) + 2 * len(mensagens)
+    nome = os.path.basename(origem)
+    guarda = 'CATALOGO_' + re.sub(r'\W', '_', os.path.splitext(nome)[0]).upper() + '_H'
+
+    linhas = [
+        '// Gerado por host/gerar_catalogo.py a partir de %s.' % nome,
+        '// Nao edite: rode make -C host catalogo',
+        '//',
+        '// %d mensagens em %d usos de MSG(): %d bytes de texto, %d sem as repetidas.'
+        % (len(mensagens), len(usos), texto_usos, texto_unico),
+        '// Catalogo: %d bytes de codigos + %d de pares + %d de indice = %d bytes (%.0f%% do texto).'
+        % (len(fluxo), 2 * len(pares), 2 * len(mensagens), catalogo, 100.0 * catalogo / max(texto_usos, 1)),
+        '// %d pares no dicionario, %d mensagens com prefixo de outra, %d dentro de outra.'
+        % (len(pares), prefixos, sufixos),
+        '#ifndef ' + guarda,
+        '#define ' + guarda,
+        '',
+        '#include "catalogo.h"',
+        '',
+        'const uint8_t CODIGOS_MENSAGENS[] PROGMEM = {',
+        tabela_bytes(fluxo),
+        '};',
+        '',
+        '// Dois codigos por par, a partir de PRIMEIRO_PAR',
+        'const uint8_t PARES_MENSAGENS[] PROGMEM = {',
+        tabela_bytes([c for par in pares for c in par] or [0]),
+        '};',
+        '',
+        'const uint16_t INICIOS_MENSAGENS[] PROGMEM = {',
+    ]
+    for id_, m in enumerate(mensagens):
+        linhas.append('  %d,   // %d: "%s"' % (inicios[id_], id_, literal_c(m)))
+    linhas += [
+        '};',
+        '',
+        '// Usadas so na compilacao, por MSG(): hash do texto -> id',
+        'constexpr uint32_t HASHES_MENSAGENS[] = {',
+    ]
+    ordenados = sorted(hashes)
+    for i in range(0, len(ordenados), 6):
+        linhas.append('  ' + ', '.join('0x%08XUL' % h for h in ordenados[i:i + 6]) + ',')
+    linhas += [
+        '};',
+        'constexpr uint8_t IDS_MENSAGENS[] = {',
+        tabela_bytes([hashes[h] for h in ordenados]),
+        '};',
+        'const uint16_t TOTAL_MENSAGENS = %d;' % len(mensagens),
+        '',
+        'constexpr uint16_t buscarMensagem(uint32_t hash, uint16_t inicio = 0, uint16_t fim = TOTAL_MENSAGENS) {',
+        '  return inicio >= fim ? MENSAGEM_INEXISTENTE',
+        '       : HASHES_MENSAGENS[(inicio + fim) / 2] == hash ? IDS_MENSAGENS[(inicio + fim) / 2]',
+        '       : HASHES_MENSAGENS[(inicio + fim) / 2] < hash ? buscarMensagem(hash, (inicio + fim) / 2 + 1, fim)',
+        '       : buscarMensagem(hash, inicio, (inicio + fim) / 2);',
+        '}',
+        '',
+        'inline size_t Mensagem::printTo(Print &p) const {',
+        '  return imprimirMensagem(p, id, CODIGOS_MENSAGENS, INICIOS_MENSAGENS, PARES_MENSAGENS);',
+        '}',
+        '',
+        '#endif',
+    ]
+    conteudo = '\n'.join(linhas) + '\n'
+
+    atual = None
+    if os.path.exists(destino):
+        with open(destino, encoding='utf-8') as f:
+            atual = f.read()
+    if atual != conteudo:
+        with open(destino, 'w', encoding='utf-8') as f:
+            f.write(conteudo)
+
+    if resumo:
+        print('%-38s %4d %5d | %6d %6d %6d | %5.0f%%' % (
+            nome, len(mensagens), len(usos), texto_usos, texto_unico, catalogo,
+            100.0 * (texto_usos - catalogo) / max(texto_usos, 1)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+"""Gera o inicializador de uma Credencial (ver credencial.h): um sal
+aleatorio de 16 bytes e HMAC-SHA256(sal, senha).
+
+uso: gerar_credencial.py senha [--sal HEX]
+
+  python3 gerar_credencial.py 1234
+  python3 gerar_credencial.py 1234 --sal 000102030405060708090a0b0c0d0e0f
+
+Cole a saida no sketch no lugar da credencial antiga.
+"""
+import hashlib
+import hmac
+import os
+import sys
+
+TAMANHO_SAL = 16
+
+
+def bytes_c(dados, recuo):
+    linhas = []
+    for i in range(0, len(dados), 8):
+        linhas.append(recuo + ', '.join('0x%02x' % b for b in dados[i:i + 8]))
+    return ',\n'.join(linhas)
+
+
+def main():
+    args = sys.argv[1:]
+    sal = None
+    if '--sal' in args:
+        i = args.index('--sal')
+        sal = bytes.fromhex(args[i + 1])
+        del args[i:i + 2]
+        if len(sal) != TAMANHO_SAL:
+            sys.exit('o sal tem %d bytes' % TAMANHO_SAL)
+    if len(args) != 1:
+        sys.exit(__doc__)
+    senha = args[0].encode('ascii')
+    if sal is None:
+        sal = os.urandom(TAMANHO_SAL)
+    resumo = hmac.new(sal, senha, hashlib.sha256).digest()
+
+    print('// HMAC-SHA256(sal, senha), gerado por host/gerar_credencial.py')
+    print('Credencial credencial = {')
+    print('  {\n%s\n  },' % bytes_c(sal, '    '))
+    print('  {\n%s\n  }' % bytes_c(resumo, '    '))
+    print('};')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,86 @@
+// Interface de uma instancia da frota (ver frota.cc). Este arquivo inclui
+// o sketch ja preparado (SKETCH_PREPARADO) e e ligado com o core numa
+// biblioteca compartilhada. Cada instancia carrega uma copia propria da
+// biblioteca, entao o sketch e o emulador (relogio virtual, serial,
+// pinos) tem globais separadas por instancia.
+//
+// So as funcoes frota_* ficam visiveis fora da biblioteca.
+#include SKETCH_PREPARADO
+
+#include "emulador.h"
+
+#define EXPORTAR extern "C" __attribute__((visibility("default")))
+
+namespace {
+
+void descartarSaida(uint8_t, uint64_t) {
+}
+
+}
+
+EXPORTAR void frota_iniciar(unsigned long semente) {
+  emu::reiniciar();
+  emu::observarSerial(descartarSaida);
+  emu::definirTimer2Ocioso(emu::varreduraTecladoOciosa);   // teclado_timer.h
+  randomSeed(semente);
+  setup();
+}
+
+EXPORTAR uint64_t frota_ciclos() {
+  return emu::ciclos();
+}
+
+// ===== Verificacao de senha (projeto_2) =====
+
+#ifdef FROTA_VERIFICADOR
+
+// SENHA_CORRETA e const no sketch, mas e uma String montada na
+// inicializacao (fica na RAM); aqui cada instancia recebe o seu segredo,
+// e a credencial do modo seguro e refeita com o mesmo sal
+EXPORTAR bool frota_definir_senha(const char *senha) {
+  const_cast<String &>(SENHA_CORRETA) = senha;
+  uint8_t sal[TAMANHO_SAL];
+  memcpy(sal, credencial.sal, TAMANHO_SAL);
+  criarCredencial(credencial, sal, senha, strlen(senha));
+  return true;
+}
+
+// Retorna 1 se liberou, 0 se negou; 'ciclos' recebe o custo virtual
+EXPORTAR int frota_verificar(const char *senha, bool segura, uint64_t *ciclos) {
+  String tentativa = senha;
+  uint64_t inicio = emu::ciclos();
+  bool liberado = segura ? verificarSenhaSegura(tentativa) : verificarSenhaVulneravel(tentativa);
+  *ciclos = emu::ciclos() - inicio;
+  return liberado;
+}
+
+#else
+
+EXPORTAR bool frota_definir_senha(const char *) {
+  return false;
+}
+
+EXPORTAR int frota_verificar(const char *, bool, uint64_t *) {
+  return -1;
+}
+
+#endif
+
+// ===== Comandos pela serial (projeto_1) =====
+
+EXPORTAR void frota_enviar_serial(const char *texto) {
+  emu::agendarSerial(emu::micros(), texto);
+}
+
+// Roda loop() ate consumir a entrada e esvaziar a TX
+EXPORTAR void frota_executar_ate_ocioso() {
+  do {
+    loop();
+    emu::avancarCiclos(emu::CUSTO_LOOP);
+    emu::contarIteracaoLoop();
+  } while (emu::serialAgendadaPendente() || emu::serialLivreParaEscrita() < emu::TAMANHO_BUFFER_TX - 1);
+}
+
+EXPORTAR uint64_t frota_bytes_enviados() {
+  return emu::estatisticas().bytesEnviados;
+}
@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+"""Le o despejo do perfil de funcoes (ver perfil.h) numa captura da serial
+e mostra o tempo de cada funcao, inclusivo (com as que ela chamou) e
+exclusivo (so o corpo dela).
+
+Opcionalmente grava as pilhas no formato dobrado ("a;b;c microssegundos",
+para flamegraph.pl ou speedscope) e um flame graph em SVG.
+
+A captura pode ser a saida do emulador ou o log de um terminal serial
+gravado em modo binario; se houver varios despejos, vale o ultimo.
+
+uso: perfil_funcoes.py captura [--dobrado pilhas.txt] [--svg perfil.svg]
+
+  build/projeto_2-timing_attack-corrigido --teclas 500:1234# \\
+      --serial '3000:PERFIL\\n' --ate 5000 > captura.bin
+  python3 perfil_funcoes.py captura.bin --svg perfil.svg
+"""
+import re
+import struct
+import sys
+
+VOLTAS_PERFIL = 0xFF
+CABECALHO = re.compile(rb'PERFIL (\d+)\r\n')
+
+
+def crc_ccitt(dados):
+    """_crc_ccitt_update do avr-libc (refletido, 0x8408), inicio 0xFFFF."""
+    crc = 0xFFFF
+    for b in dados:
+        b ^= crc & 0xFF
+        b = (b ^ (b << 4)) & 0xFF
+        crc = (((b << 8) | (crc >> 8)) ^ (b >> 4) ^ (b << 3)) & 0xFFFF
+    return crc
+
+
+def ler_despejo(captura):
+    despejos = list(CABECALHO.finditer(captura))
+    if not despejos:
+        sys.exit('nenhum despejo "PERFIL <tamanho>" na captura')
+    m = despejos[-1]
+    tamanho = int(m.group(1))
+    inicio = m.end()
+    dados = captura[inicio:inicio + tamanho]
+    if len(dados) < tamanho or len(captura) < inicio + tamanho + 2:
+        sys.exit('despejo incompleto')
+    crc, = struct.unpack_from('<H', captura, inicio + tamanho)
+    if crc != crc_ccitt(dados):
+        sys.exit('CRC do despejo nao confere')
+
+    if dados[:2] != b'PF' or dados[2] != 1:
+        sys.exit('formato de despejo desconhecido')
+    ns_por_tick, = struct.unpack_from('<H', dados, 3)
+    tamanho_nomes = dados[5]
+    nomes = dados[6:6 + tamanho_nomes].rstrip(b'\0').decode('ascii').split('\0')
+    pos = 6 + tamanho_nomes
+    total, descartados = struct.unpack_from('<HH', dados, pos)
+    pos += 4
+    eventos = [struct.unpack_from('<BH', dados, pos + 3 * i) for i in range(total)]
+    return ns_por_tick, nomes, eventos, descartados
+
+
+def tempos_absolutos(eventos):
+    """(codigo, tick) -> (codigo, tick desde o primeiro evento)."""
+    saida = []
+    voltas = 0
+    anterior = None
+    agora = 0
+    for codigo, valor in eventos:
+        if codigo == VOLTAS_PERFIL:
+            voltas += valor
+            continue
+        if anterior is not None:
+            agora += voltas * 0x10000 + valor - anterior
+        anterior = valor
+        voltas = 0
+        saida.append((codigo, agora))
+    return saida
+
+
+class Funcao:
+    def __init__(self, nome):
+        self.nome = nome
+        self.chamadas = 0
+        self.inclusivo = 0
+        self.exclusivo = 0
+        self.maior = 0
+
+
+def analisar(nomes, eventos):
+    funcoes = {}
+    pilhas = {}
+    pilha = []          # [id, entrada, tempo dos filhos]
+    incompletas = 0
+
+    def funcao(i):
+        if i not in funcoes:
+            funcoes[i] = Funcao(nomes[i] if i < len(nomes) else 'funcao_%d' % i)
+        return funcoes[i]
+
+    for codigo, agora in eventos:
+        id_ = codigo >> 1
+        if not codigo & 1:
+            pilha.append([id_, agora, 0])
+            continue
+        if not pilha or pilha[-1][0] != id_:
+            # Entrada anterior ao inicio do buffer: a duracao e parcial.
+            # Os filhos que ja fecharam ficam como raiz
+            incompletas += 1
+            pilha = [q for q in pilha if q[0] != id_]
+            continue
+        _, entrada, filhos = pilha.pop()
+        duracao = agora - entrada
+        f = funcao(id_)
+        f.chamadas += 1
+        f.exclusivo += duracao - filhos
+        f.maior = max(f.maior, duracao)
+        # Numa chamada recursiva o tempo ja conta na de fora
+        if all(q[0] != id_ for q in pilha):
+            f.inclusivo += duracao
+        if pilha:
+            pilha[-1][2] += duracao
+        caminho = ';'.join([funcao(q[0]).nome for q in pilha] + [f.nome])
+        pilhas[caminho] = pilhas.get(caminho, 0) + duracao - filhos
+    return funcoes, pilhas, incompletas + len(pilha)
+
+
+def svg_flame(pilhas, largura=1200, altura_linha=18):
+    """Flame graph simples: cada pilha dobrada vira um retangulo por nivel."""
+    arvore = {}
+    for caminho, valor in pilhas.items():
+        no = arvore
+        for nome in caminho.split(';'):
+            filho = no.setdefault(nome, [0, {}])
+            filho[0] += valor
+            no = filho[1]
+    total = sum(v[0] for v in arvore.values()) or 1
+
+    def profundidade(no):
+        return 1 + max((profundidade(f[1]) for f in no.values()), default=0)
+    niveis = profundidade(arvore) - 1
+    altura = (niveis + 1) * altura_linha + 10
+    partes = ['<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d" '
+              'font-family="monospace" font-size="11">' % (largura, altura)]
+
+    def desenhar(no, x, nivel):
+        for nome, (valor, filhos) in sorted(no.items()):
+            w = valor * largura / total
+            y = altura - (nivel + 1) * altura_linha - 5
+            cor = 200 + sum(nome.encode()) % 55
+            partes.append('<g><title>%s (%d us, %.1f%%)</title>'
+                          '<rect x="%.1f" y="%d" width="%.1f" height="%d" fill="rgb(%d,%d,60)" stroke="white"/>'
+                          % (nome, valor, 100.0 * valor / total, x, y, w, altura_linha - 1, cor, cor // 2))
+            if w > 7 * len(nome):
+                partes.append('<text x="%.1f" y="%d">%s</text>' % (x + 3, y + altura_linha - 5, nome))
+            partes.append('</g>')
+            desenhar(filhos, x, nivel + 1)
+            x += w
+
+    desenhar(arvore, 0, 0)
+    partes.append('</svg>')
+    return '\n'.join(partes) + '\n'
+
+
+def main():
+    args = sys.argv[1:]
+    opcoes = {}
+    for opcao in ('--dobrado', '--svg'):
+        if opcao in args:
+            i = args.index(opcao)
+            opcoes[opcao] = args[i + 1]
+            del args[i:i + 2]
+    if len(args) != 1:
+        sys.exit(__doc__)
+    with open(args[0], 'rb') as f:
+        captura = f.read()
+
+    ns_por_tick, nomes, eventos, descartados = ler_despejo(captura)
+    absolutos = tempos_absolutos(eventos)
+    funcoes, pilhas, incompletas = analisar(nomes, absolutos)
+    us = ns_por_tick / 1000.0
+    janela = absolutos[-1][1] * us if absolutos else 0
+
+    print('%d eventos em %.3f ms (%d mais antigos descartados, %d chamadas incompletas)'
+          % (len(absolutos), janela / 1000, descartados, incompletas))
+    print()
+    print('%-28s %8s %12s %12s %10s %10s %7s'
+          % ('funcao', 'chamadas', 'inclusivo', 'exclusivo', 'media', 'maior', '% excl'))
+    print('%-28s %8s %12s %12s %10s %10s %7s' % ('', '', 'us', 'us', 'us', 'us', ''))
+    for f in sorted(funcoes.values(), key=lambda f: -f.exclusivo):
+        print('%-28s %8d %12.1f %12.1f %10.1f %10.1f %6.1f%%'
+              % (f.nome, f.chamadas, f.inclusivo * us, f.exclusivo * us,
+                 f.inclusivo * us / f.chamadas, f.maior * us,
+                 100.0 * f.exclusivo * us / janela if janela else 0))
+
+    em_us = {caminho: int(round(v * us)) for caminho, v in pilhas.items()}
+    if '--dobrado' in opcoes:
+        with open(opcoes['--dobrado'], 'w') as f:
+            for caminho in sorted(em_us):
+                f.write('%s %d\n' % (caminho, em_us[caminho]))
+    if '--svg' in opcoes:
+        with open(opcoes['--svg'], 'w') as f:
+            f.write(svg_flame(em_us))
+
+
+if __name__ == '__main__':
+    main()
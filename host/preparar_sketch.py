@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Transforma um sketch em C++ compilavel no host, como o arduino-builder:
+inclui Arduino.h no inicio e declara os prototipos de todas as funcoes
+antes da primeira definicao, para que a ordem das funcoes nao importe.
+
+uso: preparar_sketch.py sketch.cc saida.cc
+"""
+import re
+import sys
+
+# Definicao de funcao no nivel do arquivo, com a chave na mesma linha
+DEFINICAO = re.compile(
+    r'^(?P<tipo>[A-Za-z_][\w:<>\s\*&]*?[\s\*&])'
+    r'(?P<nome>[A-Za-z_]\w*)\s*\((?P<args>[^;{}()]*)\)\s*\{')
+PALAVRAS_RESERVADAS = {'if', 'for', 'while', 'switch', 'return', 'else', 'do'}
+
+
+def main():
+    origem, destino = sys.argv[1], sys.argv[2]
+    with open(origem, encoding='utf-8') as f:
+        linhas = f.read().split('\n')
+
+    prototipos = []
+    primeira = None
+    for numero, linha in enumerate(linhas):
+        m = DEFINICAO.match(linha)
+        if not m or m.group('nome') in PALAVRAS_RESERVADAS:
+            continue
+        if m.group('tipo').split()[0] in ('struct', 'class', 'static_assert'):
+            continue
+        if primeira is None:
+            primeira = numero
+        prototipos.append('%s%s(%s);' % (m.group('tipo'), m.group('nome'), m.group('args')))
+
+    if primeira is None:
+        primeira = len(linhas)
+
+    caminho = origem.replace('\\', '/')
+    saida = ['#include <Arduino.h>', '#line 1 "%s"' % caminho]
+    saida += linhas[:primeira]
+    saida += prototipos
+    saida.append('#line %d "%s"' % (primeira + 1, caminho))
+    saida += linhas[primeira:]
+
+    with open(destino, 'w', encoding='utf-8') as f:
+        f.write('\n'.join(saida) + '\n')
+
+
+if __name__ == '__main__':
+    main()
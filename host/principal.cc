@@ -0,0 +1,206 @@
+// Executa um sketch no emulador: chama setup() e depois loop() ate o
+// relogio virtual chegar ao tempo pedido. A entrada (serial e teclado)
+// vem da linha de comando com o instante em que deve chegar.
+//
+//   build/projeto_1 --serial 100:'AUTH:1234\nLED_ON\n' --ate 2000
+//   build/projeto_2-timing_attack --teclas 500:1234# --lcd --ate 8000
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <chrono>
+
+#include "Arduino.h"
+#include "emulador.h"
+
+namespace {
+
+bool mostrarTempo = false;
+bool silencioso = false;
+bool inicioDeLinha = true;
+
+void imprimirSaida(uint8_t byte, uint64_t ciclo) {
+  if (silencioso) {
+    return;
+  }
+  if (mostrarTempo && inicioDeLinha) {
+    printf("[%9.3f] ", (double)ciclo / (emu::CICLOS_POR_US * 1000.0));
+  }
+  fputc(byte, stdout);
+  inicioDeLinha = (byte == '\n');
+}
+
+// Converte \n, \r, \t, \\ e \xHH em bytes
+std::string decodificarEscapes(const char *s) {
+  std::string r;
+  for (; *s; s++) {
+    if (*s != '\\' || !s[1]) {
+      r += *s;
+      continue;
+    }
+    s++;
+    switch (*s) {
+      case 'n': r += '\n'; break;
+      case 'r': r += '\r'; break;
+      case 't': r += '\t'; break;
+      case 'x': {
+        char hex[3] = { s[1], s[1] ? s[2] : '\0', '\0' };
+        r += (char)strtol(hex, NULL, 16);
+        s += strlen(hex);
+        break;
+      }
+      default: r += *s; break;
+    }
+  }
+  return r;
+}
+
+// "MS:RESTO" -> instante em ms e o texto depois dos dois pontos
+bool separarInstante(const char *arg, unsigned long &ms, const char *&resto) {
+  char *fim;
+  ms = strtoul(arg, &fim, 10);
+  if (fim == arg || *fim != ':') {
+    return false;
+  }
+  resto = fim + 1;
+  return true;
+}
+
+void uso(const char *programa) {
+  fprintf(stderr,
+          "uso: %s [opcoes]\n"
+          "  --ate MS               tempo virtual de execucao (padrao 10000)\n"
+          "  --serial MS:TEXTO      envia TEXTO pela serial no instante MS\n"
+          "                         (aceita \\n, \\r, \\t e \\xHH)\n"
+          "  --teclas MS:TECLAS     pressiona as TECLAS a partir de MS\n"
+          "  --intervalo-teclas MS  intervalo entre teclas (padrao 300)\n"
+          "  --duracao-tecla MS     tempo que cada tecla fica pressionada (padrao 100)\n"
+          "  --lcd                  mostra o LCD a cada mudanca\n"
+          "  --pinos                mostra cada mudanca nos pinos de saida\n"
+          "  --tempo                prefixa cada linha da serial com o tempo virtual\n"
+          "  --quieto               nao mostra a saida serial\n"
+          "  --eeprom ARQUIVO       carrega a EEPROM do arquivo (se existir) e grava\n"
+          "                         de volta no fim\n",
+          programa);
+}
+
+}
+
+int main(int argc, char **argv) {
+  unsigned long ate = 10000;
+  unsigned long intervaloTeclas = 300;
+  unsigned long duracaoTecla = 100;
+  bool mostrarLcd = false;
+  const char *arquivoEeprom = NULL;
+
+  emu::reiniciar();
+  emu::observarSerial(imprimirSaida);
+  // Nos sketches o Timer2 so varre o teclado (teclado_timer.h)
+  emu::definirTimer2Ocioso(emu::varreduraTecladoOciosa);
+
+  // Teclas sao agendadas depois de setup(), quando o Keypad ja registrou
+  // a matriz; aqui so guardamos os argumentos
+  struct SequenciaTeclas { unsigned long ms; const char *teclas; };
+  SequenciaTeclas sequencias[32];
+  int totalSequencias = 0;
+
+  for (int i = 1; i < argc; i++) {
+    const char *opcao = argv[i];
+    const char *valor = i + 1 < argc ? argv[i + 1] : NULL;
+    unsigned long ms;
+    const char *resto;
+
+    if (!strcmp(opcao, "--lcd")) {
+      mostrarLcd = true;
+    } else if (!strcmp(opcao, "--pinos")) {
+      emu::registrarPinos(true);
+    } else if (!strcmp(opcao, "--tempo")) {
+      mostrarTempo = true;
+    } else if (!strcmp(opcao, "--quieto")) {
+      silencioso = true;
+    } else if (!valor) {
+      uso(argv[0]);
+      return 2;
+    } else if (!strcmp(opcao, "--ate")) {
+      ate = strtoul(valor, NULL, 10);
+      i++;
+    } else if (!strcmp(opcao, "--eeprom")) {
+      arquivoEeprom = valor;
+      emu::carregarEeprom(arquivoEeprom);
+      i++;
+    } else if (!strcmp(opcao, "--intervalo-teclas")) {
+      intervaloTeclas = strtoul(valor, NULL, 10);
+      i++;
+    } else if (!strcmp(opcao, "--duracao-tecla")) {
+      duracaoTecla = strtoul(valor, NULL, 10);
+      i++;
+    } else if (!strcmp(opcao, "--serial") && separarInstante(valor, ms, resto)) {
+      emu::agendarSerial((uint64_t)ms * 1000, decodificarEscapes(resto));
+      i++;
+    } else if (!strcmp(opcao, "--teclas") && separarInstante(valor, ms, resto) &&
+               totalSequencias < 32) {
+      sequencias[totalSequencias].ms = ms;
+      sequencias[totalSequencias].teclas = resto;
+      totalSequencias++;
+      i++;
+    } else {
+      uso(argv[0]);
+      return 2;
+    }
+  }
+
+  std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+
+  setup();
+
+  for (int s = 0; s < totalSequencias; s++) {
+    uint64_t us = (uint64_t)sequencias[s].ms * 1000;
+    for (const char *t = sequencias[s].teclas; *t; t++) {
+      emu::agendarTecla(us, *t, duracaoTecla);
+      us += (uint64_t)intervaloTeclas * 1000;
+    }
+  }
+  emu::registrarLcd(mostrarLcd);
+
+  while (emu::millis() < ate) {
+    loop();
+    emu::avancarCiclos(emu::CUSTO_LOOP);
+    emu::contarIteracaoLoop();
+    emu::lcdAlterado();
+  }
+
+  double segundosHost = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+  emu::finalizarEstatisticas();
+  fflush(stdout);
+  if (arquivoEeprom && !emu::salvarEeprom(arquivoEeprom)) {
+    fprintf(stderr, "nao foi possivel gravar %s\n", arquivoEeprom);
+  }
+
+  const emu::Estatisticas &e = emu::estatisticas();
+  fprintf(stderr,
+          "\n--- emulador ---\n"
+          "tempo virtual:        %.3f s\n"
+          "tempo no host:        %.6f s\n"
+          "iteracoes de loop():  %llu (mais longa: %.3f ms)\n"
+          "serial RX:            %llu bytes (%llu perdidos)\n"
+          "serial TX:            %llu bytes, %.3f ms bloqueado\n"
+          "LCD:                  %llu bytes, %llu clears, %.3f ms de barramento\n"
+          "teclas:               %llu agendadas, %llu perdidas\n"
+          "interrupcoes:         %llu, %.3f ms em ISR (%llu varreduras puladas)\n"
+          "EEPROM:               %llu leituras, %llu escritas, %.3f ms esperando, "
+          "celula mais gasta %u (%u escritas)\n"
+          "heap (String):        %llu alocacoes, pico de %lld bytes\n",
+          (double)emu::ciclos() / emu::FREQUENCIA_CPU, segundosHost,
+          (unsigned long long)e.iteracoesLoop, e.maiorIntervaloLoop / (emu::CICLOS_POR_US * 1000.0),
+          (unsigned long long)e.bytesRecebidos, (unsigned long long)e.bytesRxPerdidos,
+          (unsigned long long)e.bytesEnviados, e.ciclosTxBloqueado / (emu::CICLOS_POR_US * 1000.0),
+          (unsigned long long)e.bytesLcd, (unsigned long long)e.clearsLcd, e.microsLcd / 1000.0,
+          (unsigned long long)e.teclasAgendadas, (unsigned long long)e.teclasPerdidas,
+          (unsigned long long)e.interrupcoes, e.ciclosInterrupcao / (emu::CICLOS_POR_US * 1000.0),
+          (unsigned long long)e.interrupcoesPuladas,
+          (unsigned long long)e.leiturasEeprom, (unsigned long long)e.escritasEeprom,
+          e.ciclosEsperaEeprom / (emu::CICLOS_POR_US * 1000.0), emu::celulaMaisGastaEeprom(),
+          (unsigned)emu::escritasNaCelulaEeprom(emu::celulaMaisGastaEeprom()),
+          (unsigned long long)e.alocacoesHeap, (long long)e.picoHeap);
+  return 0;
+}
@@ -0,0 +1,400 @@
+// Reproduz no host uma sessao gravada pelo
+// projeto_2-timing_attack-corrigido (ver rastro.h). Le a captura da
+// serial do aparelho, com o despejo do comando RASTRO no fim, roda o
+// sketch desde o boot com as mesmas teclas e os mesmos bytes da serial
+// nos mesmos instantes e compara a saida com a gravada.
+//
+// As entradas entram onde o sketch as le: as teclas direto na fila do
+// teclado (colocarTecla()) e os bytes no buffer RX, no primeiro loop()
+// do ms em que o aparelho os leu. delay() ja nao custa nada no emulador;
+// alem disso o relogio pula o tempo parado. Com o sketch ocioso
+// (sistemaOcioso()) e a UART vazia, vai direto ate a proxima entrada;
+// com algo andando, ate o proximo ms, a resolucao do millis() com que o
+// sketch decide tudo. Com --normal o loop() gira sem pulos, como no
+// aparelho. METRICS e PERFIL medem a propria execucao e mudam com os
+// pulos.
+//
+//   build/projeto_2-timing_attack-corrigido --teclas 500:1239#
+//       --serial '60000:ADMIN:1234\nRASTRO\n' --ate 61000 > captura.bin
+//   build/reproduzir_rastro captura.bin --saida reproduzida.txt
+//
+// Os tempos que o sketch mede (numeros em us e ms) dependem do ciclo
+// exato de cada entrada e nao contam como divergencia; a comparacao so
+// diz quantos mudaram. Sai com 1 se o resto da saida divergir e 2 se a
+// captura nao tiver um rastro valido.
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "emulador.h"
+#include "fila_serial.h"
+#include "rastro.h"
+
+// Do sketch
+extern FilaSerial<256> saida;
+bool sistemaOcioso();
+bool colocarTecla(char tecla);
+uint8_t teclasNaFila();
+
+namespace {
+
+const int CAPACIDADE_TX = 63;   // serialLivreParaEscrita() com a UART vazia
+
+struct Evento {
+  uint32_t ms;
+  uint8_t tipo;
+  uint8_t dado;
+};
+
+struct RastroLido {
+  std::string saidaGravada;   // o que o aparelho mandou antes do despejo
+  size_t bytes;
+  bool comDigitos;            // sem RASTRO_DIGITOS, todo digito veio como '0'
+  uint16_t crcEeprom;
+  uint32_t duracaoMs;
+  uint16_t perdidos;
+  std::vector<Evento> eventos;
+};
+
+std::string recebido;
+
+void guardar(uint8_t byte, uint64_t) {
+  recebido += (char)byte;
+}
+
+uint32_t lerNumero(const std::string &s, size_t pos, int bytes) {
+  uint32_t valor = 0;
+  for (int i = bytes - 1; i >= 0; i--) {
+    valor = valor << 8 | (uint8_t)s[pos + i];
+  }
+  return valor;
+}
+
+// Os eventos: varint com (ms desde o anterior) * 2 + tipo, e o byte lido
+bool decodificarEventos(const std::string &dados, uint16_t total, std::vector<Evento> &eventos) {
+  size_t pos = BYTES_CABECALHO_RASTRO;
+  uint32_t ms = 0;
+  for (uint16_t i = 0; i < total; i++) {
+    uint32_t valor = 0;
+    int deslocamento = 0;
+    uint8_t byte;
+    do {
+      if (pos >= dados.size() || deslocamento > 28) {
+        return false;
+      }
+      byte = (uint8_t)dados[pos++];
+      valor |= (uint32_t)(byte & 0x7F) << deslocamento;
+      deslocamento += 7;
+    } while (byte & 0x80);
+    if (pos >= dados.size()) {
+      return false;
+    }
+    ms += valor >> 1;
+    Evento e = { ms, (uint8_t)(valor & 1), (uint8_t)dados[pos++] };
+    eventos.push_back(e);
+  }
+  return pos == dados.size();
+}
+
+// O ultimo "RASTRO <tamanho>\r\n" da captura com um bloco inteiro e CRC
+// certo
+bool lerRastro(const std::string &captura, RastroLido &r) {
+  const std::string marca = "RASTRO ";
+  for (size_t pos = captura.rfind(marca); pos != std::string::npos;
+       pos = pos > 0 ? captura.rfind(marca, pos - 1) : std::string::npos) {
+    const char *numero = captura.c_str() + pos + marca.size();
+    char *fim;
+    unsigned long tamanho = strtoul(numero, &fim, 10);
+    if (fim == numero || strncmp(fim, "\r\n", 2) != 0 || tamanho < BYTES_CABECALHO_RASTRO) {
+      continue;
+    }
+    size_t inicio = fim + 2 - captura.c_str();
+    if (inicio + tamanho + 2 > captura.size()) {
+      fprintf(stderr, "despejo do rastro incompleto\n");
+      return false;
+    }
+    std::string dados = captura.substr(inicio, tamanho);
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < dados.size(); i++) {
+      crc = _crc_ccitt_update(crc, (uint8_t)dados[i]);
+    }
+    if (crc != lerNumero(captura, inicio + tamanho, 2)) {
+      fprintf(stderr, "CRC do rastro nao confere\n");
+      return false;
+    }
+    if (dados[0] != 'R' || dados[1] != 'S' || (uint8_t)dados[2] != VERSAO_RASTRO) {
+      fprintf(stderr, "formato de rastro desconhecido\n");
+      return false;
+    }
+    r.saidaGravada = captura.substr(0, pos);
+    r.bytes = tamanho;
+    r.comDigitos = (uint8_t)dados[3] & RASTRO_COM_DIGITOS;
+    r.crcEeprom = lerNumero(dados, 4, 2);
+    r.duracaoMs = lerNumero(dados, 6, 4);
+    uint16_t total = lerNumero(dados, 10, 2);
+    r.perdidos = lerNumero(dados, 12, 2);
+    if (!decodificarEventos(dados, total, r.eventos)) {
+      fprintf(stderr, "eventos do rastro corrompidos\n");
+      return false;
+    }
+    return true;
+  }
+  fprintf(stderr, "nenhum despejo \"RASTRO <tamanho>\" na captura\n");
+  return false;
+}
+
+uint16_t crcEepromAtual() {
+  uint16_t crc = 0xFFFF;
+  for (uint16_t i = 0; i < emu::TAMANHO_EEPROM; i++) {
+    crc = _crc_ccitt_update(crc, emu::lerEeprom(i));
+  }
+  return crc;
+}
+
+// Do boot ate o instante do despejo; no fim, o que ainda estava na fila
+// sai, como saiu antes do bloco no aparelho
+void reproduzir(const RastroLido &r, bool rapido) {
+  setup();
+  size_t proximo = 0;
+  while (emu::millis() < r.duracaoMs) {
+    // O que o aparelho leu ate este ms. As teclas do mesmo ms ficam na
+    // fila e saem uma por loop(), como la
+    std::string bytes;
+    while (proximo < r.eventos.size() && r.eventos[proximo].ms <= emu::millis()) {
+      const Evento &e = r.eventos[proximo++];
+      if (e.tipo == TIPO_RASTRO_TECLA) {
+        colocarTecla((char)e.dado);
+      } else {
+        bytes += (char)e.dado;
+      }
+    }
+    if (!bytes.empty()) {
+      emu::receberSerial(bytes);
+    }
+
+    loop();
+    emu::avancarCiclos(emu::CUSTO_LOOP);
+    emu::contarIteracaoLoop();
+    if (!rapido || teclasNaFila() > 0) {
+      continue;
+    }
+    uint64_t alvo = proximo < r.eventos.size() ? r.eventos[proximo].ms : r.duracaoMs;
+    bool parado = sistemaOcioso() && emu::serialLivreParaEscrita() == CAPACIDADE_TX;
+    if (!parado && emu::millis() + 1 < alvo) {
+      alvo = emu::millis() + 1;
+    }
+    if (alvo * 1000 > emu::micros()) {
+      emu::avancarMicros(alvo * 1000 - emu::micros());
+    }
+  }
+  saida.esvaziar();
+}
+
+std::vector<std::string> linhas(const std::string &texto) {
+  std::vector<std::string> r;
+  size_t inicio = 0;
+  while (inicio < texto.size()) {
+    size_t fim = texto.find('\n', inicio);
+    if (fim == std::string::npos) {
+      fim = texto.size();
+    }
+    std::string linha = texto.substr(inicio, fim - inicio);
+    if (!linha.empty() && linha[linha.size() - 1] == '\r') {
+      linha.erase(linha.size() - 1);
+    }
+    r.push_back(linha);
+    inicio = fim + 1;
+  }
+  return r;
+}
+
+// Numeros seguidos de "us" ou "ms" sao tempos que o sketch mediu da
+// propria execucao (verificacao de senha, fila da serial): dependem do
+// ciclo exato em que cada entrada chegou, e o rastro so guarda o ms.
+// Saem da linha como '#'; os valores, em us, vao para 'tempos'
+std::string semTempos(const std::string &linha, std::vector<long long> &tempos) {
+  std::string r;
+  size_t i = 0;
+  while (i < linha.size()) {
+    if (!isdigit((unsigned char)linha[i])) {
+      r += linha[i++];
+      continue;
+    }
+    size_t fim = i;
+    while (fim < linha.size() && isdigit((unsigned char)linha[fim])) {
+      fim++;
+    }
+    size_t unidade = fim < linha.size() && linha[fim] == ' ' ? fim + 1 : fim;
+    bool us = linha.compare(unidade, 2, "us") == 0;
+    bool ms = linha.compare(unidade, 2, "ms") == 0;
+    bool palavra = unidade + 2 < linha.size() && isalpha((unsigned char)linha[unidade + 2]);   // "usuarios"
+    if ((us || ms) && !palavra) {
+      tempos.push_back(atoll(linha.substr(i, fim - i).c_str()) * (ms ? 1000 : 1));
+      r += '#';
+    } else {
+      r.append(linha, i, fim - i);
+    }
+    i = fim;
+  }
+  return r;
+}
+
+// Linha a linha. Tempos medidos diferentes sao contados, mas nao
+// reprovam; o resto mostra a primeira diferenca
+bool comparar(const std::string &gravada, const std::string &reproduzida) {
+  std::vector<std::string> a = linhas(gravada);
+  std::vector<std::string> b = linhas(reproduzida);
+  size_t total = a.size() > b.size() ? a.size() : b.size();
+  size_t primeira = total;
+  unsigned diferentes = 0;
+  unsigned tempos = 0;
+  long long maiorDiferenca = 0;
+  for (size_t i = 0; i < total; i++) {
+    if (i < a.size() && i < b.size()) {
+      if (a[i] == b[i]) {
+        continue;
+      }
+      std::vector<long long> ta, tb;
+      if (semTempos(a[i], ta) == semTempos(b[i], tb)) {
+        tempos++;
+        for (size_t t = 0; t < ta.size(); t++) {
+          long long d = ta[t] > tb[t] ? ta[t] - tb[t] : tb[t] - ta[t];
+          maiorDiferenca = d > maiorDiferenca ? d : maiorDiferenca;
+        }
+        continue;
+      }
+    }
+    diferentes++;
+    primeira = i < primeira ? i : primeira;
+  }
+  if (diferentes == 0) {
+    printf("saida:      igual a gravada (%u bytes, %u linhas)", (unsigned)gravada.size(), (unsigned)a.size());
+    if (tempos > 0) {
+      printf(", a menos de %u tempos medidos pelo sketch (ate %lld us de diferenca)", tempos, maiorDiferenca);
+    }
+    printf("\n");
+    return true;
+  }
+  printf("saida:      DIVERGE em %u de %u linhas; a primeira e a %u\n", diferentes, (unsigned)total,
+         (unsigned)primeira + 1);
+  printf("  gravada:     %s\n", primeira < a.size() ? a[primeira].c_str() : "(fim)");
+  printf("  reproduzida: %s\n", primeira < b.size() ? b[primeira].c_str() : "(fim)");
+  return false;
+}
+
+void uso(const char *programa) {
+  fprintf(stderr,
+          "uso: %s CAPTURA [opcoes]\n"
+          "  --eeprom ARQUIVO   EEPROM do aparelho no boot (padrao: apagada)\n"
+          "  --normal           gira o loop() sem pular o tempo parado\n"
+          "  --saida ARQUIVO    grava a saida reproduzida (para um diff)\n",
+          programa);
+}
+
+}
+
+int main(int argc, char **argv) {
+  const char *arquivoCaptura = NULL;
+  const char *arquivoEeprom = NULL;
+  const char *arquivoSaida = NULL;
+  bool rapido = true;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--normal")) {
+      rapido = false;
+    } else if (!strcmp(argv[i], "--eeprom") && i + 1 < argc) {
+      arquivoEeprom = argv[++i];
+    } else if (!strcmp(argv[i], "--saida") && i + 1 < argc) {
+      arquivoSaida = argv[++i];
+    } else if (argv[i][0] != '-' && !arquivoCaptura) {
+      arquivoCaptura = argv[i];
+    } else {
+      uso(argv[0]);
+      return 2;
+    }
+  }
+  if (!arquivoCaptura) {
+    uso(argv[0]);
+    return 2;
+  }
+
+  FILE *f = fopen(arquivoCaptura, "rb");
+  if (!f) {
+    fprintf(stderr, "nao foi possivel abrir %s\n", arquivoCaptura);
+    return 2;
+  }
+  std::string captura;
+  char bloco[4096];
+  size_t lidos;
+  while ((lidos = fread(bloco, 1, sizeof(bloco), f)) > 0) {
+    captura.append(bloco, lidos);
+  }
+  fclose(f);
+
+  RastroLido r;
+  if (!lerRastro(captura, r)) {
+    return 2;
+  }
+  unsigned teclas = 0;
+  for (size_t i = 0; i < r.eventos.size(); i++) {
+    teclas += r.eventos[i].tipo == TIPO_RASTRO_TECLA;
+  }
+  printf("rastro:     %u eventos (%u teclas, %u bytes da serial) em %u bytes, sessao de %.1f s\n",
+         (unsigned)r.eventos.size(), teclas, (unsigned)r.eventos.size() - teclas, (unsigned)r.bytes,
+         r.duracaoMs / 1000.0);
+
+  // A EEPROM sobrevive a reiniciar(); o segundo zera o relogio que as
+  // leituras do CRC andaram
+  emu::reiniciar();
+  if (arquivoEeprom && !emu::carregarEeprom(arquivoEeprom)) {
+    fprintf(stderr, "nao foi possivel abrir %s\n", arquivoEeprom);
+    return 2;
+  }
+  uint16_t crc = crcEepromAtual();
+  if (crc != r.crcEeprom) {
+    printf("aviso:      a EEPROM nao e a do aparelho no boot (CRC %04x, gravado %04x)\n", crc, r.crcEeprom);
+  }
+  if (!r.comDigitos) {
+    printf("aviso:      rastro sem os digitos (aparelho compilado sem RASTRO_DIGITOS); as senhas\n"
+           "            voltam como zeros e a saida diverge a partir da primeira\n");
+  }
+  if (r.perdidos > 0) {
+    printf("aviso:      rastro cheio, %u eventos perdidos; a comparacao vai ate %.1f s\n", r.perdidos,
+           r.duracaoMs / 1000.0);
+  }
+  emu::reiniciar();
+  emu::observarSerial(guardar);
+  // As teclas vem do rastro direto para a fila: a varredura do Timer2
+  // (teclado_timer.h) nunca ve uma
+  emu::definirTimer2Ocioso(emu::varreduraTecladoOciosa);
+  emu::definirYieldOcioso(sistemaOcioso);
+
+  std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+  reproduzir(r, rapido);
+  double segundosHost = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+  double segundosVirtuais = (double)emu::ciclos() / emu::FREQUENCIA_CPU;
+  printf("reproducao: %.1f s virtuais em %.3f s no host (%.0fx), %llu iteracoes de loop()%s\n",
+         segundosVirtuais, segundosHost, segundosVirtuais / segundosHost,
+         (unsigned long long)emu::estatisticas().iteracoesLoop, rapido ? "" : " (--normal)");
+
+  if (arquivoSaida) {
+    FILE *s = fopen(arquivoSaida, "wb");
+    if (!s || fwrite(recebido.data(), 1, recebido.size(), s) != recebido.size()) {
+      fprintf(stderr, "nao foi possivel gravar %s\n", arquivoSaida);
+    }
+    if (s) {
+      fclose(s);
+    }
+  }
+
+  // Com eventos perdidos o aparelho seguiu alem do rastro
+  std::string gravada = r.saidaGravada;
+  if (r.perdidos > 0 && gravada.size() > recebido.size()) {
+    gravada.resize(recebido.size());
+  }
+  return comparar(gravada, recebido) ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+// Limite de tentativas de senha: balde de fichas com bloqueio de tempo
+// crescente, sem espera ocupada.
+//
+// Cada tentativa gasta uma ficha do balde (ate 'capacidade'), e uma
+// ficha volta a cada 'recargaMs'. Quando a ultima ficha vai embora numa
+// falha, comeca um bloqueio de bloqueioBaseMs * 2^n, onde n conta os
+// bloqueios seguidos (ate bloqueioMaximoMs). No fim do bloqueio vem uma
+// ficha so: errar de novo bloqueia pelo dobro do tempo. O nivel volta a
+// zero num acerto ou quando o balde enche de novo sem falhas.
+//
+// Nada aqui espera: o sketch consulta o estado a cada loop() (tela com a
+// contagem regressiva, teclas continuam sendo lidas). Os tempos sao
+// diferencas de millis(), entao a volta do contador nao atrapalha.
+//
+//   LimiteTentativas limite(3, 30000, 7000, 900000UL);
+//   if (limite.consumir(millis())) {
+//     if (senhaCerta) limite.registrarSucesso();
+//     else limite.registrarFalha(millis());
+//   }
+//   limite.restanteBloqueio(millis());   // ms ate liberar, 0 = livre
+#ifndef LIMITE_TENTATIVAS_H
+#define LIMITE_TENTATIVAS_H
+
+#include <Arduino.h>
+
+const uint8_t MAX_NIVEL_BLOQUEIO = 16;   // 2^16 ja passa de qualquer maximo util
+
+class LimiteTentativas {
+public:
+  LimiteTentativas(uint8_t capacidade, unsigned long recargaMs,
+                   unsigned long bloqueioBaseMs, unsigned long bloqueioMaximoMs)
+    : capacidade(capacidade), recargaMs(recargaMs), bloqueioBaseMs(bloqueioBaseMs),
+      bloqueioMaximoMs(bloqueioMaximoMs), fichas(capacidade), nivel(0),
+      bloqueado(false), ultimaRecarga(0), inicioBloqueio(0), duracaoBloqueio(0) {}
+
+  // Tentativas que podem ser feitas agora (0 durante o bloqueio)
+  uint8_t disponiveis(unsigned long agora) {
+    atualizar(agora);
+    return bloqueado ? 0 : fichas;
+  }
+
+  unsigned long restanteBloqueio(unsigned long agora) {
+    atualizar(agora);
+    return bloqueado ? duracaoBloqueio - (agora - inicioBloqueio) : 0;
+  }
+
+  // Gasta uma ficha antes de verificar a senha; false se nao havia
+  bool consumir(unsigned long agora) {
+    atualizar(agora);
+    if (bloqueado || fichas == 0) {
+      return false;
+    }
+    // Com o balde cheio a recarga estava parada: conta a partir de agora
+    if (fichas == capacidade) {
+      ultimaRecarga = agora;
+    }
+    fichas--;
+    return true;
+  }
+
+  void registrarSucesso() {
+    fichas = capacidade;
+    nivel = 0;
+  }
+
+  // Depois de consumir(): sem fichas, bloqueia pelo tempo do nivel atual
+  void registrarFalha(unsigned long agora) {
+    if (fichas > 0) {
+      return;
+    }
+    duracaoBloqueio = bloqueioBaseMs;
+    for (uint8_t i = 0; i < nivel && duracaoBloqueio < bloqueioMaximoMs; i++) {
+      duracaoBloqueio *= 2;
+    }
+    if (duracaoBloqueio > bloqueioMaximoMs) {
+      duracaoBloqueio = bloqueioMaximoMs;
+    }
+    if (nivel < MAX_NIVEL_BLOQUEIO) {
+      nivel++;
+    }
+    bloqueado = true;
+    inicioBloqueio = agora;
+  }
+
+  // Volta ao estado guardado antes de um reset. millis() recomeca do
+  // zero, entao o bloqueio vem como o tempo que faltava e a recarga
+  // recomeca agora: desligar o aparelho nunca devolve tentativas
+  void restaurar(uint8_t fichasSalvas, uint8_t nivelSalvo, unsigned long restante, unsigned long agora) {
+    fichas = fichasSalvas < capacidade ? fichasSalvas : capacidade;
+    nivel = nivelSalvo < MAX_NIVEL_BLOQUEIO ? nivelSalvo : MAX_NIVEL_BLOQUEIO;
+    ultimaRecarga = agora;
+    bloqueado = restante > 0;
+    inicioBloqueio = agora;
+    duracaoBloqueio = restante;
+  }
+
+  // Bloqueios seguidos ate agora (0 = nenhum)
+  uint8_t nivelBloqueio() const { return nivel; }
+  // Duracao do bloqueio atual ou do ultimo
+  unsigned long duracaoUltimoBloqueio() const { return duracaoBloqueio; }
+
+private:
+  void atualizar(unsigned long agora) {
+    if (bloqueado) {
+      if (agora - inicioBloqueio < duracaoBloqueio) {
+        return;
+      }
+      // Fim do bloqueio: uma ficha so, e a recarga recomeca daqui
+      bloqueado = false;
+      fichas = 1;
+      ultimaRecarga = inicioBloqueio + duracaoBloqueio;
+    }
+    while (fichas < capacidade && agora - ultimaRecarga >= recargaMs) {
+      fichas++;
+      ultimaRecarga += recargaMs;
+      if (fichas == capacidade) {
+        nivel = 0;
+      }
+    }
+  }
+
+  uint8_t capacidade;
+  unsigned long recargaMs;
+  unsigned long bloqueioBaseMs;
+  unsigned long bloqueioMaximoMs;
+  uint8_t fichas;
+  uint8_t nivel;
+  bool bloqueado;
+  unsigned long ultimaRecarga;
+  unsigned long inicioBloqueio;
+  unsigned long duracaoBloqueio;
+};
+
+#endif
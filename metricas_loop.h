@@ -0,0 +1,210 @@
+// Duracao das iteracoes do loop(), num histograma de tamanho fixo.
+//
+// marcar() no inicio de cada loop() mede o tempo desde a chamada
+// anterior (a iteracao inteira, incluindo delay() e o que o core faz entre
+// uma e outra) e conta essa duracao numa faixa de potencia de 2: a faixa
+// i vai de 2^i a 2^(i+1) - 1 us, e a ultima junta tudo acima. O custo e
+// uma leitura de micros(), algumas comparacoes e um incremento, sem
+// laco e sem divisao.
+//
+// Alem do histograma ficam o maior tempo, o numero de iteracoes e
+// quantas passaram do orcamento. O percentil sai do histograma, entao
+// vale o limite superior da faixa: "p99 <= 2047 us". As faixas contam
+// em 32 bits (80 bytes de RAM ao todo); se uma chegar ao limite, todas
+// sao divididas por 2, arredondando para cima para nenhuma faixa usada
+// sumir.
+//
+// Com METRICAS_LOOP definido como 0 antes do include (ou -DMETRICAS_LOOP=0)
+// a classe fica vazia e marcar() nao gera codigo.
+//
+//   MetricasLoop metricas(10000);    // orcamento de 10 ms
+//   void loop() { metricas.marcar(); ... }
+//   metricas.imprimir(saida);        // no comando METRICS
+#ifndef METRICAS_LOOP_H
+#define METRICAS_LOOP_H
+
+#include <Arduino.h>
+
+#ifndef METRICAS_LOOP
+#define METRICAS_LOOP 1
+#endif
+
+const uint8_t FAIXAS_METRICAS = 20;   // ate 2^19 us (~0,5 s); a ultima e "acima"
+
+#if METRICAS_LOOP
+
+class MetricasLoop {
+public:
+  explicit MetricasLoop(unsigned long orcamentoMicros)
+    : orcamento(orcamentoMicros), anterior(0), iniciado(false) {
+    zerar();
+  }
+
+  void marcar() {
+    unsigned long agora = micros();
+    unsigned long duracao = agora - anterior;
+    anterior = agora;
+    if (!iniciado) {
+      iniciado = true;
+      return;
+    }
+    iteracoes++;
+    if (duracao > maior) {
+      maior = duracao;
+    }
+    if (duracao > orcamento) {
+      acimaDoOrcamento++;
+    }
+    uint8_t faixa = faixaDe(duracao);
+    if (++contagens[faixa] == 0xFFFFFFFFUL) {
+      reduzirPelaMetade();
+    }
+  }
+
+  // Recomeca a contagem (a proxima iteracao ja e medida)
+  void zerar() {
+    for (uint8_t i = 0; i < FAIXAS_METRICAS; i++) {
+      contagens[i] = 0;
+    }
+    iteracoes = 0;
+    maior = 0;
+    acimaDoOrcamento = 0;
+  }
+
+  unsigned long totalIteracoes() const { return iteracoes; }
+  unsigned long maiorMicros() const { return maior; }
+  unsigned long iteracoesAcimaDoOrcamento() const { return acimaDoOrcamento; }
+
+  // Limite superior, em us, da faixa onde cai o percentil (1 a 100)
+  unsigned long percentilMicros(uint8_t percentil) const {
+    // 64 bits: a soma das faixas passa de 32 (so roda ao imprimir)
+    uint64_t total = 0;
+    for (uint8_t i = 0; i < FAIXAS_METRICAS; i++) {
+      total += contagens[i];
+    }
+    if (total == 0) {
+      return 0;
+    }
+    // Posicao da iteracao do percentil, arredondada para cima
+    uint64_t alvo = (total * percentil + 99) / 100;
+    uint64_t acumulado = 0;
+    uint8_t i = 0;
+    for (; i < FAIXAS_METRICAS - 1; i++) {
+      acumulado += contagens[i];
+      if (acumulado >= alvo) {
+        break;
+      }
+    }
+    return i == FAIXAS_METRICAS - 1 ? maior : limiteFaixa(i);
+  }
+
+  // antesDaLinha (opcional) e chamada no comeco de cada linha, para o
+  // sketch numerar ou marcar as respostas
+  void imprimir(Print &p, void (*antesDaLinha)() = NULL) const {
+    comecarLinha(antesDaLinha);
+    p.print(F("Iteracoes: "));
+    p.print(iteracoes);
+    p.print(F("  maior: "));
+    p.print(maior);
+    p.print(F(" us  p50 <= "));
+    p.print(percentilMicros(50));
+    p.print(F(" us  p99 <= "));
+    p.print(percentilMicros(99));
+    p.println(F(" us"));
+    comecarLinha(antesDaLinha);
+    p.print(F("Acima de "));
+    p.print(orcamento);
+    p.print(F(" us: "));
+    p.println(acimaDoOrcamento);
+    for (uint8_t i = 0; i < FAIXAS_METRICAS; i++) {
+      if (contagens[i] == 0) {
+        continue;
+      }
+      comecarLinha(antesDaLinha);
+      if (i == FAIXAS_METRICAS - 1) {
+        p.print(F(">= "));
+        p.print(limiteFaixa(i - 1) + 1);
+      } else {
+        p.print(F("<= "));
+        p.print(limiteFaixa(i));
+      }
+      p.print(F(" us: "));
+      p.println(contagens[i]);
+    }
+  }
+
+private:
+  static void comecarLinha(void (*antesDaLinha)()) {
+    if (antesDaLinha != NULL) {
+      antesDaLinha();
+    }
+  }
+
+  static unsigned long limiteFaixa(uint8_t faixa) {
+    return (2UL << faixa) - 1;
+  }
+
+  // Posicao do bit mais alto, limitada a ultima faixa: busca binaria de
+  // 16, 8, 4 e 2 bits, cinco comparacoes ao todo
+  static uint8_t faixaDe(unsigned long duracao) {
+    if (duracao >= (1UL << (FAIXAS_METRICAS - 1))) {
+      return FAIXAS_METRICAS - 1;
+    }
+    uint8_t faixa = 0;
+    uint16_t resto = duracao;
+    if (duracao >> 16) {
+      faixa = 16;
+      resto = duracao >> 16;
+    }
+    if (resto >> 8) {
+      faixa += 8;
+      resto >>= 8;
+    }
+    if (resto >> 4) {
+      faixa += 4;
+      resto >>= 4;
+    }
+    if (resto >> 2) {
+      faixa += 2;
+      resto >>= 2;
+    }
+    return faixa + (resto >> 1);
+  }
+
+  void reduzirPelaMetade() {
+    for (uint8_t i = 0; i < FAIXAS_METRICAS; i++) {
+      contagens[i] = (contagens[i] >> 1) + (contagens[i] & 1);
+    }
+  }
+
+  unsigned long orcamento;
+  unsigned long anterior;
+  bool iniciado;
+  unsigned long contagens[FAIXAS_METRICAS];
+  unsigned long iteracoes;
+  unsigned long maior;
+  unsigned long acimaDoOrcamento;
+};
+
+#else
+
+class MetricasLoop {
+public:
+  explicit MetricasLoop(unsigned long) {}
+  void marcar() {}
+  void zerar() {}
+  unsigned long totalIteracoes() const { return 0; }
+  unsigned long maiorMicros() const { return 0; }
+  unsigned long iteracoesAcimaDoOrcamento() const { return 0; }
+  unsigned long percentilMicros(uint8_t) const { return 0; }
+  void imprimir(Print &p, void (*antesDaLinha)() = NULL) const {
+    if (antesDaLinha != NULL) {
+      antesDaLinha();
+    }
+    p.println(F("Metricas do loop desligadas nesta compilacao (METRICAS_LOOP=0)"));
+  }
+};
+
+#endif
+
+#endif
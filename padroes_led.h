@@ -0,0 +1,142 @@
+// Animacoes de LED sem bloqueio, descritas como tabelas em PROGMEM.
+//
+// Um padrao e uma lista de passos {leds acesos, duracao} terminada por
+// FIM_PADRAO. Cada LED e um bit, na ordem dos pinos do GrupoPinos
+// (gpio_direto.h) que parametriza a classe. O padrao controla so os LEDs
+// que acende em algum passo; os demais seguem o estado fixo (fixar()) ou
+// outro padrao.
+//
+// Ha MAX_CANAIS_LED canais tocando ao mesmo tempo. Quando dois canais
+// controlam o mesmo LED, vale o de numero maior. atualizar() avanca todos
+// os canais e, se algo mudou, escreve todos os LEDs com um so acesso a
+// porta; chame a cada loop(). Um padrao novo custa dois bytes por passo
+// de flash, sem codigo novo.
+//
+//   const PassoLed PISCAR[] PROGMEM = { { 1, 20 }, { 0, 20 }, FIM_PADRAO };
+//   PadroesLed<GrupoPinos<13, 12> > leds;
+//   leds.iniciar();                 // no setup()
+//   leds.tocar(0, PISCAR, 3);       // pisca o pino 13 tres vezes
+//   leds.atualizar();               // no loop()
+#ifndef PADROES_LED_H
+#define PADROES_LED_H
+
+#include <Arduino.h>
+#include "gpio_direto.h"
+
+const uint8_t MAX_CANAIS_LED = 3;
+const uint8_t MS_POR_UNIDADE_LED = 10;   // duracao de 1 a 255 -> 10 ms a 2,55 s
+const uint8_t REPETIR_SEMPRE = 0;
+
+struct PassoLed {
+  uint8_t leds;      // bit i = LED i aceso
+  uint8_t duracao;   // em unidades de MS_POR_UNIDADE_LED; 0 termina o padrao
+};
+
+#define FIM_PADRAO { 0, 0 }
+
+template <class LEDS>
+class PadroesLed {
+public:
+  PadroesLed() : fixos(0), escritos(0) {}
+
+  void iniciar() {
+    LEDS::comoSaida();
+    LEDS::escrever(0);
+    fixos = 0;
+    escritos = 0;
+    for (uint8_t c = 0; c < MAX_CANAIS_LED; c++) {
+      canais[c].padrao = NULL;
+    }
+  }
+
+  // Estado dos LEDs quando nenhum padrao os controla
+  void fixar(uint8_t leds, bool aceso) {
+    fixos = aceso ? (fixos | leds) : (fixos & ~leds);
+    escrever();
+  }
+
+  // repeticoes = REPETIR_SEMPRE toca ate parar()
+  void tocar(uint8_t canal, const PassoLed *padrao, uint8_t repeticoes) {
+    Canal &c = canais[canal];
+    c.padrao = padrao;
+    c.mascara = 0;
+    for (const PassoLed *p = padrao; pgm_read_byte(&p->duracao) != 0; p++) {
+      c.mascara |= pgm_read_byte(&p->leds);
+    }
+    c.repeticoes = repeticoes;
+    c.passo = 0;
+    c.inicioPasso = millis();
+    carregarPasso(c);
+    escrever();
+  }
+
+  void parar(uint8_t canal) {
+    canais[canal].padrao = NULL;
+    escrever();
+  }
+
+  bool tocando(uint8_t canal) const {
+    return canais[canal].padrao != NULL;
+  }
+
+  void atualizar() {
+    unsigned long agora = millis();
+    for (uint8_t i = 0; i < MAX_CANAIS_LED; i++) {
+      Canal &c = canais[i];
+      // Conta a partir do fim do passo anterior (e nao de agora) para
+      // nao acumular atraso; um loop() lento pula os passos vencidos
+      while (c.padrao != NULL && agora - c.inicioPasso >= c.duracaoMs) {
+        c.inicioPasso += c.duracaoMs;
+        c.passo++;
+        carregarPasso(c);
+      }
+    }
+    escrever();
+  }
+
+private:
+  struct Canal {
+    const PassoLed *padrao;   // NULL = livre
+    uint8_t mascara;
+    uint8_t passo;
+    uint8_t repeticoes;
+    uint8_t leds;             // do passo atual, ja lido da flash
+    uint16_t duracaoMs;
+    unsigned long inicioPasso;
+  };
+
+  // Le o passo atual; no fim da tabela recomeca ou libera o canal
+  void carregarPasso(Canal &c) {
+    uint8_t duracao = pgm_read_byte(&c.padrao[c.passo].duracao);
+    if (duracao == 0) {
+      if (c.repeticoes != REPETIR_SEMPRE && --c.repeticoes == 0) {
+        c.padrao = NULL;
+        return;
+      }
+      c.passo = 0;
+      duracao = pgm_read_byte(&c.padrao[0].duracao);
+    }
+    c.leds = pgm_read_byte(&c.padrao[c.passo].leds);
+    c.duracaoMs = (uint16_t)duracao * MS_POR_UNIDADE_LED;
+  }
+
+  void escrever() {
+    uint8_t saida = fixos;
+    for (uint8_t i = 0; i < MAX_CANAIS_LED; i++) {
+      const Canal &c = canais[i];
+      if (c.padrao != NULL) {
+        saida = (saida & ~c.mascara) | (c.leds & c.mascara);
+      }
+    }
+    if (saida != escritos) {
+      LEDS::escrever(saida);
+      escritos = saida;
+    }
+  }
+
+  uint8_t fixos;
+  uint8_t escritos;
+  Canal canais[MAX_CANAIS_LED];
+};
+
+#endif
@@ -0,0 +1,213 @@
+// Perfil de funcoes no proprio Arduino: sondas de entrada e saida com o
+// tempo do Timer1, guardadas num buffer circular em RAM.
+//
+// MEDIR_PERFIL(perfil, ID) no comeco de uma funcao grava um evento de
+// entrada e, quando o escopo termina (qualquer return), um de saida.
+// Cada evento tem 3 bytes: o codigo (ID * 2, +1 na saida) e os 16 bits
+// de TCNT1, que conta livre com prescaler 8 (0,5 us a 16 MHz) e da uma
+// volta a cada 32,8 ms. A interrupcao de estouro conta as voltas; quando
+// elas mudaram desde o ultimo evento, entra antes um evento
+// VOLTAS_PERFIL com quantas foram. Assim o host reconstroi o tempo exato
+// entre eventos vizinhos, e perder os mais antigos (sobrescritos quando
+// o buffer enche) nao atrapalha os que ficaram.
+//
+// despejar() manda o buffer pela serial num bloco binario:
+//
+//   "PERFIL <tamanho>\r\n", depois <tamanho> bytes:
+//     'P' 'F' versao(1) ns_por_tick(2) tamanho_nomes(1)
+//     nomes das funcoes, cada um terminado por '\0', na ordem dos ids
+//     eventos(2) descartados(2) eventos (3 bytes cada, do mais antigo)
+//   e o CRC-CCITT (2) desses bytes, e "\r\n"
+//
+// Numeros em little-endian. host/perfil_funcoes.py le a saida da serial
+// e monta a tabela de tempo inclusivo e exclusivo por funcao e as pilhas
+// para flame graph. Durante o despejo nada e gravado.
+//
+// Define a ISR do Timer1: inclua em um unico arquivo do sketch. Com
+// PERFIL definido como 0 antes do include (ou -DPERFIL=0) as sondas
+// somem e o Timer1 fica livre.
+//
+//   const uint8_t PERFIL_LER = 0, PERFIL_ESCREVER = 1;
+//   const char NOMES_PERFIL[] PROGMEM = "ler\0escrever";
+//   Perfil<64> perfil(NOMES_PERFIL, sizeof(NOMES_PERFIL));
+//   perfil.iniciar();                  // no setup()
+//   void ler() { MEDIR_PERFIL(perfil, PERFIL_LER); ... }
+//   perfil.despejar(Serial);
+#ifndef PERFIL_H
+#define PERFIL_H
+
+#include <Arduino.h>
+#include <util/crc16.h>
+
+#ifndef PERFIL
+#define PERFIL 1
+#endif
+
+const uint8_t VERSAO_PERFIL = 1;
+const uint16_t NS_POR_TICK_PERFIL = 500;   // prescaler 8
+const uint8_t VOLTAS_PERFIL = 0xFF;        // codigo do evento de voltas
+const uint8_t MAX_FUNCOES_PERFIL = 127;
+const uint8_t BYTES_EVENTO_PERFIL = 3;
+
+#if PERFIL
+
+volatile uint16_t voltasTimerPerfil = 0;
+
+ISR(TIMER1_OVF_vect) {
+  voltasTimerPerfil++;
+}
+
+template <uint8_t EVENTOS>
+class Perfil {
+public:
+  // nomes: "funcaoA\0funcaoB" em PROGMEM; tamanho com o '\0' final
+  Perfil(const char *nomes, uint8_t tamanhoNomes)
+    : nomes(nomes), tamanhoNomes(tamanhoNomes), gravando(false) {
+    zerar();
+  }
+
+  // Liga o Timer1 em contagem livre e comeca a gravar
+  void iniciar() {
+    noInterrupts();
+    TCCR1A = 0;
+    TCCR1B = _BV(CS11);
+    TCNT1 = 0;
+    voltasTimerPerfil = 0;
+    TIMSK1 = _BV(TOIE1);
+    interrupts();
+    zerar();
+    gravando = true;
+  }
+
+  void zerar() {
+    inicio = 0;
+    total = 0;
+    descartados = 0;
+    ultimasVoltas = 0;
+  }
+
+  void registrar(uint8_t codigo) {
+    if (!gravando) {
+      return;
+    }
+    noInterrupts();
+    uint16_t tempo = TCNT1;
+    uint16_t voltas = voltasTimerPerfil;
+    // Estouro ainda nao atendido: a contagem ja recomecou
+    if ((TIFR1 & _BV(TOV1)) && tempo < 0x8000) {
+      voltas++;
+    }
+    interrupts();
+    if (voltas != ultimasVoltas) {
+      gravar(VOLTAS_PERFIL, voltas - ultimasVoltas);
+      ultimasVoltas = voltas;
+    }
+    gravar(codigo, tempo);
+  }
+
+  void despejar(Print &p) {
+    bool estavaGravando = gravando;
+    gravando = false;
+
+    uint16_t tamanho = 6 + tamanhoNomes + 4 + (uint16_t)total * BYTES_EVENTO_PERFIL;
+    p.print(F("PERFIL "));
+    p.println(tamanho);
+    uint16_t crc = 0xFFFF;
+    crc = enviar(p, crc, 'P');
+    crc = enviar(p, crc, 'F');
+    crc = enviar(p, crc, VERSAO_PERFIL);
+    crc = enviar16(p, crc, NS_POR_TICK_PERFIL);
+    crc = enviar(p, crc, tamanhoNomes);
+    for (uint8_t i = 0; i < tamanhoNomes; i++) {
+      crc = enviar(p, crc, pgm_read_byte(nomes + i));
+    }
+    crc = enviar16(p, crc, total);
+    crc = enviar16(p, crc, descartados);
+    for (uint8_t n = 0; n < total; n++) {
+      const uint8_t *evento = eventos + ((inicio + n) % EVENTOS) * BYTES_EVENTO_PERFIL;
+      for (uint8_t b = 0; b < BYTES_EVENTO_PERFIL; b++) {
+        crc = enviar(p, crc, evento[b]);
+      }
+    }
+    p.write((uint8_t)crc);
+    p.write((uint8_t)(crc >> 8));
+    p.println();
+
+    gravando = estavaGravando;
+  }
+
+private:
+  // Com o buffer cheio, o evento mais antigo da lugar ao novo
+  void gravar(uint8_t codigo, uint16_t valor) {
+    uint8_t posicao;
+    if (total < EVENTOS) {
+      posicao = (inicio + total++) % EVENTOS;
+    } else {
+      posicao = inicio;
+      inicio = (inicio + 1) % EVENTOS;
+      if (descartados < 0xFFFF) {
+        descartados++;
+      }
+    }
+    uint8_t *evento = eventos + posicao * BYTES_EVENTO_PERFIL;
+    evento[0] = codigo;
+    evento[1] = (uint8_t)valor;
+    evento[2] = (uint8_t)(valor >> 8);
+  }
+
+  static uint16_t enviar(Print &p, uint16_t crc, uint8_t byte) {
+    p.write(byte);
+    return _crc_ccitt_update(crc, byte);
+  }
+
+  static uint16_t enviar16(Print &p, uint16_t crc, uint16_t valor) {
+    crc = enviar(p, crc, (uint8_t)valor);
+    return enviar(p, crc, (uint8_t)(valor >> 8));
+  }
+
+  const char *nomes;
+  uint8_t tamanhoNomes;
+  bool gravando;
+  uint8_t eventos[EVENTOS * BYTES_EVENTO_PERFIL];
+  uint8_t inicio;
+  uint8_t total;
+  uint16_t descartados;
+  uint16_t ultimasVoltas;
+};
+
+// Grava a entrada agora e a saida no destrutor
+template <class P>
+class SondaPerfil {
+public:
+  SondaPerfil(P &perfil, uint8_t funcao) : perfil(perfil), funcao(funcao) {
+    perfil.registrar(funcao << 1);
+  }
+  ~SondaPerfil() {
+    perfil.registrar((funcao << 1) | 1);
+  }
+
+private:
+  P &perfil;
+  uint8_t funcao;
+};
+
+#define MEDIR_PERFIL(perfil, funcao) SondaPerfil<decltype(perfil)> sondaPerfil((perfil), (funcao))
+
+#else
+
+template <uint8_t EVENTOS>
+class Perfil {
+public:
+  Perfil(const char *, uint8_t) {}
+  void iniciar() {}
+  void zerar() {}
+  void despejar(Print &p) {
+    p.println(F("Perfil desligado nesta compilacao (PERFIL=0)"));
+  }
+};
+
+#define MEDIR_PERFIL(perfil, funcao)
+
+#endif
+
+#endif
@@ -1,230 +1,484 @@
 // SIMULACAO COMPLETA - BUS PIRATE + ATAQUE IoT (OTIMIZADO)
 // Demonstra interceptação e exploração de vulnerabilidades
 
-int ledVitima = 13;    // LED Vermelho - Sistema sendo atacado
-int ledPirate = 12;    // LED Verde - Bus Pirate interceptador  
-int ledAlerta = 11;    // LED Azul - Alertas de segurança
+#include "tabela_comandos.h"
+#include "padroes_led.h"
+#include "fila_serial.h"
+#include "metricas_loop.h"
+#include "cenario.h"
+#include "catalogo_projeto_1-modificado.h"
+
+// Pinos 13 (LED Vermelho - Sistema sendo atacado), 12 (LED Verde - Bus
+// Pirate interceptador) e 11 (LED Azul - Alertas de segurança), todos
+// na PORTB: os tres mudam com uma unica escrita
+typedef GrupoPinos<13, 12, 11> PinosLeds;
+const uint8_t LED_VITIMA = 1 << 0;
+const uint8_t LED_PIRATE = 1 << 1;
+const uint8_t LED_ALERTA = 1 << 2;
+const uint8_t TODOS_LEDS = LED_VITIMA | LED_PIRATE | LED_ALERTA;
+
+PadroesLed<PinosLeds> leds;
+
+// Saida da serial em fila: menu e roteiro saem em segundo plano sem
+// travar o loop() nem a leitura de comandos
+FilaSerial<512> saida(Serial);
+
+// Duracao de cada loop() (comando METRICS): o escalonador so anda quando
+// o loop() volta, entao uma iteracao longa atrasa tarefas e animacoes
+const unsigned long ORCAMENTO_LOOP_US = 1000;
+MetricasLoop metricas(ORCAMENTO_LOOP_US);
+
+// Canais de animacao: o de numero maior prevalece no mesmo LED
+const uint8_t CANAL_PIRATE = 0;   // interceptacao durante o ataque
+const uint8_t CANAL_SINAL = 1;    // piscadas curtas (inicio, alertas)
+const uint8_t CANAL_FINAL = 2;    // efeito final com todos os LEDs
+
+const PassoLed PISCAR_INICIO[] PROGMEM = { { LED_VITIMA, 30 }, { 0, 30 }, FIM_PADRAO };
+const PassoLed PISCAR_ALERTA[] PROGMEM = { { LED_ALERTA, 15 }, { 0, 15 }, FIM_PADRAO };
+const PassoLed ANIMACAO_PIRATE[] PROGMEM = { { LED_PIRATE, 25 }, { 0, 25 }, FIM_PADRAO };
+const PassoLed EFEITO_FINAL[] PROGMEM = { { TODOS_LEDS, 20 }, { 0, 20 }, FIM_PADRAO };
+// A animacao continua um pouco depois do fim do ataque
+const unsigned long ANIMACAO_APOS_ATAQUE = 5000;
 
 bool sistemaLigado = false;
 bool atacanteConectado = false;
-unsigned long ultimoAtaque = 0;
+
+// Leitura de comandos sem bloqueio (linha terminada em '\n' ou '\r')
+const byte TAMANHO_BUFFER = 16;
+char bufferComando[TAMANHO_BUFFER];
+byte tamanhoComando = 0;
+
+// ===== ESCALONADOR COOPERATIVO =====
+// Tarefas temporizadas por millis(): cada tarefa executa um trecho curto
+// e, se precisar continuar depois, agenda a propria continuacao.
+typedef void (*FuncaoTarefa)();
+
+struct Tarefa {
+  FuncaoTarefa funcao;     // NULL = slot livre
+  unsigned long inicio;
+  unsigned long espera;
+};
+
+const byte MAX_TAREFAS = 4;
+Tarefa tarefas[MAX_TAREFAS];
+
+// Roteiros do ataque em bytecode (ver cenario.h): cada fase e um
+// cenario em PROGMEM, e o ataque completo chama as fases. As tabelas
+// ficam no fim do arquivo
+const uint8_t CENARIO_INICIALIZACAO = 0;
+const uint8_t CENARIO_CONEXAO = 1;
+const uint8_t CENARIO_RECONHECIMENTO = 2;
+const uint8_t CENARIO_CREDENCIAL = 3;
+const uint8_t CENARIO_CONTROLE = 4;
+const uint8_t CENARIO_DEBUG = 5;
+const uint8_t CENARIO_INICIO = 6;
+const uint8_t CENARIO_COMPLETO = 7;
+extern const RecursosCenario RECURSOS;
+Cenario cenario(saida, &RECURSOS);
 
 void setup() {
   Serial.begin(9600);
-  pinMode(ledVitima, OUTPUT);
-  pinMode(ledPirate, OUTPUT);
-  pinMode(ledAlerta, OUTPUT);
+  leds.iniciar();
   
-  Serial.println(F("===================================="));
-  Serial.println(F("   SIMULACAO BUS PIRATE ATTACK     "));
-  Serial.println(F("===================================="));
-  Serial.println();
+  saida.println(MSG("===================================="));
+  saida.println(MSG("   SIMULACAO BUS PIRATE ATTACK     "));
+  saida.println(MSG("===================================="));
+  saida.println();
   
-  inicializarSistema();
-  conectarBusPirate();
+  // A inicializacao tambem e um roteiro: as piscadas e a espera pelo
+  // Bus Pirate nao travam o loop()
+  iniciarAtaque(CENARIO_INICIO);
 }
 
 void loop() {
-  if (Serial.available()) {
-    String comando = Serial.readString();
-    comando.trim();
+  metricas.marcar();
+  if (lerComando()) {
+    processarComando(bufferComando);
+  }
+  
+  if (cenario.executar()) {
+    agendarTarefa(pararAnimacaoPirate, ANIMACAO_APOS_ATAQUE);
+  }
+  executarTarefas();
+  leds.atualizar();
+  saida.bombear();
+}
+
+// Consome os bytes disponiveis; retorna true quando uma linha completa
+// estiver em bufferComando
+bool lerComando() {
+  while (Serial.available()) {
+    char c = Serial.read();
     
-    if (comando == "1") {
-      demonstrarReconhecimento();
-    }
-    else if (comando == "2") {
-      demonstrarAtaqueCredencial();
-    }
-    else if (comando == "3") {
-      demonstrarControleRemoto();
-    }
-    else if (comando == "4") {
-      demonstrarExtracaoDebug();
-    }
-    else if (comando == "AUTO") {
-      ataqueCompleto();
-    }
-    else {
-      mostrarMenu();
+    if (c == '\n' || c == '\r') {
+      bufferComando[tamanhoComando] = '\0';
+      bool completo = tamanhoComando > 0;
+      tamanhoComando = 0;
+      if (completo) {
+        return true;
+      }
+    } else if (tamanhoComando < TAMANHO_BUFFER - 1) {
+      bufferComando[tamanhoComando++] = c;
     }
   }
-  
-  // Animação Bus Pirate
-  if (millis() - ultimoAtaque < 5000) {
-    digitalWrite(ledPirate, millis() % 500 < 250);
+  return false;
+}
+
+// Remove espacos do inicio e do fim no proprio buffer
+char *aparar(char *texto) {
+  while (isspace(*texto)) {
+    texto++;
   }
+  char *fim = texto + strlen(texto);
+  while (fim > texto && isspace(fim[-1])) {
+    *--fim = '\0';
+  }
+  return texto;
 }
 
-void inicializarSistema() {
-  Serial.println(F("FASE 1: INICIALIZACAO SISTEMA"));
-  Serial.println(F("Sistema IoT iniciando..."));
-  
-  for(int i = 0; i < 3; i++) {
-    digitalWrite(ledVitima, HIGH);
-    delay(300);
-    digitalWrite(ledVitima, LOW);
-    delay(300);
+// ===== COMANDOS =====
+
+void comandoAbortar(const char *argumento) {
+  abortarRoteiro();
+}
+
+void comandoReconhecimento(const char *argumento) {
+  iniciarAtaque(CENARIO_RECONHECIMENTO);
+}
+
+void comandoAtaqueCredencial(const char *argumento) {
+  iniciarAtaque(CENARIO_CREDENCIAL);
+}
+
+void comandoControleRemoto(const char *argumento) {
+  iniciarAtaque(CENARIO_CONTROLE);
+}
+
+void comandoExtracaoDebug(const char *argumento) {
+  iniciarAtaque(CENARIO_DEBUG);
+}
+
+void comandoAuto(const char *argumento) {
+  iniciarAtaque(CENARIO_COMPLETO);
+}
+
+void comandoFilaTx(const char *argumento) {
+  saida.print(MSG("Fila TX: pico "));
+  saida.print(saida.pico());
+  saida.print(MSG("/512 bytes, "));
+  saida.print(saida.vezesBloqueado());
+  saida.print(MSG(" esperas, "));
+  saida.print(saida.microsBloqueado() / 1000);
+  saida.println(MSG(" ms bloqueado"));
+}
+
+// METRICS:ZERAR recomeca a contagem depois de mostrar
+void comandoMetricas(const char *argumento) {
+  metricas.imprimir(saida);
+  if (strcmp_P(argumento, PSTR("ZERAR")) == 0) {
+    metricas.zerar();
   }
-  
-  Serial.println(F(" Sistema online"));
-  Serial.println(F(" UART ativo"));
-  Serial.println(F(" VULNERAVEL: Senha padrao exposta!"));
-  Serial.println(F(">>> Senha: 1234"));
-  Serial.println();
-  sistemaLigado = true;
 }
 
-void conectarBusPirate() {
-  Serial.println(F("FASE 2: ATACANTE CONECTA BUS PIRATE"));
-  Serial.println(F("Localizando pinos TX/RX..."));
-  delay(1000);
+constexpr Comando COMANDOS[] PROGMEM = {
+  { "0",       comandoAbortar,          COMANDO_SEM_ARGUMENTO },
+  { "1",       comandoReconhecimento,   COMANDO_SEM_ARGUMENTO },
+  { "2",       comandoAtaqueCredencial, COMANDO_SEM_ARGUMENTO },
+  { "3",       comandoControleRemoto,   COMANDO_SEM_ARGUMENTO },
+  { "4",       comandoExtracaoDebug,    COMANDO_SEM_ARGUMENTO },
+  { "AUTO",    comandoAuto,             COMANDO_SEM_ARGUMENTO },
+  { "TX",      comandoFilaTx,           COMANDO_SEM_ARGUMENTO },
+  { "METRICS", comandoMetricas,         0 },
+};
+constexpr IndiceComandos INDICE_COMANDOS PROGMEM = GERAR_INDICE_COMANDOS(COMANDOS);
+
+void processarComando(char *linha) {
+  if (!atacanteConectado) {
+    saida.println(MSG("Aguarde: sistema iniciando"));
+    return;
+  }
   
-  digitalWrite(ledPirate, HIGH);
-  Serial.println(F(" Bus Pirate conectado"));
-  Serial.println(F(" Interceptacao ativa"));
-  Serial.println(F(" Monitorando trafego..."));
-  Serial.println();
+  char *argumento;
+  const Comando *comando = buscarComando(COMANDOS, INDICE_COMANDOS, aparar(linha), &argumento);
   
-  atacanteConectado = true;
-  mostrarMenu();
+  if (comando != NULL) {
+    funcaoDoComando(comando)(argumento);
+  } else {
+    mostrarMenu();
+  }
 }
 
-void mostrarMenu() {
-  Serial.println(F("===== MENU DO ATACANTE ====="));
-  Serial.println(F("1 - Reconhecimento passivo"));
-  Serial.println(F("2 - Ataque de credencial"));
-  Serial.println(F("3 - Controle remoto"));
-  Serial.println(F("4 - Extracao modo DEBUG"));
-  Serial.println(F("AUTO - Ataque completo"));
-  Serial.println(F("============================"));
-}
-
-void demonstrarReconhecimento() {
-  Serial.println();
-  Serial.println(F("RECONHECIMENTO PASSIVO:"));
-  Serial.println(F("Bus Pirate interceptando..."));
-  
-  piscarAlerta(3);
-  
-  Serial.println(F("[INTERCEPTADO] Sistema iniciado"));
-  delay(500);
-  Serial.println(F("[INTERCEPTADO] Firmware v1.0"));
-  delay(500);
-  Serial.println(F("[INTERCEPTADO] Senha: 1234"));
-  
-  digitalWrite(ledAlerta, HIGH);
-  Serial.println(F("CREDENCIAL EXPOSTA!"));
-  Serial.println(F("Acesso total possivel"));
-  Serial.println();
-  
-  ultimoAtaque = millis();
+// ===== ESCALONADOR =====
+
+bool agendarTarefa(FuncaoTarefa funcao, unsigned long espera) {
+  for (byte i = 0; i < MAX_TAREFAS; i++) {
+    if (tarefas[i].funcao == NULL) {
+      tarefas[i].funcao = funcao;
+      tarefas[i].inicio = millis();
+      tarefas[i].espera = espera;
+      return true;
+    }
+  }
+  return false;
 }
 
-void demonstrarAtaqueCredencial() {
-  Serial.println();
-  Serial.println(F("ATAQUE DE CREDENCIAL:"));
-  Serial.println(F("Usando senha descoberta..."));
-  
-  Serial.println(F("[ENVIADO] AUTH:1234"));
-  delay(1000);
-  
-  digitalWrite(ledVitima, HIGH);
-  Serial.println(F("[INTERCEPTADO] ACESSO_LIBERADO"));
-  Serial.println(F("Sistema comprometido!"));
-  Serial.println(F("Controle total obtido"));
-  Serial.println();
-  
-  ultimoAtaque = millis();
+void cancelarTarefa(FuncaoTarefa funcao) {
+  for (byte i = 0; i < MAX_TAREFAS; i++) {
+    if (tarefas[i].funcao == funcao) {
+      tarefas[i].funcao = NULL;
+    }
+  }
 }
 
-void demonstrarControleRemoto() {
-  Serial.println();
-  Serial.println(F("CONTROLE REMOTO:"));
-  Serial.println(F("Executando comandos..."));
-  
-  Serial.println(F("[ENVIADO] LED_ON"));
-  digitalWrite(ledVitima, HIGH);
-  delay(1000);
-  
-  Serial.println(F("[INTERCEPTADO] LED_LIGADO"));
-  Serial.println(F("Dispositivo controlado"));
-  
-  delay(2000);
-  
-  Serial.println(F("[ENVIADO] LED_OFF"));
-  digitalWrite(ledVitima, LOW);
-  Serial.println(F("[INTERCEPTADO] LED_DESLIGADO"));
-  Serial.println(F("Controle fisico obtido"));
-  Serial.println();
-  
-  ultimoAtaque = millis();
+void executarTarefas() {
+  for (byte i = 0; i < MAX_TAREFAS; i++) {
+    FuncaoTarefa funcao = tarefas[i].funcao;
+    if (funcao != NULL && millis() - tarefas[i].inicio >= tarefas[i].espera) {
+      // Libera o slot antes de executar: a tarefa pode se reagendar
+      tarefas[i].funcao = NULL;
+      funcao();
+    }
+  }
 }
 
-void demonstrarExtracaoDebug() {
-  Serial.println();
-  Serial.println(F("EXTRACAO MODO DEBUG:"));
-  Serial.println(F("Comando secreto..."));
-  
-  piscarAlerta(5);
-  
-  Serial.println(F("[ENVIADO] DEBUG"));
-  delay(1000);
-  
-  Serial.println(F("[INTERCEPTADO] === INFO CONFIDENCIAL ==="));
-  delay(500);
-  Serial.println(F("[INTERCEPTADO] Senha: 1234"));
-  delay(500);
-  Serial.println(F("[INTERCEPTADO] Versao: BETA-INSECURE"));
-  
-  digitalWrite(ledAlerta, HIGH);
-  Serial.println(F("Dados criticos extraidos!"));
-  Serial.println(F("SISTEMA COMPROMETIDO"));
-  Serial.println();
-  
-  ultimoAtaque = millis();
+// ===== ROTEIRO DE ATAQUE =====
+
+void pararAnimacaoPirate() {
+  leds.parar(CANAL_PIRATE);
 }
 
-void ataqueCompleto() {
-  Serial.println();
-  Serial.println(F("ATAQUE AUTOMATICO COMPLETO..."));
-  Serial.println();
-  
-  delay(1000);
-  demonstrarReconhecimento();
-  delay(3000);
-  demonstrarAtaqueCredencial();  
-  delay(3000);
-  demonstrarControleRemoto();
-  delay(3000);
-  demonstrarExtracaoDebug();
-  
-  Serial.println();
-  Serial.println(F("===== ATAQUE CONCLUIDO ====="));
-  Serial.println(F(" Credenciais capturadas"));
-  Serial.println(F(" Acesso total obtido"));
-  Serial.println(F(" Controle remoto ativo"));
-  Serial.println(F(" Dados criticos extraidos"));
-  Serial.println(F(" SISTEMA COMPROMETIDO"));
-  Serial.println(F("============================"));
-  
-  // Efeito final
-  for(int i = 0; i < 10; i++) {
-    digitalWrite(ledVitima, HIGH);
-    digitalWrite(ledPirate, HIGH);
-    digitalWrite(ledAlerta, HIGH);
-    delay(200);
-    digitalWrite(ledVitima, LOW);
-    digitalWrite(ledPirate, LOW);
-    digitalWrite(ledAlerta, LOW);
-    delay(200);
+void abortarRoteiro() {
+  if (!cenario.ativo()) {
+    saida.println(MSG("Nenhum ataque em andamento"));
+    return;
+  }
+
+  cenario.parar();
+  cancelarTarefa(pararAnimacaoPirate);
+  leds.fixar(TODOS_LEDS, false);
+  for (byte canal = 0; canal < MAX_CANAIS_LED; canal++) {
+    leds.parar(canal);
   }
+
+  saida.println();
+  saida.println(MSG(">>> ATAQUE ABORTADO <<<"));
+  saida.println();
+}
+
+void mostrarMenu() {
+  saida.println(MSG("===== MENU DO ATACANTE ====="));
+  saida.println(MSG("1 - Reconhecimento passivo"));
+  saida.println(MSG("2 - Ataque de credencial"));
+  saida.println(MSG("3 - Controle remoto"));
+  saida.println(MSG("4 - Extracao modo DEBUG"));
+  saida.println(MSG("AUTO - Ataque completo"));
+  saida.println(MSG("0 - Abortar ataque em andamento"));
+  saida.println(MSG("TX - Uso da fila de saida"));
+  saida.println(MSG("METRICS - Duracao do loop()"));
+  saida.println(MSG("============================"));
+}
+
+// Acoes que os cenarios chamam com ACAO(numero, argumento)
+
+void acaoPiscarInicio(uint8_t vezes) {
+  leds.tocar(CANAL_SINAL, PISCAR_INICIO, vezes);
 }
 
-void piscarAlerta(int vezes) {
-  for(int i = 0; i < vezes; i++) {
-    digitalWrite(ledAlerta, HIGH);
-    delay(150);
-    digitalWrite(ledAlerta, LOW);
-    delay(150);
+void acaoPiscarAlerta(uint8_t vezes) {
+  leds.tocar(CANAL_SINAL, PISCAR_ALERTA, vezes);
+}
+
+// Efeito final: todos os LEDs piscam juntos, por cima da animacao
+void acaoEfeitoFinal(uint8_t vezes) {
+  leds.tocar(CANAL_FINAL, EFEITO_FINAL, vezes);
+}
+
+void acaoSistemaLigado(uint8_t) {
+  sistemaLigado = true;
+}
+
+void acaoAtacanteConectado(uint8_t) {
+  atacanteConectado = true;
+  mostrarMenu();
+}
+
+void fixarLedsCenario(uint8_t mascara, uint8_t acesos) {
+  leds.fixar(mascara & acesos, true);
+  leds.fixar(mascara & ~acesos, false);
+}
+
+const uint8_t ACAO_PISCAR_INICIO = 0;
+const uint8_t ACAO_PISCAR_ALERTA = 1;
+const uint8_t ACAO_EFEITO_FINAL = 2;
+const uint8_t ACAO_SISTEMA_LIGADO = 3;
+const uint8_t ACAO_ATACANTE_CONECTADO = 4;
+const AcaoCenario ACOES[] PROGMEM = {
+  acaoPiscarInicio,
+  acaoPiscarAlerta,
+  acaoEfeitoFinal,
+  acaoSistemaLigado,
+  acaoAtacanteConectado
+};
+
+// As esperas depois das piscadas cobrem a animacao (PISCAR_INICIO: 600 ms
+// por vez, PISCAR_ALERTA: 300 ms, EFEITO_FINAL: 400 ms)
+const uint8_t FASE_INICIALIZACAO[] PROGMEM = {
+  LINHA_MSG("FASE 1: INICIALIZACAO SISTEMA"),
+  LINHA_MSG("Sistema IoT iniciando..."),
+  ACAO(ACAO_PISCAR_INICIO, 3),
+  ESPERAR_MS(3 * 600),
+  LINHA_MSG(" Sistema online"),
+  LINHA_MSG(" UART ativo"),
+  LINHA_MSG(" VULNERAVEL: Senha padrao exposta!"),
+  LINHA_MSG(">>> Senha: 1234"),
+  PULAR_LINHA,
+  ACAO(ACAO_SISTEMA_LIGADO, 0),
+  FIM_CENARIO
+};
+
+const uint8_t FASE_CONEXAO[] PROGMEM = {
+  LINHA_MSG("FASE 2: ATACANTE CONECTA BUS PIRATE"),
+  LINHA_MSG("Localizando pinos TX/RX..."),
+  ESPERAR_MS(1000),
+  FIXAR_LEDS(LED_PIRATE, LED_PIRATE),
+  LINHA_MSG(" Bus Pirate conectado"),
+  LINHA_MSG(" Interceptacao ativa"),
+  LINHA_MSG(" Monitorando trafego..."),
+  PULAR_LINHA,
+  ACAO(ACAO_ATACANTE_CONECTADO, 0),
+  FIM_CENARIO
+};
+
+const uint8_t FASE_RECONHECIMENTO[] PROGMEM = {
+  PULAR_LINHA,
+  LINHA_MSG("RECONHECIMENTO PASSIVO:"),
+  LINHA_MSG("Bus Pirate interceptando..."),
+  ACAO(ACAO_PISCAR_ALERTA, 3),
+  ESPERAR_MS(3 * 300),
+  LINHA_MSG("[INTERCEPTADO] Sistema iniciado"),
+  ESPERAR_MS(500),
+  LINHA_MSG("[INTERCEPTADO] Firmware v1.0"),
+  ESPERAR_MS(500),
+  LINHA_MSG("[INTERCEPTADO] Senha: 1234"),
+  FIXAR_LEDS(LED_ALERTA, LED_ALERTA),
+  LINHA_MSG("CREDENCIAL EXPOSTA!"),
+  LINHA_MSG("Acesso total possivel"),
+  PULAR_LINHA,
+  FIM_CENARIO
+};
+
+const uint8_t FASE_CREDENCIAL[] PROGMEM = {
+  PULAR_LINHA,
+  LINHA_MSG("ATAQUE DE CREDENCIAL:"),
+  LINHA_MSG("Usando senha descoberta..."),
+  LINHA_MSG("[ENVIADO] AUTH:1234"),
+  ESPERAR_MS(1000),
+  FIXAR_LEDS(LED_VITIMA, LED_VITIMA),
+  LINHA_MSG("[INTERCEPTADO] ACESSO_LIBERADO"),
+  LINHA_MSG("Sistema comprometido!"),
+  LINHA_MSG("Controle total obtido"),
+  PULAR_LINHA,
+  FIM_CENARIO
+};
+
+const uint8_t FASE_CONTROLE[] PROGMEM = {
+  PULAR_LINHA,
+  LINHA_MSG("CONTROLE REMOTO:"),
+  LINHA_MSG("Executando comandos..."),
+  LINHA_MSG("[ENVIADO] LED_ON"),
+  FIXAR_LEDS(LED_VITIMA, LED_VITIMA),
+  ESPERAR_MS(1000),
+  LINHA_MSG("[INTERCEPTADO] LED_LIGADO"),
+  LINHA_MSG("Dispositivo controlado"),
+  ESPERAR_MS(2000),
+  LINHA_MSG("[ENVIADO] LED_OFF"),
+  FIXAR_LEDS(LED_VITIMA, 0),
+  LINHA_MSG("[INTERCEPTADO] LED_DESLIGADO"),
+  LINHA_MSG("Controle fisico obtido"),
+  PULAR_LINHA,
+  FIM_CENARIO
+};
+
+const uint8_t FASE_DEBUG[] PROGMEM = {
+  PULAR_LINHA,
+  LINHA_MSG("EXTRACAO MODO DEBUG:"),
+  LINHA_MSG("Comando secreto..."),
+  ACAO(ACAO_PISCAR_ALERTA, 5),
+  ESPERAR_MS(5 * 300),
+  LINHA_MSG("[ENVIADO] DEBUG"),
+  ESPERAR_MS(1000),
+  LINHA_MSG("[INTERCEPTADO] === INFO CONFIDENCIAL ==="),
+  ESPERAR_MS(500),
+  LINHA_MSG("[INTERCEPTADO] Senha: 1234"),
+  ESPERAR_MS(500),
+  LINHA_MSG("[INTERCEPTADO] Versao: BETA-INSECURE"),
+  FIXAR_LEDS(LED_ALERTA, LED_ALERTA),
+  LINHA_MSG("Dados criticos extraidos!"),
+  LINHA_MSG("SISTEMA COMPROMETIDO"),
+  PULAR_LINHA,
+  FIM_CENARIO
+};
+
+// No setup(): as piscadas e a espera pelo Bus Pirate nao travam o loop()
+const uint8_t ROTEIRO_INICIO[] PROGMEM = {
+  CHAMAR(CENARIO_INICIALIZACAO),
+  CHAMAR(CENARIO_CONEXAO),
+  FIM_CENARIO
+};
+
+const uint8_t ROTEIRO_COMPLETO[] PROGMEM = {
+  PULAR_LINHA,
+  LINHA_MSG("ATAQUE AUTOMATICO COMPLETO..."),
+  PULAR_LINHA,
+  ESPERAR_MS(1000),
+  CHAMAR(CENARIO_RECONHECIMENTO),
+  ESPERAR_MS(3000),
+  CHAMAR(CENARIO_CREDENCIAL),
+  ESPERAR_MS(3000),
+  CHAMAR(CENARIO_CONTROLE),
+  ESPERAR_MS(3000),
+  CHAMAR(CENARIO_DEBUG),
+  PULAR_LINHA,
+  LINHA_MSG("===== ATAQUE CONCLUIDO ====="),
+  LINHA_MSG(" Credenciais capturadas"),
+  LINHA_MSG(" Acesso total obtido"),
+  LINHA_MSG(" Controle remoto ativo"),
+  LINHA_MSG(" Dados criticos extraidos"),
+  LINHA_MSG(" SISTEMA COMPROMETIDO"),
+  LINHA_MSG("============================"),
+  ACAO(ACAO_EFEITO_FINAL, 10),
+  ESPERAR_MS(10 * 400),
+  // Apaga vitima e alerta como o efeito original; o Bus Pirate segue
+  // conectado
+  FIXAR_LEDS(LED_VITIMA | LED_ALERTA, 0),
+  FIM_CENARIO
+};
+
+// Na ordem dos CENARIO_*
+const uint8_t *const CENARIOS[] PROGMEM = {
+  FASE_INICIALIZACAO,
+  FASE_CONEXAO,
+  FASE_RECONHECIMENTO,
+  FASE_CREDENCIAL,
+  FASE_CONTROLE,
+  FASE_DEBUG,
+  ROTEIRO_INICIO,
+  ROTEIRO_COMPLETO
+};
+
+const RecursosCenario RECURSOS PROGMEM = { CENARIOS, ACOES, NULL, fixarLedsCenario };
+
+// Fica depois das tabelas porque le CENARIOS
+void iniciarAtaque(uint8_t numero) {
+  if (cenario.ativo()) {
+    saida.println(MSG("Ataque em andamento - envie 0 para abortar"));
+    return;
   }
-}
\ No newline at end of file
+
+  cenario.iniciar((const uint8_t *)pgm_read_ptr(&CENARIOS[numero]));
+
+  if (atacanteConectado) {
+    cancelarTarefa(pararAnimacaoPirate);
+    leds.tocar(CANAL_PIRATE, ANIMACAO_PIRATE, REPETIR_SEMPRE);
+  }
+}
@@ -1,69 +1,316 @@
 // Sistema de Controle LED via Serial
 // ATENÇÃO: Este código tem vulnerabilidades INTENCIONAIS para aprendizado
 
-String senha = "1234"; // PROBLEMA 1: senha visível no código
+#include "tabela_comandos.h"
+#include "protocolo_binario.h"
+#include "metricas_loop.h"
+#include "fila_serial.h"
+
+const char senha[] = "1234"; // PROBLEMA 1: senha visível no código
 int ledPin = 13;
 bool autenticado = false;
 
+// Leitura de comandos sem bloqueio: os bytes sao acumulados um a um
+// e o comando e executado assim que chega o fim de linha ('\n' ou '\r')
+// ou um ';'. Varios comandos podem vir numa transmissao so
+// ("AUTH:1234;LED_ON;STATUS\n") e sao executados em ordem.
+const byte TAMANHO_BUFFER = 32;
+char bufferComando[TAMANHO_BUFFER];
+byte tamanhoComando = 0;
+bool linhaDescartada = false; // linha maior que o buffer
+
+// Modo binario (comando BIN): quadros COBS + CRC16, ver protocolo_binario.h
+bool modoBinario = false;
+byte tamanhoQuadro = 0;
+
+// Cada comando recebido ganha um numero e toda linha de resposta dele
+// comeca com "#numero ", para o cliente casar as respostas do lote
+unsigned int sequencia = 0;
+
+// Toda a saida passa pela fila e sai pela UART a cada loop(), sem
+// esperar: a tela inicial e as respostas de DEBUG e STATUS passam dos
+// 64 bytes da TX e bloqueariam a leitura dos comandos seguintes
+FilaSerial<256> saida(Serial);
+
+// Duracao de cada loop() (comando METRICS). A 9600 baud chega um byte
+// por ms; uma iteracao mais longa que isso atrasa a leitura
+const unsigned long ORCAMENTO_LOOP_US = 1000;
+MetricasLoop metricas(ORCAMENTO_LOOP_US);
+
 void setup() {
   Serial.begin(9600);
   pinMode(ledPin, OUTPUT);
   
   // PROBLEMA 2: mostra informações sensíveis na inicialização
-  Serial.println("=== SISTEMA INICIADO ===");
-  Serial.println("Firmware v1.0 - Debug Mode");
-  Serial.println("Senha default: " + senha); // MUITO PERIGOSO!
-  Serial.println("Digite 'AUTH:senha' para autenticar");
-  Serial.println("Comandos: LED_ON, LED_OFF, STATUS");
+  saida.println(F("=== SISTEMA INICIADO ==="));
+  saida.println(F("Firmware v1.0 - Debug Mode"));
+  saida.print(F("Senha default: "));
+  saida.println(senha); // MUITO PERIGOSO!
+  saida.println(F("Digite 'AUTH:senha' para autenticar"));
+  saida.println(F("Comandos: LED_ON, LED_OFF, STATUS, BIN (modo binario), METRICS"));
+  saida.println(F("Cada comando termina com Enter ou ';' (varios por linha)"));
+  saida.println(F("Respostas: '#n ...' com n = 1 para o primeiro comando"));
 }
 
 void loop() {
-  if (Serial.available()) {
-    String comando = Serial.readString();
-    comando.trim();
-    
-    // PROBLEMA 3: registra todos os comandos digitados
-    Serial.println("CMD_LOG: " + comando);
-    
-    // Verificação de autenticação
-    if (comando.startsWith("AUTH:")) {
-      String senhaDigitada = comando.substring(5);
-      if (senhaDigitada == senha) {
-        autenticado = true;
-        Serial.println("ACESSO_LIBERADO");
-      } else {
-        // PROBLEMA 4: mostra a senha que a pessoa tentou
-        Serial.println("ACESSO_NEGADO - Tentativa: " + senhaDigitada);
+  metricas.marcar();
+  // Processa todos os comandos completos sem esperar timeout da serial.
+  // O modo pode mudar no meio (BIN / OP_TEXTO), entao e conferido a cada um.
+  bool recebido;
+  do {
+    if (modoBinario) {
+      recebido = lerQuadro();
+      if (recebido) {
+        processarQuadro();
+      }
+    } else {
+      recebido = lerComando();
+      if (recebido) {
+        processarComando(bufferComando);
       }
-      return;
     }
+  } while (recebido);
+  saida.bombear();
+}
+
+// Consome os bytes disponiveis; retorna true quando uma linha completa
+// estiver em bufferComando. Nunca espera por bytes que ainda nao chegaram.
+bool lerComando() {
+  while (Serial.available()) {
+    char c = Serial.read();
     
-    // Comandos do sistema (só funciona se autenticado)
-    if (autenticado) {
-      if (comando == "LED_ON") {
-        digitalWrite(ledPin, HIGH);
-        Serial.println("LED_LIGADO");
+    if (c == '\n' || c == '\r' || c == ';') {
+      bool completo = tamanhoComando > 0 && !linhaDescartada;
+      if (linhaDescartada) {
+        sequencia++;
+        numerarResposta();
+        saida.println(F("ERRO: Comando muito longo"));
       }
-      else if (comando == "LED_OFF") {
-        digitalWrite(ledPin, LOW);
-        Serial.println("LED_DESLIGADO");
+      bufferComando[tamanhoComando] = '\0';
+      tamanhoComando = 0;
+      linhaDescartada = false;
+      if (completo) {
+        return true;
       }
-      else if (comando == "STATUS") {
-        Serial.println("Sistema: ATIVO");
-        Serial.println("LED: " + String(digitalRead(ledPin) ? "ON" : "OFF"));
-        Serial.println("Tempo ligado: " + String(millis()) + "ms");
+    } else if (tamanhoComando < TAMANHO_BUFFER - 1) {
+      bufferComando[tamanhoComando++] = c;
+    } else {
+      linhaDescartada = true;
+    }
+  }
+  return false;
+}
+
+// Mesmo esquema de lerComando(), mas o quadro termina no byte 0x00
+bool lerQuadro() {
+  while (Serial.available()) {
+    uint8_t b = Serial.read();
+    
+    if (b == DELIMITADOR_QUADRO) {
+      bool completo = tamanhoComando > 0 && !linhaDescartada;
+      if (linhaDescartada) {
+        responderErro(ERRO_QUADRO);
       }
-      else if (comando == "DEBUG") {
-        // PROBLEMA 5: comando secreto que vaza informações
-        Serial.println("=== INFORMAÇÕES CONFIDENCIAIS ===");
-        Serial.println("Senha do sistema: " + senha);
-        Serial.println("Memória livre: 1024 bytes");
-        Serial.println("Versão: 1.0-BETA-INSECURE");
+      tamanhoQuadro = tamanhoComando;
+      tamanhoComando = 0;
+      linhaDescartada = false;
+      if (completo) {
+        return true;
       }
+    } else if (tamanhoComando < TAMANHO_BUFFER) {
+      bufferComando[tamanhoComando++] = b;
     } else {
-      Serial.println("ERRO: Você precisa se autenticar primeiro");
+      linhaDescartada = true;
     }
   }
+  return false;
+}
+
+// Prefixo de cada linha de resposta do comando atual
+void numerarResposta() {
+  saida.print('#');
+  saida.print(sequencia);
+  saida.print(' ');
+}
+
+// Remove espacos do inicio e do fim no proprio buffer, sem copiar
+char *aparar(char *texto) {
+  while (isspace(*texto)) {
+    texto++;
+  }
+  char *fim = texto + strlen(texto);
+  while (fim > texto && isspace(fim[-1])) {
+    *--fim = '\0';
+  }
+  return texto;
+}
+
+// ===== COMANDOS =====
+
+// Opcoes da tabela de comandos
+const uint8_t EXIGE_AUTENTICACAO = 0x01;
+
+void comandoAuth(const char *senhaDigitada) {
+  if (strcmp(senhaDigitada, senha) == 0) {
+    autenticado = true;
+    numerarResposta();
+    saida.println(F("ACESSO_LIBERADO"));
+  } else {
+    // PROBLEMA 4: mostra a senha que a pessoa tentou
+    numerarResposta();
+    saida.print(F("ACESSO_NEGADO - Tentativa: "));
+    saida.println(senhaDigitada);
+  }
+}
+
+void comandoLedOn(const char *argumento) {
+  digitalWrite(ledPin, HIGH);
+  numerarResposta();
+  saida.println(F("LED_LIGADO"));
+}
+
+void comandoLedOff(const char *argumento) {
+  digitalWrite(ledPin, LOW);
+  numerarResposta();
+  saida.println(F("LED_DESLIGADO"));
+}
+
+void comandoStatus(const char *argumento) {
+  numerarResposta();
+  saida.println(F("Sistema: ATIVO"));
+  numerarResposta();
+  saida.print(F("LED: "));
+  saida.println(digitalRead(ledPin) ? F("ON") : F("OFF"));
+  numerarResposta();
+  saida.print(F("Tempo ligado: "));
+  saida.print(millis());
+  saida.println(F("ms"));
+}
+
+void comandoBin(const char *argumento) {
+  numerarResposta();
+  saida.println(F("MODO_BINARIO"));
+  modoBinario = true;
+}
+
+void comandoDebug(const char *argumento) {
+  // PROBLEMA 5: comando secreto que vaza informações
+  numerarResposta();
+  saida.println(F("=== INFORMAÇÕES CONFIDENCIAIS ==="));
+  numerarResposta();
+  saida.print(F("Senha do sistema: "));
+  saida.println(senha);
+  numerarResposta();
+  saida.println(F("Memória livre: 1024 bytes"));
+  numerarResposta();
+  saida.println(F("Versão: 1.0-BETA-INSECURE"));
+}
+
+// METRICS:ZERAR recomeca a contagem depois de mostrar
+void comandoMetricas(const char *argumento) {
+  metricas.imprimir(saida, numerarResposta);
+  if (strcmp_P(argumento, PSTR("ZERAR")) == 0) {
+    metricas.zerar();
+  }
+}
+
+// Novos comandos entram aqui; o indice e refeito pelo compilador
+constexpr Comando COMANDOS[] PROGMEM = {
+  { "AUTH",    comandoAuth,     COMANDO_EXIGE_ARGUMENTO },
+  { "LED_ON",  comandoLedOn,    EXIGE_AUTENTICACAO | COMANDO_SEM_ARGUMENTO },
+  { "LED_OFF", comandoLedOff,   EXIGE_AUTENTICACAO | COMANDO_SEM_ARGUMENTO },
+  { "STATUS",  comandoStatus,   EXIGE_AUTENTICACAO | COMANDO_SEM_ARGUMENTO },
+  { "DEBUG",   comandoDebug,    EXIGE_AUTENTICACAO | COMANDO_SEM_ARGUMENTO },
+  { "BIN",     comandoBin,      COMANDO_SEM_ARGUMENTO },
+  { "METRICS", comandoMetricas, 0 },
+};
+constexpr IndiceComandos INDICE_COMANDOS PROGMEM = GERAR_INDICE_COMANDOS(COMANDOS);
+
+// Interpreta e responde o comando direto do buffer de leitura: nenhuma
+// String e criada, entao nada e alocado no heap por comando
+void processarComando(char *comando) {
+  comando = aparar(comando);
+  sequencia++;
+  
+  // PROBLEMA 3: registra todos os comandos digitados
+  numerarResposta();
+  saida.print(F("CMD_LOG: "));
+  saida.println(comando);
+  
+  char *argumento;
+  const Comando *encontrado = buscarComando(COMANDOS, INDICE_COMANDOS, comando, &argumento);
+  
+  // Comandos do sistema (só funciona se autenticado)
+  if (!autenticado && (encontrado == NULL || (opcoesDoComando(encontrado) & EXIGE_AUTENTICACAO))) {
+    numerarResposta();
+    saida.println(F("ERRO: Você precisa se autenticar primeiro"));
+    return;
+  }
+  
+  if (encontrado != NULL) {
+    funcaoDoComando(encontrado)(argumento);
+  }
+}
+
+// ===== MODO BINARIO =====
+
+void enviarPacote(uint8_t *pacote, uint8_t tamanho) {
+  uint8_t quadro[TAMANHO_MAX_QUADRO];
+  uint8_t n = montarQuadro(pacote, tamanho, quadro);
+  saida.write(quadro, n);
+  saida.write(DELIMITADOR_QUADRO);
+}
+
+void responderErro(uint8_t codigo) {
+  uint8_t pacote[2 + 2] = { OP_ERRO, codigo };
+  enviarPacote(pacote, 2);
+}
+
+void processarQuadro() {
+  uint8_t *pacote = (uint8_t *)bufferComando;
+  uint8_t tamanho = abrirQuadro(pacote, tamanhoQuadro);
+  if (tamanho == 0) {
+    responderErro(ERRO_CRC);
+    return;
+  }
   
-  delay(100);
-}
\ No newline at end of file
+  uint8_t opcode = pacote[0];
+  uint8_t resposta[8 + 2] = { (uint8_t)(opcode | OP_RESPOSTA) };
+  uint8_t tamanhoResposta = 1;
+  
+  if (opcode == OP_AUTH) {
+    uint8_t tamanhoSenha = tamanho - 1;
+    bool ok = tamanhoSenha == strlen(senha) && memcmp(pacote + 1, senha, tamanhoSenha) == 0;
+    // Como no AUTH de texto: senha errada nao desfaz a sessao aberta
+    if (ok) {
+      autenticado = true;
+    }
+    resposta[tamanhoResposta++] = ok;
+  }
+  else if (opcode == OP_TEXTO) {
+    modoBinario = false;
+  }
+  else if (!autenticado) {
+    responderErro(ERRO_AUTENTICACAO);
+    return;
+  }
+  else if (opcode == OP_LED_ON || opcode == OP_LED_OFF) {
+    digitalWrite(ledPin, opcode == OP_LED_ON ? HIGH : LOW);
+    resposta[tamanhoResposta++] = digitalRead(ledPin);
+  }
+  else if (opcode == OP_STATUS) {
+    unsigned long tempo = millis();
+    resposta[tamanhoResposta++] = digitalRead(ledPin);
+    resposta[tamanhoResposta++] = autenticado;
+    resposta[tamanhoResposta++] = (uint8_t)tempo;
+    resposta[tamanhoResposta++] = (uint8_t)(tempo >> 8);
+    resposta[tamanhoResposta++] = (uint8_t)(tempo >> 16);
+    resposta[tamanhoResposta++] = (uint8_t)(tempo >> 24);
+  }
+  else {
+    responderErro(ERRO_OPCODE);
+    return;
+  }
+  
+  enviarPacote(resposta, tamanhoResposta);
+}
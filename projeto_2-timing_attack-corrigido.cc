@@ -32,9 +32,24 @@ Montagem:
 
 #include <Keypad.h>
 #include <LiquidCrystal.h>
+#include "tela_lcd.h"
+#include "teclado_timer.h"
+#include "padroes_led.h"
+#include "fila_serial.h"
+#include "tabela_comandos.h"
+#include "metricas_loop.h"
+#include "perfil.h"
+#include "limite_tentativas.h"
+#include "credencial.h"
+#include "tabela_usuarios.h"
+#include "diario_eeprom.h"
+#include "cenario.h"
+#include "rastro.h"
+#include "catalogo_projeto_2-timing_attack-corrigido.h"
 
 // Configuração do LCD (RS, EN, D4, D5, D6, D7)
 LiquidCrystal lcd(A0, A1, A2, A3, A4, A5);
+TelaLcd tela(lcd);  // so envia ao LCD as celulas que mudaram
 
 // Configuração do Keypad 4x4
 const byte ROWS = 4;
@@ -50,48 +65,186 @@ byte colPins[COLS] = {6, 7, 8, 9};
 Keypad keypad = Keypad(makeKeymap(keys), rowPins, colPins, ROWS, COLS);
 
 // Configuração dos componentes
-const int LED_VERDE = 12;
-const int LED_VERMELHO = 13;
+typedef GrupoPinos<12, 13> PinosLeds;  // verde, vermelho (PORTB)
+const uint8_t LED_VERDE = 1 << 0;
+const uint8_t LED_VERMELHO = 1 << 1;
+PadroesLed<PinosLeds> leds;
+const uint8_t CANAL_ALERTA = 0;
+const PassoLed PISCAR_BLOQUEIO[] PROGMEM = { { LED_VERMELHO, 20 }, { 0, 20 }, FIM_PADRAO };
+
+// Saida da serial: as telas de texto saem em segundo plano, tambem
+// durante os delay() (ver yield())
+FilaSerial<256> saida(Serial);
+
+// A serial tambem recebe comandos de manutencao (o usuario so usa o
+// teclado). METRICS mostra a duracao das iteracoes do loop(), que aqui
+// depende da tela bloqueante que estiver aberta
+const unsigned long ORCAMENTO_LOOP_US = 10000;   // um passo dos padroes de LED
+MetricasLoop metricas(ORCAMENTO_LOOP_US);
+const byte TAMANHO_COMANDO_SERIAL = 24;   // cabe "USUARIO:9999:12345678"
+char comandoSerial[TAMANHO_COMANDO_SERIAL];
+byte tamanhoComandoSerial = 0;
+
+// Os comandos que mexem nos usuarios pedem antes ADMIN:<senha mestra>.
+// A sessao acaba com SAIR ou depois de 5 min sem comando de administracao
+const unsigned long DURACAO_SESSAO_ADMIN_MS = 5 * 60000UL;
+bool sessaoAdmin = false;
+unsigned long ultimoComandoAdmin = 0;
+
+// Funcoes medidas pelo perfil (comando PERFIL, ver perfil.h); os nomes
+// seguem a ordem dos ids
+const uint8_t PERFIL_PROCESSAR_TECLA = 0;
+const uint8_t PERFIL_ATUALIZAR_DISPLAY = 1;
+const uint8_t PERFIL_VERIFICAR_SENHA = 2;
+const uint8_t PERFIL_SENHA_VULNERAVEL = 3;
+const uint8_t PERFIL_SENHA_SEGURA = 4;
+const uint8_t PERFIL_ANALISAR_RESULTADO = 5;
+const uint8_t PERFIL_INFORMACOES = 6;
+const uint8_t PERFIL_ACESSO_NEGADO = 7;
+const char NOMES_PERFIL[] PROGMEM =
+  "processarTecla\0atualizarDisplay\0verificarSenha\0verificarSenhaVulneravel\0"
+  "verificarSenhaSegura\0analisarResultado\0mostrarInformacoesSistema\0acessoNegado";
+Perfil<128> perfil(NOMES_PERFIL, sizeof(NOMES_PERFIL));
+
+// Teclas e bytes da serial lidos desde o boot, com o instante (comando
+// RASTRO, ver rastro.h), para rodar a sessao de novo no host. 384 bytes
+// guardam umas 120 teclas. So existe compilado com -DRASTRO=1, e so sai
+// numa sessao de administracao
+Rastro<384> rastro;
 
 // Configuração do sistema
+// A senha em texto so serve ao modo vulneravel, que e a demonstracao;
+// o modo seguro confere o resumo com sal (ver credencial.h), gerado por
+// host/gerar_credencial.py para a mesma senha
 const String SENHA_CORRETA = "1234";
+Credencial credencial = {
+  {
+    0x5b, 0x1f, 0x0c, 0x7a, 0xe2, 0x93, 0x4d, 0x68,
+    0xa1, 0xc4, 0xe0, 0x7b, 0x3d, 0x92, 0xf6, 0x15
+  },
+  {
+    0xb4, 0x90, 0xfe, 0xa9, 0x94, 0xb5, 0x66, 0xaf,
+    0xa9, 0x78, 0x98, 0x83, 0x59, 0x75, 0x07, 0xd7,
+    0xec, 0xdc, 0x50, 0x2b, 0xe5, 0x1d, 0x25, 0x8a,
+    0x34, 0x78, 0xe0, 0x42, 0xe7, 0x10, 0x40, 0x7f
+  }
+};
+const byte TAMANHO_MAX_SENHA = 8;   // limite de adicionarDigito()
 String senhaDigitada = "";
-const int MAX_TENTATIVAS = 3;
-int tentativasRestantes = MAX_TENTATIVAS;
+
+// Usuarios com PIN proprio, cadastrados pela serial (ver
+// tabela_usuarios.h). Com a tabela vazia o modo seguro confere a
+// credencial acima; com usuarios, o teclado pede o numero do usuario e
+// depois o PIN. A tabela usa os primeiros 768 bytes da EEPROM
+const byte TAMANHO_MAX_USUARIO = 4;   // ids de 0 a 9999
+const long SEM_USUARIO = -1;
+TabelaUsuarios<0, 768> usuarios;
+long usuarioDigitado = SEM_USUARIO;   // id ja confirmado com '#'
+bool carregandoUsuarios = false;      // entre CARGA e FIM
+
+// Tentativas: 3 seguidas, uma de volta a cada 30 s. Esgotadas, o sistema
+// bloqueia por 7 s, depois 14 s, 28 s... ate 15 min, sem parar o loop()
+// (ver limite_tentativas.h). O '*' limpa a senha, mas nao devolve
+// tentativas
+const uint8_t MAX_TENTATIVAS = 3;
+const unsigned long RECARGA_TENTATIVA_MS = 30000;
+const unsigned long BLOQUEIO_BASE_MS = 7000;
+const unsigned long BLOQUEIO_MAXIMO_MS = 15 * 60000UL;
+LimiteTentativas limite(MAX_TENTATIVAS, RECARGA_TENTATIVA_MS, BLOQUEIO_BASE_MS, BLOQUEIO_MAXIMO_MS);
+bool emBloqueio = false;
+unsigned long segundosNaTela = 0;   // contagem regressiva ja desenhada
 
 // Configuração dos modos
 bool modoVulneravel = true;  // true = vulnerável, false = seguro
 bool modoAnalise = false;    // true = mostra timing no serial
 bool modoDemo = false;       // true = demonstração automática
 
-// Variáveis de timing
+// A demonstracao automatica e um cenario em bytecode (ver cenario.h),
+// executado no loop() sem bloquear. Ele digita as senhas e confere a
+// resposta na copia da saida; as tabelas ficam junto de
+// iniciarDemonstracao()
+extern const RecursosCenario RECURSOS_DEMO;
+Cenario cenario(saida, &RECURSOS_DEMO);
+
+// O que sobrevive ao reset (ver diario_eeprom.h): as tentativas e o
+// bloqueio, para desligar o aparelho nao zerar o limite, e os modos.
+// Ocupa os 256 bytes da EEPROM depois da tabela de usuarios: 32
+// registros de 8 bytes
+struct EstadoSalvo {
+  uint16_t segundosBloqueio;   // o que faltava do bloqueio (0 = livre)
+  uint8_t fichas;
+  uint8_t nivel;
+  uint8_t modos;               // MODO_SALVO_*
+  uint8_t falhas;              // senhas erradas desde a instalacao (ate 255)
+};
+const uint8_t MODO_SALVO_VULNERAVEL = 0x01;
+const uint8_t MODO_SALVO_ANALISE = 0x02;
+const unsigned long ATRASO_DIARIO_MS = 3000;   // junta trocas de modo seguidas
+DiarioEeprom<EstadoSalvo, 768, 256> diario(ATRASO_DIARIO_MS);
+uint8_t falhasTotais = 0;
+unsigned long microsRecuperacao = 0;           // duracao do recuperar() no setup()
+
+// Variáveis de timing (em microssegundos)
 unsigned long tempoInicio = 0;
 unsigned long tempoFim = 0;
 
 void setup() {
   Serial.begin(9600);
   lcd.begin(16, 2);
-  pinMode(LED_VERDE, OUTPUT);
-  pinMode(LED_VERMELHO, OUTPUT);
+  tela.iniciar();
+  leds.iniciar();
+  saida.espelhar(&cenario);
+  iniciarVarreduraTeclado(keypad);
+  perfil.iniciar();
+  rastro.iniciar();
+  usuarios.iniciar();
+  recuperarEstado();
   
   mostrarTelaInicial();
   mostrarInstrucoes();
 }
 
+// Chamada pelo delay() enquanto espera: as telas seguram o loop(), mas
+// os LEDs e a serial continuam andando
+void yield() {
+  leds.atualizar();
+  saida.bombear();
+  diario.bombear(millis());
+}
+
 void loop() {
-  char tecla = keypad.getKey();
+  metricas.marcar();
+  leds.atualizar();
+  saida.bombear();
+  diario.bombear(millis());
+  lerComandoSerial();
+  atualizarBloqueio();
+  // Varrida pelo Timer2, ver teclado_timer.h. Bloqueado, so as teclas de
+  // modo e informacao saem da fila; as outras esperam nela o fim do
+  // bloqueio e sao tratadas depois, na ordem
+  char tecla = emBloqueio ? lerTeclaSe(respondeNoBloqueio) : lerTecla();
   
   if (tecla) {
+    rastro.tecla(tecla);
     processarTecla(tecla);
   }
   
   // Modo demonstração automática
-  if (modoDemo) {
-    executarDemonstracao();
+  if (cenario.executar()) {
+    concluirDemonstracao();
   }
 }
 
+bool respondeNoBloqueio(char tecla) {
+  return tecla == 'A' || tecla == 'B' || tecla == 'C';
+}
+
 void processarTecla(char tecla) {
+  MEDIR_PERFIL(perfil, PERFIL_PROCESSAR_TECLA);
+  // Durante a demonstracao so o 'D', que a interrompe
+  if (modoDemo && tecla != 'D') {
+    return;
+  }
   switch (tecla) {
     case 'A':
       alternarModoSeguranca();
@@ -110,7 +263,7 @@ void processarTecla(char tecla) {
       break;
     case '#':
       if (senhaDigitada.length() > 0) {
-        verificarSenha();
+        confirmarSenha();
       }
       break;
     default:
@@ -122,47 +275,58 @@ void processarTecla(char tecla) {
 }
 
 void mostrarInstrucoes() {
-  Serial.println("====================================================================");
-  Serial.println("SISTEMA DE DEMONSTRACAO - TIMING ATTACKS");
-  Serial.println("====================================================================");
-  Serial.println("CONTROLES:");
-  Serial.println("A - Alternar modo (Vulneravel/Seguro)");
-  Serial.println("B - Ativar/Desativar analise de timing");
-  Serial.println("C - Mostrar informacoes do sistema");
-  Serial.println("D - Modo demonstracao automatica");
-  Serial.println("* - Reset do sistema");
-  Serial.println("# - Confirmar senha");
-  Serial.println("0-9 - Digitar senha");
-  Serial.println("====================================================================");
-  Serial.println("Senha correta: " + SENHA_CORRETA);
-  Serial.println("Modo atual: " + String(modoVulneravel ? "VULNERAVEL" : "SEGURO"));
-  Serial.println("====================================================================");
+  saida.println(MSG("===================================================================="));
+  saida.println(MSG("SISTEMA DE DEMONSTRACAO - TIMING ATTACKS"));
+  saida.println(MSG("===================================================================="));
+  saida.println(MSG("CONTROLES:"));
+  saida.println(MSG("A - Alternar modo (Vulneravel/Seguro)"));
+  saida.println(MSG("B - Ativar/Desativar analise de timing"));
+  saida.println(MSG("C - Mostrar informacoes do sistema"));
+  saida.println(MSG("D - Modo demonstracao automatica"));
+  saida.println(MSG("* - Reset do sistema"));
+  saida.println(MSG("# - Confirmar senha"));
+  saida.println(MSG("0-9 - Digitar senha"));
+  saida.println(MSG("===================================================================="));
+  saida.print(MSG("Senha correta: "));
+  saida.println(SENHA_CORRETA);
+  saida.print(MSG("Modo atual: "));
+  saida.println(modoVulneravel ? MSG("VULNERAVEL") : MSG("SEGURO"));
+  saida.println(MSG("===================================================================="));
 }
 
 void mostrarTelaInicial() {
-  lcd.clear();
-  lcd.print("SISTEMA ");
-  lcd.print(modoVulneravel ? "VULN" : "SEGURO");
-  lcd.setCursor(0, 1);
-  lcd.print("Digite senha:");
   senhaDigitada = "";
+  usuarioDigitado = SEM_USUARIO;
+  if (emBloqueio) {
+    segundosNaTela = 0;
+    mostrarTelaBloqueio(limite.restanteBloqueio(millis()));
+    return;
+  }
+  tela.limpar();
+  tela.print(MSG("SISTEMA "));
+  tela.print(modoVulneravel ? MSG("VULN") : MSG("SEGURO"));
+  tela.posicionar(0, 1);
+  tela.print(pedindoUsuario() ? MSG("Digite usuario:") : MSG("Digite senha:"));
+  tela.atualizar();
   apagarLEDs();
 }
 
 void alternarModoSeguranca() {
   modoVulneravel = !modoVulneravel;
+  salvarEstado();
   
-  lcd.clear();
-  lcd.print("MODO: ");
+  tela.limpar();
+  tela.print(MSG("MODO: "));
   if (modoVulneravel) {
-    lcd.print("VULNERAVEL");
-    Serial.println("\n>>> MODO VULNERAVEL ATIVADO <<<");
-    Serial.println("Sistema para no primeiro erro - timing variavel");
+    tela.print(MSG("VULNERAVEL"));
+    saida.println(MSG("\n>>> MODO VULNERAVEL ATIVADO <<<"));
+    saida.println(MSG("Sistema para no primeiro erro - timing variavel"));
   } else {
-    lcd.print("SEGURO");
-    Serial.println("\n>>> MODO SEGURO ATIVADO <<<");
-    Serial.println("Sistema sempre verifica toda senha - timing constante");
+    tela.print(MSG("SEGURO"));
+    saida.println(MSG("\n>>> MODO SEGURO ATIVADO <<<"));
+    saida.println(MSG("Sistema sempre verifica toda senha - timing constante"));
   }
+  tela.atualizar();
   
   delay(2000);
   mostrarTelaInicial();
@@ -170,82 +334,188 @@ void alternarModoSeguranca() {
 
 void alternarModoAnalise() {
   modoAnalise = !modoAnalise;
+  salvarEstado();
   
-  lcd.clear();
-  lcd.print("ANALISE: ");
-  lcd.print(modoAnalise ? "ON" : "OFF");
-  lcd.setCursor(0, 1);
-  lcd.print("Timing no serial");
+  tela.limpar();
+  tela.print(MSG("ANALISE: "));
+  tela.print(modoAnalise ? MSG("ON") : MSG("OFF"));
+  tela.posicionar(0, 1);
+  tela.print(MSG("Timing no serial"));
   
   if (modoAnalise) {
-    Serial.println("\n>>> MODO ANALISE ATIVADO <<<");
-    Serial.println("Timing sera exibido no Serial Monitor");
+    saida.println(MSG("\n>>> MODO ANALISE ATIVADO <<<"));
+    saida.println(MSG("Timing sera exibido no Serial Monitor"));
   } else {
-    Serial.println("\n>>> MODO ANALISE DESATIVADO <<<");
+    saida.println(MSG("\n>>> MODO ANALISE DESATIVADO <<<"));
   }
+  tela.atualizar();
   
   delay(1500);
   mostrarTelaInicial();
 }
 
 void mostrarInformacoesSistema() {
-  Serial.println("\n====== INFORMACOES DO SISTEMA ======");
-  Serial.println("Modo de seguranca: " + String(modoVulneravel ? "VULNERAVEL" : "SEGURO"));
-  Serial.println("Analise de timing: " + String(modoAnalise ? "ATIVADA" : "DESATIVADA"));
-  Serial.println("Senha correta: " + SENHA_CORRETA);
-  Serial.println("Tentativas restantes: " + String(tentativasRestantes));
-  Serial.println("Senha atual: " + senhaDigitada);
-  Serial.println("=====================================");
+  MEDIR_PERFIL(perfil, PERFIL_INFORMACOES);
+  saida.println(MSG("\n====== INFORMACOES DO SISTEMA ======"));
+  saida.print(MSG("Modo de seguranca: "));
+  saida.println(modoVulneravel ? MSG("VULNERAVEL") : MSG("SEGURO"));
+  saida.print(MSG("Analise de timing: "));
+  saida.println(modoAnalise ? MSG("ATIVADA") : MSG("DESATIVADA"));
+  saida.print(MSG("Senha correta: "));
+  saida.println(SENHA_CORRETA);
+  saida.print(MSG("Tentativas restantes: "));
+  saida.println(limite.disponiveis(millis()));
+  saida.print(MSG("Senhas erradas desde a instalacao: "));
+  saida.println(falhasTotais);
+  saida.print(MSG("EEPROM: registro "));
+  saida.print(diario.registroAtual());
+  saida.print(MSG(" de "));
+  saida.print(diario.registros());
+  saida.print(MSG(", "));
+  saida.print(diario.totalGravacoes());
+  saida.print(MSG(" gravacoes, recuperado em "));
+  saida.print(microsRecuperacao);
+  saida.println(MSG(" us"));
+  saida.print(MSG("Usuarios: "));
+  saida.print(usuarios.total());
+  saida.print(MSG("/"));
+  saida.print(usuarios.capacidade());
+  saida.print(MSG(", falhas sem usuario: "));
+  saida.println(usuarios.falhasSemUsuario());
+  if (emBloqueio) {
+    saida.print(MSG("Bloqueado por mais "));
+    saida.print((limite.restanteBloqueio(millis()) + 999) / 1000);
+    saida.println(MSG(" s"));
+  }
+  saida.print(MSG("Senha atual: "));
+  saida.println(senhaDigitada);
+  saida.print(MSG("Fila TX: pico "));
+  saida.print(saida.pico());
+  saida.print(MSG("/256 bytes, "));
+  saida.print(saida.vezesBloqueado());
+  saida.print(MSG(" esperas, "));
+  saida.print(saida.microsBloqueado() / 1000);
+  saida.println(MSG(" ms bloqueado"));
+  saida.println(MSG("====================================="));
 }
 
 void alternarModoDemo() {
   modoDemo = !modoDemo;
   
-  lcd.clear();
+  tela.limpar();
   if (modoDemo) {
-    lcd.print("MODO DEMO ON");
-    lcd.setCursor(0, 1);
-    lcd.print("Aguarde...");
-    Serial.println("\n>>> MODO DEMONSTRACAO ATIVADO <<<");
-    Serial.println("Executando testes automaticos...");
+    tela.print(MSG("MODO DEMO ON"));
+    tela.posicionar(0, 1);
+    tela.print(MSG("Aguarde..."));
+    saida.println(MSG("\n>>> MODO DEMONSTRACAO ATIVADO <<<"));
+    saida.println(MSG("Executando testes automaticos..."));
   } else {
-    lcd.print("MODO DEMO OFF");
-    Serial.println("\n>>> MODO DEMONSTRACAO DESATIVADO <<<");
+    tela.print(MSG("MODO DEMO OFF"));
+    saida.println(MSG("\n>>> MODO DEMONSTRACAO DESATIVADO <<<"));
+    cenario.parar();
   }
+  tela.atualizar();
   
   delay(1500);
   mostrarTelaInicial();
+  if (modoDemo) {
+    iniciarDemonstracao();
+  }
+}
+
+// Com usuarios cadastrados, o modo seguro pede primeiro o numero do
+// usuario e so depois o PIN
+bool pedindoUsuario() {
+  return !modoVulneravel && usuarios.total() > 0 && usuarioDigitado == SEM_USUARIO;
 }
 
 void adicionarDigito(char digito) {
-  if (senhaDigitada.length() < 8) {
+  if (senhaDigitada.length() < (pedindoUsuario() ? TAMANHO_MAX_USUARIO : TAMANHO_MAX_SENHA)) {
     senhaDigitada += digito;
     atualizarDisplay();
   }
 }
 
+// A dica fica fixa na primeira linha: cada novo digito muda so uma
+// celula, que vai para o LCD como um unico byte
 void atualizarDisplay() {
-  lcd.clear();
-  lcd.print("Senha:");
-  lcd.setCursor(0, 1);
+  MEDIR_PERFIL(perfil, PERFIL_ATUALIZAR_DISPLAY);
+  tela.limpar();
+  if (pedindoUsuario()) {
+    tela.print(MSG("Usuario: (# OK)"));
+    tela.posicionar(0, 1);
+    tela.print(senhaDigitada);
+    tela.atualizar();
+    return;
+  }
+  tela.print(MSG("Senha: (# p/ OK)"));
+  tela.posicionar(0, 1);
   
   for (int i = 0; i < senhaDigitada.length(); i++) {
-    lcd.print("*");
+    tela.print(MSG("*"));
   }
-  lcd.print(" (# p/ OK)");
+  tela.atualizar();
 }
 
-void verificarSenha() {
-  tempoInicio = millis();
-  
+// '#' no teclado: a unica verificacao que gasta tentativa. O '#' do
+// numero do usuario so guarda o id, sem gastar
+void confirmarSenha() {
+  if (pedindoUsuario()) {
+    usuarioDigitado = senhaDigitada.toInt();
+    senhaDigitada = "";
+    atualizarDisplay();
+    return;
+  }
+  if (!limite.consumir(millis())) {
+    semTentativa();
+    return;
+  }
+  gravarTentativaComoErrada();
+  bool certa = verificarSenha();
+  diario.concluir();
+  if (certa) {
+    limite.registrarSucesso();
+    salvarEstado();
+    acessoPermitido();
+    return;
+  }
+  if (falhasTotais < 255) {
+    falhasTotais++;
+  }
+  // Depois da tela de acesso negado, para o bloqueio contar inteiro
+  acessoNegado();
+  limite.registrarFalha(millis());
+  if (limite.restanteBloqueio(millis()) > 0) {
+    iniciarBloqueio();
+  }
+}
+
+// Antes da resposta a EEPROM ja tem a tentativa gasta, como se fosse
+// errada: cortar a energia ao ver "ACESSO NEGADO" nao devolve a
+// tentativa nem evita o bloqueio. A gravacao corre junto com o HMAC;
+// quem chama termina com diario.concluir()
+void gravarTentativaComoErrada() {
+  LimiteTentativas seErrar = limite;
+  seErrar.registrarFalha(millis());
+  diario.gravarAgora(estadoParaSalvar(seErrar, falhasTotais < 255 ? falhasTotais + 1 : 255));
+}
+
+// Verifica e mede; quem chama decide o que fazer com o resultado
+bool verificarSenha() {
+  MEDIR_PERFIL(perfil, PERFIL_VERIFICAR_SENHA);
   if (modoAnalise) {
-    Serial.println("\n--- ANALISE DE TIMING ---");
-    Serial.println("Modo: " + String(modoVulneravel ? "VULNERAVEL" : "SEGURO"));
-    Serial.println("Senha digitada: " + senhaDigitada);
-    Serial.println("Senha correta:  " + SENHA_CORRETA);
-    Serial.print("Verificando... ");
+    saida.println(MSG("\n--- ANALISE DE TIMING ---"));
+    saida.print(MSG("Modo: "));
+    saida.println(modoVulneravel ? MSG("VULNERAVEL") : MSG("SEGURO"));
+    saida.print(MSG("Senha digitada: "));
+    saida.println(senhaDigitada);
+    saida.print(MSG("Senha correta:  "));
+    saida.println(SENHA_CORRETA);
+    saida.print(MSG("Verificando... "));
   }
   
+  // Mede so a verificacao: o texto acima ainda pode estar saindo pela serial
+  tempoInicio = micros();
   bool senhaCorreta;
   if (modoVulneravel) {
     senhaCorreta = verificarSenhaVulneravel(senhaDigitada);
@@ -253,29 +523,23 @@ void verificarSenha() {
     senhaCorreta = verificarSenhaSegura(senhaDigitada);
   }
   
-  tempoFim = millis();
+  tempoFim = micros();
   unsigned long tempoDecorrido = tempoFim - tempoInicio;
   
   if (modoAnalise) {
-    Serial.println("Concluido!");
-    Serial.println("Tempo decorrido: " + String(tempoDecorrido) + "ms");
-    analisarResultado(tempoDecorrido);
+    saida.println(MSG("Concluido!"));
+    saida.print(MSG("Tempo decorrido: "));
+    saida.print(tempoDecorrido);
+    saida.println(MSG("us"));
+    analisarResultado(tempoDecorrido / 1000);
   }
   
-  if (senhaCorreta) {
-    acessoPermitido();
-  } else {
-    acessoNegado();
-    tentativasRestantes--;
-    
-    if (tentativasRestantes <= 0) {
-      sistemaBloquado();
-    }
-  }
+  return senhaCorreta;
 }
 
 // IMPLEMENTACAO VULNERAVEL - Para no primeiro erro
 bool verificarSenhaVulneravel(String senha) {
+  MEDIR_PERFIL(perfil, PERFIL_SENHA_VULNERAVEL);
   if (senha.length() != SENHA_CORRETA.length()) {
     delay(50);
     return false;
@@ -296,32 +560,22 @@ bool verificarSenhaVulneravel(String senha) {
 }
 
 // IMPLEMENTACAO SEGURA - Timing constante
-bool verificarSenhaSegura(String senha) {
-  bool resultado = true;
-  int maxLength = max(senha.length(), SENHA_CORRETA.length());
-  
-  // CORRECAO: Sempre verifica todas as posicoes
-  for (int i = 0; i < maxLength; i++) {
-    delay(100); // Tempo constante por posicao
-    
-    // Verifica se indices sao validos
-    if (i >= senha.length() || i >= SENHA_CORRETA.length()) {
-      resultado = false;
-      // NAO retorna aqui - continua verificando
-    } else if (senha[i] != SENHA_CORRETA[i]) {
-      resultado = false;
-      // NAO retorna aqui - continua verificando
-    }
+// A tentativa passa pelo HMAC-SHA256 com o sal da credencial e os 32
+// bytes sao comparados por inteiro, acumulando as diferencas com XOR/OR.
+// O tempo (4 compressoes do SHA-256) depende so do tamanho da tentativa,
+// e nao de quantos digitos estao certos; nao precisa de delay(). Com um
+// usuario digitado, a tabela tambem nao revela se o id existe.
+bool verificarSenhaSegura(const String &senha) {
+  MEDIR_PERFIL(perfil, PERFIL_SENHA_SEGURA);
+  if (usuarioDigitado != SEM_USUARIO) {
+    return usuarios.verificar(usuarioDigitado, senha.c_str(), senha.length());
   }
-  
-  // Adiciona delay adicional para mascarar variacoes
-  delay(100);
-  
-  return resultado;
+  return verificarCredencial(credencial, senha.c_str(), senha.length());
 }
 
 void analisarResultado(unsigned long tempo) {
-  Serial.println("--- ANALISE DA VULNERABILIDADE ---");
+  MEDIR_PERFIL(perfil, PERFIL_ANALISAR_RESULTADO);
+  saida.println(MSG("--- ANALISE DA VULNERABILIDADE ---"));
   
   if (modoVulneravel) {
     // Estima caracteres corretos baseado no timing
@@ -331,125 +585,501 @@ void analisarResultado(unsigned long tempo) {
       caracteresCorretos = SENHA_CORRETA.length();
     }
     
-    Serial.println("Caracteres corretos estimados: " + String(caracteresCorretos));
+    saida.print(MSG("Caracteres corretos estimados: "));
+    saida.println(caracteresCorretos);
     
     if (caracteresCorretos > 0 && caracteresCorretos < SENHA_CORRETA.length()) {
-      Serial.print("Prefixo descoberto: ");
+      saida.print(MSG("Prefixo descoberto: "));
       for (int i = 0; i < caracteresCorretos; i++) {
-        Serial.print(SENHA_CORRETA[i]);
+        saida.print(SENHA_CORRETA[i]);
       }
-      Serial.println();
+      saida.println();
       
-      Serial.println("VULNERABILIDADE DETECTADA:");
-      Serial.println("- Timing varia com numero de caracteres corretos");
-      Serial.println("- Atacante pode descobrir senha digito por digito");
-      Serial.println("- Cada tentativa revela informacao adicional");
+      saida.println(MSG("VULNERABILIDADE DETECTADA:"));
+      saida.println(MSG("- Timing varia com numero de caracteres corretos"));
+      saida.println(MSG("- Atacante pode descobrir senha digito por digito"));
+      saida.println(MSG("- Cada tentativa revela informacao adicional"));
     }
   } else {
-    Serial.println("Sistema seguro - timing constante");
-    Serial.println("- Tempo nao varia com entrada");
-    Serial.println("- Nenhuma informacao vazada");
-    Serial.println("- Resistente a timing attacks");
+    saida.println(MSG("Sistema seguro - timing constante"));
+    saida.println(MSG("- Tempo nao varia com entrada"));
+    saida.println(MSG("- Nenhuma informacao vazada"));
+    saida.println(MSG("- Resistente a timing attacks"));
   }
   
-  Serial.println("=====================================");
-}
-
-void executarDemonstracao() {
-  String senhasTesteVuln[] = {"0000", "1000", "1200", "1230", "1234"};
-  String senhasTesteSeguro[] = {"0000", "5555", "9999", "1234"};
-  
-  Serial.println("\n=== DEMONSTRACAO AUTOMATICA ===");
-  
-  // Teste modo vulneravel
-  if (modoVulneravel) {
-    Serial.println("Testando modo VULNERAVEL:");
-    for (int i = 0; i < 5; i++) {
-      senhaDigitada = senhasTesteVuln[i];
-      Serial.print("Testando: " + senhasTesteVuln[i] + " -> ");
-      verificarSenha();
-      delay(2000);
-      resetarSistema();
-    }
-  } else {
-    Serial.println("Testando modo SEGURO:");
-    for (int i = 0; i < 4; i++) {
-      senhaDigitada = senhasTesteSeguro[i];
-      Serial.print("Testando: " + senhasTesteSeguro[i] + " -> ");
-      verificarSenha();
-      delay(2000);
-      resetarSistema();
-    }
-  }
-  
-  modoDemo = false;
-  Serial.println("=== DEMONSTRACAO CONCLUIDA ===");
-  mostrarTelaInicial();
+  saida.println(MSG("====================================="));
 }
 
 void acessoPermitido() {
-  lcd.clear();
-  lcd.print("ACESSO PERMITIDO");
-  lcd.setCursor(0, 1);
-  lcd.print("Bem-vindo!");
+  tela.limpar();
+  tela.print(MSG("ACESSO PERMITIDO"));
+  tela.posicionar(0, 1);
+  tela.print(MSG("Bem-vindo!"));
+  tela.atualizar();
   
-  digitalWrite(LED_VERDE, HIGH);
-  digitalWrite(LED_VERMELHO, LOW);
+  leds.fixar(LED_VERMELHO, false);
+  leds.fixar(LED_VERDE, true);
   
-  Serial.println("ACESSO PERMITIDO!");
+  saida.println(MSG("ACESSO PERMITIDO!"));
   
   delay(3000);
   resetarSistema();
 }
 
 void acessoNegado() {
-  lcd.clear();
-  lcd.print("ACESSO NEGADO");
-  lcd.setCursor(0, 1);
-  lcd.print("Tent.: " + String(tentativasRestantes));
+  MEDIR_PERFIL(perfil, PERFIL_ACESSO_NEGADO);
+  tela.limpar();
+  tela.print(MSG("ACESSO NEGADO"));
+  tela.posicionar(0, 1);
+  tela.print(MSG("Tent.: "));
+  tela.print(limite.disponiveis(millis()));
+  tela.atualizar();
   
-  digitalWrite(LED_VERMELHO, HIGH);
-  digitalWrite(LED_VERDE, LOW);
+  leds.fixar(LED_VERDE, false);
+  leds.fixar(LED_VERMELHO, true);
   
-  Serial.println("ACESSO NEGADO! Tentativas restantes: " + String(tentativasRestantes));
+  saida.print(MSG("ACESSO NEGADO! Tentativas restantes: "));
+  saida.println(limite.disponiveis(millis()));
   
   delay(2000);
   apagarLEDs();
   mostrarTelaInicial();
 }
 
-void sistemaBloquado() {
-  lcd.clear();
-  lcd.print("SISTEMA BLOQUADO");
-  lcd.setCursor(0, 1);
-  lcd.print("Muitas tentativas");
-  
-  // Pisca LED vermelho
-  for (int i = 0; i < 10; i++) {
-    digitalWrite(LED_VERMELHO, HIGH);
-    delay(200);
-    digitalWrite(LED_VERMELHO, LOW);
-    delay(200);
+// O '#' chegou sem tentativa disponivel: a senha sai da memoria e da
+// tela, que mostra a contagem do bloqueio ou um aviso para esperar
+void semTentativa() {
+  if (limite.restanteBloqueio(millis()) > 0 && !emBloqueio) {
+    iniciarBloqueio();
   }
+  if (!emBloqueio) {
+    tela.limpar();
+    tela.print(MSG("SEM TENTATIVAS"));
+    tela.posicionar(0, 1);
+    tela.print(MSG("Aguarde..."));
+    tela.atualizar();
+    saida.println(MSG("Sem tentativas agora: aguarde e digite de novo"));
+    delay(1500);
+  }
+  mostrarTelaInicial();
+}
+
+// O bloqueio corre em segundo plano: atualizarBloqueio() mostra a
+// contagem e libera o sistema quando o tempo acaba
+void iniciarBloqueio() {
+  emBloqueio = true;
+  segundosNaTela = 0;
+  leds.tocar(CANAL_ALERTA, PISCAR_BLOQUEIO, REPETIR_SEMPRE);
   
-  Serial.println("SISTEMA BLOQUEADO POR SEGURANCA!");
-  
-  delay(3000);
-  resetarSistema();
+  saida.print(MSG("SISTEMA BLOQUEADO POR SEGURANCA! Espera de "));
+  saida.print(limite.duracaoUltimoBloqueio() / 1000);
+  saida.println(MSG(" s"));
+  mostrarTelaBloqueio(limite.restanteBloqueio(millis()));
+}
+
+// No loop(): redesenha so quando o segundo muda
+void atualizarBloqueio() {
+  if (!emBloqueio) {
+    return;
+  }
+  unsigned long restante = limite.restanteBloqueio(millis());
+  if (restante == 0) {
+    emBloqueio = false;
+    leds.parar(CANAL_ALERTA);
+    saida.println(MSG("Bloqueio encerrado"));
+    salvarEstado();
+    resetarSistema();
+    return;
+  }
+  mostrarTelaBloqueio(restante);
+}
+
+void mostrarTelaBloqueio(unsigned long restante) {
+  unsigned long segundos = (restante + 999) / 1000;
+  if (segundos == segundosNaTela) {
+    return;
+  }
+  segundosNaTela = segundos;
+  tela.limpar();
+  tela.print(MSG("SISTEMA BLOQUADO"));
+  tela.posicionar(0, 1);
+  tela.print(MSG("Aguarde "));
+  tela.print(segundos / 60);
+  tela.print(segundos % 60 < 10 ? MSG(":0") : MSG(":"));
+  tela.print(segundos % 60);
+  tela.atualizar();
+}
+
+// ===== ESTADO NA EEPROM =====
+
+EstadoSalvo estadoParaSalvar(LimiteTentativas &limiteSalvo, uint8_t falhas) {
+  unsigned long agora = millis();
+  EstadoSalvo estado;
+  estado.segundosBloqueio = (limiteSalvo.restanteBloqueio(agora) + 999) / 1000;
+  estado.fichas = limiteSalvo.disponiveis(agora);
+  estado.nivel = limiteSalvo.nivelBloqueio();
+  estado.modos = (modoVulneravel ? MODO_SALVO_VULNERAVEL : 0) | (modoAnalise ? MODO_SALVO_ANALISE : 0);
+  estado.falhas = falhas;
+  return estado;
+}
+
+// Grava no fundo, alguns segundos depois da ultima mudanca
+void salvarEstado() {
+  diario.agendar(estadoParaSalvar(limite, falhasTotais), millis());
+}
+
+// No setup(): um bloqueio em andamento recomeca com o tempo que faltava
+void recuperarEstado() {
+  unsigned long inicio = micros();
+  EstadoSalvo estado;
+  bool recuperado = diario.recuperar(estado);
+  microsRecuperacao = micros() - inicio;
+  if (!recuperado) {
+    return;
+  }
+  modoVulneravel = estado.modos & MODO_SALVO_VULNERAVEL;
+  modoAnalise = estado.modos & MODO_SALVO_ANALISE;
+  falhasTotais = estado.falhas;
+  limite.restaurar(estado.fichas, estado.nivel, estado.segundosBloqueio * 1000UL, millis());
+  if (estado.segundosBloqueio > 0) {
+    iniciarBloqueio();
+  }
 }
 
 void resetarSistema() {
-  tentativasRestantes = MAX_TENTATIVAS;
   senhaDigitada = "";
   apagarLEDs();
   mostrarTelaInicial();
   
   if (modoAnalise) {
-    Serial.println("Sistema resetado - Pronto para nova analise");
+    saida.println(MSG("Sistema resetado - Pronto para nova analise"));
   }
 }
 
 void apagarLEDs() {
-  digitalWrite(LED_VERDE, LOW);
-  digitalWrite(LED_VERMELHO, LOW);
-}
\ No newline at end of file
+  leds.fixar(LED_VERDE | LED_VERMELHO, false);
+}
+
+// ===== DEMONSTRACAO AUTOMATICA =====
+
+// Entrada dos cenarios: os digitos formam a senha e o '#' testa sem
+// gastar tentativa, como a demonstracao sempre fez
+void entradaDemonstracao(char c) {
+  if (c != '#') {
+    senhaDigitada += c;
+    return;
+  }
+  saida.print(MSG("Testando: "));
+  saida.print(senhaDigitada);
+  saida.print(MSG(" -> "));
+  if (verificarSenha()) {
+    acessoPermitido();
+  } else {
+    acessoNegado();
+  }
+}
+
+void acaoResetar(uint8_t) {
+  resetarSistema();
+}
+
+const uint8_t ACAO_RESETAR = 0;
+const AcaoCenario ACOES_DEMO[] PROGMEM = { acaoResetar };
+
+// Cada senha: a resposta esperada, a senha com '#' e a pausa antes do
+// reset
+const uint8_t DEMO_VULNERAVEL[] PROGMEM = {
+  LINHA_MSG("\n=== DEMONSTRACAO AUTOMATICA ==="),
+  LINHA_MSG("Testando modo VULNERAVEL:"),
+  CONFERIR_MSG("ACESSO NEGADO"), ENVIAR_MSG("0000#"), ESPERAR_MS(2000), ACAO(ACAO_RESETAR, 0),
+  CONFERIR_MSG("ACESSO NEGADO"), ENVIAR_MSG("1000#"), ESPERAR_MS(2000), ACAO(ACAO_RESETAR, 0),
+  CONFERIR_MSG("ACESSO NEGADO"), ENVIAR_MSG("1200#"), ESPERAR_MS(2000), ACAO(ACAO_RESETAR, 0),
+  CONFERIR_MSG("ACESSO NEGADO"), ENVIAR_MSG("1230#"), ESPERAR_MS(2000), ACAO(ACAO_RESETAR, 0),
+  CONFERIR_MSG("ACESSO PERMITIDO"), ENVIAR_MSG("1234#"), ESPERAR_MS(2000), ACAO(ACAO_RESETAR, 0),
+  LINHA_MSG("=== DEMONSTRACAO CONCLUIDA ==="),
+  FIM_CENARIO
+};
+
+const uint8_t DEMO_SEGURO[] PROGMEM = {
+  LINHA_MSG("\n=== DEMONSTRACAO AUTOMATICA ==="),
+  LINHA_MSG("Testando modo SEGURO:"),
+  CONFERIR_MSG("ACESSO NEGADO"), ENVIAR_MSG("0000#"), ESPERAR_MS(2000), ACAO(ACAO_RESETAR, 0),
+  CONFERIR_MSG("ACESSO NEGADO"), ENVIAR_MSG("5555#"), ESPERAR_MS(2000), ACAO(ACAO_RESETAR, 0),
+  CONFERIR_MSG("ACESSO NEGADO"), ENVIAR_MSG("9999#"), ESPERAR_MS(2000), ACAO(ACAO_RESETAR, 0),
+  CONFERIR_MSG("ACESSO PERMITIDO"), ENVIAR_MSG("1234#"), ESPERAR_MS(2000), ACAO(ACAO_RESETAR, 0),
+  LINHA_MSG("=== DEMONSTRACAO CONCLUIDA ==="),
+  FIM_CENARIO
+};
+
+const RecursosCenario RECURSOS_DEMO PROGMEM = { NULL, ACOES_DEMO, entradaDemonstracao, NULL };
+
+void iniciarDemonstracao() {
+  senhaDigitada = "";
+  cenario.iniciar(modoVulneravel ? DEMO_VULNERAVEL : DEMO_SEGURO);
+}
+
+void concluirDemonstracao() {
+  modoDemo = false;
+  saida.print(MSG("Respostas conferidas: "));
+  saida.print(cenario.totalConferencias() - cenario.conferenciasFalhas());
+  saida.print(MSG("/"));
+  saida.println(cenario.totalConferencias());
+  mostrarTelaInicial();
+}
+
+// ===== COMANDOS DA SERIAL =====
+
+// METRICS:ZERAR recomeca a contagem depois de mostrar
+void comandoMetricas(const char *argumento) {
+  metricas.imprimir(saida);
+  if (strcmp_P(argumento, PSTR("ZERAR")) == 0) {
+    metricas.zerar();
+  }
+}
+
+// Bloco binario com os eventos gravados (host/perfil_funcoes.py);
+// PERFIL:ZERAR descarta os eventos depois de mandar
+void comandoPerfil(const char *argumento) {
+  perfil.despejar(saida);
+  if (strcmp_P(argumento, PSTR("ZERAR")) == 0) {
+    perfil.zerar();
+  }
+}
+
+// Bloco binario com as teclas e os bytes da serial lidos desde o boot
+// (host/reproduzir_rastro.cc); a gravacao termina aqui
+void comandoRastro(const char *) {
+  rastro.despejar(saida);
+}
+
+// Nada muda sem entrada nova: sem texto na fila, cenario, bloqueio,
+// piscada ou registro do diario por gravar. Enquanto isso a reproducao
+// do rastro no host pula direto para a proxima entrada
+bool sistemaOcioso() {
+  return saida.pendentes() == 0 && !cenario.ativo() && !emBloqueio && !leds.tocando(CANAL_ALERTA) &&
+         diario.ocioso();
+}
+
+// ===== ADMINISTRACAO PELA SERIAL =====
+
+// Opcoes da tabela de comandos
+const uint8_t EXIGE_ADMIN = 0x01;
+
+// ADMIN:<senha mestra> gasta uma tentativa do mesmo limite do teclado,
+// com a mesma gravacao previa na EEPROM: pela serial nao da para testar
+// senhas mais depressa que pelo teclado, nem escapar do bloqueio
+void comandoAdmin(const char *senha) {
+  if (!limite.consumir(millis())) {
+    saida.print(MSG("Bloqueado por mais "));
+    saida.print((limite.restanteBloqueio(millis()) + 999) / 1000);
+    saida.println(MSG(" s"));
+    return;
+  }
+  gravarTentativaComoErrada();
+  bool certa = verificarCredencial(credencial, senha, strlen(senha));
+  diario.concluir();
+  if (certa) {
+    limite.registrarSucesso();
+    salvarEstado();
+    sessaoAdmin = true;
+    ultimoComandoAdmin = millis();
+    saida.println(MSG("Sessao de administracao aberta"));
+    return;
+  }
+  if (falhasTotais < 255) {
+    falhasTotais++;
+  }
+  sessaoAdmin = false;
+  saida.print(MSG("Senha errada. Tentativas restantes: "));
+  saida.println(limite.disponiveis(millis()));
+  limite.registrarFalha(millis());
+  if (limite.restanteBloqueio(millis()) > 0 && !emBloqueio) {
+    iniciarBloqueio();
+  }
+}
+
+void comandoSair(const char *) {
+  sessaoAdmin = false;
+  saida.println(MSG("Sessao de administracao encerrada"));
+}
+
+// Conta o prazo a partir do ultimo comando de administracao
+bool sessaoAdminAberta() {
+  if (sessaoAdmin && millis() - ultimoComandoAdmin >= DURACAO_SESSAO_ADMIN_MS) {
+    sessaoAdmin = false;
+  }
+  return sessaoAdmin;
+}
+
+// Numero do usuario no inicio do texto; retorna o que vem depois, ou
+// NULL se nao comecar com 1 a 4 digitos
+const char *lerIdUsuario(const char *texto, uint16_t &id) {
+  id = 0;
+  byte digitos = 0;
+  while (*texto >= '0' && *texto <= '9') {
+    if (++digitos > TAMANHO_MAX_USUARIO) {
+      return NULL;
+    }
+    id = id * 10 + (*texto++ - '0');
+  }
+  return digitos > 0 ? texto : NULL;
+}
+
+// "<id>:<pin>", com um PIN que o teclado consiga digitar
+bool lerUsuarioEPin(const char *texto, uint16_t &id, const char *&pin) {
+  pin = lerIdUsuario(texto, id);
+  if (pin == NULL || *pin != ':') {
+    return false;
+  }
+  pin++;
+  byte tamanho = 0;
+  while (pin[tamanho] >= '0' && pin[tamanho] <= '9') {
+    tamanho++;
+  }
+  return pin[tamanho] == '\0' && tamanho > 0 && tamanho <= TAMANHO_MAX_SENHA;
+}
+
+// USUARIO:<id>:<pin> cadastra ou troca o PIN (e destrava)
+void comandoUsuario(const char *argumento) {
+  uint16_t id;
+  const char *pin;
+  if (!lerUsuarioEPin(argumento, id, pin)) {
+    saida.println(MSG("Uso: USUARIO:<id>:<pin>"));
+  } else if (usuarios.definir(id, pin, strlen(pin))) {
+    saida.print(MSG("Usuario "));
+    saida.print(id);
+    saida.println(MSG(" cadastrado"));
+  } else {
+    saida.println(MSG("Tabela de usuarios cheia"));
+  }
+}
+
+// REMOVER, TRAVAR e LIBERAR recebem so o id
+bool lerSoId(const char *argumento, uint16_t &id) {
+  const char *fim = lerIdUsuario(argumento, id);
+  if (fim == NULL || *fim != '\0') {
+    saida.println(MSG("Informe o id do usuario, ex.: REMOVER:42"));
+    return false;
+  }
+  return true;
+}
+
+void responderUsuario(uint16_t id, bool achou) {
+  saida.print(MSG("Usuario "));
+  saida.print(id);
+  saida.println(achou ? MSG(": ok") : MSG(" nao cadastrado"));
+}
+
+void comandoRemover(const char *argumento) {
+  uint16_t id;
+  if (lerSoId(argumento, id)) {
+    responderUsuario(id, usuarios.remover(id));
+  }
+}
+
+void comandoTravar(const char *argumento) {
+  uint16_t id;
+  if (lerSoId(argumento, id)) {
+    responderUsuario(id, usuarios.travar(id, true));
+  }
+}
+
+// Tambem zera as tentativas erradas do usuario
+void comandoLiberar(const char *argumento) {
+  uint16_t id;
+  if (lerSoId(argumento, id)) {
+    responderUsuario(id, usuarios.travar(id, false));
+  }
+}
+
+// Os usuarios em ordem de id, com as tentativas erradas seguidas
+void comandoListar(const char *) {
+  saida.print(usuarios.total());
+  saida.print(MSG(" de "));
+  saida.print(usuarios.capacidade());
+  saida.println(MSG(" usuarios:"));
+  usuarios.listar(saida);
+}
+
+// CARGA troca a tabela inteira: cada linha seguinte e um "<id>:<pin>",
+// ate FIM. Cada linha recebe uma resposta; quem manda espera por ela
+// antes da proxima (host/carga_usuarios.py), ja que gravar um registro
+// leva ~40 ms de EEPROM
+void comandoCarga(const char *) {
+  carregandoUsuarios = true;
+  usuarios.iniciarCarga();
+  saida.println(MSG("Carga de usuarios: <id>:<pin> por linha, FIM no final"));
+}
+
+void carregarLinhaUsuario() {
+  if (strcmp_P(comandoSerial, PSTR("FIM")) == 0) {
+    carregandoUsuarios = false;
+    saida.print(usuarios.concluirCarga());
+    saida.println(MSG(" usuarios carregados"));
+    return;
+  }
+  uint16_t id;
+  const char *pin;
+  if (!lerUsuarioEPin(comandoSerial, id, pin)) {
+    saida.print(MSG("erro: "));
+    saida.println(comandoSerial);
+  } else if (!usuarios.acrescentar(id, pin, strlen(pin))) {
+    saida.println(MSG("erro: tabela cheia"));
+  } else {
+    saida.println(MSG("ok"));
+  }
+}
+
+constexpr Comando COMANDOS_SERIAL[] PROGMEM = {
+  { "METRICS", comandoMetricas, 0 },
+  { "PERFIL",  comandoPerfil,   0 },
+  { "RASTRO",  comandoRastro,   EXIGE_ADMIN | COMANDO_SEM_ARGUMENTO },
+  { "ADMIN",   comandoAdmin,    COMANDO_EXIGE_ARGUMENTO },
+  { "SAIR",    comandoSair,     COMANDO_SEM_ARGUMENTO },
+  { "USUARIO", comandoUsuario,  EXIGE_ADMIN | COMANDO_EXIGE_ARGUMENTO },
+  { "REMOVER", comandoRemover,  EXIGE_ADMIN | COMANDO_EXIGE_ARGUMENTO },
+  { "TRAVAR",  comandoTravar,   EXIGE_ADMIN | COMANDO_EXIGE_ARGUMENTO },
+  { "LIBERAR", comandoLiberar,  EXIGE_ADMIN | COMANDO_EXIGE_ARGUMENTO },
+  { "LISTAR",  comandoListar,   EXIGE_ADMIN | COMANDO_SEM_ARGUMENTO },
+  { "CARGA",   comandoCarga,    EXIGE_ADMIN | COMANDO_SEM_ARGUMENTO },
+};
+constexpr IndiceComandos INDICE_COMANDOS_SERIAL PROGMEM = GERAR_INDICE_COMANDOS(COMANDOS_SERIAL);
+
+// Junta os bytes da serial ate o fim de linha, sem esperar pelos que
+// ainda nao chegaram; o excesso de uma linha longa e descartado
+void lerComandoSerial() {
+  while (Serial.available()) {
+    char c = Serial.read();
+    rastro.serial(c);
+    if (c == '\n' || c == '\r') {
+      comandoSerial[tamanhoComandoSerial] = '\0';
+      if (tamanhoComandoSerial > 0 && carregandoUsuarios) {
+        carregarLinhaUsuario();
+      } else if (tamanhoComandoSerial > 0) {
+        executarComandoSerial();
+      }
+      tamanhoComandoSerial = 0;
+    } else if (tamanhoComandoSerial < TAMANHO_COMANDO_SERIAL - 1) {
+      comandoSerial[tamanhoComandoSerial++] = c;
+    }
+  }
+}
+
+void executarComandoSerial() {
+  char *argumento;
+  const Comando *comando = buscarComando(COMANDOS_SERIAL, INDICE_COMANDOS_SERIAL, comandoSerial, &argumento);
+  if (comando == NULL) {
+    saida.println(MSG("Comandos da serial: METRICS, METRICS:ZERAR, PERFIL, PERFIL:ZERAR"));
+    saida.println(MSG("Depois de ADMIN:<senha>: USUARIO:<id>:<pin>, REMOVER:<id>, TRAVAR:<id>,"));
+    saida.println(MSG("LIBERAR:<id>, LISTAR, CARGA, RASTRO; SAIR encerra a sessao"));
+    return;
+  }
+  if (opcoesDoComando(comando) & EXIGE_ADMIN) {
+    if (!sessaoAdminAberta()) {
+      saida.println(MSG("Comando de administracao: mande antes ADMIN:<senha>"));
+      return;
+    }
+    ultimoComandoAdmin = millis();
+  }
+  funcaoDoComando(comando)(argumento);
+}
@@ -26,9 +26,19 @@ Montagem:
 
 #include <Keypad.h>
 #include <LiquidCrystal.h>
+#include "tela_lcd.h"
+#include "teclado_timer.h"
+#include "padroes_led.h"
+#include "fila_serial.h"
+#include "tabela_comandos.h"
+#include "metricas_loop.h"
+#include "limite_tentativas.h"
+#include "diario_eeprom.h"
+#include "catalogo_projeto_2-timing_attack.h"
 
 // Configuração do LCD (RS, EN, D4, D5, D6, D7)
 LiquidCrystal lcd(A0, A1, A2, A3, A4, A5);
+TelaLcd tela(lcd);  // so envia ao LCD as celulas que mudaram
 
 // Configuração do Keypad 4x4
 const byte ROWS = 4;
@@ -44,55 +54,118 @@ byte colPins[COLS] = {6, 7, 8, 9};
 Keypad keypad = Keypad(makeKeymap(keys), rowPins, colPins, ROWS, COLS);
 
 // Configuração dos LEDs
-const int LED_VERDE = 12;  // Acesso permitido
-const int LED_VERMELHO = 13; // Acesso negado
+typedef GrupoPinos<12, 13> PinosLeds;  // verde, vermelho (PORTB)
+const uint8_t LED_VERDE = 1 << 0;  // Acesso permitido
+const uint8_t LED_VERMELHO = 1 << 1; // Acesso negado
+PadroesLed<PinosLeds> leds;
+const uint8_t CANAL_ALERTA = 0;
+const PassoLed PISCAR_BLOQUEIO[] PROGMEM = { { LED_VERMELHO, 20 }, { 0, 20 }, FIM_PADRAO };
+
+// Saida da serial: as telas de texto saem em segundo plano, tambem
+// durante os delay() (ver yield())
+FilaSerial<256> saida(Serial);
+
+// A serial tambem recebe comandos de manutencao (o usuario so usa o
+// teclado). METRICS mostra a duracao das iteracoes do loop(), que aqui
+// depende da tela bloqueante que estiver aberta
+const unsigned long ORCAMENTO_LOOP_US = 10000;   // um passo dos padroes de LED
+MetricasLoop metricas(ORCAMENTO_LOOP_US);
+const byte TAMANHO_COMANDO_SERIAL = 16;
+char comandoSerial[TAMANHO_COMANDO_SERIAL];
+byte tamanhoComandoSerial = 0;
 
 // Configuração da senha
 const String SENHA_CORRETA = "1234";  // Senha do sistema
 String senhaDigitada = "";
-const int MAX_TENTATIVAS = 3;
-int tentativasRestantes = MAX_TENTATIVAS;
+
+// Tentativas: 3 seguidas, uma de volta a cada 30 s. Esgotadas, o sistema
+// bloqueia por 7 s, depois 14 s, 28 s... ate 15 min, sem parar o loop()
+// (ver limite_tentativas.h). O '*' limpa a senha, mas nao devolve
+// tentativas
+const uint8_t MAX_TENTATIVAS = 3;
+const unsigned long RECARGA_TENTATIVA_MS = 30000;
+const unsigned long BLOQUEIO_BASE_MS = 7000;
+const unsigned long BLOQUEIO_MAXIMO_MS = 15 * 60000UL;
+LimiteTentativas limite(MAX_TENTATIVAS, RECARGA_TENTATIVA_MS, BLOQUEIO_BASE_MS, BLOQUEIO_MAXIMO_MS);
+bool emBloqueio = false;
+unsigned long segundosNaTela = 0;   // contagem regressiva ja desenhada
 
 // Variáveis para análise de timing
 unsigned long tempoInicio = 0;
 unsigned long tempoFim = 0;
 bool modoAnalise = false;
 
+// O que sobrevive ao reset (ver diario_eeprom.h): as tentativas e o
+// bloqueio, para desligar o aparelho nao zerar o limite, e o modo de
+// analise. Mesmo formato e lugar do projeto_2-timing_attack-corrigido
+struct EstadoSalvo {
+  uint16_t segundosBloqueio;   // o que faltava do bloqueio (0 = livre)
+  uint8_t fichas;
+  uint8_t nivel;
+  uint8_t modos;               // MODO_SALVO_*
+  uint8_t falhas;              // senhas erradas desde a instalacao (ate 255)
+};
+const uint8_t MODO_SALVO_ANALISE = 0x02;
+const unsigned long ATRASO_DIARIO_MS = 3000;   // junta trocas de modo seguidas
+DiarioEeprom<EstadoSalvo, 768, 256> diario(ATRASO_DIARIO_MS);
+uint8_t falhasTotais = 0;
+
 void setup() {
   // Inicialização
   Serial.begin(9600);
   lcd.begin(16, 2);
-  pinMode(LED_VERDE, OUTPUT);
-  pinMode(LED_VERMELHO, OUTPUT);
+  tela.iniciar();
+  leds.iniciar();
+  iniciarVarreduraTeclado(keypad);
+  recuperarEstado();
   
   // Tela inicial
   mostrarTelaInicial();
   
-  Serial.println("====================================");
-  Serial.println("SISTEMA DE SENHA - TIMING ATTACK DEMO");
-  Serial.println("====================================");
-  Serial.println("Senha correta: " + SENHA_CORRETA);
-  Serial.println("Modo de análise ativado!");
-  Serial.println("Pressione 'D' para modo de ataque");
-  Serial.println("====================================");
+  saida.println(MSG("===================================="));
+  saida.println(MSG("SISTEMA DE SENHA - TIMING ATTACK DEMO"));
+  saida.println(MSG("===================================="));
+  saida.print(MSG("Senha correta: "));
+  saida.println(SENHA_CORRETA);
+  saida.println(MSG("Modo de análise ativado!"));
+  saida.println(MSG("Pressione 'D' para modo de ataque"));
+  saida.println(MSG("===================================="));
+}
+
+// Chamada pelo delay() enquanto espera: as telas seguram o loop(), mas
+// os LEDs e a serial continuam andando
+void yield() {
+  leds.atualizar();
+  saida.bombear();
+  diario.bombear(millis());
 }
 
 void loop() {
-  char tecla = keypad.getKey();
+  metricas.marcar();
+  leds.atualizar();
+  saida.bombear();
+  diario.bombear(millis());
+  lerComandoSerial();
+  atualizarBloqueio();
+  // Varrida pelo Timer2, ver teclado_timer.h. Bloqueado, so o 'D' sai da
+  // fila; as outras teclas esperam nela o fim do bloqueio
+  char tecla = emBloqueio ? lerTeclaSe(respondeNoBloqueio) : lerTecla();
   
   if (tecla) {
     // Modo especial de análise - ativado pela tecla 'D'
     if (tecla == 'D') {
       modoAnalise = !modoAnalise;
+      salvarEstado();
       if (modoAnalise) {
-        lcd.clear();
-        lcd.print("MODO ANALISE ON");
-        lcd.setCursor(0, 1);
-        lcd.print("Timing visivel");
-        Serial.println("\n>>> MODO ANÁLISE ATIVADO <<<");
+        tela.limpar();
+        tela.print(MSG("MODO ANALISE ON"));
+        tela.posicionar(0, 1);
+        tela.print(MSG("Timing visivel"));
+        tela.atualizar();
+        saida.println(MSG("\n>>> MODO ANÁLISE ATIVADO <<<"));
       } else {
         mostrarTelaInicial();
-        Serial.println("\n>>> MODO NORMAL <<<");
+        saida.println(MSG("\n>>> MODO NORMAL <<<"));
       }
       delay(1500);
       mostrarTelaInicial();
@@ -123,26 +196,37 @@ void loop() {
   }
 }
 
+bool respondeNoBloqueio(char tecla) {
+  return tecla == 'D';
+}
+
 void mostrarTelaInicial() {
-  lcd.clear();
-  lcd.print("SISTEMA SEGURO");
-  lcd.setCursor(0, 1);
-  lcd.print("Digite senha:");
   senhaDigitada = "";
-  digitalWrite(LED_VERDE, LOW);
-  digitalWrite(LED_VERMELHO, LOW);
+  if (emBloqueio) {
+    segundosNaTela = 0;
+    mostrarTelaBloqueio(limite.restanteBloqueio(millis()));
+    return;
+  }
+  tela.limpar();
+  tela.print(MSG("SISTEMA SEGURO"));
+  tela.posicionar(0, 1);
+  tela.print(MSG("Digite senha:"));
+  tela.atualizar();
+  leds.fixar(LED_VERDE | LED_VERMELHO, false);
 }
 
+// A dica fica fixa na primeira linha: cada novo digito muda so uma
+// celula, que vai para o LCD como um unico byte
 void atualizarDisplay() {
-  lcd.clear();
-  lcd.print("Senha:");
-  lcd.setCursor(0, 1);
+  tela.limpar();
+  tela.print(MSG("Senha: (# p/ OK)"));
+  tela.posicionar(0, 1);
   
   // Mostra asteriscos para a senha
   for (int i = 0; i < senhaDigitada.length(); i++) {
-    lcd.print("*");
+    tela.print(MSG("*"));
   }
-  lcd.print(" (# p/ OK)");
+  tela.atualizar();
 }
 
 // FUNÇÃO VULNERÁVEL - Implementação com timing attack
@@ -170,14 +254,27 @@ bool verificarSenhaVulneravel(String senha) {
 }
 
 void verificarSenha() {
+  if (!limite.consumir(millis())) {
+    semTentativa();
+    return;
+  }
+  // A tentativa vai para a EEPROM como errada antes da resposta: cortar a
+  // energia depois nao a devolve nem evita o bloqueio. Os bytes saem
+  // durante os delay() da verificacao (yield())
+  LimiteTentativas seErrar = limite;
+  seErrar.registrarFalha(millis());
+  diario.gravarAgora(estadoParaSalvar(seErrar, falhasTotais < 255 ? falhasTotais + 1 : 255));
+  
   // Registra tempo de início
   tempoInicio = millis();
   
   if (modoAnalise) {
-    Serial.println("\n--- ANÁLISE DE TIMING ---");
-    Serial.println("Senha digitada: " + senhaDigitada);
-    Serial.println("Senha correta:  " + SENHA_CORRETA);
-    Serial.print("Iniciando verificação... ");
+    saida.println(MSG("\n--- ANÁLISE DE TIMING ---"));
+    saida.print(MSG("Senha digitada: "));
+    saida.println(senhaDigitada);
+    saida.print(MSG("Senha correta:  "));
+    saida.println(SENHA_CORRETA);
+    saida.print(MSG("Iniciando verificação... "));
   }
   
   // Chama função vulnerável
@@ -186,29 +283,37 @@ void verificarSenha() {
   // Registra tempo final
   tempoFim = millis();
   unsigned long tempoDecorrido = tempoFim - tempoInicio;
+  diario.concluir();
   
   if (modoAnalise) {
-    Serial.println("Concluído!");
-    Serial.println("Tempo decorrido: " + String(tempoDecorrido) + "ms");
+    saida.println(MSG("Concluído!"));
+    saida.print(MSG("Tempo decorrido: "));
+    saida.print(tempoDecorrido);
+    saida.println(MSG("ms"));
     
     // Análise da vulnerabilidade
     analisarTiming(tempoDecorrido);
   }
   
   if (senhaCorreta) {
+    limite.registrarSucesso();
+    salvarEstado();
     acessoPermitido();
   } else {
+    if (falhasTotais < 255) {
+      falhasTotais++;
+    }
     acessoNegado();
-    tentativasRestantes--;
+    limite.registrarFalha(millis());
     
-    if (tentativasRestantes <= 0) {
-      sistemaBloquado();
+    if (limite.restanteBloqueio(millis()) > 0) {
+      iniciarBloqueio();
     }
   }
 }
 
 void analisarTiming(unsigned long tempo) {
-  Serial.println("--- ANÁLISE DA VULNERABILIDADE ---");
+  saida.println(MSG("--- ANÁLISE DA VULNERABILIDADE ---"));
   
   // Calcula quantos caracteres provavelmente estavam corretos
   // baseado no tempo (cada caractere = ~100ms + overhead)
@@ -218,82 +323,203 @@ void analisarTiming(unsigned long tempo) {
     caracteresCorretos = SENHA_CORRETA.length();
   }
   
-  Serial.println("Caracteres corretos estimados: " + String(caracteresCorretos));
+  saida.print(MSG("Caracteres corretos estimados: "));
+  saida.println(caracteresCorretos);
   
   if (caracteresCorretos > 0) {
-    Serial.print("Prefixo descoberto: ");
+    saida.print(MSG("Prefixo descoberto: "));
     for (int i = 0; i < caracteresCorretos; i++) {
-      Serial.print(SENHA_CORRETA[i]);
+      saida.print(SENHA_CORRETA[i]);
     }
-    Serial.println();
+    saida.println();
   }
   
-  Serial.println("VULNERABILIDADE DETECTADA:");
-  Serial.println("- Sistema para no primeiro erro");
-  Serial.println("- Timing revela progresso da verificação");
-  Serial.println("- Ataque pode descobrir senha digit por digit");
-  Serial.println("=====================================\n");
+  saida.println(MSG("VULNERABILIDADE DETECTADA:"));
+  saida.println(MSG("- Sistema para no primeiro erro"));
+  saida.println(MSG("- Timing revela progresso da verificação"));
+  saida.println(MSG("- Ataque pode descobrir senha digit por digit"));
+  saida.println(MSG("=====================================\n"));
 }
 
 void acessoPermitido() {
-  lcd.clear();
-  lcd.print("ACESSO PERMITIDO");
-  lcd.setCursor(0, 1);
-  lcd.print("Bem-vindo!");
+  tela.limpar();
+  tela.print(MSG("ACESSO PERMITIDO"));
+  tela.posicionar(0, 1);
+  tela.print(MSG("Bem-vindo!"));
+  tela.atualizar();
   
-  digitalWrite(LED_VERDE, HIGH);
-  digitalWrite(LED_VERMELHO, LOW);
+  leds.fixar(LED_VERMELHO, false);
+  leds.fixar(LED_VERDE, true);
   
-  Serial.println("ACESSO PERMITIDO!");
+  saida.println(MSG("ACESSO PERMITIDO!"));
   
   delay(3000);
   resetarSistema();
 }
 
 void acessoNegado() {
-  lcd.clear();
-  lcd.print("ACESSO NEGADO");
-  lcd.setCursor(0, 1);
-  lcd.print("Tent.:" + String(tentativasRestantes));
+  tela.limpar();
+  tela.print(MSG("ACESSO NEGADO"));
+  tela.posicionar(0, 1);
+  tela.print(MSG("Tent.:"));
+  tela.print(limite.disponiveis(millis()));
+  tela.atualizar();
   
-  digitalWrite(LED_VERMELHO, HIGH);
-  digitalWrite(LED_VERDE, LOW);
+  leds.fixar(LED_VERDE, false);
+  leds.fixar(LED_VERMELHO, true);
   
-  Serial.println("ACESSO NEGADO! Tentativas restantes: " + String(tentativasRestantes));
+  saida.print(MSG("ACESSO NEGADO! Tentativas restantes: "));
+  saida.println(limite.disponiveis(millis()));
   
   delay(2000);
-  digitalWrite(LED_VERMELHO, LOW);
+  leds.fixar(LED_VERMELHO, false);
   mostrarTelaInicial();
 }
 
-void sistemaBloquado() {
-  lcd.clear();
-  lcd.print("SISTEMA BLOQUADO");
-  lcd.setCursor(0, 1);
-  lcd.print("Muitas tentativas");
-  
-  // Pisca LED vermelho
-  for (int i = 0; i < 10; i++) {
-    digitalWrite(LED_VERMELHO, HIGH);
-    delay(200);
-    digitalWrite(LED_VERMELHO, LOW);
-    delay(200);
+// O '#' chegou sem tentativa disponivel: a senha sai da memoria e da
+// tela, que mostra a contagem do bloqueio ou um aviso para esperar
+void semTentativa() {
+  if (limite.restanteBloqueio(millis()) > 0 && !emBloqueio) {
+    iniciarBloqueio();
   }
+  if (!emBloqueio) {
+    tela.limpar();
+    tela.print(MSG("SEM TENTATIVAS"));
+    tela.posicionar(0, 1);
+    tela.print(MSG("Aguarde..."));
+    tela.atualizar();
+    saida.println(MSG("Sem tentativas agora: aguarde e digite de novo"));
+    delay(1500);
+  }
+  mostrarTelaInicial();
+}
+
+// O bloqueio corre em segundo plano: atualizarBloqueio() mostra a
+// contagem e libera o sistema quando o tempo acaba
+void iniciarBloqueio() {
+  emBloqueio = true;
+  segundosNaTela = 0;
+  leds.tocar(CANAL_ALERTA, PISCAR_BLOQUEIO, REPETIR_SEMPRE);
   
-  Serial.println("SISTEMA BLOQUEADO POR SEGURANÇA!");
-  
-  delay(3000);
-  resetarSistema();
+  saida.print(MSG("SISTEMA BLOQUEADO POR SEGURANÇA! Espera de "));
+  saida.print(limite.duracaoUltimoBloqueio() / 1000);
+  saida.println(MSG(" s"));
+  mostrarTelaBloqueio(limite.restanteBloqueio(millis()));
+}
+
+// No loop(): redesenha so quando o segundo muda
+void atualizarBloqueio() {
+  if (!emBloqueio) {
+    return;
+  }
+  unsigned long restante = limite.restanteBloqueio(millis());
+  if (restante == 0) {
+    emBloqueio = false;
+    leds.parar(CANAL_ALERTA);
+    saida.println(MSG("Bloqueio encerrado"));
+    salvarEstado();
+    resetarSistema();
+    return;
+  }
+  mostrarTelaBloqueio(restante);
+}
+
+void mostrarTelaBloqueio(unsigned long restante) {
+  unsigned long segundos = (restante + 999) / 1000;
+  if (segundos == segundosNaTela) {
+    return;
+  }
+  segundosNaTela = segundos;
+  tela.limpar();
+  tela.print(MSG("SISTEMA BLOQUADO"));
+  tela.posicionar(0, 1);
+  tela.print(MSG("Aguarde "));
+  tela.print(segundos / 60);
+  tela.print(segundos % 60 < 10 ? MSG(":0") : MSG(":"));
+  tela.print(segundos % 60);
+  tela.atualizar();
+}
+
+// ===== ESTADO NA EEPROM =====
+
+EstadoSalvo estadoParaSalvar(LimiteTentativas &limiteSalvo, uint8_t falhas) {
+  unsigned long agora = millis();
+  EstadoSalvo estado;
+  estado.segundosBloqueio = (limiteSalvo.restanteBloqueio(agora) + 999) / 1000;
+  estado.fichas = limiteSalvo.disponiveis(agora);
+  estado.nivel = limiteSalvo.nivelBloqueio();
+  estado.modos = modoAnalise ? MODO_SALVO_ANALISE : 0;
+  estado.falhas = falhas;
+  return estado;
+}
+
+// Grava no fundo, alguns segundos depois da ultima mudanca
+void salvarEstado() {
+  diario.agendar(estadoParaSalvar(limite, falhasTotais), millis());
+}
+
+// No setup(): um bloqueio em andamento recomeca com o tempo que faltava
+void recuperarEstado() {
+  EstadoSalvo estado;
+  if (!diario.recuperar(estado)) {
+    return;
+  }
+  modoAnalise = estado.modos & MODO_SALVO_ANALISE;
+  falhasTotais = estado.falhas;
+  limite.restaurar(estado.fichas, estado.nivel, estado.segundosBloqueio * 1000UL, millis());
+  if (estado.segundosBloqueio > 0) {
+    iniciarBloqueio();
+  }
 }
 
 void resetarSistema() {
-  tentativasRestantes = MAX_TENTATIVAS;
   senhaDigitada = "";
-  digitalWrite(LED_VERDE, LOW);
-  digitalWrite(LED_VERMELHO, LOW);
+  leds.fixar(LED_VERDE | LED_VERMELHO, false);
   mostrarTelaInicial();
   
   if (modoAnalise) {
-    Serial.println("\n>>> Sistema resetado - Pronto para nova análise <<<");
+    saida.println(MSG("\n>>> Sistema resetado - Pronto para nova análise <<<"));
+  }
+}
+
+// ===== COMANDOS DA SERIAL =====
+
+// METRICS:ZERAR recomeca a contagem depois de mostrar
+void comandoMetricas(const char *argumento) {
+  metricas.imprimir(saida);
+  if (strcmp_P(argumento, PSTR("ZERAR")) == 0) {
+    metricas.zerar();
   }
-}
\ No newline at end of file
+}
+
+constexpr Comando COMANDOS_SERIAL[] PROGMEM = {
+  { "METRICS", comandoMetricas, 0 },
+};
+constexpr IndiceComandos INDICE_COMANDOS_SERIAL PROGMEM = GERAR_INDICE_COMANDOS(COMANDOS_SERIAL);
+
+// Junta os bytes da serial ate o fim de linha, sem esperar pelos que
+// ainda nao chegaram; o excesso de uma linha longa e descartado
+void lerComandoSerial() {
+  while (Serial.available()) {
+    char c = Serial.read();
+    if (c == '\n' || c == '\r') {
+      comandoSerial[tamanhoComandoSerial] = '\0';
+      if (tamanhoComandoSerial > 0) {
+        executarComandoSerial();
+      }
+      tamanhoComandoSerial = 0;
+    } else if (tamanhoComandoSerial < TAMANHO_COMANDO_SERIAL - 1) {
+      comandoSerial[tamanhoComandoSerial++] = c;
+    }
+  }
+}
+
+void executarComandoSerial() {
+  char *argumento;
+  const Comando *comando = buscarComando(COMANDOS_SERIAL, INDICE_COMANDOS_SERIAL, comandoSerial, &argumento);
+  if (comando != NULL) {
+    funcaoDoComando(comando)(argumento);
+  } else {
+    saida.println(MSG("Comandos da serial: METRICS, METRICS:ZERAR"));
+  }
+}
@@ -0,0 +1,110 @@
+// Protocolo binario da serial
+//
+// Cada pacote e [opcode][dados...][CRC16 little-endian], codificado em
+// COBS (nenhum byte 0x00 no meio) e terminado por 0x00. Respostas usam o
+// opcode do pedido com o bit 0x80 ligado; erros usam OP_ERRO + codigo.
+// Numeros vao em little-endian.
+//
+//   pedido                 resposta
+//   OP_AUTH   senha        OP_AUTH|80   ok(1)
+//   OP_LED_ON              OP_LED_ON|80  led(1)
+//   OP_LED_OFF             OP_LED_OFF|80 led(1)
+//   OP_STATUS              OP_STATUS|80  led(1) autenticado(1) uptime_ms(4)
+//   OP_TEXTO               OP_TEXTO|80   (volta ao modo texto)
+#ifndef PROTOCOLO_BINARIO_H
+#define PROTOCOLO_BINARIO_H
+
+#include <Arduino.h>
+#include <util/crc16.h>
+
+const uint8_t DELIMITADOR_QUADRO = 0x00;
+const uint8_t TAMANHO_MAX_PACOTE = 24;   // opcode + dados, sem CRC
+// Pacote + CRC + 1 byte de overhead do COBS
+const uint8_t TAMANHO_MAX_QUADRO = TAMANHO_MAX_PACOTE + 2 + 1;
+
+const uint8_t OP_AUTH = 0x01;
+const uint8_t OP_LED_ON = 0x02;
+const uint8_t OP_LED_OFF = 0x03;
+const uint8_t OP_STATUS = 0x04;
+const uint8_t OP_TEXTO = 0x05;
+const uint8_t OP_RESPOSTA = 0x80;
+const uint8_t OP_ERRO = 0xFF;
+
+const uint8_t ERRO_CRC = 0x01;
+const uint8_t ERRO_QUADRO = 0x02;
+const uint8_t ERRO_OPCODE = 0x03;
+const uint8_t ERRO_AUTENTICACAO = 0x04;
+
+// CRC-CCITT do avr-libc com valor inicial 0xFFFF
+inline uint16_t crcPacote(const uint8_t *dados, uint8_t tamanho) {
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < tamanho; i++) {
+    crc = _crc_ccitt_update(crc, dados[i]);
+  }
+  return crc;
+}
+
+// Codifica em COBS (sem o delimitador final). 'saida' precisa de
+// tamanho + 1 bytes para pacotes de ate 254 bytes.
+inline uint8_t codificarCobs(const uint8_t *entrada, uint8_t tamanho, uint8_t *saida) {
+  uint8_t posCodigo = 0;
+  uint8_t codigo = 1;
+  uint8_t n = 1;
+  for (uint8_t i = 0; i < tamanho; i++) {
+    if (entrada[i] == 0) {
+      saida[posCodigo] = codigo;
+      posCodigo = n++;
+      codigo = 1;
+    } else {
+      saida[n++] = entrada[i];
+      codigo++;
+    }
+  }
+  saida[posCodigo] = codigo;
+  return n;
+}
+
+// Decodifica COBS no proprio buffer. Retorna o tamanho decodificado ou
+// 0 se o quadro estiver malformado.
+inline uint8_t decodificarCobs(uint8_t *dados, uint8_t tamanho) {
+  uint8_t lido = 0;
+  uint8_t escrito = 0;
+  while (lido < tamanho) {
+    uint8_t codigo = dados[lido++];
+    if (codigo == 0 || lido + codigo - 1 > tamanho) {
+      return 0;
+    }
+    for (uint8_t i = 1; i < codigo; i++) {
+      dados[escrito++] = dados[lido++];
+    }
+    if (codigo < 0xFF && lido < tamanho) {
+      dados[escrito++] = 0;
+    }
+  }
+  return escrito;
+}
+
+// Acrescenta o CRC ao pacote e codifica. 'pacote' precisa de 2 bytes
+// livres depois dos dados; 'saida' de TAMANHO_MAX_QUADRO bytes.
+inline uint8_t montarQuadro(uint8_t *pacote, uint8_t tamanho, uint8_t *saida) {
+  uint16_t crc = crcPacote(pacote, tamanho);
+  pacote[tamanho] = (uint8_t)crc;
+  pacote[tamanho + 1] = (uint8_t)(crc >> 8);
+  return codificarCobs(pacote, tamanho + 2, saida);
+}
+
+// Decodifica o quadro recebido e confere o CRC. Retorna o tamanho do
+// pacote (opcode + dados) ou 0 se o quadro for invalido.
+inline uint8_t abrirQuadro(uint8_t *quadro, uint8_t tamanho) {
+  uint8_t n = decodificarCobs(quadro, tamanho);
+  if (n < 3) {
+    return 0;
+  }
+  uint16_t crc = quadro[n - 2] | ((uint16_t)quadro[n - 1] << 8);
+  if (crcPacote(quadro, n - 2) != crc) {
+    return 0;
+  }
+  return n - 2;
+}
+
+#endif
@@ -0,0 +1,221 @@
+// Rastro da entrada: cada byte que o sketch le da serial e cada tecla
+// que ele tira da fila, com o instante em ms, gravados desde o boot num
+// buffer em RAM. No host, a mesma sessao roda de novo com as mesmas
+// entradas nos mesmos instantes e a saida e comparada com a gravada.
+//
+// Grava no ponto em que o sketch consome a entrada, e nao na chegada:
+// uma tecla que esperou na fila durante uma tela bloqueante entra com o
+// instante em que o loop() a leu, que e o que decide o que o sketch faz.
+//
+// Cada evento e um varint (7 bits por byte, os mais baixos primeiro, bit
+// 7 = continua) com (ms desde o evento anterior) * 2 + tipo, seguido do
+// byte lido: 2 bytes por byte de uma linha da serial, 3 por tecla
+// digitada com calma. Sem espaco, a gravacao para e so conta os
+// perdidos; a reproducao vai ate o primeiro que nao coube.
+//
+// despejar() encerra a gravacao e manda o buffer pela serial:
+//
+//   "RASTRO <tamanho>\r\n", depois <tamanho> bytes:
+//     'R' 'S' versao(1) opcoes(1) crc_eeprom(2) duracao_ms(4) eventos(2)
+//     perdidos(2) eventos
+//   e o CRC-CCITT (2) desses bytes, e "\r\n"
+//
+// Numeros em little-endian. crc_eeprom e o CRC da EEPROM no boot: a
+// reproducao tem que comecar da mesma imagem. duracao_ms e o instante do
+// despejo (ou do primeiro evento perdido). despejar() e chamado pelo
+// comando da serial que pede o rastro, entao a linha desse comando (e o
+// que chegou do teclado enquanto ela chegava) sai do rastro: o sketch
+// reproduzido nao o executa. host/build/reproduzir_rastro le a captura
+// da serial com o despejo no fim.
+//
+// O rastro guarda os PINs digitados, entao so existe com RASTRO definido
+// como 1 antes do include (ou -DRASTRO=1); sem isso a gravacao some e o
+// buffer nao ocupa RAM. Mesmo assim, os digitos (do teclado e da serial)
+// sao gravados como '0', e as opcoes do cabecalho nao tem
+// RASTRO_COM_DIGITOS: a reproducao segue o roteiro, mas nao as senhas.
+// So uma compilacao de depuracao, como a do host, define RASTRO_DIGITOS
+// como 1 para gravar os digitos de verdade.
+//
+//   Rastro<384> rastro;
+//   rastro.iniciar();                  // no setup(), antes de gravar na EEPROM
+//   rastro.serial(c);                  // a cada Serial.read()
+//   rastro.tecla(tecla);               // a cada lerTecla() com tecla
+//   rastro.despejar(Serial);
+#ifndef RASTRO_H
+#define RASTRO_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <util/crc16.h>
+
+#ifndef RASTRO
+#define RASTRO 0
+#endif
+#ifndef RASTRO_DIGITOS
+#define RASTRO_DIGITOS 0
+#endif
+
+const uint8_t VERSAO_RASTRO = 2;
+const uint8_t RASTRO_COM_DIGITOS = 0x01;      // opcoes: digitos gravados como lidos
+const uint8_t TIPO_RASTRO_SERIAL = 0;
+const uint8_t TIPO_RASTRO_TECLA = 1;
+const uint8_t MAX_BYTES_EVENTO_RASTRO = 6;    // varint de 32 bits e o dado
+const uint8_t BYTES_CABECALHO_RASTRO = 14;
+
+#if RASTRO
+
+template <uint16_t BYTES>
+class Rastro {
+public:
+  Rastro() : encerrado(true), cheio(false), comecoDeLinha(true) {
+    zerar();
+  }
+
+  // Guarda o CRC da EEPROM como esta agora e comeca a gravar
+  void iniciar() {
+    zerar();
+    crcEeprom = 0xFFFF;
+    for (uint16_t i = 0; i < EEPROM.length(); i++) {
+      crcEeprom = _crc_ccitt_update(crcEeprom, EEPROM.read(i));
+    }
+    encerrado = false;
+    cheio = false;
+    comecoDeLinha = true;
+  }
+
+  void serial(uint8_t byte) {
+    uint16_t usadosAntes = usados;
+    uint16_t eventosAntes = eventos;
+    if (!gravar(TIPO_RASTRO_SERIAL, byte)) {
+      return;
+    }
+    if (comecoDeLinha) {
+      inicioLinha.usados = usadosAntes;
+      inicioLinha.eventos = eventosAntes;
+    }
+    comecoDeLinha = byte == '\n' || byte == '\r';
+  }
+
+  void tecla(char tecla) {
+    gravar(TIPO_RASTRO_TECLA, tecla);
+  }
+
+  void despejar(Print &p) {
+    encerrar();
+
+    p.print(F("RASTRO "));
+    p.println(BYTES_CABECALHO_RASTRO + usados);
+    uint16_t crc = 0xFFFF;
+    crc = enviar(p, crc, 'R');
+    crc = enviar(p, crc, 'S');
+    crc = enviar(p, crc, VERSAO_RASTRO);
+    crc = enviar(p, crc, RASTRO_DIGITOS ? RASTRO_COM_DIGITOS : 0);
+    crc = enviar16(p, crc, crcEeprom);
+    crc = enviar16(p, crc, (uint16_t)duracaoMs);
+    crc = enviar16(p, crc, (uint16_t)(duracaoMs >> 16));
+    crc = enviar16(p, crc, eventos);
+    crc = enviar16(p, crc, perdidos);
+    for (uint16_t i = 0; i < usados; i++) {
+      crc = enviar(p, crc, dados[i]);
+    }
+    p.write((uint8_t)crc);
+    p.write((uint8_t)(crc >> 8));
+    p.println();
+  }
+
+private:
+  struct Marca {
+    uint16_t usados;
+    uint16_t eventos;
+  };
+
+  void zerar() {
+    usados = 0;
+    eventos = 0;
+    perdidos = 0;
+    ultimoMs = 0;
+    duracaoMs = 0;
+    crcEeprom = 0;
+    inicioLinha.usados = inicioLinha.eventos = 0;
+  }
+
+  // A linha que terminou por ultimo e o pedido de despejo: volta ao
+  // primeiro byte dela
+  void encerrar() {
+    if (encerrado) {
+      return;
+    }
+    encerrado = true;
+    if (!cheio) {
+      usados = inicioLinha.usados;
+      eventos = inicioLinha.eventos;
+      duracaoMs = millis();
+    }
+  }
+
+  bool gravar(uint8_t tipo, uint8_t dado) {
+    if (encerrado) {
+      return false;
+    }
+    unsigned long agora = millis();
+    if (!cheio && usados + MAX_BYTES_EVENTO_RASTRO > BYTES) {
+      cheio = true;
+      duracaoMs = agora;
+    }
+    if (cheio) {
+      if (perdidos < 0xFFFF) {
+        perdidos++;
+      }
+      return false;
+    }
+    uint32_t valor = (uint32_t)(agora - ultimoMs) << 1 | tipo;
+    ultimoMs = agora;
+    while (valor >= 0x80) {
+      dados[usados++] = (uint8_t)valor | 0x80;
+      valor >>= 7;
+    }
+    dados[usados++] = (uint8_t)valor;
+    dados[usados++] = !RASTRO_DIGITOS && dado >= '0' && dado <= '9' ? '0' : dado;
+    eventos++;
+    return true;
+  }
+
+  static uint16_t enviar(Print &p, uint16_t crc, uint8_t byte) {
+    p.write(byte);
+    return _crc_ccitt_update(crc, byte);
+  }
+
+  static uint16_t enviar16(Print &p, uint16_t crc, uint16_t valor) {
+    crc = enviar(p, crc, (uint8_t)valor);
+    return enviar(p, crc, (uint8_t)(valor >> 8));
+  }
+
+  bool encerrado;
+  bool cheio;
+  bool comecoDeLinha;      // o proximo byte da serial abre uma linha
+  uint8_t dados[BYTES];
+  uint16_t usados;
+  uint16_t eventos;
+  uint16_t perdidos;
+  unsigned long ultimoMs;
+  unsigned long duracaoMs;
+  uint16_t crcEeprom;
+  Marca inicioLinha;       // antes do primeiro byte da ultima linha
+};
+
+#else
+
+template <uint16_t BYTES>
+class Rastro {
+public:
+  void iniciar() {}
+  void serial(uint8_t) {}
+  void tecla(char) {}
+  void despejar(Print &p) {
+    p.println(F("Rastro desligado nesta compilacao (compile com -DRASTRO=1)"));
+  }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,205 @@
+// SHA-256 (FIPS 180-4) e HMAC-SHA256 (RFC 2104) escritos para o AVR de
+// 8 bits.
+//
+// A compressao e onde vai o tempo: 64 rodadas por bloco de 64 bytes.
+// Aqui ela
+//   - guarda as 8 palavras do estado em variaveis locais, desenroladas de
+//     8 em 8 rodadas com os nomes trocados em vez de mover a..h a cada
+//     rodada (no AVR cada palavra copiada sao 4 registradores);
+//   - expande a mensagem num anel de 16 palavras (64 bytes na pilha, e
+//     nao os 256 de W[64]);
+//   - le as 64 constantes da flash (PROGMEM), sem ocupar RAM.
+// Desenrolar as 64 rodadas multiplicaria esse codigo por 8 na flash de
+// 32 KB. host/bench_credencial.cc confere os vetores de teste e estima os
+// ciclos no AVR.
+//
+//   uint8_t resumo[TAMANHO_RESUMO_SHA256];
+//   Sha256 sha;
+//   sha.adicionar(dados, tamanho);
+//   sha.finalizar(resumo);
+//   hmacSha256(chave, tamanhoChave, mensagem, tamanhoMensagem, resumo);
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <Arduino.h>
+
+const uint8_t TAMANHO_BLOCO_SHA256 = 64;
+const uint8_t TAMANHO_RESUMO_SHA256 = 32;
+
+const uint32_t K_SHA256[64] PROGMEM = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const uint32_t INICIO_SHA256[8] PROGMEM = {
+  0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+// Rotacoes multiplas de 8 sao so troca de bytes no AVR; o resto custa
+// um deslocamento de 4 registradores por bit
+static inline uint32_t rotacaoSha256(uint32_t x, uint8_t n) {
+  return (x >> n) | (x << (32 - n));
+}
+
+static inline uint32_t grandeSigma0(uint32_t x) {
+  return rotacaoSha256(x, 2) ^ rotacaoSha256(x, 13) ^ rotacaoSha256(x, 22);
+}
+
+static inline uint32_t grandeSigma1(uint32_t x) {
+  return rotacaoSha256(x, 6) ^ rotacaoSha256(x, 11) ^ rotacaoSha256(x, 25);
+}
+
+static inline uint32_t pequenoSigma0(uint32_t x) {
+  return rotacaoSha256(x, 7) ^ rotacaoSha256(x, 18) ^ (x >> 3);
+}
+
+static inline uint32_t pequenoSigma1(uint32_t x) {
+  return rotacaoSha256(x, 17) ^ rotacaoSha256(x, 19) ^ (x >> 10);
+}
+
+// Uma rodada: so d e h mudam; quem chama gira os nomes das variaveis.
+// kw = K[t] + W[t]
+static inline void rodadaSha256(uint32_t a, uint32_t b, uint32_t c, uint32_t &d,
+                                uint32_t e, uint32_t f, uint32_t g, uint32_t &h,
+                                uint32_t kw) {
+  uint32_t t1 = h + grandeSigma1(e) + (g ^ (e & (f ^ g))) + kw;
+  d += t1;
+  h = t1 + grandeSigma0(a) + ((a & b) | (c & (a | b)));
+}
+
+class Sha256 {
+public:
+  Sha256() { iniciar(); }
+
+  void iniciar() {
+    for (uint8_t i = 0; i < 8; i++) {
+      estado[i] = pgm_read_dword(&INICIO_SHA256[i]);
+    }
+    usados = 0;
+    total = 0;
+  }
+
+  void adicionar(const uint8_t *dados, size_t tamanho) {
+    total += tamanho;
+    while (tamanho > 0) {
+      bloco[usados++] = *dados++;
+      tamanho--;
+      if (usados == TAMANHO_BLOCO_SHA256) {
+        comprimir();
+        usados = 0;
+      }
+    }
+  }
+
+  // Escreve os 32 bytes do resumo; depois disso chame iniciar() para
+  // reaproveitar o objeto
+  void finalizar(uint8_t *resumo) {
+    uint32_t bits = total << 3;
+    uint8_t bitsAltos = (uint8_t)(total >> 29);
+    bloco[usados++] = 0x80;
+    if (usados > TAMANHO_BLOCO_SHA256 - 8) {
+      memset(bloco + usados, 0, TAMANHO_BLOCO_SHA256 - usados);
+      comprimir();
+      usados = 0;
+    }
+    memset(bloco + usados, 0, TAMANHO_BLOCO_SHA256 - 8 - usados);
+    bloco[56] = 0;
+    bloco[57] = 0;
+    bloco[58] = 0;
+    bloco[59] = bitsAltos;
+    escreverPalavra(bloco + 60, bits);
+    comprimir();
+    for (uint8_t i = 0; i < 8; i++) {
+      escreverPalavra(resumo + 4 * i, estado[i]);
+    }
+  }
+
+private:
+  static uint32_t lerPalavra(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+  }
+
+  static void escreverPalavra(uint8_t *p, uint32_t x) {
+    p[0] = (uint8_t)(x >> 24);
+    p[1] = (uint8_t)(x >> 16);
+    p[2] = (uint8_t)(x >> 8);
+    p[3] = (uint8_t)x;
+  }
+
+  void comprimir() {
+    uint32_t w[16];
+    for (uint8_t i = 0; i < 16; i++) {
+      w[i] = lerPalavra(bloco + 4 * i);
+    }
+    uint32_t a = estado[0], b = estado[1], c = estado[2], d = estado[3];
+    uint32_t e = estado[4], f = estado[5], g = estado[6], h = estado[7];
+
+    for (uint8_t t = 0; t < 64; t += 8) {
+      // W[t..t+7] a partir da rodada 16, no lugar de W[t-16]
+      if (t >= 16) {
+        for (uint8_t i = t; i < t + 8; i++) {
+          w[i & 15] += pequenoSigma1(w[(i - 2) & 15]) + w[(i - 7) & 15] + pequenoSigma0(w[(i - 15) & 15]);
+        }
+      }
+      const uint32_t *k = K_SHA256 + t;
+      uint32_t *wt = w + (t & 15);
+      rodadaSha256(a, b, c, d, e, f, g, h, pgm_read_dword(k + 0) + wt[0]);
+      rodadaSha256(h, a, b, c, d, e, f, g, pgm_read_dword(k + 1) + wt[1]);
+      rodadaSha256(g, h, a, b, c, d, e, f, pgm_read_dword(k + 2) + wt[2]);
+      rodadaSha256(f, g, h, a, b, c, d, e, pgm_read_dword(k + 3) + wt[3]);
+      rodadaSha256(e, f, g, h, a, b, c, d, pgm_read_dword(k + 4) + wt[4]);
+      rodadaSha256(d, e, f, g, h, a, b, c, pgm_read_dword(k + 5) + wt[5]);
+      rodadaSha256(c, d, e, f, g, h, a, b, pgm_read_dword(k + 6) + wt[6]);
+      rodadaSha256(b, c, d, e, f, g, h, a, pgm_read_dword(k + 7) + wt[7]);
+    }
+
+    estado[0] += a; estado[1] += b; estado[2] += c; estado[3] += d;
+    estado[4] += e; estado[5] += f; estado[6] += g; estado[7] += h;
+  }
+
+  uint32_t estado[8];
+  uint8_t bloco[TAMANHO_BLOCO_SHA256];
+  uint8_t usados;
+  uint32_t total;   // em bytes (ate 4 GB)
+};
+
+// HMAC-SHA256: 4 compressoes para chave e mensagem curtas. Chaves maiores
+// que um bloco sao hasheadas antes, como manda a RFC. Usa um so Sha256
+// (~100 bytes) mais o bloco da chave na pilha
+inline void hmacSha256(const uint8_t *chave, size_t tamanhoChave,
+                       const uint8_t *mensagem, size_t tamanhoMensagem, uint8_t *resumo) {
+  uint8_t chaveBloco[TAMANHO_BLOCO_SHA256];
+  Sha256 sha;
+  memset(chaveBloco, 0, sizeof(chaveBloco));
+  if (tamanhoChave > TAMANHO_BLOCO_SHA256) {
+    sha.adicionar(chave, tamanhoChave);
+    sha.finalizar(chaveBloco);
+    sha.iniciar();
+  } else {
+    memcpy(chaveBloco, chave, tamanhoChave);
+  }
+
+  for (uint8_t i = 0; i < TAMANHO_BLOCO_SHA256; i++) {
+    chaveBloco[i] ^= 0x36;
+  }
+  sha.adicionar(chaveBloco, TAMANHO_BLOCO_SHA256);
+  sha.adicionar(mensagem, tamanhoMensagem);
+  sha.finalizar(resumo);
+
+  // 0x36 ^ 0x5c: troca ipad por opad sem guardar a chave de novo
+  for (uint8_t i = 0; i < TAMANHO_BLOCO_SHA256; i++) {
+    chaveBloco[i] ^= 0x36 ^ 0x5c;
+  }
+  sha.iniciar();
+  sha.adicionar(chaveBloco, TAMANHO_BLOCO_SHA256);
+  sha.adicionar(resumo, TAMANHO_RESUMO_SHA256);
+  sha.finalizar(resumo);
+}
+
+#endif
@@ -0,0 +1,146 @@
+// Tabela de comandos da serial com hash perfeito gerado em tempo de
+// compilacao.
+//
+// Cada sketch declara seus comandos numa tabela constexpr em PROGMEM.
+// O compilador procura um multiplicador que leva cada nome a um slot
+// diferente e monta o indice de slots tambem em PROGMEM. Na execucao, a
+// busca calcula o hash do nome numa unica passada pelos bytes, acha o
+// slot com uma multiplicacao e confirma o nome com strcmp_P. O custo nao
+// cresce com o numero de comandos (ate MAX_COMANDOS).
+//
+//   constexpr Comando COMANDOS[] PROGMEM = {
+//     { "LED_ON", comandoLedOn, 0 },
+//     ...
+//   };
+//   constexpr IndiceComandos INDICE PROGMEM = GERAR_INDICE_COMANDOS(COMANDOS);
+//
+//   char *argumento;
+//   const Comando *c = buscarComando(COMANDOS, INDICE, linha, &argumento);
+//
+// Os dois bits altos das opcoes dizem se o comando aceita argumento:
+// com COMANDO_SEM_ARGUMENTO, "NOME:x" nao e o comando; com
+// COMANDO_EXIGE_ARGUMENTO, "NOME" e "NOME:" tambem nao. Sem nenhum dos
+// dois o argumento e opcional.
+#ifndef TABELA_COMANDOS_H
+#define TABELA_COMANDOS_H
+
+#include <Arduino.h>
+
+const uint8_t TAMANHO_NOME_COMANDO = 8;   // 7 caracteres + '\0'
+// Quatro slots por comando deixam o multiplicador facil de achar
+const uint8_t BITS_SLOT_COMANDO = 6;
+const uint8_t SLOTS_COMANDOS = 1 << BITS_SLOT_COMANDO;
+const uint8_t MAX_COMANDOS = SLOTS_COMANDOS / 4;
+const uint8_t SEM_COMANDO = 0xFF;
+const uint8_t COMANDO_SEM_ARGUMENTO = 0x80;
+const uint8_t COMANDO_EXIGE_ARGUMENTO = 0x40;
+
+// Recebe o texto depois de "NOME:" (ou "" se nao houver)
+typedef void (*ExecutarComando)(const char *argumento);
+
+struct Comando {
+  char nome[TAMANHO_NOME_COMANDO];
+  ExecutarComando executar;
+  uint8_t opcoes;   // COMANDO_*_ARGUMENTO; os bits 0 a 5 sao do sketch
+};
+
+struct IndiceComandos {
+  uint16_t multiplicador;
+  uint8_t slots[SLOTS_COMANDOS];   // slot -> posicao na tabela
+};
+
+// FNV-1a de 16 bits: o mesmo passo roda no compilador e no AVR, um byte
+// por vez enquanto o nome e lido
+constexpr uint16_t passoHashComando(uint16_t hash, char c) {
+  return (uint16_t)((unsigned int)(hash ^ (uint8_t)c) * 0x0193u);
+}
+
+constexpr uint16_t hashComando(const char *nome, uint16_t hash = 0x9DC5) {
+  return *nome ? hashComando(nome + 1, passoHashComando(hash, *nome)) : hash;
+}
+
+// Multiplica e fica com os bits altos, que dependem de todo o hash
+constexpr uint8_t slotDoHash(uint16_t hash, uint16_t multiplicador) {
+  return (uint16_t)((unsigned int)hash * multiplicador) >> (16 - BITS_SLOT_COMANDO);
+}
+
+template <size_t N>
+constexpr bool slotsColidem(const Comando (&tabela)[N], uint16_t multiplicador,
+                            size_t i = 0, size_t j = 1) {
+  return i >= N ? false
+       : j >= N ? slotsColidem(tabela, multiplicador, i + 1, i + 2)
+       : slotDoHash(hashComando(tabela[i].nome), multiplicador) ==
+             slotDoHash(hashComando(tabela[j].nome), multiplicador)
+         || slotsColidem(tabela, multiplicador, i, j + 1);
+}
+
+// Primeiro multiplicador impar sem colisoes. Se nenhum servir, a
+// recursao estoura o limite do compilador e o build falha.
+template <size_t N>
+constexpr uint16_t multiplicadorComandos(const Comando (&tabela)[N], uint16_t multiplicador = 1) {
+  return !slotsColidem(tabela, multiplicador)
+         ? multiplicador
+         : multiplicadorComandos(tabela, multiplicador + 2);
+}
+
+template <size_t N>
+constexpr uint8_t slotComando(const Comando (&tabela)[N], uint8_t slot, size_t i = 0) {
+  static_assert(N <= MAX_COMANDOS, "Comandos demais para a tabela");
+  return i >= N ? SEM_COMANDO
+       : slotDoHash(hashComando(tabela[i].nome), multiplicadorComandos(tabela)) == slot
+         ? (uint8_t)i
+         : slotComando(tabela, slot, i + 1);
+}
+
+#define SLOTS_COMANDO_8(t, b)                                           \
+  slotComando(t, b),     slotComando(t, b + 1), slotComando(t, b + 2), \
+  slotComando(t, b + 3), slotComando(t, b + 4), slotComando(t, b + 5), \
+  slotComando(t, b + 6), slotComando(t, b + 7)
+
+#define GERAR_INDICE_COMANDOS(t) { multiplicadorComandos(t), {              \
+  SLOTS_COMANDO_8(t, 0),  SLOTS_COMANDO_8(t, 8),  SLOTS_COMANDO_8(t, 16), \
+  SLOTS_COMANDO_8(t, 24), SLOTS_COMANDO_8(t, 32), SLOTS_COMANDO_8(t, 40), \
+  SLOTS_COMANDO_8(t, 48), SLOTS_COMANDO_8(t, 56) } }
+
+// Procura o comando no inicio de 'linha' ("NOME" ou "NOME:argumento").
+// Termina o nome com '\0' no lugar do ':' e aponta 'argumento' para o
+// resto. Retorna o endereco em PROGMEM da entrada, ou NULL (tambem se
+// o argumento nao combinar com as opcoes do comando).
+template <size_t N>
+const Comando *buscarComando(const Comando (&tabela)[N], const IndiceComandos &indice,
+                             char *linha, char **argumento) {
+  uint16_t hash = hashComando("");
+  char *p = linha;
+  while (*p && *p != ':') {
+    hash = passoHashComando(hash, *p++);
+  }
+  bool doisPontos = *p == ':';
+  if (doisPontos) {
+    *p++ = '\0';
+  }
+  *argumento = p;
+
+  uint16_t multiplicador = pgm_read_word(&indice.multiplicador);
+  uint8_t posicao = pgm_read_byte(&indice.slots[slotDoHash(hash, multiplicador)]);
+  if (posicao == SEM_COMANDO || strcmp_P(linha, tabela[posicao].nome) != 0) {
+    return NULL;
+  }
+  uint8_t opcoes = pgm_read_byte(&tabela[posicao].opcoes);
+  if ((opcoes & COMANDO_SEM_ARGUMENTO) && doisPontos) {
+    return NULL;
+  }
+  if ((opcoes & COMANDO_EXIGE_ARGUMENTO) && *p == '\0') {
+    return NULL;
+  }
+  return &tabela[posicao];
+}
+
+inline ExecutarComando funcaoDoComando(const Comando *comando) {
+  return (ExecutarComando)pgm_read_ptr(&comando->executar);
+}
+
+inline uint8_t opcoesDoComando(const Comando *comando) {
+  return pgm_read_byte(&comando->opcoes);
+}
+
+#endif
@@ -0,0 +1,341 @@
+// Tabela de usuarios na EEPROM: registros de tamanho fixo com um indice
+// ordenado por id, para achar o usuario por busca binaria.
+//
+// Layout a partir de INICIO (TAMANHO bytes):
+//
+//   cabecalho  'U' versao total falhasSemUsuario sal[16]        20 bytes
+//   indice     numero do registro de cada usuario, em ordem de id
+//   registros  id(2) resumo(8) flags(1) tentativas(1)          12 bytes
+//
+// O indice tem um byte por usuario: inserir desloca bytes do indice, e
+// nao registros de 12 bytes. Em 768 bytes cabem 57 usuarios; numa EEPROM
+// de 4 KB (Mega), 314.
+//
+// O resumo e HMAC-SHA256(sal da tabela, id + PIN) (sha256.h) cortado em
+// 8 bytes: o id entra no HMAC, entao dois usuarios com o mesmo PIN tem
+// resumos diferentes. Para PINs de poucos digitos 64 bits sobram.
+//
+// verificar() nao revela pelo tempo qual id achou, nem se achou: a busca
+// da sempre o mesmo numero de passos (o da capacidade, nao o do total),
+// cada passo le os mesmos bytes, o registro candidato e lido e o HMAC e
+// calculado mesmo sem usuario, e toda verificacao grava exatamente um
+// byte (as tentativas do usuario, ou o contador de falhas sem usuario no
+// cabecalho). O tempo tambem nao cresce com a tabela.
+//
+// Depois de MAX_TENTATIVAS_USUARIO erros seguidos o usuario fica
+// recusado ate liberar(); travar() recusa o usuario sem apagar.
+//
+// Carga em lote: iniciarCarga() apaga a tabela, acrescentar() grava so o
+// registro e concluirCarga() ordena o indice uma vez no fim.
+//
+//   TabelaUsuarios<0, 768> usuarios;
+//   usuarios.iniciar();                       // no setup()
+//   usuarios.definir(42, "1234", 4);
+//   if (usuarios.verificar(42, digitado, tamanho)) ...
+#ifndef TABELA_USUARIOS_H
+#define TABELA_USUARIOS_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "sha256.h"
+#include "credencial.h"
+
+const uint8_t MARCA_TABELA_USUARIOS = 'U';
+const uint8_t VERSAO_TABELA_USUARIOS = 1;
+const uint8_t CABECALHO_USUARIOS = 4 + TAMANHO_SAL;
+const uint8_t TAMANHO_RESUMO_USUARIO = 8;
+const uint8_t TAMANHO_REGISTRO_USUARIO = 2 + TAMANHO_RESUMO_USUARIO + 2;
+const uint8_t MAX_TENTATIVAS_USUARIO = 10;
+const uint8_t FLAG_USUARIO_TRAVADO = 0x01;
+
+// Passos da busca binaria para 'n' entradas: o menor k com 2^k > n
+constexpr uint8_t passosBuscaUsuarios(uint16_t n) {
+  return n == 0 ? 0 : 1 + passosBuscaUsuarios(n >> 1);
+}
+
+template <uint16_t INICIO, uint16_t TAMANHO>
+class TabelaUsuarios {
+public:
+  static const uint8_t CAPACIDADE =
+    (TAMANHO - CABECALHO_USUARIOS) / (1 + TAMANHO_REGISTRO_USUARIO) > 255
+      ? 255 : (TAMANHO - CABECALHO_USUARIOS) / (1 + TAMANHO_REGISTRO_USUARIO);
+
+  TabelaUsuarios() : quantidade(0), carregados(0), valida(false) {}
+
+  // Le o cabecalho; sem tabela valida fica vazia, sem gravar nada
+  void iniciar() {
+    valida = EEPROM.read(INICIO) == MARCA_TABELA_USUARIOS &&
+             EEPROM.read(INICIO + 1) == VERSAO_TABELA_USUARIOS;
+    quantidade = valida ? EEPROM.read(ENDERECO_TOTAL) : 0;
+    if (quantidade > CAPACIDADE) {
+      quantidade = 0;
+    }
+  }
+
+  uint8_t total() const { return quantidade; }
+  uint8_t capacidade() const { return CAPACIDADE; }
+  uint8_t falhasSemUsuario() { return valida ? EEPROM.read(ENDERECO_FALHAS) : 0; }
+
+  // Cria ou troca o PIN (zera tentativas e destrava); false se cheia
+  bool definir(uint16_t id, const char *pin, uint8_t tamanho) {
+    if (!valida) {
+      formatar();
+    }
+    uint8_t posicao = posicaoNoIndice(id);
+    if (posicao < quantidade && lerId(registroNoIndice(posicao)) == id) {
+      gravarRegistro(registroNoIndice(posicao), id, pin, tamanho);
+      return true;
+    }
+    if (quantidade == CAPACIDADE) {
+      return false;
+    }
+    uint8_t registro = registroLivre();
+    gravarRegistro(registro, id, pin, tamanho);
+    for (uint8_t i = quantidade; i > posicao; i--) {
+      EEPROM.update(INICIO_INDICE + i, EEPROM.read(INICIO_INDICE + i - 1));
+    }
+    EEPROM.update(INICIO_INDICE + posicao, registro);
+    gravarTotal(quantidade + 1);
+    return true;
+  }
+
+  bool remover(uint16_t id) {
+    uint8_t posicao;
+    if (!acharId(id, posicao)) {
+      return false;
+    }
+    for (uint8_t i = posicao; i + 1 < quantidade; i++) {
+      EEPROM.update(INICIO_INDICE + i, EEPROM.read(INICIO_INDICE + i + 1));
+    }
+    gravarTotal(quantidade - 1);
+    return true;
+  }
+
+  // Trava ou libera; liberar tambem zera as tentativas
+  bool travar(uint16_t id, bool travado) {
+    uint8_t posicao;
+    if (!acharId(id, posicao)) {
+      return false;
+    }
+    uint16_t endereco = enderecoRegistro(registroNoIndice(posicao));
+    EEPROM.update(endereco + 2 + TAMANHO_RESUMO_USUARIO, travado ? FLAG_USUARIO_TRAVADO : 0);
+    if (!travado) {
+      EEPROM.update(endereco + 3 + TAMANHO_RESUMO_USUARIO, 0);
+    }
+    return true;
+  }
+
+  bool verificar(uint16_t id, const char *pin, uint8_t tamanho) {
+    // Busca binaria sem desvio: 'posicao' termina no numero de ids <= id.
+    // Todo passo le um byte do indice e um id, mesmo fora da tabela
+    uint8_t posicao = 0;
+    uint8_t ultimo = quantidade > 0 ? quantidade - 1 : 0;
+    for (uint8_t passo = 1 << (PASSOS_BUSCA - 1); passo > 0; passo >>= 1) {
+      uint8_t proxima = posicao + passo;
+      uint8_t lida = proxima <= quantidade ? proxima - 1 : ultimo;
+      uint16_t idLido = lerId(registroNoIndice(lida));
+      uint8_t avanca = -(uint8_t)(proxima <= quantidade && idLido <= id);
+      posicao = (posicao & ~avanca) | (proxima & avanca);
+    }
+    uint8_t candidata = posicao > 0 ? posicao - 1 : 0;
+
+    uint8_t registro[TAMANHO_REGISTRO_USUARIO];
+    uint16_t endereco = enderecoRegistro(registroNoIndice(candidata));
+    for (uint8_t i = 0; i < TAMANHO_REGISTRO_USUARIO; i++) {
+      registro[i] = EEPROM.read(endereco + i);
+    }
+    uint8_t resumo[TAMANHO_RESUMO_SHA256];
+    calcularResumo(id, pin, tamanho, resumo);
+
+    uint16_t idRegistro = registro[0] | ((uint16_t)registro[1] << 8);
+    uint8_t flags = registro[2 + TAMANHO_RESUMO_USUARIO];
+    uint8_t tentativas = registro[3 + TAMANHO_RESUMO_USUARIO];
+    bool achou = quantidade > 0 && posicao > 0 && idRegistro == id;
+    bool aceito = iguaisTempoConstante(resumo, registro + 2, TAMANHO_RESUMO_USUARIO) &
+                  ((flags & FLAG_USUARIO_TRAVADO) == 0) & (tentativas < MAX_TENTATIVAS_USUARIO) & achou;
+
+    // Sempre uma leitura do contador sem usuario e uma escrita (write, e
+    // nao update, que pularia valores iguais)
+    uint8_t falhas = EEPROM.read(ENDERECO_FALHAS);
+    uint16_t alvo = achou ? endereco + 3 + TAMANHO_RESUMO_USUARIO : ENDERECO_FALHAS;
+    uint8_t valor = achou ? (aceito ? 0 : proximaTentativa(tentativas)) : proximaTentativa(falhas);
+    EEPROM.write(alvo, valor);
+    return aceito;
+  }
+
+  // Apaga a tabela (sal novo) e passa a aceitar acrescentar()
+  void iniciarCarga() {
+    formatar();
+    carregados = 0;
+  }
+
+  // Grava o registro seguinte sem mexer no indice; false se cheia
+  bool acrescentar(uint16_t id, const char *pin, uint8_t tamanho) {
+    if (carregados == CAPACIDADE) {
+      return false;
+    }
+    gravarRegistro(carregados++, id, pin, tamanho);
+    return true;
+  }
+
+  // Ordena os registros carregados e grava o indice de uma vez. Ids
+  // repetidos: vale o ultimo acrescentado. Retorna o total
+  uint8_t concluirCarga() {
+    uint8_t ordem[CAPACIDADE];
+    uint8_t n = 0;
+    for (uint8_t r = 0; r < carregados; r++) {
+      // Insercao: os ids sao lidos da EEPROM, a RAM guarda so a ordem
+      uint16_t id = lerId(r);
+      uint8_t i = n;
+      while (i > 0 && lerId(ordem[i - 1]) > id) {
+        i--;
+      }
+      if (i > 0 && lerId(ordem[i - 1]) == id) {
+        ordem[i - 1] = r;
+        continue;
+      }
+      memmove(ordem + i + 1, ordem + i, n - i);
+      ordem[i] = r;
+      n++;
+    }
+    for (uint8_t i = 0; i < n; i++) {
+      EEPROM.update(INICIO_INDICE + i, ordem[i]);
+    }
+    carregados = 0;
+    gravarTotal(n);
+    return n;
+  }
+
+  // Uma linha por usuario, em ordem de id: "id tentativas [TRAVADO]"
+  void listar(Print &p) {
+    for (uint8_t i = 0; i < quantidade; i++) {
+      uint16_t endereco = enderecoRegistro(registroNoIndice(i));
+      p.print(lerId(registroNoIndice(i)));
+      p.print(F(" tentativas "));
+      p.print(EEPROM.read(endereco + 3 + TAMANHO_RESUMO_USUARIO));
+      if (EEPROM.read(endereco + 2 + TAMANHO_RESUMO_USUARIO) & FLAG_USUARIO_TRAVADO) {
+        p.print(F(" TRAVADO"));
+      }
+      p.println();
+    }
+  }
+
+private:
+  static const uint16_t ENDERECO_TOTAL = INICIO + 2;
+  static const uint16_t ENDERECO_FALHAS = INICIO + 3;
+  static const uint16_t ENDERECO_SAL = INICIO + 4;
+  static const uint16_t INICIO_INDICE = INICIO + CABECALHO_USUARIOS;
+  static const uint16_t INICIO_REGISTROS = INICIO_INDICE + CAPACIDADE;
+  static const uint8_t PASSOS_BUSCA = passosBuscaUsuarios(CAPACIDADE);
+
+  static uint16_t enderecoRegistro(uint8_t registro) {
+    return INICIO_REGISTROS + (uint16_t)registro * TAMANHO_REGISTRO_USUARIO;
+  }
+
+  // Fora da tabela (EEPROM apagada) o numero pode passar da capacidade
+  static uint8_t registroNoIndice(uint8_t posicao) {
+    uint8_t registro = EEPROM.read(INICIO_INDICE + posicao);
+    return registro < CAPACIDADE ? registro : 0;
+  }
+
+  static uint16_t lerId(uint8_t registro) {
+    uint16_t endereco = enderecoRegistro(registro);
+    return EEPROM.read(endereco) | ((uint16_t)EEPROM.read(endereco + 1) << 8);
+  }
+
+  static uint8_t proximaTentativa(uint8_t tentativas) {
+    return tentativas < 255 ? tentativas + 1 : 255;
+  }
+
+  // Primeira posicao do indice com id >= 'id' (busca comum, com desvio:
+  // so para manutencao, nunca na verificacao)
+  uint8_t posicaoNoIndice(uint16_t id) {
+    uint8_t baixo = 0, alto = quantidade;
+    while (baixo < alto) {
+      uint8_t meio = (baixo + alto) / 2;
+      if (lerId(registroNoIndice(meio)) < id) {
+        baixo = meio + 1;
+      } else {
+        alto = meio;
+      }
+    }
+    return baixo;
+  }
+
+  bool acharId(uint16_t id, uint8_t &posicao) {
+    posicao = posicaoNoIndice(id);
+    return posicao < quantidade && lerId(registroNoIndice(posicao)) == id;
+  }
+
+  // Um registro que o indice nao usa
+  uint8_t registroLivre() {
+    uint8_t usados[(CAPACIDADE + 7) / 8];
+    memset(usados, 0, sizeof(usados));
+    for (uint8_t i = 0; i < quantidade; i++) {
+      uint8_t r = registroNoIndice(i);
+      usados[r >> 3] |= 1 << (r & 7);
+    }
+    uint8_t r = 0;
+    while (usados[r >> 3] & (1 << (r & 7))) {
+      r++;
+    }
+    return r;
+  }
+
+  void calcularResumo(uint16_t id, const char *pin, uint8_t tamanho, uint8_t *resumo) {
+    uint8_t sal[TAMANHO_SAL];
+    for (uint8_t i = 0; i < TAMANHO_SAL; i++) {
+      sal[i] = EEPROM.read(ENDERECO_SAL + i);
+    }
+    uint8_t mensagem[2 + TAMANHO_BLOCO_SHA256];
+    if (tamanho > TAMANHO_BLOCO_SHA256) {
+      tamanho = TAMANHO_BLOCO_SHA256;
+    }
+    mensagem[0] = (uint8_t)id;
+    mensagem[1] = (uint8_t)(id >> 8);
+    memcpy(mensagem + 2, pin, tamanho);
+    hmacSha256(sal, TAMANHO_SAL, mensagem, 2 + tamanho, resumo);
+  }
+
+  void gravarRegistro(uint8_t registro, uint16_t id, const char *pin, uint8_t tamanho) {
+    uint8_t resumo[TAMANHO_RESUMO_SHA256];
+    calcularResumo(id, pin, tamanho, resumo);
+    uint16_t endereco = enderecoRegistro(registro);
+    EEPROM.update(endereco, (uint8_t)id);
+    EEPROM.update(endereco + 1, (uint8_t)(id >> 8));
+    for (uint8_t i = 0; i < TAMANHO_RESUMO_USUARIO; i++) {
+      EEPROM.update(endereco + 2 + i, resumo[i]);
+    }
+    EEPROM.update(endereco + 2 + TAMANHO_RESUMO_USUARIO, 0);
+    EEPROM.update(endereco + 3 + TAMANHO_RESUMO_USUARIO, 0);
+  }
+
+  void gravarTotal(uint8_t total) {
+    quantidade = total;
+    EEPROM.update(ENDERECO_TOTAL, total);
+  }
+
+  // Tabela vazia com sal novo. O AVR nao tem fonte de entropia: o sal sai
+  // do micros() no instante da primeira carga, que depende de quando o
+  // operador mandou o comando, e so precisa variar entre aparelhos
+  void formatar() {
+    uint32_t x = micros() | 1;
+    for (uint8_t i = 0; i < TAMANHO_SAL; i++) {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      EEPROM.update(ENDERECO_SAL + i, (uint8_t)x);
+    }
+    EEPROM.update(INICIO, MARCA_TABELA_USUARIOS);
+    EEPROM.update(INICIO + 1, VERSAO_TABELA_USUARIOS);
+    EEPROM.update(ENDERECO_FALHAS, 0);
+    gravarTotal(0);
+    valida = true;
+  }
+
+  uint8_t quantidade;
+  uint8_t carregados;
+  bool valida;
+};
+
+#endif
@@ -0,0 +1,104 @@
+// Varredura do teclado matricial pela interrupcao do Timer2.
+//
+// A cada 5 ms a ISR chama keypad.getKey() (a biblioteca ja faz o
+// debounce) e coloca a tecla nova numa fila circular. O loop() tira as
+// teclas com lerTecla(). Assim as teclas pressionadas durante um delay()
+// de tela (ACESSO NEGADO, bloqueio...) nao se perdem: ficam na fila e
+// sao tratadas quando o loop() volta.
+//
+// A fila tem um produtor (a ISR) e um consumidor (o loop): cada indice
+// so e escrito por um lado e tem um byte, que o AVR le de uma vez, entao
+// nao e preciso desligar as interrupcoes para ler.
+//
+// Define a ISR: inclua em um unico arquivo do sketch.
+//
+//   Keypad keypad = Keypad(...);
+//   iniciarVarreduraTeclado(keypad);   // no setup()
+//   char tecla = lerTecla();           // no loop(), NO_KEY se vazia
+//   tecla = lerTeclaSe(teclaDeModo);   // a primeira que teclaDeModo() aceitar
+#ifndef TECLADO_TIMER_H
+#define TECLADO_TIMER_H
+
+#include <Arduino.h>
+#include <Keypad.h>
+
+const uint8_t TAMANHO_FILA_TECLAS = 32;   // potencia de 2
+// CTC com prescaler 1024: 16 MHz / 1024 / (77 + 1) = 200 Hz
+const uint8_t COMPARACAO_TIMER_TECLADO = 77;
+
+volatile char filaTeclas[TAMANHO_FILA_TECLAS];
+volatile uint8_t escritaFilaTeclas = 0;   // so a ISR altera
+volatile uint8_t leituraFilaTeclas = 0;   // so o loop() altera
+volatile uint8_t teclasDescartadas = 0;   // fila cheia
+Keypad *tecladoVarrido = NULL;
+
+// Pela ISR; fora dela so quando a varredura nao ve teclas (a
+// reproducao de um rastro no host, ver rastro.h), senao seriam dois
+// produtores
+bool colocarTecla(char tecla) {
+  uint8_t proxima = (escritaFilaTeclas + 1) & (TAMANHO_FILA_TECLAS - 1);
+  if (proxima == leituraFilaTeclas) {
+    teclasDescartadas++;
+    return false;
+  }
+  filaTeclas[escritaFilaTeclas] = tecla;
+  escritaFilaTeclas = proxima;
+  return true;
+}
+
+ISR(TIMER2_COMPA_vect) {
+  char tecla = tecladoVarrido->getKey();
+  if (tecla != NO_KEY) {
+    colocarTecla(tecla);
+  }
+}
+
+void iniciarVarreduraTeclado(Keypad &teclado) {
+  tecladoVarrido = &teclado;
+  noInterrupts();
+  TCCR2A = _BV(WGM21);                          // modo CTC
+  TCCR2B = _BV(CS22) | _BV(CS21) | _BV(CS20);   // prescaler 1024
+  TCNT2 = 0;
+  OCR2A = COMPARACAO_TIMER_TECLADO;
+  TIMSK2 = _BV(OCIE2A);
+  interrupts();
+}
+
+uint8_t teclasNaFila() {
+  return (escritaFilaTeclas - leituraFilaTeclas) & (TAMANHO_FILA_TECLAS - 1);
+}
+
+char lerTecla() {
+  if (leituraFilaTeclas == escritaFilaTeclas) {
+    return NO_KEY;
+  }
+  char tecla = filaTeclas[leituraFilaTeclas];
+  leituraFilaTeclas = (leituraFilaTeclas + 1) & (TAMANHO_FILA_TECLAS - 1);
+  return tecla;
+}
+
+// Tira da fila a primeira tecla que aceita() aceitar; as que vieram
+// antes dela ficam, na mesma ordem (um bloqueio deixa os digitos para
+// depois). A ISR so escreve depois de escritaFilaTeclas, entao as
+// posicoes entre a leitura e a escrita podem ser deslocadas sem desligar
+// as interrupcoes
+char lerTeclaSe(bool (*aceita)(char)) {
+  uint8_t escrita = escritaFilaTeclas;
+  for (uint8_t i = leituraFilaTeclas; i != escrita; i = (i + 1) & (TAMANHO_FILA_TECLAS - 1)) {
+    char tecla = filaTeclas[i];
+    if (!aceita(tecla)) {
+      continue;
+    }
+    // As anteriores andam uma posicao, fechando o buraco
+    while (i != leituraFilaTeclas) {
+      uint8_t anterior = (i - 1) & (TAMANHO_FILA_TECLAS - 1);
+      filaTeclas[i] = filaTeclas[anterior];
+      i = anterior;
+    }
+    leituraFilaTeclas = (leituraFilaTeclas + 1) & (TAMANHO_FILA_TECLAS - 1);
+    return tecla;
+  }
+  return NO_KEY;
+}
+
+#endif
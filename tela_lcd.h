@@ -0,0 +1,84 @@
+// Copia em RAM do LCD 16x2 para os sketches do projeto_2.
+//
+// As telas sao desenhadas no buffer 'desejado' (limpar, posicionar e
+// print, como no LiquidCrystal) sem tocar no barramento. atualizar()
+// compara com o que ja esta no display e envia so as celulas que
+// mudaram, reposicionando o cursor apenas quando a proxima celula
+// alterada nao e a seguinte a ultima escrita. Nao ha lcd.clear()
+// (~2 ms e a tela pisca): digitar um digito custa um byte.
+//
+//   TelaLcd tela(lcd);
+//   tela.iniciar();               // depois de lcd.begin(16, 2)
+//   tela.limpar();
+//   tela.print("Senha:");
+//   tela.atualizar();
+#ifndef TELA_LCD_H
+#define TELA_LCD_H
+
+#include <Arduino.h>
+#include <LiquidCrystal.h>
+
+const uint8_t COLUNAS_TELA = 16;
+const uint8_t LINHAS_TELA = 2;
+
+class TelaLcd : public Print {
+public:
+  explicit TelaLcd(LiquidCrystal &lcd) : lcd(lcd), coluna(0), linha(0), colunaLcd(0), linhaLcd(0) {}
+
+  // Apaga o display uma vez e sincroniza as duas copias
+  void iniciar() {
+    lcd.clear();
+    memset(exibido, ' ', sizeof(exibido));
+    colunaLcd = 0;
+    linhaLcd = 0;
+    limpar();
+  }
+
+  void limpar() {
+    memset(desejado, ' ', sizeof(desejado));
+    coluna = 0;
+    linha = 0;
+  }
+
+  void posicionar(uint8_t novaColuna, uint8_t novaLinha) {
+    coluna = novaColuna;
+    linha = novaLinha < LINHAS_TELA ? novaLinha : LINHAS_TELA - 1;
+  }
+
+  // Texto alem da coluna 16 nao aparece no display e e descartado
+  size_t write(uint8_t caractere) {
+    if (coluna < COLUNAS_TELA) {
+      desejado[linha][coluna] = (char)caractere;
+    }
+    coluna++;
+    return 1;
+  }
+  using Print::write;
+
+  void atualizar() {
+    for (uint8_t l = 0; l < LINHAS_TELA; l++) {
+      for (uint8_t c = 0; c < COLUNAS_TELA; c++) {
+        if (desejado[l][c] == exibido[l][c]) {
+          continue;
+        }
+        // O HD44780 avanca o cursor sozinho a cada caractere
+        if (l != linhaLcd || c != colunaLcd) {
+          lcd.setCursor(c, l);
+          linhaLcd = l;
+        }
+        lcd.write(desejado[l][c]);
+        exibido[l][c] = desejado[l][c];
+        colunaLcd = c + 1;
+      }
+    }
+  }
+
+private:
+  LiquidCrystal &lcd;
+  char desejado[LINHAS_TELA][COLUNAS_TELA];
+  char exibido[LINHAS_TELA][COLUNAS_TELA];
+  uint8_t coluna, linha;           // cursor de desenho
+  uint8_t colunaLcd, linhaLcd;     // cursor do controlador
+};
+
+#endif